@@ -0,0 +1,90 @@
+## benchmarks :
+
+include_directories(src/bench/include)
+
+add_executable(
+	bench-thegame
+	src/bench/c/bench.c
+	src/bench/c/ModelGenerator.c
+)
+
+target_link_libraries(bench-thegame THEGAME)
+
+add_executable(
+	modelgen-thegame
+	src/bench/c/modelgen.c
+	src/bench/c/ModelGenerator.c
+)
+
+target_link_libraries(modelgen-thegame THEGAME)
+
+add_executable(
+	replay-thegame
+	src/bench/c/replay.c
+	src/bench/c/ModelGenerator.c
+)
+
+target_link_libraries(replay-thegame THEGAME)
+
+set_target_properties(
+    bench-thegame modelgen-thegame replay-thegame
+    PROPERTIES
+    COMPILE_FLAGS ${thegame_compile_flags}
+)
+
+if(LIBXML2_FOUND)
+    target_link_libraries(bench-thegame THEGAME-xml)
+    set_property(TARGET bench-thegame APPEND PROPERTY COMPILE_DEFINITIONS THEGAME_XML)
+endif(LIBXML2_FOUND)
+
+add_custom_target(bench
+    cmake -E copy_directory ${CMAKE_SOURCE_DIR}/src/test/resources/data ${CMAKE_BINARY_DIR}/data
+    COMMAND bench-thegame --output ${CMAKE_BINARY_DIR}/bench.json
+    DEPENDS bench-thegame
+    WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+    COMMENT "\n\n   ===== BENCHMARKS =====   \n\n"
+)
+
+## performance regression gate (ctest -L perf), a short subset compared to a baseline:
+## the timings depend on the machine, so the committed baseline only holds for the machine that measured it.
+## Regenerate it on each machine (cmake --build . --target perf_baseline) before enabling the tests with -DTHEGAME_PERF_TESTS=ON.
+
+option(THEGAME_PERF_TESTS "Register the perf tests (ctest -L perf), compared to a baseline measured on this machine" OFF)
+set(THEGAME_PERF_TOLERANCE 1.0 CACHE STRING "Relative slowdown tolerated by the perf tests (1.0 fails at twice the time of the baseline)")
+set(thegame_perf_baseline ${CMAKE_SOURCE_DIR}/src/test/resources/perf/baseline.json)
+set(thegame_perf_arguments
+    --min-size 8 --max-size 8
+    --filter BF_SmetsCombination,BF_DuboisPradeCombination,BF_getMaxBetP,BFB_believeFromBelief,BFS_getEvidence,BFS_loadBeliefStructure,BFB_loadBeliefStructure
+)
+
+if(THEGAME_PERF_TESTS AND NOT SKIPTEST AND NOT CMAKE_CROSSCOMPILING)
+    add_test(NAME perf_data
+        COMMAND cmake -E copy_directory ${CMAKE_SOURCE_DIR}/src/test/resources/data ${CMAKE_BINARY_DIR}/data
+    )
+    add_test(NAME perf
+        COMMAND bench-thegame ${thegame_perf_arguments} --output ${CMAKE_BINARY_DIR}/perf.json
+                --baseline ${thegame_perf_baseline} --tolerance ${THEGAME_PERF_TOLERANCE}
+        WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+    )
+    set_tests_properties(perf_data PROPERTIES FIXTURES_SETUP perf_data LABELS perf)
+    set_tests_properties(perf PROPERTIES FIXTURES_REQUIRED perf_data LABELS perf)
+endif(THEGAME_PERF_TESTS AND NOT SKIPTEST AND NOT CMAKE_CROSSCOMPILING)
+
+add_custom_target(perf_baseline
+    cmake -E copy_directory ${CMAKE_SOURCE_DIR}/src/test/resources/data ${CMAKE_BINARY_DIR}/data
+    COMMAND bench-thegame ${thegame_perf_arguments} --output ${thegame_perf_baseline}
+    DEPENDS bench-thegame
+    WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+    COMMENT "\n\n   ===== PERFORMANCE BASELINE =====   \n\n"
+)
+
+add_custom_target(replay
+    cmake -E remove_directory ${CMAKE_BINARY_DIR}/data/replay
+    COMMAND cmake -E remove_directory ${CMAKE_BINARY_DIR}/data/beliefsFromBeliefs/synthetic0
+    COMMAND cmake -E remove_directory ${CMAKE_BINARY_DIR}/data/beliefsFromBeliefs/synthetic1
+    COMMAND cmake -E copy_directory ${CMAKE_SOURCE_DIR}/src/test/resources/data ${CMAKE_BINARY_DIR}/data
+    COMMAND replay-thegame --output ${CMAKE_BINARY_DIR}/replay.json
+    DEPENDS replay-thegame
+    WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+    COMMENT "\n\n   ===== REPLAY =====   \n\n"
+)
@@ -0,0 +1,431 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "ModelGenerator.h"
+#include "BeliefsFromRandomness.h"
+
+/**
+ * This module writes synthetic models for load and scale testing.
+ * @file ModelGenerator.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief BENCHMARKS: Writes synthetic models for load and scale testing.
+ */
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * The curves of a sensor: nbFocals focal elements, nbPoints sensor values and the masses
+ * of the focal elements at each point (masses[point * nbFocals + focal]).
+ */
+struct Sensor {
+	uint64_t* elements;
+	float* values;
+	double* masses;
+	int nbFocals;
+	/** The options: variation, then tempo-fusion or tempo-specificity */
+	int variation;
+	int tempo;
+	const char* tempoName;
+};
+
+static int makeDirectory(const char* path){
+	return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+/**
+ * Gets the random generator of a frame: the frames use non-overlapping sequences,
+ * so that the model of a frame does not depend on the format.
+ */
+static BFR_Random getFrameRandom(const MG_Parameters parameters, const int frame){
+	BFR_Random random = BFR_createRandom(parameters.seed);
+	int i = 0;
+
+	for(i = 0; i < frame; i++){
+		BFR_jump(&random);
+	}
+
+	return random;
+}
+
+/**
+ * Quantizes masses summing to 1 into multiples of 1 / MG_MASS_QUANTUM summing exactly to 1
+ * (the remainder goes to the highest mass).
+ */
+static void quantizeMasses(double* masses, const int nbMasses){
+	long total = 0, quantum = 0;
+	int i = 0, highest = 0;
+
+	for(i = 0; i < nbMasses; i++){
+		quantum = (long)(masses[i] * MG_MASS_QUANTUM);
+		masses[i] = quantum;
+		total += quantum;
+		if(masses[i] > masses[highest]){
+			highest = i;
+		}
+	}
+	masses[highest] += MG_MASS_QUANTUM - total;
+	for(i = 0; i < nbMasses; i++){
+		masses[i] /= MG_MASS_QUANTUM;
+	}
+}
+
+/**
+ * Draws masses following a uniform Dirichlet distribution (the masses are quantized).
+ */
+static void drawMasses(BFR_Random* random, const int nbMasses, double* masses){
+	double sum = 0;
+	int i = 0;
+
+	for(i = 0; i < nbMasses; i++){
+		masses[i] = BFR_gamma(random, 1);
+		sum += masses[i];
+	}
+	for(i = 0; i < nbMasses; i++){
+		masses[i] /= sum;
+	}
+	quantizeMasses(masses, nbMasses);
+}
+
+/**
+ * Draws distinct non-empty random elements.
+ * @return The number of elements (nbElements capped to the number of non-empty subsets).
+ */
+static int drawElements(BFR_Random* random, const int nbAtoms, const int nbElements, uint64_t* elements){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	int i = 0, j = 0, nb = nbElements;
+
+	if(nbAtoms < 31 && nb > (1 << nbAtoms) - 1){
+		nb = (1 << nbAtoms) - 1;
+	}
+	bf = BFR_getRandomBelief(random, nbAtoms, nb, 1);
+	for(i = 0; i < bf.nbFocals; i++){
+		elements[i] = 0;
+		for(j = 0; j < nbAtoms; j++){
+			elements[i] |= (uint64_t)bf.focals[i].element.values[j] << j;
+		}
+	}
+	BF_freeBeliefFunction(&bf);
+
+	return nb;
+}
+
+static struct Sensor createSensor(BFR_Random* random, const MG_Parameters parameters, const int sensor){
+	struct Sensor s = {NULL, NULL, NULL, 0, 0, 0, NULL};
+	double value = 0;
+	int i = 0;
+
+	s.elements = malloc(sizeof(uint64_t) * parameters.nbFocals);
+	s.values = malloc(sizeof(float) * parameters.nbPoints);
+	s.masses = malloc(sizeof(double) * parameters.nbPoints * parameters.nbFocals);
+	s.nbFocals = drawElements(random, parameters.nbAtoms, parameters.nbFocals, s.elements);
+	/*Increasing sensor values, with the masses of all the focal elements at each point: */
+	for(i = 0; i < parameters.nbPoints; i++){
+		value += 1 + (int)BFR_uniformInteger(random, 100);
+		s.values[i] = value;
+		drawMasses(random, s.nbFocals, s.masses + i * s.nbFocals);
+	}
+	if(parameters.nbOptions > 0){
+		s.variation = 1 + BFR_uniformInteger(random, 4);
+	}
+	if(parameters.nbOptions > 1){
+		s.tempo = 1 + BFR_uniformInteger(random, 10);
+		s.tempoName = sensor % 2 ? "tempo-specificity" : "tempo-fusion";
+	}
+
+	return s;
+}
+
+static void freeSensor(struct Sensor* s){
+	free(s->elements);
+	free(s->values);
+	free(s->masses);
+}
+
+/**
+ * Writes the atoms of an element, one per line (with a leading new line) or separated by spaces.
+ */
+static void writeAtoms(FILE* f, const uint64_t element, const int nbAtoms, const char* separator){
+	int i = 0, first = 1;
+
+	for(i = 0; i < nbAtoms; i++){
+		if((element >> i) & 1){
+			fprintf(f, "%sw%d", first && separator[0] == ' ' ? "" : separator, i);
+			first = 0;
+		}
+	}
+}
+
+static int countAtoms(const uint64_t element){
+	uint64_t e = element;
+	int card = 0;
+
+	for(; e != 0; e >>= 1){
+		card += e & 1;
+	}
+
+	return card;
+}
+
+/**
+ * Writes the values file of a frame (no new line at the end, which would be read as an atom).
+ */
+static int writeValues(const char* path, const int nbAtoms){
+	FILE* f = fopen(path, "w");
+	int i = 0;
+
+	if(f == NULL){
+		return 0;
+	}
+	for(i = 0; i < nbAtoms; i++){
+		fprintf(f, "%sw%d", i > 0 ? "\n" : "", i);
+	}
+
+	return fclose(f) == 0;
+}
+
+static int writeSensorDirectory(const char* path, const struct Sensor s, const MG_Parameters parameters){
+	char filepath[1024];
+	FILE* f = NULL;
+	int i = 0, j = 0, written = 1;
+
+	if(!makeDirectory(path)){
+		return 0;
+	}
+	if(parameters.nbOptions > 0){
+		sprintf(filepath, "%s/options", path);
+		f = fopen(filepath, "w");
+		if(f == NULL){
+			return 0;
+		}
+		fprintf(f, "%d option%s\nvariation %d", parameters.nbOptions > 1 ? 2 : 1,
+				parameters.nbOptions > 1 ? "s" : "", s.variation);
+		if(parameters.nbOptions > 1){
+			fprintf(f, "\n%s %d", s.tempoName, s.tempo);
+		}
+		written = fclose(f) == 0 && written;
+	}
+	for(j = 0; j < s.nbFocals && written; j++){
+		sprintf(filepath, "%s/F%d.txt", path, j);
+		f = fopen(filepath, "w");
+		if(f == NULL){
+			return 0;
+		}
+		fprintf(f, "%d element%s", countAtoms(s.elements[j]), countAtoms(s.elements[j]) > 1 ? "s" : "");
+		writeAtoms(f, s.elements[j], parameters.nbAtoms, "\n");
+		fprintf(f, "\n%d points", parameters.nbPoints);
+		for(i = 0; i < parameters.nbPoints; i++){
+			/*Multiples of 1 / 2^16 have 16 decimals: */
+			fprintf(f, "\n%.0f %.16f", s.values[i], s.masses[i * s.nbFocals + j]);
+		}
+		written = fclose(f) == 0;
+	}
+
+	return written;
+}
+
+static void writeSensorXml(FILE* f, const struct Sensor s, const MG_Parameters parameters, const int sensor){
+	int i = 0, j = 0;
+
+	fprintf(f, "\t\t<sensor-belief name=\"S%dSet\">\n", sensor);
+	if(parameters.nbOptions > 0){
+		fprintf(f, "\t\t\t<options>\n");
+		fprintf(f, "\t\t\t\t<option name=\"variation\">%d</option>\n", s.variation);
+		if(parameters.nbOptions > 1){
+			fprintf(f, "\t\t\t\t<option name=\"%s\">%d</option>\n", s.tempoName, s.tempo);
+		}
+		fprintf(f, "\t\t\t</options>\n");
+	}
+	for(i = 0; i < parameters.nbPoints; i++){
+		fprintf(f, "\t\t\t<point>\n\t\t\t\t<value>%.0f</value>\n", s.values[i]);
+		for(j = 0; j < s.nbFocals; j++){
+			fprintf(f, "\t\t\t\t<mass set=\"");
+			writeAtoms(f, s.elements[j], parameters.nbAtoms, " ");
+			fprintf(f, "\">%.16f</mass>\n", s.masses[i * s.nbFocals + j]);
+		}
+		fprintf(f, "\t\t\t</point>\n");
+	}
+	fprintf(f, "\t\t</sensor-belief>\n");
+}
+
+static int checkParameters(const MG_Parameters parameters){
+	return parameters.nbFrames > 0 && parameters.nbAtoms > 0 && parameters.nbAtoms <= BFR_MAX_SIZE &&
+			parameters.nbSensors > 0 && parameters.nbFocals > 0 && parameters.nbPoints > 0 &&
+			parameters.nbOptions >= 0 && parameters.nbOptions <= MG_MAX_OPTIONS;
+}
+
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+MG_Parameters MG_getDefaultParameters(){
+	MG_Parameters parameters = {1, 8, 16, 16, 16, 1, 4, 42};
+
+	return parameters;
+}
+
+
+
+void MG_getFrameName(char* name, const int frame){
+	sprintf(name, "synthetic%d", frame);
+}
+
+
+
+int MG_writeSensorModels(const char* directory, const MG_Parameters parameters){
+	char path[1024], name[MG_MAX_NAME];
+	struct Sensor s;
+	BFR_Random random;
+	int frame = 0, i = 0, written = 1;
+
+	if(!checkParameters(parameters) || !makeDirectory(directory)){
+		return 0;
+	}
+	for(frame = 0; frame < parameters.nbFrames && written; frame++){
+		MG_getFrameName(name, frame);
+		sprintf(path, "%s%s", directory, name);
+		if(!makeDirectory(path)){
+			return 0;
+		}
+		sprintf(path, "%s%s/values", directory, name);
+		written = writeValues(path, parameters.nbAtoms);
+		random = getFrameRandom(parameters, frame);
+		for(i = 0; i < parameters.nbSensors && written; i++){
+			s = createSensor(&random, parameters, i);
+			sprintf(path, "%s%s/S%d", directory, name, i);
+			written = writeSensorDirectory(path, s, parameters);
+			freeSensor(&s);
+		}
+	}
+
+	return written;
+}
+
+
+
+int MG_writeXmlSensorModels(const char* directory, const MG_Parameters parameters){
+	char path[1024], name[MG_MAX_NAME];
+	struct Sensor s;
+	BFR_Random random;
+	FILE* f = NULL;
+	int frame = 0, i = 0, written = 1;
+
+	if(!checkParameters(parameters) || !makeDirectory(directory)){
+		return 0;
+	}
+	for(frame = 0; frame < parameters.nbFrames && written; frame++){
+		MG_getFrameName(name, frame);
+		sprintf(path, "%s%s.xml", directory, name);
+		f = fopen(path, "w");
+		if(f == NULL){
+			return 0;
+		}
+		fprintf(f, "<belief-from-sensors>\n\n\t<frame name=\"%s\">\n", name);
+		for(i = 0; i < parameters.nbAtoms; i++){
+			fprintf(f, "\t\t<state>w%d</state>\n", i);
+		}
+		fprintf(f, "\t</frame>\n\n\t<sensor-beliefs>\n");
+		random = getFrameRandom(parameters, frame);
+		for(i = 0; i < parameters.nbSensors; i++){
+			s = createSensor(&random, parameters, i);
+			writeSensorXml(f, s, parameters, i);
+			freeSensor(&s);
+		}
+		fprintf(f, "\t</sensor-beliefs>\n\n\t<sensors>\n");
+		for(i = 0; i < parameters.nbSensors; i++){
+			fprintf(f, "\t\t<sensor name=\"S%d\" belief=\"S%dSet\" />\n", i, i);
+		}
+		fprintf(f, "\t</sensors>\n\n</belief-from-sensors>\n");
+		written = fclose(f) == 0;
+	}
+
+	return written;
+}
+
+
+
+int MG_writeBeliefModels(const char* directory, const MG_Parameters parameters){
+	char path[1024], name[MG_MAX_NAME], origin[MG_MAX_NAME];
+	uint64_t* elements = NULL;
+	double* factors = NULL;
+	BFR_Random random;
+	FILE* f = NULL;
+	uint64_t from = 0;
+	int frame = 0, other = 0, j = 0, nbConversions = 0, written = 1;
+
+	if(!checkParameters(parameters) || parameters.nbFrames < 2 || parameters.nbAtoms > MG_MAX_BFB_ATOMS ||
+	   parameters.nbConversions < 1 || !makeDirectory(directory)){
+		return 0;
+	}
+	elements = malloc(sizeof(uint64_t) * parameters.nbConversions);
+	factors = malloc(sizeof(double) * parameters.nbConversions);
+	for(frame = 0; frame < parameters.nbFrames && written; frame++){
+		MG_getFrameName(name, frame);
+		sprintf(path, "%s%s", directory, name);
+		written = makeDirectory(path);
+		sprintf(path, "%s%s/values", directory, name);
+		written = written && writeValues(path, parameters.nbAtoms);
+		random = getFrameRandom(parameters, frame);
+		/*The frame is computed from all the other ones: */
+		for(other = 0; other < parameters.nbFrames && written; other++){
+			if(other == frame){
+				continue;
+			}
+			MG_getFrameName(origin, other);
+			sprintf(path, "%s%s/%s", directory, name, origin);
+			written = makeDirectory(path);
+			sprintf(path, "%s%s/%s/values", directory, name, origin);
+			written = written && writeValues(path, parameters.nbAtoms);
+			/*One file per non-empty subset of the frame of origin: */
+			for(from = 1; from < (UINT64_C(1) << parameters.nbAtoms) && written; from++){
+				sprintf(path, "%s%s/%s/V%lu.txt", directory, name, origin, (unsigned long)from);
+				f = fopen(path, "w");
+				if(f == NULL){
+					written = 0;
+					break;
+				}
+				nbConversions = drawElements(&random, parameters.nbAtoms, parameters.nbConversions, elements);
+				drawMasses(&random, nbConversions, factors);
+				fprintf(f, "%d element%s", countAtoms(from), countAtoms(from) > 1 ? "s" : "");
+				writeAtoms(f, from, parameters.nbAtoms, "\n");
+				fprintf(f, "\n%d conversions", nbConversions);
+				for(j = 0; j < nbConversions; j++){
+					fprintf(f, "\n%d element%s", countAtoms(elements[j]), countAtoms(elements[j]) > 1 ? "s" : "");
+					writeAtoms(f, elements[j], parameters.nbAtoms, "\n");
+					fprintf(f, "\n%.16f", factors[j]);
+				}
+				written = fclose(f) == 0;
+			}
+		}
+	}
+	free(elements);
+	free(factors);
+
+	return written;
+}
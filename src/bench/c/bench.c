@@ -0,0 +1,767 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * bench.c
+ *
+ * Microbenchmarks of the public functions of the library. Each benchmark is run
+ * on random belief functions for frames of 2 to 12 atoms (up to 20 with --max-size 20) and
+ * several numbers of focal elements. A complete run takes several minutes (most of it in
+ * BF_fullChenCombination()), use --filter and --max-size to run a part of it.
+ * The results are written in JSON (in bench.json by default, the debug messages of the
+ * library being printed on the standard output):
+ *
+ * {"benchmarks": [
+ *   {"name": "BF_SmetsCombination", "group": "combination", "size": 8, "focals": 16,
+ *    "iterations": 4096, "ns_per_op": 1520.3, "allocations_per_op": 2.0, "bytes_per_op": 712.0},
+ *   ...
+ * ]}
+ *
+ * The time is measured with the default allocator. The allocations are counted
+ * in a second pass with a counting allocator (see Memory_pushAllocator()): as the pool
+ * of flat belief functions only works with the default allocator, they are the
+ * allocations made without the pool.
+ *
+ * The loading of models is measured on synthetic models written in ./data by ModelGenerator.c
+ * (BENCH_LOAD_* parameters, "size" being the number of atoms and "focals" the number of focal elements per sensor).
+ *
+ * The results can be compared to a baseline written by a previous run (--baseline file): the program fails if
+ * the time or the allocations per operation of a benchmark exceed the ones of the baseline by more than the
+ * tolerance (--tolerance 1.0 fails at twice the time of the baseline). The benchmarks missing from one of
+ * the files are reported but do not fail. The perf tests of ctest (ctest -L perf) compare a short subset to
+ * src/test/resources/perf/baseline.json, refreshed with the target perf_baseline (the baseline depends on
+ * the machine, it should be refreshed on the machine running the tests).
+ *
+ * Usage: bench-thegame [--min-size n] [--max-size n] [--filter name[,name...]] [--min-time seconds] [--output file|-]
+ *                      [--baseline file] [--tolerance ratio]
+ * The models of ./data are used (run it from the build directory, see the target bench).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "BeliefCombinations.h"
+#include "BeliefDecisions.h"
+#include "BeliefMetrics.h"
+#include "BeliefsFromBeliefs.h"
+#include "BeliefsFromRandomness.h"
+#include "BeliefsFromSensors.h"
+#include "Memory.h"
+#include "ModelGenerator.h"
+#ifdef THEGAME_XML
+#include "XmlBeliefFromSensors.h"
+#endif
+
+
+/*
+  +------------+
+  | PARAMETERS |
+  +------------+
+*/
+
+/** The directory of the models of belief from sensors. */
+#define BENCH_BFS_PATH "./data/beliefsFromSensors/"
+/** The random seed, to compare runs. */
+#define BENCH_SEED 42
+/** The default maximum size of frames. */
+#define BENCH_MAX_SIZE 12
+/** The default file of the results. */
+#define BENCH_OUTPUT "bench.json"
+/** The default minimum time measured for each benchmark (in seconds). */
+#define BENCH_MIN_TIME 0.02
+/** The maximum number of iterations when counting allocations. */
+#define BENCH_COUNT_ITERATIONS 16
+/** The number of belief functions given to the functions working on lists. */
+#define BENCH_NB_FUNCTIONS 8
+/** The number of entities of the batched transformations. */
+#define BENCH_NB_ENTITIES 256
+/** The maximum size of frames for which the powerset is generated. */
+#define BENCH_MAX_POWERSET_SIZE 20
+/** The maximum number of results compared to a baseline. */
+#define BENCH_MAX_RECORDS 1024
+/** The maximum length of the names of benchmarks. */
+#define BENCH_MAX_NAME 128
+/** The default relative increase of time and allocations tolerated by the comparison to a baseline. */
+#define BENCH_TOLERANCE 1.0
+
+/** The directory of the synthetic models loaded by the benchmarks (the models of beliefs from beliefs are written in BFB_PATH). */
+#define BENCH_LOAD_PATH "./data/synthetic/"
+/** The synthetic models loaded (synthetic0 in each format): */
+#define BENCH_LOAD_FRAMES 2
+#define BENCH_LOAD_ATOMS 10
+#define BENCH_LOAD_SENSORS 64
+#define BENCH_LOAD_FOCALS 32
+#define BENCH_LOAD_POINTS 32
+#define BENCH_LOAD_OPTIONS 2
+#define BENCH_LOAD_CONVERSIONS 8
+
+/** The numbers of focal elements (capped to the number of non-empty subsets). */
+static const int nbFocalsList[] = {4, 16, 64};
+#define BENCH_NB_FOCALS_LIST 3
+
+/** The benchmark uses the random belief functions (otherwise, it only depends on the size). */
+#define BENCH_FOCALS 1
+/** The benchmark uses the powerset. */
+#define BENCH_POWERSET 2
+/** The benchmark uses the synthetic compiled model (frames up to BFB_MAX_COMPILED_SIZE). */
+#define BENCH_MATRIX 4
+/** The benchmark uses the models of ./data (only run once, on their frames). */
+#define BENCH_MODEL 8
+/** The benchmark loads the synthetic models (only run once). */
+#define BENCH_LOAD 16
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * The data given to the benchmarked operations.
+ */
+struct Bench_Context {
+	int size;
+	int nbFocals;
+	/* Random data: */
+	Sets_Element e1, e2;
+	BF_BeliefFunction m1, m2;
+	BF_BeliefFunction functions[BENCH_NB_FUNCTIONS];
+	Sets_Set powerset;
+	int hasPowerset;
+	BF_MetricsTable table;
+	/* Synthetic compiled model (m(A) -> 0.8 m(A) + 0.2 m(Omega)): */
+	BFB_BeliefFromBelief bfb;
+	int hasModel;
+	float* masses;
+	float* results;
+	/* Models of ./data: */
+	BFS_BeliefStructure bfs;
+	BFB_BeliefStructure sleeping;
+	BF_BeliefFunction posture;
+	/* Results kept so that the operations are not optimized out: */
+	volatile float sink;
+};
+typedef struct Bench_Context Bench_Context;
+
+typedef void (*Bench_Operation)(Bench_Context* c);
+
+/**
+ * A benchmark.
+ */
+struct Bench_Case {
+	const char* name;
+	const char* group;
+	int flags;
+	Bench_Operation operation;
+};
+typedef struct Bench_Case Bench_Case;
+
+/**
+ * The result of a benchmark, kept to be compared to a baseline.
+ */
+struct Bench_Record {
+	char name[BENCH_MAX_NAME];
+	int size;
+	int nbFocals;
+	double nsPerOp;
+	double allocationsPerOp;
+};
+typedef struct Bench_Record Bench_Record;
+
+
+/*
+  +------------+
+  | OPERATIONS |
+  +------------+
+*/
+
+static void freeResult(Bench_Context* c, BF_BeliefFunction result){
+	c->sink = result.nbFocals;
+	BF_freeBeliefFunction(&result);
+}
+
+static void freeElement(Bench_Context* c, Sets_Element result){
+	c->sink = result.card;
+	Sets_freeElement(&result);
+}
+
+static void freeDecision(Bench_Context* c, BF_FocalElement result){
+	c->sink = result.beliefValue;
+	if(result.element.values != NULL){
+		Sets_freeElement(&(result.element));
+	}
+}
+
+/* Sets: */
+static void setsConjunction(Bench_Context* c){ freeElement(c, Sets_conjunction(c->e1, c->e2, c->size)); }
+static void setsDisjunction(Bench_Context* c){ freeElement(c, Sets_disjunction(c->e1, c->e2, c->size)); }
+static void setsOpposite(Bench_Context* c){ freeElement(c, Sets_getOpposite(c->e1, c->size)); }
+static void setsEquals(Bench_Context* c){ c->sink = Sets_equals(c->e1, c->e2, c->size); }
+static void setsIsSubset(Bench_Context* c){ c->sink = Sets_isSubset(c->e1, c->e2, c->size); }
+static void setsNumber(Bench_Context* c){ c->sink = Sets_numberFromElement(c->e1, c->size); }
+
+/* Operations on belief functions: */
+static void bfCopy(Bench_Context* c){ freeResult(c, BF_copyBeliefFunction(c->m1)); }
+static void bfDiscounting(Bench_Context* c){ freeResult(c, BF_discounting(c->m1, 0.1)); }
+static void bfM(Bench_Context* c){ c->sink = BF_m(c->m1, c->e1); }
+static void bfBel(Bench_Context* c){ c->sink = BF_bel(c->m1, c->e1); }
+static void bfPl(Bench_Context* c){ c->sink = BF_pl(c->m1, c->e1); }
+static void bfBetP(Bench_Context* c){ c->sink = BF_betP(c->m1, c->e1); }
+
+/* Combinations: */
+static void combinationDempster(Bench_Context* c){ freeResult(c, BF_DempsterCombination(c->m1, c->m2)); }
+static void combinationSmets(Bench_Context* c){ freeResult(c, BF_SmetsCombination(c->m1, c->m2)); }
+static void combinationYager(Bench_Context* c){ freeResult(c, BF_YagerCombination(c->m1, c->m2)); }
+static void combinationDuboisPrade(Bench_Context* c){ freeResult(c, BF_DuboisPradeCombination(c->m1, c->m2)); }
+static void combinationDiscountedDuboisPrade(Bench_Context* c){ freeResult(c, BF_discountedDuboisPradeCombination(c->m1, 0.1, c->m2)); }
+static void combinationMurphy(Bench_Context* c){ freeResult(c, BF_MurphyCombination(c->m1, c->m2)); }
+static void combinationAverage(Bench_Context* c){ freeResult(c, BF_averageCombination(c->m1, c->m2)); }
+static void combinationChen(Bench_Context* c){ freeResult(c, BF_fullChenCombination(c->functions, BENCH_NB_FUNCTIONS)); }
+static void combinationFullSmets(Bench_Context* c){ freeResult(c, BF_fullSmetsCombination(c->functions, BENCH_NB_FUNCTIONS)); }
+
+/* Distances: */
+static void distanceJousselme(Bench_Context* c){ c->sink = BF_distance(c->m1, c->m2); }
+static void distanceSimilarity(Bench_Context* c){ c->sink = BF_similarity(c->m1, c->m2); }
+static void distanceGlobal(Bench_Context* c){ c->sink = BF_globalDistance(c->m1, c->functions, BENCH_NB_FUNCTIONS); }
+static void distanceSupport(Bench_Context* c){ c->sink = BF_support(c->m1, c->functions, BENCH_NB_FUNCTIONS); }
+
+/* Metrics (all at once, and with the separate functions): */
+static void metricsAll(Bench_Context* c){
+	BF_Metrics metrics = BF_getMetrics(c->m1, c->table, c->functions, BENCH_NB_FUNCTIONS, 2);
+
+	c->sink = metrics.globalDistance;
+	BF_freeMetrics(&metrics);
+}
+static void metricsSeparate(Bench_Context* c){
+	float* autoConflict = BF_autoConflict(c->m1, 2);
+
+	c->sink = BF_specificity(c->m1) + BF_nonSpecificity(c->m1) + BF_discrepancy(c->m1)
+			+ BF_globalDistance(c->m1, c->functions, BENCH_NB_FUNCTIONS) + autoConflict[0];
+	Memory_free(autoConflict);
+}
+
+/* Decisions: */
+static void decisionMaxMass(Bench_Context* c){ freeDecision(c, BF_getMaxMass(c->m1, 0)); }
+static void decisionMaxBel(Bench_Context* c){ freeDecision(c, BF_getMaxBel(c->m1, 1, c->powerset)); }
+static void decisionMaxPl(Bench_Context* c){ freeDecision(c, BF_getMaxPl(c->m1, 1, c->powerset)); }
+static void decisionMaxBetP(Bench_Context* c){ freeDecision(c, BF_getMaxBetP(c->m1, 1, c->powerset)); }
+
+/* Transformations: */
+static void bfbBelieveFromBelief(Bench_Context* c){ freeResult(c, BFB_believeFromBelief(c->bfb, c->m1, c->size)); }
+static void bfbTransformMasses(Bench_Context* c){
+	BFB_transformMasses(c->bfb.matrix, c->masses, c->results, BENCH_NB_ENTITIES, 1);
+	c->sink = c->results[0];
+}
+
+/* Models: */
+static void bfsProjection(Bench_Context* c){
+	freeResult(c, BFS_getProjection(c->bfs.beliefs[0], 300, c->bfs.refList.card));
+}
+static void bfsEvidence(Bench_Context* c){
+	char const *sensorTypes[] = {"S1", "S2"};
+	double sensorMeasures[] = {300.0, 400.0};
+	BF_BeliefFunction* evidence = BFS_getEvidence(c->bfs, sensorTypes, sensorMeasures, 2);
+
+	freeResult(c, evidence[0]);
+	freeResult(c, evidence[1]);
+	Memory_free(evidence);
+}
+static void bfbSleeping(Bench_Context* c){
+	freeResult(c, BFB_believeFromBelief(c->sleeping.beliefs[0], c->posture, c->sleeping.refList.card));
+}
+
+/* Loading: */
+static void loadSensors(Bench_Context* c){
+	BFS_BeliefStructure bs = BFS_loadBeliefStructure(BENCH_LOAD_PATH, "synthetic0");
+
+	c->sink = bs.nbSensors;
+	BFS_freeBeliefStructure(&bs);
+}
+#ifdef THEGAME_XML
+static void loadSensorsFromXml(Bench_Context* c){
+	char path[] = BENCH_LOAD_PATH "synthetic0.xml";
+	BFS_BeliefStructure bs = BFS_loadBeliefStructureFromXml(path);
+
+	c->sink = bs.nbSensors;
+	BFS_freeBeliefStructure(&bs);
+}
+#endif
+static void loadBeliefs(Bench_Context* c){
+	BFB_BeliefStructure bs = BFB_loadBeliefStructure("synthetic0");
+
+	c->sink = bs.nbBeliefs;
+	BFB_freeBeliefStructure(&bs);
+}
+
+
+static const Bench_Case cases[] = {
+	{"Sets_conjunction", "sets", 0, setsConjunction},
+	{"Sets_disjunction", "sets", 0, setsDisjunction},
+	{"Sets_getOpposite", "sets", 0, setsOpposite},
+	{"Sets_equals", "sets", 0, setsEquals},
+	{"Sets_isSubset", "sets", 0, setsIsSubset},
+	{"Sets_numberFromElement", "sets", 0, setsNumber},
+	{"BF_copyBeliefFunction", "functions", BENCH_FOCALS, bfCopy},
+	{"BF_discounting", "functions", BENCH_FOCALS, bfDiscounting},
+	{"BF_m", "functions", BENCH_FOCALS, bfM},
+	{"BF_bel", "functions", BENCH_FOCALS, bfBel},
+	{"BF_pl", "functions", BENCH_FOCALS, bfPl},
+	{"BF_betP", "functions", BENCH_FOCALS, bfBetP},
+	{"BF_DempsterCombination", "combination", BENCH_FOCALS, combinationDempster},
+	{"BF_SmetsCombination", "combination", BENCH_FOCALS, combinationSmets},
+	{"BF_YagerCombination", "combination", BENCH_FOCALS, combinationYager},
+	{"BF_DuboisPradeCombination", "combination", BENCH_FOCALS, combinationDuboisPrade},
+	{"BF_discountedDuboisPradeCombination", "combination", BENCH_FOCALS, combinationDiscountedDuboisPrade},
+	{"BF_MurphyCombination", "combination", BENCH_FOCALS, combinationMurphy},
+	{"BF_averageCombination", "combination", BENCH_FOCALS, combinationAverage},
+	{"BF_fullChenCombination", "combination", BENCH_FOCALS, combinationChen},
+	{"BF_fullSmetsCombination", "combination", BENCH_FOCALS, combinationFullSmets},
+	{"BF_distance", "distance", BENCH_FOCALS, distanceJousselme},
+	{"BF_similarity", "distance", BENCH_FOCALS, distanceSimilarity},
+	{"BF_globalDistance", "distance", BENCH_FOCALS, distanceGlobal},
+	{"BF_support", "distance", BENCH_FOCALS, distanceSupport},
+	{"BF_getMetrics", "metrics", BENCH_FOCALS, metricsAll},
+	{"BF_getMetrics/separate", "metrics", BENCH_FOCALS, metricsSeparate},
+	{"BF_getMaxMass", "decision", BENCH_FOCALS, decisionMaxMass},
+	{"BF_getMaxBel", "decision", BENCH_FOCALS | BENCH_POWERSET, decisionMaxBel},
+	{"BF_getMaxPl", "decision", BENCH_FOCALS | BENCH_POWERSET, decisionMaxPl},
+	{"BF_getMaxBetP", "decision", BENCH_FOCALS | BENCH_POWERSET, decisionMaxBetP},
+	{"BFB_believeFromBelief", "transformation", BENCH_FOCALS | BENCH_MATRIX, bfbBelieveFromBelief},
+	{"BFB_transformMasses", "transformation", BENCH_MATRIX, bfbTransformMasses},
+	{"BFS_getProjection", "model", BENCH_MODEL, bfsProjection},
+	{"BFS_getEvidence", "model", BENCH_MODEL, bfsEvidence},
+	{"BFB_believeFromBelief/Sleeping", "model", BENCH_MODEL, bfbSleeping},
+	{"BFS_loadBeliefStructure", "load", BENCH_LOAD, loadSensors},
+#ifdef THEGAME_XML
+	{"BFS_loadBeliefStructureFromXml", "load", BENCH_LOAD, loadSensorsFromXml},
+#endif
+	{"BFB_loadBeliefStructure", "load", BENCH_LOAD, loadBeliefs}
+};
+#define BENCH_NB_CASES ((int)(sizeof(cases) / sizeof(cases[0])))
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+static unsigned long nbAllocations = 0;
+static unsigned long nbBytes = 0;
+
+static Bench_Record records[BENCH_MAX_RECORDS];
+static int nbRecords = 0;
+
+static void* countingMalloc(size_t size, __attribute__((unused)) void* data){
+	nbAllocations++;
+	nbBytes += size;
+	return malloc(size);
+}
+
+static void* countingRealloc(void* pointer, size_t size, __attribute__((unused)) void* data){
+	nbAllocations++;
+	nbBytes += size;
+	return realloc(pointer, size);
+}
+
+static void countingFree(void* pointer, __attribute__((unused)) void* data){
+	free(pointer);
+}
+
+static double now(){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Measures an operation and writes its JSON record.
+ */
+static void measure(FILE* output, const Bench_Case bench, Bench_Context* c, const double minTime, int* first){
+	Memory_Allocator counting = {countingMalloc, countingRealloc, countingFree, NULL};
+	long iterations = 1, i = 0, countIterations = 0;
+	double start = 0, elapsed = 0;
+
+	/*Warm up (which is enough for slow operations), then double the iterations until the time is long enough: */
+	start = now();
+	bench.operation(c);
+	elapsed = now() - start;
+	while(elapsed < minTime){
+		start = now();
+		for(i = 0; i < iterations; i++){
+			bench.operation(c);
+		}
+		elapsed = now() - start;
+		if(elapsed < minTime){
+			iterations *= 2;
+		}
+	}
+
+	/*Allocations: */
+	countIterations = iterations < BENCH_COUNT_ITERATIONS ? iterations : BENCH_COUNT_ITERATIONS;
+	nbAllocations = 0;
+	nbBytes = 0;
+	Memory_pushAllocator(counting);
+	for(i = 0; i < countIterations; i++){
+		bench.operation(c);
+	}
+	Memory_popAllocator();
+
+	fprintf(output, "%s\n  {\"name\": \"%s\", \"group\": \"%s\", \"size\": %d, \"focals\": %d, \"iterations\": %ld, "
+			"\"ns_per_op\": %.1f, \"allocations_per_op\": %.1f, \"bytes_per_op\": %.1f}",
+			*first ? "" : ",", bench.name, bench.group, c->size, c->nbFocals, iterations,
+			elapsed * 1e9 / iterations, (double)nbAllocations / countIterations, (double)nbBytes / countIterations);
+	fflush(output);
+	*first = 0;
+
+	if(nbRecords < BENCH_MAX_RECORDS){
+		strncpy(records[nbRecords].name, bench.name, BENCH_MAX_NAME - 1);
+		records[nbRecords].name[BENCH_MAX_NAME - 1] = '\0';
+		records[nbRecords].size = c->size;
+		records[nbRecords].nbFocals = c->nbFocals;
+		records[nbRecords].nsPerOp = elapsed * 1e9 / iterations;
+		records[nbRecords].allocationsPerOp = (double)nbAllocations / countIterations;
+		nbRecords++;
+	}
+}
+
+/**
+ * Builds the synthetic model of a frame: m(A) -> 0.8 m(A) + 0.2 m(Omega).
+ */
+static BFB_BeliefFromBelief createSyntheticModel(const int size){
+	BFB_BeliefFromBelief bfb = {NULL, {NULL, 0}, NULL, 0, 0, {0, 0, NULL, NULL, NULL, NULL}};
+	char** names = NULL;
+	char name[16];
+	int i = 0;
+
+	names = malloc(sizeof(char*) * size);
+	for(i = 0; i < size; i++){
+		sprintf(name, "w%d", i);
+		names[i] = malloc(strlen(name) + 1);
+		strcpy(names[i], name);
+	}
+	bfb.frameName = Memory_strdup("Synthetic");
+	bfb.refList = Sets_createRefListFromArray((const char* const*)names, size);
+	bfb.nbVectors = (1 << size) - 1;
+	bfb.vectors = Memory_malloc(sizeof(BFB_BeliefVector) * bfb.nbVectors);
+	for(i = 0; i < bfb.nbVectors; i++){
+		bfb.vectors[i].from = Sets_elementFromNumber(i + 1, size);
+		bfb.vectors[i].nbTos = 2;
+		bfb.vectors[i].to = Memory_malloc(sizeof(Sets_Element) * 2);
+		bfb.vectors[i].factors = Memory_malloc(sizeof(float) * 2);
+		bfb.vectors[i].to[0] = Sets_copyElement(bfb.vectors[i].from, size);
+		bfb.vectors[i].to[1] = Sets_getCompleteElement(size);
+		bfb.vectors[i].factors[0] = 0.8;
+		bfb.vectors[i].factors[1] = 0.2;
+	}
+	bfb.matrix = BFB_compileMatrix(bfb, size);
+
+	for(i = 0; i < size; i++){
+		free(names[i]);
+	}
+	free(names);
+
+	return bfb;
+}
+
+/**
+ * Checks if a benchmark is selected by the filter: a comma-separated list of parts of names.
+ */
+static int selected(const Bench_Case bench, const char* filter){
+	const char* part = filter;
+	size_t length = 0, i = 0;
+
+	if(filter == NULL){
+		return 1;
+	}
+	while(part != NULL){
+		length = strchr(part, ',') != NULL ? (size_t)(strchr(part, ',') - part) : strlen(part);
+		for(i = 0; length > 0 && i + length <= strlen(bench.name); i++){
+			if(strncmp(bench.name + i, part, length) == 0){
+				return 1;
+			}
+		}
+		part = strchr(part, ',') != NULL ? strchr(part, ',') + 1 : NULL;
+	}
+
+	return 0;
+}
+
+static int anySelected(const int flag, const char* filter){
+	int i = 0;
+
+	for(i = 0; i < BENCH_NB_CASES; i++){
+		if((cases[i].flags & flag) && selected(cases[i], filter)){
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Compares the results to a baseline (the JSON of a previous run, one benchmark per line).
+ * @return The number of regressions, -1 if the baseline cannot be read.
+ */
+static int compareToBaseline(const char* fileName, const double tolerance){
+	FILE* f = fopen(fileName, "r");
+	char line[512];
+	char name[BENCH_MAX_NAME];
+	double nsPerOp = 0, allocationsPerOp = 0, bytesPerOp = 0;
+	long iterations = 0;
+	int size = 0, nbFocals = 0, i = 0, nbRegressions = 0, nbCompared = 0;
+	int* found = NULL;
+
+	if(f == NULL){
+		fprintf(stderr, "Cannot open the baseline %s.\n", fileName);
+		return -1;
+	}
+	found = calloc(nbRecords > 0 ? nbRecords : 1, sizeof(int));
+	while(fgets(line, sizeof(line), f) != NULL){
+		if(sscanf(line, " {\"name\": \"%127[^\"]\", \"group\": \"%*[^\"]\", \"size\": %d, \"focals\": %d, \"iterations\": %ld, "
+				"\"ns_per_op\": %lf, \"allocations_per_op\": %lf, \"bytes_per_op\": %lf",
+				name, &size, &nbFocals, &iterations, &nsPerOp, &allocationsPerOp, &bytesPerOp) != 7){
+			continue;
+		}
+		for(i = 0; i < nbRecords; i++){
+			if(strcmp(records[i].name, name) == 0 && records[i].size == size && records[i].nbFocals == nbFocals){
+				break;
+			}
+		}
+		if(i == nbRecords){
+			fprintf(stderr, "Not measured: %s (size %d, focals %d).\n", name, size, nbFocals);
+			continue;
+		}
+		found[i] = 1;
+		nbCompared++;
+		/*Slower or more allocations than tolerated: */
+		if(records[i].nsPerOp > nsPerOp * (1 + tolerance) || records[i].allocationsPerOp > allocationsPerOp * (1 + tolerance)){
+			fprintf(stderr, "REGRESSION %s (size %d, focals %d): %.1f ns -> %.1f ns (x%.2f), %.1f -> %.1f allocations per operation.\n",
+					name, size, nbFocals, nsPerOp, records[i].nsPerOp, records[i].nsPerOp / nsPerOp,
+					allocationsPerOp, records[i].allocationsPerOp);
+			nbRegressions++;
+		}
+		/*Faster than the band, the baseline may be refreshed: */
+		else if(records[i].nsPerOp * (1 + tolerance) < nsPerOp){
+			fprintf(stderr, "Improvement %s (size %d, focals %d): %.1f ns -> %.1f ns (x%.2f).\n",
+					name, size, nbFocals, nsPerOp, records[i].nsPerOp, records[i].nsPerOp / nsPerOp);
+		}
+	}
+	fclose(f);
+	for(i = 0; i < nbRecords; i++){
+		if(!found[i]){
+			fprintf(stderr, "Not in the baseline: %s (size %d, focals %d).\n", records[i].name, records[i].size, records[i].nbFocals);
+		}
+	}
+	free(found);
+	fprintf(stderr, "%d benchmark(s) compared to %s (tolerance %.2f): %d regression(s).\n",
+			nbCompared, fileName, tolerance, nbRegressions);
+
+	return nbRegressions;
+}
+
+
+/*
+  +------+
+  | MAIN |
+  +------+
+*/
+
+int main(int argc, char** argv){
+	Bench_Context c;
+	BFR_Random random;
+	MG_Parameters load = MG_getDefaultParameters();
+	FILE* output = NULL;
+	const char* outputName = BENCH_OUTPUT;
+	const char* filter = NULL;
+	const char* baselineName = NULL;
+	double minTime = BENCH_MIN_TIME, tolerance = BENCH_TOLERANCE;
+	int minSize = 2, maxSize = BENCH_MAX_SIZE, first = 1;
+	int i = 0, j = 0, k = 0, size = 0;
+
+	/*Arguments: */
+	for(i = 1; i < argc - 1; i += 2){
+		if(strcmp(argv[i], "--min-size") == 0){
+			minSize = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--max-size") == 0){
+			maxSize = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--filter") == 0){
+			filter = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--min-time") == 0){
+			minTime = atof(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--output") == 0){
+			outputName = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--baseline") == 0){
+			baselineName = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--tolerance") == 0){
+			tolerance = atof(argv[i + 1]);
+		}
+	}
+	output = strcmp(outputName, "-") == 0 ? stdout : fopen(outputName, "w");
+	if(output == NULL){
+		fprintf(stderr, "Cannot open %s.\n", outputName);
+		return EXIT_FAILURE;
+	}
+	if(minSize < 1){
+		minSize = 1;
+	}
+
+	memset(&c, 0, sizeof(Bench_Context));
+	random = BFR_createRandom(BENCH_SEED);
+	fprintf(output, "{\"benchmarks\": [");
+
+	/*Models of ./data: */
+	if(anySelected(BENCH_MODEL, filter)){
+		c.bfs = BFS_loadBeliefStructure(BENCH_BFS_PATH, "unittest");
+		c.sleeping = BFB_loadBeliefStructure("Sleeping");
+		if(c.bfs.frameName != NULL && c.sleeping.frameName != NULL){
+			c.posture = BFR_getRandomBelief(&random, c.sleeping.beliefs[0].refList.card, 4, 1);
+			for(i = 0; i < BENCH_NB_CASES; i++){
+				if((cases[i].flags & BENCH_MODEL) && selected(cases[i], filter)){
+					c.size = c.bfs.refList.card;
+					c.nbFocals = 0;
+					measure(output, cases[i], &c, minTime, &first);
+				}
+			}
+			BF_freeBeliefFunction(&(c.posture));
+		}
+		else {
+			fprintf(stderr, "The models of ./data are missing, run the benchmarks from the build directory.\n");
+		}
+		if(c.bfs.frameName != NULL){
+			BFS_freeBeliefStructure(&(c.bfs));
+		}
+		if(c.sleeping.frameName != NULL){
+			BFB_freeBeliefStructure(&(c.sleeping));
+		}
+	}
+
+	/*Synthetic models: */
+	if(anySelected(BENCH_LOAD, filter)){
+		load.nbFrames = BENCH_LOAD_FRAMES;
+		load.nbAtoms = BENCH_LOAD_ATOMS;
+		load.nbSensors = BENCH_LOAD_SENSORS;
+		load.nbFocals = BENCH_LOAD_FOCALS;
+		load.nbPoints = BENCH_LOAD_POINTS;
+		load.nbOptions = BENCH_LOAD_OPTIONS;
+		load.nbConversions = BENCH_LOAD_CONVERSIONS;
+		load.seed = BENCH_SEED;
+		if(MG_writeSensorModels(BENCH_LOAD_PATH, load) && MG_writeXmlSensorModels(BENCH_LOAD_PATH, load) &&
+		   MG_writeBeliefModels(BFB_PATH, load)){
+			c.size = load.nbAtoms;
+			c.nbFocals = load.nbFocals;
+			for(i = 0; i < BENCH_NB_CASES; i++){
+				if((cases[i].flags & BENCH_LOAD) && selected(cases[i], filter)){
+					measure(output, cases[i], &c, minTime, &first);
+				}
+			}
+		}
+		else {
+			fprintf(stderr, "Cannot write the synthetic models in ./data, run the benchmarks from the build directory.\n");
+		}
+	}
+
+	/*Sweep on the size of the frame: */
+	for(size = minSize; size <= maxSize; size++){
+		c.size = size;
+		c.e1 = Sets_elementFromNumber(BFR_uniformInteger(&random, 1 << size), size);
+		c.e2 = Sets_elementFromNumber(BFR_uniformInteger(&random, 1 << size), size);
+		c.hasPowerset = size <= BENCH_MAX_POWERSET_SIZE && anySelected(BENCH_POWERSET, filter);
+		if(c.hasPowerset){
+			c.powerset = Sets_generatePowerSet(size);
+		}
+		c.table = BF_createMetricsTable(size);
+		c.hasModel = size <= BFB_MAX_COMPILED_SIZE && anySelected(BENCH_MATRIX, filter);
+		if(c.hasModel){
+			c.bfb = createSyntheticModel(size);
+			c.masses = malloc(sizeof(float) * c.bfb.matrix.nbRows * BENCH_NB_ENTITIES);
+			c.results = malloc(sizeof(float) * c.bfb.matrix.nbColumns * BENCH_NB_ENTITIES);
+			for(i = 0; i < c.bfb.matrix.nbRows * BENCH_NB_ENTITIES; i++){
+				c.masses[i] = BFR_uniform(&random) / c.bfb.matrix.nbRows;
+			}
+		}
+
+		/*Benchmarks only depending on the size: */
+		c.nbFocals = 0;
+		for(i = 0; i < BENCH_NB_CASES; i++){
+			if(!(cases[i].flags & (BENCH_FOCALS | BENCH_MODEL | BENCH_LOAD)) && selected(cases[i], filter) &&
+			   (!(cases[i].flags & BENCH_MATRIX) || c.hasModel)){
+				measure(output, cases[i], &c, minTime, &first);
+			}
+		}
+
+		/*Sweep on the number of focal elements: */
+		for(j = 0; j < BENCH_NB_FOCALS_LIST && anySelected(BENCH_FOCALS, filter); j++){
+			/*Stops once the number of focal elements is capped by the size of the frame: */
+			if(j > 0 && c.nbFocals == (1 << size) - 1){
+				break;
+			}
+			c.nbFocals = nbFocalsList[j] < (1 << size) - 1 ? nbFocalsList[j] : (1 << size) - 1;
+			c.m1 = BFR_getRandomBelief(&random, size, c.nbFocals, 1);
+			c.m2 = BFR_getRandomBelief(&random, size, c.nbFocals, 1);
+			for(k = 0; k < BENCH_NB_FUNCTIONS; k++){
+				c.functions[k] = BFR_getRandomBelief(&random, size, c.nbFocals, 1);
+			}
+			for(i = 0; i < BENCH_NB_CASES; i++){
+				if((cases[i].flags & BENCH_FOCALS) && selected(cases[i], filter) &&
+				   (!(cases[i].flags & BENCH_POWERSET) || c.hasPowerset) &&
+				   (!(cases[i].flags & BENCH_MATRIX) || c.hasModel)){
+					measure(output, cases[i], &c, minTime, &first);
+				}
+			}
+			BF_freeBeliefFunction(&(c.m1));
+			BF_freeBeliefFunction(&(c.m2));
+			for(k = 0; k < BENCH_NB_FUNCTIONS; k++){
+				BF_freeBeliefFunction(&(c.functions[k]));
+			}
+		}
+
+		Sets_freeElement(&(c.e1));
+		Sets_freeElement(&(c.e2));
+		if(c.hasPowerset){
+			Sets_freeSet(&(c.powerset));
+		}
+		BF_freeMetricsTable(&(c.table));
+		if(c.hasModel){
+			BFB_freeBeliefFromBelief(&(c.bfb));
+			free(c.masses);
+			free(c.results);
+		}
+	}
+
+	fprintf(output, "\n]}\n");
+	if(output != stdout){
+		fclose(output);
+	}
+
+	if(baselineName != NULL && compareToBaseline(baselineName, tolerance) != 0){
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
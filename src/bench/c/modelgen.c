@@ -0,0 +1,91 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * modelgen.c
+ *
+ * Writes synthetic models (see ModelGenerator.h) to test the loading of large models:
+ *
+ * Usage: modelgen-thegame [--format sensors|xml|beliefs] [--output directory/] [--frames n] [--atoms n]
+ *                         [--sensors n] [--focals n] [--points n] [--options n] [--conversions n] [--seed n]
+ *
+ * Example: modelgen-thegame --format sensors --output ./data/beliefsFromSensors/ --sensors 200 --atoms 12
+ * writes ./data/beliefsFromSensors/synthetic0, loaded with BFS_loadBeliefStructure("./data/beliefsFromSensors/", "synthetic0").
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ModelGenerator.h"
+
+
+int main(int argc, char** argv){
+	MG_Parameters parameters = MG_getDefaultParameters();
+	const char* format = "sensors";
+	const char* output = "./";
+	int i = 0, written = 0;
+
+	/*Arguments: */
+	for(i = 1; i < argc - 1; i += 2){
+		if(strcmp(argv[i], "--format") == 0){
+			format = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--output") == 0){
+			output = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--frames") == 0){
+			parameters.nbFrames = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--atoms") == 0){
+			parameters.nbAtoms = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--sensors") == 0){
+			parameters.nbSensors = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--focals") == 0){
+			parameters.nbFocals = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--points") == 0){
+			parameters.nbPoints = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--options") == 0){
+			parameters.nbOptions = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--conversions") == 0){
+			parameters.nbConversions = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--seed") == 0){
+			parameters.seed = strtoull(argv[i + 1], NULL, 10);
+		}
+	}
+
+	if(strcmp(format, "sensors") == 0){
+		written = MG_writeSensorModels(output, parameters);
+	}
+	else if(strcmp(format, "xml") == 0){
+		written = MG_writeXmlSensorModels(output, parameters);
+	}
+	else if(strcmp(format, "beliefs") == 0){
+		written = MG_writeBeliefModels(output, parameters);
+	}
+	if(!written){
+		fprintf(stderr, "Cannot write the %s models in %s (check the parameters).\n", format, output);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,495 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * replay.c
+ *
+ * End-to-end benchmark of the complete pipeline: a stream of timestamped sensor measures is
+ * replayed tick by tick and, for each tick:
+ *   1) the evidence is built with BFS_getEvidenceElapsedTime() (the options, temporizations
+ *      included, using the time elapsed since the previous tick of the stream),
+ *   2) the evidence of the sensors is fused with BF_fullCombination() (the conjunctive rule of Smets by
+ *      default, --rule to use another one),
+ *   3) the fused function is transformed with BFB_believeFromBelief() (if there is a model of
+ *      beliefs from beliefs),
+ *   4) the decision is taken with BF_getMaxBetP() (singletons).
+ * The stream is loaded before the replay (no I/O is measured) and the ticks are replayed as fast
+ * as possible: the latency of each tick and of each stage is kept in a histogram (see Trace.h).
+ * The results are written in JSON (in replay.json by default):
+ *
+ * {"replay": {"model": "synthetic0", "transform": "synthetic1", "rule": "smets", "sensors": 8, "ticks": 2000, "seconds": 14.4,
+ *   "ticks_per_second": 138.6, "mean_ns": 7215476.5, "p50_ns": 5767167, "p99_ns": 34603007, "p999_ns": 44040191,
+ *   "max_ns": 67716331, "stages": [{"name": "evidence", "mean_ns": 1109173.2, "p50_ns": ...}, ...]}}
+ *
+ * By default, the stream is synthetic: a seeded random walk of the measures of each sensor of a synthetic
+ * model written in ./data by ModelGenerator.c (REPLAY_* parameters: every sensor has a variation
+ * and a tempo-fusion or tempo-specificity option), a tick every REPLAY_PERIOD seconds on average
+ * (uniform jitter of +/- 50%) and each sensor missing a tick with the probability REPLAY_MISSING.
+ *
+ * A recorded stream can be replayed instead with --trace file, one measure per line:
+ *   time;sensor;measure
+ * with the time in seconds (increasing), the lines of the same time forming a tick. The sensors
+ * missing in a tick are given NO_MEASURE. The model is then given with --model directory frame
+ * (BFS_loadBeliefStructure()) and the model of beliefs from beliefs computing another frame from
+ * it with --transform frame (BFB_loadBeliefStructure(), skipped if not given).
+ *
+ * Usage: replay-thegame [--ticks n] [--sensors n] [--atoms n] [--seed n] [--trace file] [--rule name]
+ *                       [--model directory frame] [--transform frame] [--output file|-]
+ * Example: replay-thegame --model ./data/beliefsFromSensors/ tempoFusion --trace tempoFusion.csv
+ * The models are read and written in ./data (run it from the build directory, see the target replay). The synthetic
+ * models are written over the previous ones, which must be removed when the parameters change (the target replay
+ * removes them, with the synthetic models of beliefs from beliefs of bench-thegame).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "BeliefCombinations.h"
+#include "BeliefDecisions.h"
+#include "BeliefsFromBeliefs.h"
+#include "BeliefsFromRandomness.h"
+#include "BeliefsFromSensors.h"
+#include "Memory.h"
+#include "ModelGenerator.h"
+#include "Trace.h"
+
+
+/*
+  +------------+
+  | PARAMETERS |
+  +------------+
+*/
+
+/** The directory of the synthetic models of the replay (the models of beliefs from beliefs are written in BFB_PATH). */
+#define REPLAY_PATH "./data/replay/"
+/** The default file of the results. */
+#define REPLAY_OUTPUT "replay.json"
+/** The random seed, to compare runs. */
+#define REPLAY_SEED 42
+/** The default number of ticks of the synthetic stream. */
+#define REPLAY_TICKS 2000
+/** The number of ticks replayed before the measures (warm-up). */
+#define REPLAY_WARMUP 100
+/** The average time between two ticks of the synthetic stream (in seconds). */
+#define REPLAY_PERIOD 0.1
+/** The probability of a sensor missing a tick in the synthetic stream. */
+#define REPLAY_MISSING 0.1
+/** The synthetic models (the sensor frame synthetic0, transformed into synthetic1): */
+#define REPLAY_SENSORS 8
+#define REPLAY_ATOMS 8
+#define REPLAY_FOCALS 8
+#define REPLAY_POINTS 16
+#define REPLAY_CONVERSIONS 4
+/** The maximum length of the names of sensors in the recorded streams. */
+#define REPLAY_MAX_NAME 64
+
+/** The stages of a tick. */
+#define REPLAY_EVIDENCE 0
+#define REPLAY_FUSION 1
+#define REPLAY_TRANSFORMATION 2
+#define REPLAY_DECISION 3
+#define REPLAY_NB_STAGES 4
+
+static const char* stageNames[REPLAY_NB_STAGES] = {"evidence", "fusion", "transformation", "decision"};
+
+/** The names of the combination rules (in the order of BF_CombinationRule). */
+#define REPLAY_NB_RULES 7
+static const char* ruleNames[REPLAY_NB_RULES] = {"dempster", "smets", "yager", "duboisprade", "murphy", "chen", "average"};
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * A stream of measures: the measures of all the sensors of the model for each tick
+ * (NO_MEASURE if missing) and the time elapsed since the previous tick.
+ */
+struct Replay_Stream {
+	int nbTicks;
+	int nbSensors;
+	double* measures;
+	float* elapsedTimes;
+};
+typedef struct Replay_Stream Replay_Stream;
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+static uint64_t now(){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+static Replay_Stream createStream(const int nbTicks, const int nbSensors){
+	Replay_Stream stream = {0, 0, NULL, NULL};
+	int i = 0;
+
+	stream.nbTicks = nbTicks;
+	stream.nbSensors = nbSensors;
+	stream.measures = malloc(sizeof(double) * nbTicks * nbSensors);
+	stream.elapsedTimes = malloc(sizeof(float) * nbTicks);
+	for(i = 0; i < nbTicks * nbSensors; i++){
+		stream.measures[i] = NO_MEASURE;
+	}
+
+	return stream;
+}
+
+static void freeStream(Replay_Stream* stream){
+	free(stream->measures);
+	free(stream->elapsedTimes);
+	stream->measures = NULL;
+	stream->elapsedTimes = NULL;
+	stream->nbTicks = 0;
+}
+
+/**
+ * Gets the range of the measures of a sensor (the values of its first part of belief).
+ */
+static void getRange(const BFS_SensorBeliefs sensor, double* min, double* max){
+	BFS_PartOfBelief pob = sensor.beliefOnElements[0];
+
+	*min = pob.points[0].sensorValue;
+	*max = pob.points[pob.nbPts - 1].sensorValue;
+}
+
+/**
+ * Generates a synthetic stream: a random walk of the measures of each sensor, in the range of its model.
+ */
+static Replay_Stream generateStream(BFR_Random* random, const BFS_BeliefStructure bs, const int nbTicks){
+	Replay_Stream stream = createStream(nbTicks, bs.nbSensors);
+	double* current = malloc(sizeof(double) * bs.nbSensors);
+	double min = 0, max = 0;
+	int i = 0, j = 0;
+
+	for(j = 0; j < bs.nbSensors; j++){
+		getRange(bs.beliefs[j], &min, &max);
+		current[j] = min + BFR_uniform(random) * (max - min);
+	}
+	for(i = 0; i < nbTicks; i++){
+		stream.elapsedTimes[i] = REPLAY_PERIOD * (0.5 + BFR_uniform(random));
+		for(j = 0; j < bs.nbSensors; j++){
+			getRange(bs.beliefs[j], &min, &max);
+			/*Steps of up to 5% of the range, staying in the range: */
+			current[j] += (BFR_uniform(random) - 0.5) * 0.1 * (max - min);
+			if(current[j] < min){
+				current[j] = min;
+			}
+			if(current[j] > max){
+				current[j] = max;
+			}
+			if(BFR_uniform(random) >= REPLAY_MISSING){
+				stream.measures[i * bs.nbSensors + j] = current[j];
+			}
+		}
+	}
+	free(current);
+
+	return stream;
+}
+
+/**
+ * Loads a recorded stream (time;sensor;measure per line, see above).
+ */
+static Replay_Stream loadStream(const char* fileName, const BFS_BeliefStructure bs){
+	Replay_Stream stream = {0, 0, NULL, NULL};
+	FILE* f = fopen(fileName, "r");
+	char line[256];
+	char sensor[REPLAY_MAX_NAME];
+	double time = 0, measure = 0, previous = 0;
+	int nbLines = 0, tick = -1, i = 0;
+
+	if(f == NULL){
+		fprintf(stderr, "Cannot open %s.\n", fileName);
+		return stream;
+	}
+	/*At most one tick per line: */
+	while(fgets(line, sizeof(line), f) != NULL){
+		nbLines++;
+	}
+	stream = createStream(nbLines, bs.nbSensors);
+	rewind(f);
+	while(fgets(line, sizeof(line), f) != NULL){
+		if(sscanf(line, "%lf;%63[^;];%lf", &time, sensor, &measure) != 3){
+			continue;
+		}
+		if(tick < 0 || time != previous){
+			tick++;
+			stream.elapsedTimes[tick] = tick > 0 ? time - previous : 0;
+			previous = time;
+		}
+		for(i = 0; i < bs.nbSensors && strcmp(bs.beliefs[i].sensorType, sensor) != 0; i++);
+		if(i < bs.nbSensors){
+			stream.measures[tick * bs.nbSensors + i] = measure;
+		}
+		else {
+			fprintf(stderr, "Unknown sensor %s in %s (ignored).\n", sensor, fileName);
+		}
+	}
+	stream.nbTicks = tick + 1;
+	fclose(f);
+
+	return stream;
+}
+
+/**
+ * Finds the model of beliefs from beliefs computing the frame of the structure from the given frame.
+ * @return The index of the model, -1 if none.
+ */
+static int findBelief(const BFB_BeliefStructure bfbs, const char* frameName){
+	int i = 0;
+
+	for(i = 0; i < bfbs.nbBeliefs; i++){
+		if(strcmp(bfbs.beliefs[i].frameName, frameName) == 0){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void writeHistogram(FILE* output, const THEGAME_Histogram* histogram){
+	fprintf(output, "\"mean_ns\": %.1f, \"p50_ns\": %lu, \"p99_ns\": %lu, \"p999_ns\": %lu, \"max_ns\": %lu",
+			histogram->count > 0 ? histogram->sum / histogram->count : 0,
+			(unsigned long)THEGAME_getPercentile(histogram, 50),
+			(unsigned long)THEGAME_getPercentile(histogram, 99),
+			(unsigned long)THEGAME_getPercentile(histogram, 99.9),
+			(unsigned long)histogram->max);
+}
+
+
+/*
+  +------+
+  | MAIN |
+  +------+
+*/
+
+int main(int argc, char** argv){
+	BFS_BeliefStructure bs = {NULL, {NULL, 0}, {NULL, 0}, {NULL, 0}, NULL, 0};
+	BFB_BeliefStructure bfbs = {NULL, {NULL, 0}, NULL, 0};
+	BF_BeliefFunction* evidence = NULL;
+	BF_BeliefFunction fused = {NULL, 0, 0}, transformed = {NULL, 0, 0};
+	BF_FocalElement decision;
+	Replay_Stream stream = {0, 0, NULL, NULL};
+	THEGAME_Histogram ticks, stages[REPLAY_NB_STAGES];
+	BFR_Random random;
+	MG_Parameters parameters = MG_getDefaultParameters();
+	Sets_Set powerset = {NULL, 0};
+	FILE* output = NULL;
+	const char* outputName = REPLAY_OUTPUT;
+	const char* traceName = NULL;
+	const char* modelDirectory = NULL;
+	const char* modelName = NULL;
+	const char* transformName = NULL;
+	const char** sensorTypes = NULL;
+	uint64_t times[REPLAY_NB_STAGES + 1];
+	uint64_t start = 0, elapsed = 0;
+	BF_CombinationRule rule = SMETS;
+	int nbTicks = REPLAY_TICKS, belief = -1, elementSize = 0;
+	int i = 0, j = 0;
+	volatile float sink = 0;
+
+	/*Arguments: */
+	parameters.nbFrames = 2;
+	parameters.nbSensors = REPLAY_SENSORS;
+	parameters.nbAtoms = REPLAY_ATOMS;
+	parameters.nbFocals = REPLAY_FOCALS;
+	parameters.nbPoints = REPLAY_POINTS;
+	parameters.nbOptions = MG_MAX_OPTIONS;
+	parameters.nbConversions = REPLAY_CONVERSIONS;
+	parameters.seed = REPLAY_SEED;
+	for(i = 1; i < argc - 1; i += 2){
+		if(strcmp(argv[i], "--ticks") == 0){
+			nbTicks = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--sensors") == 0){
+			parameters.nbSensors = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--atoms") == 0){
+			parameters.nbAtoms = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--seed") == 0){
+			parameters.seed = strtoull(argv[i + 1], NULL, 10);
+		}
+		else if(strcmp(argv[i], "--trace") == 0){
+			traceName = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--model") == 0 && i < argc - 2){
+			modelDirectory = argv[i + 1];
+			modelName = argv[i + 2];
+			i++;
+		}
+		else if(strcmp(argv[i], "--rule") == 0){
+			for(j = 0; j < REPLAY_NB_RULES && strcmp(ruleNames[j], argv[i + 1]) != 0; j++);
+			if(j == REPLAY_NB_RULES){
+				fprintf(stderr, "Unknown combination rule %s.\n", argv[i + 1]);
+				return EXIT_FAILURE;
+			}
+			rule = (BF_CombinationRule)j;
+		}
+		else if(strcmp(argv[i], "--transform") == 0){
+			transformName = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--output") == 0){
+			outputName = argv[i + 1];
+		}
+	}
+	if(nbTicks < 1){
+		nbTicks = 1;
+	}
+
+	/*Models: */
+	if(modelName == NULL){
+		if(!MG_writeSensorModels(REPLAY_PATH, parameters) || !MG_writeBeliefModels(BFB_PATH, parameters)){
+			fprintf(stderr, "Cannot write the synthetic models in ./data, run the replay from the build directory.\n");
+			return EXIT_FAILURE;
+		}
+		modelDirectory = REPLAY_PATH;
+		modelName = "synthetic0";
+		transformName = "synthetic1";
+	}
+	bs = BFS_loadBeliefStructure(modelDirectory, modelName);
+	if(bs.frameName == NULL || bs.nbSensors == 0){
+		fprintf(stderr, "Cannot load the model %s of %s.\n", modelName, modelDirectory);
+		return EXIT_FAILURE;
+	}
+	elementSize = bs.refList.card;
+	if(transformName != NULL){
+		bfbs = BFB_loadBeliefStructure(transformName);
+		belief = bfbs.frameName != NULL ? findBelief(bfbs, bs.frameName) : -1;
+		if(belief < 0){
+			fprintf(stderr, "No model computing %s from %s in %s, the transformation is skipped.\n",
+					transformName, bs.frameName, BFB_PATH);
+		}
+		else {
+			elementSize = bfbs.refList.card;
+		}
+	}
+	sensorTypes = malloc(sizeof(char*) * bs.nbSensors);
+	for(j = 0; j < bs.nbSensors; j++){
+		sensorTypes[j] = bs.beliefs[j].sensorType;
+	}
+	powerset = Sets_generatePowerSet(elementSize);
+
+	/*Stream: */
+	random = BFR_createRandom(parameters.seed);
+	if(traceName != NULL){
+		stream = loadStream(traceName, bs);
+	}
+	else {
+		stream = generateStream(&random, bs, nbTicks + REPLAY_WARMUP);
+	}
+
+	/*Replay (the warm-up ticks are not measured): */
+	memset(&ticks, 0, sizeof(THEGAME_Histogram));
+	memset(stages, 0, sizeof(THEGAME_Histogram) * REPLAY_NB_STAGES);
+	start = now();
+	for(i = 0; i < stream.nbTicks; i++){
+		if(i == REPLAY_WARMUP || (traceName != NULL && i == 0)){
+			start = now();
+		}
+		times[0] = now();
+		evidence = BFS_getEvidenceElapsedTime(bs, sensorTypes, stream.measures + i * stream.nbSensors,
+				stream.nbSensors, stream.elapsedTimes[i]);
+		times[1] = now();
+		/*The full combinations need at least two functions: */
+		if(stream.nbSensors > 1){
+			fused = BF_fullCombination(evidence, stream.nbSensors, rule);
+		}
+		else {
+			fused = BF_copyBeliefFunction(evidence[0]);
+		}
+		times[2] = now();
+		if(belief >= 0){
+			transformed = BFB_believeFromBelief(bfbs.beliefs[belief], fused, bfbs.refList.card);
+		}
+		else {
+			transformed = fused;
+		}
+		times[3] = now();
+		decision = BF_getMaxBetP(transformed, 1, powerset);
+		times[4] = now();
+
+		sink = decision.beliefValue;
+		if(decision.element.values != NULL){
+			Sets_freeElement(&(decision.element));
+		}
+		if(belief >= 0){
+			BF_freeBeliefFunction(&transformed);
+		}
+		BF_freeBeliefFunction(&fused);
+		for(j = 0; j < stream.nbSensors; j++){
+			BF_freeBeliefFunction(&(evidence[j]));
+		}
+		Memory_free(evidence);
+
+		/*The recorded streams have no warm-up: */
+		if(i >= REPLAY_WARMUP || traceName != NULL){
+			THEGAME_recordLatency(&ticks, now() - times[0]);
+			for(j = 0; j < REPLAY_NB_STAGES; j++){
+				THEGAME_recordLatency(&(stages[j]), times[j + 1] - times[j]);
+			}
+		}
+	}
+	elapsed = now() - start;
+
+	/*Results: */
+	output = strcmp(outputName, "-") == 0 ? stdout : fopen(outputName, "w");
+	if(output == NULL){
+		fprintf(stderr, "Cannot open %s.\n", outputName);
+	}
+	else {
+		fprintf(output, "{\"replay\": {\"model\": \"%s\", \"transform\": \"%s\", \"rule\": \"%s\", \"sensors\": %d, \"ticks\": %lu, "
+				"\"seconds\": %.3f, \"ticks_per_second\": %.1f, ",
+				bs.frameName, belief >= 0 ? transformName : "", ruleNames[rule], bs.nbSensors, ticks.count,
+				elapsed * 1e-9, elapsed > 0 ? ticks.count / (elapsed * 1e-9) : 0);
+		writeHistogram(output, &ticks);
+		fprintf(output, ", \"stages\": [");
+		for(j = 0; j < REPLAY_NB_STAGES; j++){
+			fprintf(output, "%s\n  {\"name\": \"%s\", ", j > 0 ? "," : "", stageNames[j]);
+			writeHistogram(output, &(stages[j]));
+			fprintf(output, "}");
+		}
+		fprintf(output, "\n]}}\n");
+		if(output != stdout){
+			fclose(output);
+		}
+	}
+
+	(void)sink;
+	freeStream(&stream);
+	Sets_freeSet(&powerset);
+	free(sensorTypes);
+	if(bfbs.frameName != NULL){
+		BFB_freeBeliefStructure(&bfbs);
+	}
+	BFS_freeBeliefStructure(&bs);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DEF_MODELGENERATOR
+#define DEF_MODELGENERATOR
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * This module writes synthetic models of any size, to measure the loading of models at scale
+ * (the models of data/ only have a few sensors on frames of 3 to 5 atoms). The same parameters and seed
+ * always give the same models, in the directory format of BFS_loadBeliefStructure(), in the XML format
+ * of BFS_loadBeliefStructureFromXml() or in the directory format of BFB_loadBeliefStructure().
+ *
+ * The frames are called synthetic0, synthetic1, etc., their atoms w0, w1, etc. and their sensors
+ * S0, S1, etc. The focal elements of each sensor are distinct random subsets, their masses follow a
+ * Dirichlet distribution at each point of the curves. The masses are multiples of 1 / MG_MASS_QUANTUM:
+ * they are written exactly and their sums are exactly 1, so that the models pass the checks of CHECK_MODELS.
+ * @file ModelGenerator.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief BENCHMARKS: Writes synthetic models for load and scale testing.
+ */
+
+
+/**
+ * @def MG_MASS_QUANTUM
+ * The masses and factors written are multiples of 1 / MG_MASS_QUANTUM (a power of 2, exact in float).
+ */
+#define MG_MASS_QUANTUM 65536
+
+/**
+ * @def MG_MAX_OPTIONS
+ * The maximum number of options per sensor (variation, then tempo-fusion or tempo-specificity).
+ */
+#define MG_MAX_OPTIONS 2
+
+/**
+ * @def MG_MAX_BFB_ATOMS
+ * The maximum number of atoms for the models of beliefs from beliefs (one file per subset of the frame of origin).
+ */
+#define MG_MAX_BFB_ATOMS 12
+
+/**
+ * @def MG_MAX_NAME
+ * The maximum length of the names of frames.
+ */
+#define MG_MAX_NAME 32
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * The parameters of the synthetic models.
+ * @struct MG_Parameters
+ */
+struct MG_Parameters {
+	/** The number of frames (each frame has its own model) */
+	int nbFrames;
+	/** The number of atoms of each frame */
+	int nbAtoms;
+	/** The number of sensors of each frame */
+	int nbSensors;
+	/** The number of focal elements of each sensor (capped to the number of non-empty subsets) */
+	int nbFocals;
+	/** The number of points of each curve */
+	int nbPoints;
+	/** The number of options of each sensor (up to MG_MAX_OPTIONS) */
+	int nbOptions;
+	/** The number of conversions of each subset in the models of beliefs from beliefs */
+	int nbConversions;
+	/** The seed of the random generator */
+	uint64_t seed;
+};
+typedef struct MG_Parameters MG_Parameters;
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+/**
+ * Gets the default parameters: 1 frame of 8 atoms, 16 sensors with 16 focal elements, 16 points and 1 option,
+ * 4 conversions per subset.
+ * @return The default parameters.
+ */
+MG_Parameters MG_getDefaultParameters();
+
+/**
+ * Gets the name of a synthetic frame.
+ * @param name The string receiving the name (at least MG_MAX_NAME characters)
+ * @param frame The index of the frame
+ */
+void MG_getFrameName(char* name, const int frame);
+
+/**
+ * Writes the models of beliefs from sensors in the directory format: directory/synthetic0/values,
+ * directory/synthetic0/S0/options, directory/synthetic0/S0/F0.txt, etc. They are loaded with
+ * BFS_loadBeliefStructure(directory, "synthetic0").
+ * @param directory The directory where to write the models (created if needed, ends with '/')
+ * @param parameters The parameters of the models
+ * @return 1 if the models have been written, 0 otherwise.
+ */
+int MG_writeSensorModels(const char* directory, const MG_Parameters parameters);
+
+/**
+ * Writes the same models as MG_writeSensorModels() in the XML format: directory/synthetic0.xml, etc.
+ * They are loaded with BFS_loadBeliefStructureFromXml().
+ * @param directory The directory where to write the models (created if needed, ends with '/')
+ * @param parameters The parameters of the models
+ * @return 1 if the models have been written, 0 otherwise.
+ */
+int MG_writeXmlSensorModels(const char* directory, const MG_Parameters parameters);
+
+/**
+ * Writes the models of beliefs from beliefs: each frame is computed from all the other ones, with
+ * random conversions for each non-empty subset of the frames of origin (directory/synthetic0/values,
+ * directory/synthetic0/synthetic1/values, directory/synthetic0/synthetic1/V1.txt, etc.). With the directory
+ * BFB_PATH, they are loaded with BFB_loadBeliefStructure("synthetic0"). At least two frames are needed.
+ * @param directory The directory where to write the models (created if needed, ends with '/')
+ * @param parameters The parameters of the models (up to MG_MAX_BFB_ATOMS atoms)
+ * @return 1 if the models have been written, 0 otherwise.
+ */
+int MG_writeBeliefModels(const char* directory, const MG_Parameters parameters);
+
+#endif
@@ -0,0 +1,416 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BeliefApproximations.h"
+#include "Checks.h"
+
+/**
+ * This module offers approximations of belief functions with a bounded number of focal elements.
+ *
+ * If you have no idea to what corresponds exactly a function, you should refer to the given references.
+ * @file BeliefApproximations.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief CORE: Gives functions to approximate belief functions.
+ */
+
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * Compares two focal elements by decreasing mass (and increasing cardinality for equal masses).
+ * To be used with qsort().
+ */
+static int compareByDecreasingMass(const void* a, const void* b){
+	const BF_FocalElement* f1 = (const BF_FocalElement*) a;
+	const BF_FocalElement* f2 = (const BF_FocalElement*) b;
+
+	if(f1->beliefValue > f2->beliefValue){
+		return -1;
+	}
+	if(f1->beliefValue < f2->beliefValue){
+		return 1;
+	}
+	return f1->element.card - f2->element.card;
+}
+
+/**
+ * Gives a shallow copy of the focal elements of m sorted by decreasing mass.
+ * Only the array must be freed, the elements still belong to m.
+ */
+static BF_FocalElement* getSortedFocals(const BF_BeliefFunction m){
+	BF_FocalElement* sorted = NULL;
+
+	sorted = Memory_malloc(sizeof(BF_FocalElement) * (m.nbFocals + 1));
+	DEBUG_CHECK_MALLOC(sorted);
+	memcpy(sorted, m.focals, sizeof(BF_FocalElement) * m.nbFocals);
+	qsort(sorted, m.nbFocals, sizeof(BF_FocalElement), compareByDecreasingMass);
+
+	return sorted;
+}
+
+/**
+ * Gives the plausibility of each singleton (the contour function) of m.
+ * The array must be freed after use.
+ */
+static float* getContour(const BF_BeliefFunction m){
+	float* contour = NULL;
+	int i = 0, j = 0;
+
+	contour = Memory_calloc(m.elementSize, sizeof(float));
+	DEBUG_CHECK_MALLOC(contour);
+	for(i = 0; i < m.nbFocals; i++){
+		for(j = 0; j < m.elementSize; j++){
+			if(m.focals[i].element.values[j]){
+				contour[j] += m.focals[i].beliefValue;
+			}
+		}
+	}
+
+	return contour;
+}
+
+/**
+ * Gives the atoms of the frame ordered by decreasing plausibility (lowest index first for ties).
+ * The array must be freed after use.
+ */
+static int* getPlausibilityOrder(const BF_BeliefFunction m){
+	float* contour = NULL;
+	int* order = NULL;
+	int i = 0, j = 0, atom = 0;
+
+	contour = getContour(m);
+	order = Memory_malloc(sizeof(int) * m.elementSize);
+	DEBUG_CHECK_MALLOC(order);
+	/*Insertion sort, frames are small: */
+	for(i = 0; i < m.elementSize; i++){
+		atom = i;
+		for(j = i; j > 0 && contour[order[j - 1]] < contour[atom]; j--){
+			order[j] = order[j - 1];
+		}
+		order[j] = atom;
+	}
+	Memory_free(contour);
+
+	return order;
+}
+
+/**
+ * Builds the consonant belief function whose focal element of index j
+ * is made of the first j atoms in the given order.
+ */
+static BF_BeliefFunction buildConsonant(const float* masses, const int* order, const int elementSize){
+	BF_BeliefFunction consonant = {NULL, 0, 0};
+	int i = 0, j = 0;
+
+	consonant.elementSize = elementSize;
+	consonant.focals = Memory_malloc(sizeof(BF_FocalElement) * (elementSize + 1));
+	DEBUG_CHECK_MALLOC(consonant.focals);
+	for(j = 0; j <= elementSize; j++){
+		if(masses[j] > 0){
+			consonant.focals[consonant.nbFocals].element = Sets_getEmptyElement(elementSize);
+			for(i = 0; i < j; i++){
+				consonant.focals[consonant.nbFocals].element.values[order[i]] = 1;
+			}
+			consonant.focals[consonant.nbFocals].element.card = j;
+			consonant.focals[consonant.nbFocals].beliefValue = masses[j];
+			consonant.nbFocals++;
+		}
+	}
+
+	return consonant;
+}
+
+/**
+ * Builds the Bayesian belief function giving to each singleton its weight normalized by the sum of weights.
+ * If all the weights are null, a copy of m is returned.
+ */
+static BF_BeliefFunction buildBayesian(const BF_BeliefFunction m, const float* weights){
+	BF_BeliefFunction bayesian = {NULL, 0, 0};
+	float total = 0;
+	int i = 0;
+
+	for(i = 0; i < m.elementSize; i++){
+		total += weights[i];
+	}
+	/*Everything on the empty set, nothing to approximate: */
+	if(total <= 0){
+		return BF_copyBeliefFunction(m);
+	}
+
+	bayesian.elementSize = m.elementSize;
+	bayesian.focals = Memory_malloc(sizeof(BF_FocalElement) * m.elementSize);
+	DEBUG_CHECK_MALLOC(bayesian.focals);
+	for(i = 0; i < m.elementSize; i++){
+		if(weights[i] > 0){
+			bayesian.focals[bayesian.nbFocals].element = Sets_getEmptyElement(m.elementSize);
+			bayesian.focals[bayesian.nbFocals].element.values[i] = 1;
+			bayesian.focals[bayesian.nbFocals].element.card = 1;
+			bayesian.focals[bayesian.nbFocals].beliefValue = weights[i] / total;
+			bayesian.nbFocals++;
+		}
+	}
+
+	return bayesian;
+}
+
+/**
+ * Stores the Jousselme distance between m and its approximation if required.
+ */
+static void setError(const BF_BeliefFunction m, const BF_BeliefFunction approximation, float* error){
+	if(error != NULL){
+		*error = BF_distance(m, approximation);
+	}
+}
+
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+
+/**
+ * @name Approximations with a bounded number of focal elements
+ * @{
+ */
+
+BF_BeliefFunction BF_summarize(const BF_BeliefFunction m, const int maxFocals, float* error){
+	BF_BeliefFunction summarized = {NULL, 0, 0};
+	BF_FocalElement* sorted = NULL;
+	Sets_Element merged = {NULL, 0};
+	float mergedMass = 0;
+	int i = 0, j = 0, nbKept = 0;
+
+	/*Nothing to do: */
+	if(maxFocals >= m.nbFocals){
+		if(error != NULL){
+			*error = 0;
+		}
+		return BF_copyBeliefFunction(m);
+	}
+
+	nbKept = (maxFocals > 1) ? maxFocals - 1 : 0;
+	sorted = getSortedFocals(m);
+
+	summarized.elementSize = m.elementSize;
+	summarized.focals = Memory_malloc(sizeof(BF_FocalElement) * (nbKept + 1));
+	DEBUG_CHECK_MALLOC(summarized.focals);
+	/*Keep the biggest masses: */
+	for(i = 0; i < nbKept; i++){
+		summarized.focals[i].element = Sets_copyElement(sorted[i].element, m.elementSize);
+		summarized.focals[i].beliefValue = sorted[i].beliefValue;
+	}
+	summarized.nbFocals = nbKept;
+	/*Merge the others into their union: */
+	merged = Sets_getEmptyElement(m.elementSize);
+	for(i = nbKept; i < m.nbFocals; i++){
+		for(j = 0; j < m.elementSize; j++){
+			if(sorted[i].element.values[j] && !merged.values[j]){
+				merged.values[j] = 1;
+				merged.card++;
+			}
+		}
+		mergedMass += sorted[i].beliefValue;
+	}
+	/*The union may already be a focal element: */
+	for(i = 0; i < nbKept; i++){
+		if(Sets_equals(summarized.focals[i].element, merged, m.elementSize)){
+			summarized.focals[i].beliefValue += mergedMass;
+			break;
+		}
+	}
+	if(i == nbKept){
+		summarized.focals[nbKept].element = merged;
+		summarized.focals[nbKept].beliefValue = mergedMass;
+		summarized.nbFocals++;
+	}
+	else {
+		Sets_freeElement(&merged);
+	}
+	Memory_free(sorted);
+
+	setError(m, summarized, error);
+
+	#ifdef CHECK_SUM
+	if(THEGAME_VALIDATING() && BF_checkSum(summarized)){
+		THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &summarized, "the sum is not equal to 1");
+	}
+	#endif
+
+	return summarized;
+}
+
+
+
+BF_BeliefFunction BF_klxApproximation(const BF_BeliefFunction m, const int k, const int l,
+		const float x, float* error){
+	BF_BeliefFunction approximation = {NULL, 0, 0};
+	BF_FocalElement* sorted = NULL;
+	float keptMass = 0;
+	int i = 0, maxKept = 0;
+
+	/*At least one focal element must remain: */
+	maxKept = (l > 1) ? l : 1;
+	sorted = getSortedFocals(m);
+
+	approximation.elementSize = m.elementSize;
+	approximation.focals = Memory_malloc(sizeof(BF_FocalElement) * (m.nbFocals + 1));
+	DEBUG_CHECK_MALLOC(approximation.focals);
+	for(i = 0; i < m.nbFocals; i++){
+		if(approximation.nbFocals >= maxKept){
+			break;
+		}
+		if(approximation.nbFocals >= k && 1 - keptMass <= x){
+			break;
+		}
+		approximation.focals[approximation.nbFocals].element = Sets_copyElement(sorted[i].element, m.elementSize);
+		approximation.focals[approximation.nbFocals].beliefValue = sorted[i].beliefValue;
+		approximation.nbFocals++;
+		keptMass += sorted[i].beliefValue;
+	}
+	Memory_free(sorted);
+	/*Normalize the kept masses: */
+	if(keptMass > 0){
+		for(i = 0; i < approximation.nbFocals; i++){
+			approximation.focals[i].beliefValue /= keptMass;
+		}
+	}
+
+	setError(m, approximation, error);
+
+	#ifdef CHECK_SUM
+	if(THEGAME_VALIDATING() && BF_checkSum(approximation)){
+		THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &approximation, "the sum is not equal to 1");
+	}
+	#endif
+
+	return approximation;
+}
+
+/** @} */
+
+
+
+/**
+ * @name Consonant and Bayesian approximations
+ * @{
+ */
+
+BF_BeliefFunction BF_outerConsonantApproximation(const BF_BeliefFunction m, float* error){
+	BF_BeliefFunction consonant = {NULL, 0, 0};
+	float* masses = NULL;
+	int* order = NULL;
+	int i = 0, j = 0, last = 0;
+
+	order = getPlausibilityOrder(m);
+	masses = Memory_calloc(m.elementSize + 1, sizeof(float));
+	DEBUG_CHECK_MALLOC(masses);
+	/*Each focal element goes to the smallest nested set containing it: */
+	for(i = 0; i < m.nbFocals; i++){
+		last = 0;
+		for(j = 0; j < m.elementSize; j++){
+			if(m.focals[i].element.values[order[j]]){
+				last = j + 1;
+			}
+		}
+		masses[last] += m.focals[i].beliefValue;
+	}
+	consonant = buildConsonant(masses, order, m.elementSize);
+	Memory_free(masses);
+	Memory_free(order);
+
+	setError(m, consonant, error);
+
+	return consonant;
+}
+
+
+
+BF_BeliefFunction BF_innerConsonantApproximation(const BF_BeliefFunction m, float* error){
+	BF_BeliefFunction consonant = {NULL, 0, 0};
+	float* masses = NULL;
+	int* order = NULL;
+	int i = 0, j = 0;
+
+	order = getPlausibilityOrder(m);
+	masses = Memory_calloc(m.elementSize + 1, sizeof(float));
+	DEBUG_CHECK_MALLOC(masses);
+	/*Each focal element goes to the biggest nested set it contains: */
+	for(i = 0; i < m.nbFocals; i++){
+		j = 0;
+		while(j < m.elementSize && m.focals[i].element.values[order[j]]){
+			j++;
+		}
+		masses[j] += m.focals[i].beliefValue;
+	}
+	consonant = buildConsonant(masses, order, m.elementSize);
+	Memory_free(masses);
+	Memory_free(order);
+
+	setError(m, consonant, error);
+
+	return consonant;
+}
+
+
+
+BF_BeliefFunction BF_bayesianApproximation(const BF_BeliefFunction m, float* error){
+	BF_BeliefFunction bayesian = {NULL, 0, 0};
+	float* contour = NULL;
+
+	contour = getContour(m);
+	bayesian = buildBayesian(m, contour);
+	Memory_free(contour);
+
+	setError(m, bayesian, error);
+
+	return bayesian;
+}
+
+
+
+BF_BeliefFunction BF_pignisticApproximation(const BF_BeliefFunction m, float* error){
+	BF_BeliefFunction bayesian = {NULL, 0, 0};
+	float* proba = NULL;
+	int i = 0, j = 0;
+
+	proba = Memory_calloc(m.elementSize, sizeof(float));
+	DEBUG_CHECK_MALLOC(proba);
+	for(i = 0; i < m.nbFocals; i++){
+		if(m.focals[i].element.card > 0){
+			for(j = 0; j < m.elementSize; j++){
+				if(m.focals[i].element.values[j]){
+					proba[j] += m.focals[i].beliefValue / m.focals[i].element.card;
+				}
+			}
+		}
+	}
+	bayesian = buildBayesian(m, proba);
+	Memory_free(proba);
+
+	setError(m, bayesian, error);
+
+	return bayesian;
+}
+
+/** @} */
@@ -27,6 +27,59 @@
 
 
 #include "BeliefCombinations.h"
+#include "Counters.h"
+#include "Tracing.h"
+#include "Checks.h"
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * Allocates the result of the combination of nbProducts products between focal elements
+ * (see BF_allocateBeliefFunction()). The capacity is the number of products, bounded by
+ * the number of subsets of the frame plus one (the slot in which a product is written before
+ * being merged, even when all the subsets are already focal elements). The function is returned
+ * with no focal element, the free slots being filled with addFocal().
+ */
+static BF_BeliefFunction allocateCombination(const int nbProducts, const int elementSize){
+	BF_BeliefFunction combined = {NULL, 0, 0};
+	int capacity = nbProducts;
+
+	if(elementSize < 30 && capacity > (1 << elementSize) + 1){
+		capacity = (1 << elementSize) + 1;
+	}
+	combined = BF_allocateBeliefFunction(capacity, elementSize);
+	combined.nbFocals = 0;
+	THEGAME_COUNT(nbCombinations);
+	THEGAME_COUNT_N(nbCombinationProducts, nbProducts);
+
+	return combined;
+}
+
+/**
+ * Adds a mass to the element written in the first free slot of a combination being built
+ * (the focal at index nbFocals): the mass goes to the same focal element if already present,
+ * otherwise the slot becomes a new focal element.
+ */
+static void addFocal(BF_BeliefFunction* combined, const float mass){
+	BF_FocalElement* slot = &(combined->focals[combined->nbFocals]);
+	int k = 0;
+
+	for(k = 0; k < combined->nbFocals; k++){
+		if(Sets_equals(combined->focals[k].element, slot->element, combined->elementSize)){
+			combined->focals[k].beliefValue += mass;
+			return;
+		}
+	}
+	slot->beliefValue = mass;
+	combined->nbFocals++;
+}
+
+
 
 
 
@@ -42,14 +95,18 @@ BF_BeliefFunction BF_fullDempsterCombination(const BF_BeliefFunction* m, const i
     int i = 0;
 
     #ifdef CHECK_COMPATIBILITY
-    int size = m[0].elementSize;
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullDempsterCombination(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
     /*Initialization: */
     combined = BF_DempsterCombination(m[0], m[1]);
     for(i = 2; i < nbM; i++){
@@ -59,17 +116,17 @@ BF_BeliefFunction BF_fullDempsterCombination(const BF_BeliefFunction* m, const i
     }
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_fullDempsterCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    /*Check values: */
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_fullDempsterCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -80,23 +137,17 @@ BF_BeliefFunction BF_DempsterCombination(const BF_BeliefFunction m1, const BF_Be
     Sets_Element emptySet;
     int i = 0, voidIndex = -1;
     float voidMass = 0;
-    #if defined(CHECK_VALUES) || defined(CHECK_SUM)
-    char *str;
-    #endif
 
     #ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_DempsterCombination(), the two mass functions aren't defined on the same frame...\n");
+    if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+        THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
     }
     #endif
 
-    /*Get the Smets combination:*/
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
+    /*Get the Smets combination (checked by itself):*/
     combined = BF_SmetsCombination(m1, m2);
-    #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_DempsterCombination(), bad sum from SmetsCombination() !\n");
-    }
-    #endif
     emptySet = Sets_getEmptyElement(m1.elementSize);
     voidMass = BF_m(combined, emptySet);
     /*Normalize with the void mass:*/
@@ -115,39 +166,25 @@ BF_BeliefFunction BF_DempsterCombination(const BF_BeliefFunction m1, const BF_Be
         }
     }
     #ifdef CHECK_VALUES
-    else{
-    	printf("debug: in BF_DempsterCombination(), major conflict, m(void) = 1!\n");
-    	str = BF_beliefFunctionToBitString(m1);
-    	printf("debug: m1\n%s\n", str);
-    	free(str);
-    	str = BF_beliefFunctionToBitString(m2);
-    	printf("debug: m2\n%s\n", str);
-    	free(str);
+    else if(THEGAME_VALIDATING()){
+    	THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, NULL, "major conflict, m(void) = 1");
     }
     #endif
     /*Deallocation:*/
     Sets_freeElement(&emptySet);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_DempsterCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
-        str = BF_beliefFunctionToBitString(m1);
-    	printf("debug: m1\n%s\n", str);
-    	free(str);
-    	str = BF_beliefFunctionToBitString(m2);
-    	printf("debug: m2\n%s\n", str);
-    	free(str);
-    	str = BF_beliefFunctionToBitString(combined);
-    	printf("debug: combined\n%s\n", str);
-    	free(str);
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_DempsterCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -159,14 +196,18 @@ BF_BeliefFunction BF_fullSmetsCombination(const BF_BeliefFunction* m, const int
     int i = 0;
 
     #ifdef CHECK_COMPATIBILITY
-    int size = m[0].elementSize;
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullSmetsCombination(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
     /*Initialization:*/
     combined = BF_SmetsCombination(m[0], m[1]);
     for(i = 2; i<nbM; i++){
@@ -176,16 +217,17 @@ BF_BeliefFunction BF_fullSmetsCombination(const BF_BeliefFunction* m, const int
     }
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_fullSmetsCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_fullSmetsCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -193,106 +235,50 @@ BF_BeliefFunction BF_fullSmetsCombination(const BF_BeliefFunction* m, const int
 
 BF_BeliefFunction BF_SmetsCombination(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     BF_BeliefFunction combined = {NULL, 0, 0};
-    Sets_Element conj = {NULL, 0};
-    int i = 0, j = 0, k = 0, index = -1;
+    Sets_Element* conj = NULL;
+    int i = 0, j = 0, l = 0;
 
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_SmetsCombination(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
+
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
 
-    /*Memory allocation:*/
-    combined.nbFocals = 0;
-    combined.focals = NULL;
-    combined.elementSize = m1.elementSize;
+    /*Memory allocation (pooled, a single block):*/
+    combined = allocateCombination(m1.nbFocals * m2.nbFocals, m1.elementSize);
     /* For all focal elements of both mass functions : */
     for(i = 0; i < m1.nbFocals; i++){
     	for(j = 0; j < m2.nbFocals; j++){
-    		/* Conjunction */
-    		conj = Sets_conjunction(m1.focals[i].element, m2.focals[j].element, combined.elementSize);
-    		index = -1;
-    		/* Check if already in the focals */
-    		for(k = 0; k < combined.nbFocals; k++){
-    			if(Sets_equals(combined.focals[k].element, conj, combined.elementSize)){
-    				index = k;
-    				combined.focals[k].beliefValue += m1.focals[i].beliefValue * m2.focals[j].beliefValue;
-    				break;
-    			}
+    		/* Conjunction, written directly in the next free slot */
+    		conj = &(combined.focals[combined.nbFocals].element);
+    		conj->card = 0;
+    		for(l = 0; l < combined.elementSize; l++){
+    			conj->values[l] = m1.focals[i].element.values[l] && m2.focals[j].element.values[l];
+    			conj->card += conj->values[l];
     		}
-    		/* If not in, add it ! */
-    		if(index == -1){
-    			combined.nbFocals++;
-    			combined.focals = realloc(combined.focals, sizeof(BF_FocalElement) * combined.nbFocals);
-    			DEBUG_CHECK_MALLOC(combined.focals);
-
-    			combined.focals[combined.nbFocals - 1].element = Sets_copyElement(conj, combined.elementSize);
-    			combined.focals[combined.nbFocals - 1].beliefValue = m1.focals[i].beliefValue * m2.focals[j].beliefValue;
-    		}
-    		Sets_freeElement(&conj);
+    		/* Merged with the same focal element or added */
+    		addFocal(&combined, m1.focals[i].beliefValue * m2.focals[j].beliefValue);
     	}
     }
+    THEGAME_COUNT_N(nbCombinedFocals, combined.nbFocals);
+    /*Fewer focals than slots after the merges, the values are packed (and the block shrunk if mostly unused): */
+    BF_shrinkBeliefFunction(&combined);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_SmetsCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
-        printf("debug: First belief function:\n");
-        for(i = 0; i < m1.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < m1.elementSize; j++){
-        		printf("%d", m1.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", m1.focals[i].beliefValue);
-        }
-        printf("debug: Second belief function:\n");
-        for(i = 0; i < m2.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < m2.elementSize; j++){
-        		printf("%d", m2.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", m2.focals[i].beliefValue);
-        }
-        printf("debug: Resulting belief function:\n");
-        for(i = 0; i < combined.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < combined.elementSize; j++){
-        		printf("%d", combined.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", combined.focals[i].beliefValue);
-        }
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
 
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_SmetsCombination(), at least one value is not valid!\n");
-    	printf("debug: First belief function:\n");
-        for(i = 0; i < m1.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < m1.elementSize; j++){
-        		printf("%d", m1.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", m1.focals[i].beliefValue);
-        }
-        printf("debug: Second belief function:\n");
-        for(i = 0; i < m2.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < m2.elementSize; j++){
-        		printf("%d", m2.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", m2.focals[i].beliefValue);
-        }
-        printf("debug: Resulting belief function:\n");
-        for(i = 0; i < combined.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < combined.elementSize; j++){
-        		printf("%d", combined.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", combined.focals[i].beliefValue);
-        }
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -304,14 +290,18 @@ BF_BeliefFunction BF_fullYagerCombination(const BF_BeliefFunction* m, const int
     int i = 0;
 
     #ifdef CHECK_COMPATIBILITY
-    int size = m[0].elementSize;
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullYagerCombination(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
     /*Initialization:*/
     combined = BF_YagerCombination(m[0], m[1]);
     for(i = 2; i<nbM; i++){
@@ -321,16 +311,17 @@ BF_BeliefFunction BF_fullYagerCombination(const BF_BeliefFunction* m, const int
     }
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_fullYagerCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_fullYagerCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -342,20 +333,17 @@ BF_BeliefFunction BF_YagerCombination(const BF_BeliefFunction m1, const BF_Belie
     int i = 0, addComplete = 1, completeIndex = -1, voidIndex = -1;
 
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_YagerCombination(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
+
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
 
     /*Get the complete set:*/
     complete = Sets_getCompleteElement(m1.elementSize);
     /*Get the Smets combination:*/
     smets = BF_SmetsCombination(m1, m2);
-    #ifdef CHECK_SUM
-    if(BF_checkSum(smets)){
-        printf("debug: in BF_YagerCombination(), bad sum from SmetsCombination() !\n");
-    }
-    #endif
     /*Check if the complete set is a focal element:*/
     for(i = 0; i<smets.nbFocals; i++){
         if(smets.focals[i].element.card == m1.elementSize){
@@ -374,7 +362,7 @@ BF_BeliefFunction BF_YagerCombination(const BF_BeliefFunction m1, const BF_Belie
     else {
         combined.nbFocals = smets.nbFocals;
     }
-    combined.focals = malloc(sizeof(BF_FocalElement) * combined.nbFocals);
+    combined.focals = Memory_malloc(sizeof(BF_FocalElement) * combined.nbFocals);
     DEBUG_CHECK_MALLOC(combined.focals);
 
     combined.elementSize = smets.elementSize;
@@ -397,16 +385,17 @@ BF_BeliefFunction BF_YagerCombination(const BF_BeliefFunction m1, const BF_Belie
     BF_freeBeliefFunction(&smets);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_YagerCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_YagerCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -418,14 +407,18 @@ BF_BeliefFunction BF_fullDuboisPradeCombination(const BF_BeliefFunction* m, cons
     int i = 0;
 
     #ifdef CHECK_COMPATIBILITY
-    int size = m[0].elementSize;
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullDuboisPradeCombination(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
     /*Initialization:*/
     combined = BF_DuboisPradeCombination(m[0], m[1]);
     for(i = 2; i<nbM; i++){
@@ -435,16 +428,17 @@ BF_BeliefFunction BF_fullDuboisPradeCombination(const BF_BeliefFunction* m, cons
     }
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_fullDuboisPradeCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_fullDuboisPradeCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -452,62 +446,165 @@ BF_BeliefFunction BF_fullDuboisPradeCombination(const BF_BeliefFunction* m, cons
 
 BF_BeliefFunction BF_DuboisPradeCombination(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     BF_BeliefFunction combined;
-    Sets_Element newFocal;
-    int i = 0, j = 0, k = 0, index = -1;
+    Sets_Element* newFocal = NULL;
+    int i = 0, j = 0, l = 0;
 
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_DuboisPradeCombination(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
+
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
 
-    /*Initialize the belief function:*/
-    combined.nbFocals = 0;
-    combined.focals = NULL;
-    combined.elementSize = m1.elementSize;
+    /*Initialize the belief function (pooled, a single block):*/
+    combined = allocateCombination(m1.nbFocals * m2.nbFocals, m1.elementSize);
     /* For all focal elements of both mass functions : */
     for(i = 0; i < m1.nbFocals; i++){
     	for(j = 0; j < m2.nbFocals; j++){
-    		/* Conjunction */
-    		newFocal = Sets_conjunction(m1.focals[i].element, m2.focals[j].element, combined.elementSize);
-    		/* If empty intersection, then disjunction */
-    		if(newFocal.card == 0){
-    			Sets_freeElement(&newFocal);
-    			newFocal = Sets_disjunction(m1.focals[i].element, m2.focals[j].element, combined.elementSize);
+    		/* Conjunction, written directly in the next free slot */
+    		newFocal = &(combined.focals[combined.nbFocals].element);
+    		newFocal->card = 0;
+    		for(l = 0; l < combined.elementSize; l++){
+    			newFocal->values[l] = m1.focals[i].element.values[l] && m2.focals[j].element.values[l];
+    			newFocal->card += newFocal->values[l];
     		}
-    		index = -1;
-    		/* Check if already in the focals */
-    		for(k = 0; k < combined.nbFocals; k++){
-    			if(Sets_equals(combined.focals[k].element, newFocal, combined.elementSize)){
-    				index = k;
-    				combined.focals[k].beliefValue += m1.focals[i].beliefValue * m2.focals[j].beliefValue;
-    				break;
+    		/* If empty intersection, then disjunction */
+    		if(newFocal->card == 0){
+    			for(l = 0; l < combined.elementSize; l++){
+    				newFocal->values[l] = m1.focals[i].element.values[l] || m2.focals[j].element.values[l];
+    				newFocal->card += newFocal->values[l];
     			}
     		}
-    		/* If not in, add it ! */
-    		if(index == -1){
-    			combined.nbFocals++;
-    			combined.focals = realloc(combined.focals, sizeof(BF_FocalElement) * combined.nbFocals);
-    			DEBUG_CHECK_MALLOC(combined.focals);
-
-    			combined.focals[combined.nbFocals - 1].element = Sets_copyElement(newFocal, combined.elementSize);
-    			combined.focals[combined.nbFocals - 1].beliefValue = m1.focals[i].beliefValue * m2.focals[j].beliefValue;
+    		/* Merged with the same focal element or added */
+    		addFocal(&combined, m1.focals[i].beliefValue * m2.focals[j].beliefValue);
+    	}
+    }
+    THEGAME_COUNT_N(nbCombinedFocals, combined.nbFocals);
+    /*Fewer focals than slots after the merges, the values are packed (and the block shrunk if mostly unused): */
+    BF_shrinkBeliefFunction(&combined);
+
+    #ifdef CHECK_SUM
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
+    }
+    #endif
+    #ifdef CHECK_VALUES
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
+    }
+    #endif
+
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
+    return combined;
+}
+
+
+
+BF_BeliefFunction BF_discountedDuboisPradeCombination(const BF_BeliefFunction m1, const float alpha,
+		const BF_BeliefFunction m2){
+    BF_BeliefFunction combined = {NULL, 0, 0};
+    Sets_Element complete = {NULL, 0};
+    Sets_Element* newFocal = NULL;
+    const Sets_Element* focal1 = NULL;
+    const Sets_Element* focal2 = NULL;
+    int i = 0, j = 0, l = 0;
+    int completeIndex = -1, nbDiscounted = 0;
+    float realAlpha = 0, sum = 0, discountedMass = 0;
+
+	#ifdef CHECK_COMPATIBILITY
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
+
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
+    /*Same bounds as BF_discounting(): */
+    if(alpha >= 1){
+    	realAlpha = 1;
+    }
+    else if(alpha <= 0){
+    	realAlpha = 0;
+    }
+    else {
+    	realAlpha = alpha;
+    }
+
+    /*Find the complete set and the discounted mass it will receive: */
+    for(i = 0; i < m1.nbFocals; i++){
+    	if(m1.focals[i].element.card == m1.elementSize){
+    		completeIndex = i;
+    	}
+    	else {
+    		sum += m1.focals[i].beliefValue * (1 - realAlpha);
+    	}
+    }
+    nbDiscounted = m1.nbFocals;
+    if(completeIndex == -1){
+    	/*The lost belief goes to an extra complete set: */
+    	complete = Sets_getCompleteElement(m1.elementSize);
+    	nbDiscounted++;
+    }
+
+    /*Initialize the belief function (pooled, a single block):*/
+    combined = allocateCombination(nbDiscounted * m2.nbFocals, m1.elementSize);
+
+    for(i = 0; i < nbDiscounted; i++){
+    	/*Discount on the fly: */
+    	if(i == m1.nbFocals){
+    		focal1 = &complete;
+    		discountedMass = realAlpha;
+    	}
+    	else if(i == completeIndex){
+    		focal1 = &(m1.focals[i].element);
+    		discountedMass = 1 - sum;
+    	}
+    	else {
+    		focal1 = &(m1.focals[i].element);
+    		discountedMass = m1.focals[i].beliefValue * (1 - realAlpha);
+    	}
+    	for(j = 0; j < m2.nbFocals; j++){
+    		focal2 = &(m2.focals[j].element);
+    		/* Conjunction, written directly in the next free slot */
+    		newFocal = &(combined.focals[combined.nbFocals].element);
+    		newFocal->card = 0;
+    		for(l = 0; l < combined.elementSize; l++){
+    			newFocal->values[l] = focal1->values[l] && focal2->values[l];
+    			newFocal->card += newFocal->values[l];
+    		}
+    		/* If empty intersection, then disjunction */
+    		if(newFocal->card == 0){
+    			for(l = 0; l < combined.elementSize; l++){
+    				newFocal->values[l] = focal1->values[l] || focal2->values[l];
+    				newFocal->card += newFocal->values[l];
+    			}
     		}
-    		Sets_freeElement(&newFocal);
+    		/* Merged with the same focal element or added */
+    		addFocal(&combined, discountedMass * m2.focals[j].beliefValue);
     	}
     }
+    THEGAME_COUNT_N(nbCombinedFocals, combined.nbFocals);
+    /*Fewer focals than slots after the merges, the values are packed (and the block shrunk if mostly unused): */
+    BF_shrinkBeliefFunction(&combined);
+
+    /*Deallocation: */
+    if(completeIndex == -1){
+    	Sets_freeElement(&complete);
+    }
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_DuboisPradeCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1 (alpha = %f)", alpha);
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_DuboisPradeCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -515,59 +612,43 @@ BF_BeliefFunction BF_DuboisPradeCombination(const BF_BeliefFunction m1, const BF
 
 BF_BeliefFunction BF_fullAverageCombination(const BF_BeliefFunction* m, const int nbM){
     BF_BeliefFunction combined;
-    int i = 0, j = 0, k = 0, index = -1;
-    int size = m[0].elementSize;
+    float* weights = NULL;
+    int i = 0;
 
     #ifdef CHECK_COMPATIBILITY
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullAverageCombination(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
-    /*Initialize the belief function:*/
-    combined.nbFocals = 0;
-    combined.focals = NULL;
-    combined.elementSize = size;
-    /* For all mass functions : */
-    for(k = 0; k < nbM; k++){
-		for(i = 0; i < m[k].nbFocals; i++){
-			index = -1;
-			/* Check if already in the focals */
-			for(j = 0; j < combined.nbFocals; j++){
-				if(Sets_equals(combined.focals[j].element, m[k].focals[i].element, combined.elementSize)){
-					index = j;
-					combined.focals[j].beliefValue += m[k].focals[i].beliefValue;
-					break;
-				}
-			}
-			/* If not in, add it ! */
-			if(index == -1){
-				combined.nbFocals++;
-				combined.focals = realloc(combined.focals, sizeof(BF_FocalElement) * combined.nbFocals);
-				DEBUG_CHECK_MALLOC(combined.focals);
-
-				combined.focals[combined.nbFocals - 1].element = Sets_copyElement(m[k].focals[i].element, combined.elementSize);
-				combined.focals[combined.nbFocals - 1].beliefValue = m[k].focals[i].beliefValue;
-			}
-		}
-	}
-	for(i = 0; i<combined.nbFocals; i++){
-        combined.focals[i].beliefValue /= nbM;
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
+    weights = Memory_malloc(sizeof(float) * nbM);
+    DEBUG_CHECK_MALLOC(weights);
+    for(i = 0; i < nbM; i++){
+    	weights[i] = 1.0 / nbM;
     }
+    /*Merge the focals of all the functions: */
+    combined = BF_weightedSum(m, weights, nbM);
+    Memory_free(weights);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_fullAverageCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_fullAverageCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -575,75 +656,34 @@ BF_BeliefFunction BF_fullAverageCombination(const BF_BeliefFunction* m, const in
 
 BF_BeliefFunction BF_averageCombination(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     BF_BeliefFunction combined;
-    int i = 0, j = 0, index = -1;
+    BF_BeliefFunction functions[2];
+    float weights[2] = {0.5, 0.5};
 
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_averageCombination(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
 
-    /*Initialize the belief function:*/
-    combined.nbFocals = 0;
-    combined.focals = NULL;
-    combined.elementSize = m1.elementSize;
-    /*Do the average:*/
-    for(i = 0; i < m1.nbFocals; i++){
-    	index = -1;
-    	/* Check if already in the focals */
-    	for(j = 0; j < combined.nbFocals; j++){
-    		if(Sets_equals(combined.focals[j].element, m1.focals[i].element, combined.elementSize)){
-    			index = j;
-    			combined.focals[j].beliefValue += m1.focals[i].beliefValue;
-    			break;
-    		}
-    	}
-    	/* If not in, add it ! */
-    	if(index == -1){
-    		combined.nbFocals++;
-    		combined.focals = realloc(combined.focals, sizeof(BF_FocalElement) * combined.nbFocals);
-    		DEBUG_CHECK_MALLOC(combined.focals);
-
-    		combined.focals[combined.nbFocals - 1].element = Sets_copyElement(m1.focals[i].element, combined.elementSize);
-    		combined.focals[combined.nbFocals - 1].beliefValue = m1.focals[i].beliefValue;
-    	}
-    }
-    for(i = 0; i < m2.nbFocals; i++){
-    	index = -1;
-    	/* Check if already in the focals */
-    	for(j = 0; j < combined.nbFocals; j++){
-    		if(Sets_equals(combined.focals[j].element, m2.focals[i].element, combined.elementSize)){
-    			index = j;
-    			combined.focals[j].beliefValue += m2.focals[i].beliefValue;
-    			break;
-    		}
-    	}
-    	/* If not in, add it ! */
-    	if(index == -1){
-    		combined.nbFocals++;
-    		combined.focals = realloc(combined.focals, sizeof(BF_FocalElement) * combined.nbFocals);
-    		DEBUG_CHECK_MALLOC(combined.focals);
-
-    		combined.focals[combined.nbFocals - 1].element = Sets_copyElement(m2.focals[i].element, combined.elementSize);
-    		combined.focals[combined.nbFocals - 1].beliefValue = m2.focals[i].beliefValue;
-    	}
-    }
-    for(i = 0; i<combined.nbFocals; i++){
-        combined.focals[i].beliefValue /= 2;
-    }
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
 
+    /*Do the average:*/
+    functions[0] = m1;
+    functions[1] = m2;
+    combined = BF_weightedSum(functions, weights, 2);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_AverageCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_AverageCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -654,14 +694,18 @@ BF_BeliefFunction BF_fullMurphyCombination(const BF_BeliefFunction* m, const int
     int i = 0;
 
     #ifdef CHECK_COMPATIBILITY
-    int size = m[0].elementSize;
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullMurphyCombination(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
+
     /*Get the average:*/
     combined = BF_fullAverageCombination(m, nbM);
     temp = BF_DempsterCombination(combined, combined);
@@ -675,16 +719,17 @@ BF_BeliefFunction BF_fullMurphyCombination(const BF_BeliefFunction* m, const int
     combined = temp;
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_fullMurphyCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_fullMurphyCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -694,10 +739,12 @@ BF_BeliefFunction BF_MurphyCombination(const BF_BeliefFunction m1, const BF_Beli
     BF_BeliefFunction combined, temp;
 
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_MurphyCombination(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
+
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
 
     /*Get the average:*/
     temp = BF_averageCombination(m1, m2);
@@ -707,16 +754,17 @@ BF_BeliefFunction BF_MurphyCombination(const BF_BeliefFunction m1, const BF_Beli
     BF_freeBeliefFunction(&temp);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_MurphyCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_MurphyCombination(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -724,48 +772,28 @@ BF_BeliefFunction BF_MurphyCombination(const BF_BeliefFunction m1, const BF_Beli
 
 BF_BeliefFunction BF_fullChenCombination(const BF_BeliefFunction* m, const int nbM){
     BF_BeliefFunction combined, temp, temp2;
-    Sets_Set focals = {NULL, 0};
-    int i = 0, j = 0, nbMaxFocals = 0;
+    int i = 0;
     float *supports = NULL, *cred = NULL;
     float supportSum = 0;
-    int size = m[0].elementSize;
 
     #ifdef CHECK_COMPATIBILITY
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_fullChenCombination(), at least one mass function is not compatible with others...\n");
-    	}
-    }
-    #endif
-
-    /*Count the max number of focals:*/
-    for(i = 0; i<nbM; i++){
-        nbMaxFocals += m[i].nbFocals;
-    }
-    /*Initialize set:*/
-    focals.elements = malloc(sizeof(Sets_Element) * nbMaxFocals);
-    DEBUG_CHECK_MALLOC(focals.elements);
-
-    /*Get focals:*/
-    for(i = 0; i<nbM; i++){
-        for(j = 0; j<m[i].nbFocals; j++){
-            if(!Sets_isMember(m[i].focals[j].element, focals, size)){
-                focals.elements[focals.card] = Sets_copyElement(m[i].focals[j].element, size);
-                focals.card++;
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != m[0].elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
             }
         }
     }
-    /*Initialize the belief function:*/
-    combined.nbFocals = focals.card;
-    combined.focals = malloc(sizeof(BF_FocalElement) * combined.nbFocals);
-    DEBUG_CHECK_MALLOC(combined.focals);
+    #endif
+
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_COMBINATION);
 
-    combined.elementSize = size;
     /*Get the credibility for each body of evidence:*/
-    supports = malloc(sizeof(float)*nbM);
+    supports = Memory_malloc(sizeof(float)*nbM);
     DEBUG_CHECK_MALLOC(supports);
 
-    cred = malloc(sizeof(float)*nbM);
+    cred = Memory_malloc(sizeof(float)*nbM);
     DEBUG_CHECK_MALLOC(cred);
 
 
@@ -776,14 +804,8 @@ BF_BeliefFunction BF_fullChenCombination(const BF_BeliefFunction* m, const int n
     for(i = 0; i<nbM; i++){
         cred[i] = supports[i] / supportSum;
     }
-    /*Compute the weighted average:*/
-    for(i = 0; i<combined.nbFocals; i++){
-        combined.focals[i].element = Sets_copyElement(focals.elements[i], size);
-        combined.focals[i].beliefValue = 0;
-        for(j = 0; j<nbM; j++){
-            combined.focals[i].beliefValue += cred[j] * BF_m(m[j], focals.elements[i]);
-        }
-    }
+    /*Compute the weighted average on the union of the focals:*/
+    combined = BF_weightedSum(m, cred, nbM);
     /*nbM-1 Dempster combinations: */
     temp = BF_DempsterCombination(combined, combined);
     for(i = 1; i<nbM-1; i++){
@@ -794,21 +816,21 @@ BF_BeliefFunction BF_fullChenCombination(const BF_BeliefFunction* m, const int n
     BF_freeBeliefFunction(&combined);
     combined = temp;
     /*Deallocation:*/
-    free(supports);
-    free(cred);
-    Sets_freeSet(&focals);
+    Memory_free(supports);
+    Memory_free(cred);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(combined)){
-        printf("debug: in BF_ChenCombination(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(combined)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &combined, "the sum is not equal to 1");
     }
     #endif
-    #ifdef CHECK_SUM
-    if(BF_checkValues(combined)){
-    	printf("debug: in BF_ChenCombination(), at least one value is not valid!\n");
+    #ifdef CHECK_VALUES
+    if(THEGAME_VALIDATING() && BF_checkValues(combined)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &combined, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_COMBINATION);
     return combined;
 }
 
@@ -846,12 +868,12 @@ BF_BeliefFunction BF_combination(const BF_BeliefFunction m1, const BF_BeliefFunc
         case AVERAGE :     return BF_averageCombination(m1, m2);     break;
         case MURPHY :      return BF_MurphyCombination(m1, m2);      break;
         case CHEN :
-            m = malloc(sizeof(BF_BeliefFunction)*2);
+            m = Memory_malloc(sizeof(BF_BeliefFunction)*2);
             DEBUG_CHECK_MALLOC(m);
             m[0] = m1;
             m[1] = m2;
             result = BF_fullChenCombination(m, 2);
-            free(m);
+            Memory_free(m);
             return result;
             break;
         default :
@@ -871,31 +893,93 @@ BF_BeliefFunction BF_combination(const BF_BeliefFunction m1, const BF_BeliefFunc
  */
 
 
+/**
+ * Gives the commonality of every subset of the frame (dense vector of 2^size values, the index
+ * of a subset being given by Sets_numberFromElement()). Computed in double precision as
+ * the Moebius inversion of the empty set sums alternating powers of these values.
+ */
+static double* getCommonalities(const BF_BeliefFunction m){
+    double* q = NULL;
+    int i = 0, bit = 0, index = 0, nbSubsets = 1 << m.elementSize;
+
+    q = Memory_calloc(nbSubsets, sizeof(double));
+    DEBUG_CHECK_MALLOC(q);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, nbSubsets);
+    /*Masses: */
+    for(i = 0; i < m.nbFocals; i++){
+        q[Sets_numberFromElement(m.focals[i].element, m.elementSize)] += m.focals[i].beliefValue;
+    }
+    /*Sum over supersets, one atom at a time: */
+    for(bit = 0; bit < m.elementSize; bit++){
+        for(index = 0; index < nbSubsets; index++){
+            if(!(index & (1 << bit))){
+                q[index] += q[index | (1 << bit)];
+            }
+        }
+    }
+
+    return q;
+}
+
+
+
 float* BF_autoConflict(const BF_BeliefFunction m, const int maxDegree){
     float* voidMasses = NULL;
-    int i = 0;
+    double* q = NULL;
+    double* sums = NULL;
+    double power = 0;
+    int i = 0, index = 0, odd = 0, nbSubsets = 0;
     Sets_Element emptySet;
     BF_BeliefFunction temp, temp2;
 
-    /*Get void: */
-    emptySet = Sets_getEmptyElement(m.elementSize);
-
     /*Allocation: */
-    voidMasses = malloc(sizeof(float) * maxDegree);
+    voidMasses = Memory_malloc(sizeof(float) * maxDegree);
     DEBUG_CHECK_MALLOC(voidMasses);
 
-    /*Initialization: */
-    temp = BF_SmetsCombination(m, m);
-    for(i = 0; i<maxDegree; i++){
-        voidMasses[i] = BF_m(temp, emptySet);
-        temp2 = temp;
-        temp = BF_SmetsCombination(temp, m);
-        BF_freeBeliefFunction(&temp2);
+    if(m.elementSize <= BF_MAX_COMMONALITY_SIZE){
+        sums = Memory_calloc(maxDegree, sizeof(double));
+        DEBUG_CHECK_MALLOC(sums);
+        /*Single commonality transform: */
+        q = getCommonalities(m);
+        nbSubsets = 1 << m.elementSize;
+        for(index = 0; index < nbSubsets; index++){
+            if(q[index] > 0){
+                /*Parity of the cardinal: */
+                odd = 0;
+                for(i = index; i != 0; i &= i - 1){
+                    odd = !odd;
+                }
+                /*Degree i is the combination of i + 2 copies of m: */
+                power = q[index] * q[index];
+                for(i = 0; i < maxDegree; i++){
+                    sums[i] += odd ? -power : power;
+                    power *= q[index];
+                }
+            }
+        }
+        for(i = 0; i < maxDegree; i++){
+            /*Rounding errors may give tiny negative values: */
+            voidMasses[i] = (sums[i] > 0) ? sums[i] : 0;
+        }
+        Memory_free(sums);
+        Memory_free(q);
+    }
+    else {
+        /*Get void: */
+        emptySet = Sets_getEmptyElement(m.elementSize);
+        /*Successive combinations: */
+        temp = BF_SmetsCombination(m, m);
+        for(i = 0; i<maxDegree; i++){
+            voidMasses[i] = BF_m(temp, emptySet);
+            temp2 = temp;
+            temp = BF_SmetsCombination(temp, m);
+            BF_freeBeliefFunction(&temp2);
+        }
+        /*Deallocation: */
+        BF_freeBeliefFunction(&temp);
+        Sets_freeElement(&emptySet);
     }
-
-    /*Deallocation: */
-    BF_freeBeliefFunction(&temp);
-    Sets_freeElement(&emptySet);
 
     return voidMasses;
 }
@@ -17,6 +17,8 @@
 
 
 #include "BeliefDecisions.h"
+#include "Counters.h"
+#include "Tracing.h"
 
 
 /**
@@ -43,7 +45,7 @@ static unsigned int listAppend(BF_FocalElementList *list, const BF_FocalElement
 	if(realSize == list->size) {
 		/* increase allocated memory size */
 		newSize = (list->size + 1)  * 1.25;
-		newArray = realloc(list->elements, sizeof(BF_FocalElement) * newSize);
+		newArray = Memory_realloc(list->elements, sizeof(BF_FocalElement) * newSize);
 		DEBUG_CHECK_MALLOC_OR_RETURN(newArray, realSize);
 
 		list->elements = newArray;
@@ -90,7 +92,9 @@ BF_FocalElement BF_getMax(BF_criterionFunction criterion, const BF_BeliefFunctio
     int i = 0, maxIndex = -1;
     float value = 0;
 
-
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= maxCard ||
         		maxCard == 0)                         &&
@@ -106,6 +110,7 @@ BF_FocalElement BF_getMax(BF_criterionFunction criterion, const BF_BeliefFunctio
         max.element = Sets_copyElement(powerset.elements[maxIndex], beliefFunction.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return max;
 }
 
@@ -115,6 +120,9 @@ BF_FocalElement BF_getMin(BF_criterionFunction criterion, const BF_BeliefFunctio
     int i = 0, minIndex = -1;
     float value = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= maxCard ||
         		maxCard == 0)                         &&
@@ -131,6 +139,7 @@ BF_FocalElement BF_getMin(BF_criterionFunction criterion, const BF_BeliefFunctio
         min.element = Sets_copyElement(powerset.elements[minIndex], beliefFunction.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return min;
 }
 
@@ -145,7 +154,9 @@ BF_FocalElementList BF_getMaxList(BF_criterionFunction criterion, const BF_Belie
 	int i = 0;
 	float value = 0;
 
-
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+	THEGAME_COUNT(nbPowersetScans);
+	THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
 	for(i = 0; i < powerset.card; i++){
 		if((powerset.elements[i].card <= maxCard ||
 				maxCard == 0)                         &&
@@ -165,6 +176,7 @@ BF_FocalElementList BF_getMaxList(BF_criterionFunction criterion, const BF_Belie
 		}
 	}
 
+	THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
 	return list;
 }
 
@@ -177,7 +189,9 @@ BF_FocalElementList BF_getMinList(BF_criterionFunction criterion, const BF_Belie
 	int i = 0;
 	float value = 0;
 
-
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+	THEGAME_COUNT(nbPowersetScans);
+	THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
 	for(i = 0; i < powerset.card; i++){
 		if((powerset.elements[i].card <= maxCard ||
 				maxCard == 0)                         &&
@@ -197,6 +211,7 @@ BF_FocalElementList BF_getMinList(BF_criterionFunction criterion, const BF_Belie
 		}
 	}
 
+	THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
 	return list;
 }
 
@@ -216,7 +231,7 @@ void BF_freeFocalElementList(BF_FocalElementList *list) {
 	for (i = 0; i < list->size; ++i) {
 		Sets_freeElement(&(list->elements[i].element));
 	}
-	free(list->elements);
+	Memory_free(list->elements);
 	list->size = 0;
 }
 
@@ -236,6 +251,7 @@ BF_FocalElement BF_getMaxMass(const BF_BeliefFunction m, const int card){
     BF_FocalElement  max = {{NULL,0}, 0};
     int i = 0, maxIndex = -1;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     for(i = 0; i < m.nbFocals; i++){
         if(m.focals[i].beliefValue > max.beliefValue &&
            (m.focals[i].element.card <= card         ||
@@ -249,6 +265,7 @@ BF_FocalElement BF_getMaxMass(const BF_BeliefFunction m, const int card){
         max.element = Sets_copyElement(m.focals[maxIndex].element, m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return max;
 }
 
@@ -258,6 +275,7 @@ BF_FocalElement  BF_getMinMass(const BF_BeliefFunction m, const int card){
     BF_FocalElement  min = {{NULL,0}, 1};
     int i = 0, minIndex = -1;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     for(i = 0; i < m.nbFocals; i++){
         if(m.focals[i].beliefValue <= min.beliefValue &&
            m.focals[i].beliefValue != 0               &&
@@ -272,6 +290,7 @@ BF_FocalElement  BF_getMinMass(const BF_BeliefFunction m, const int card){
         min.element = Sets_copyElement(m.focals[minIndex].element, m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return min;
 }
 
@@ -282,7 +301,9 @@ BF_FocalElement  BF_getMaxBel(const BF_BeliefFunction m, const int card, const S
     int i = 0, maxIndex = -1;
     float value = 0;
 
-
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -298,6 +319,7 @@ BF_FocalElement  BF_getMaxBel(const BF_BeliefFunction m, const int card, const S
         max.element = Sets_copyElement(powerset.elements[maxIndex], m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return max;
 }
 
@@ -308,6 +330,9 @@ BF_FocalElement  BF_getMinBel(const BF_BeliefFunction m, const int card, const S
     int i = 0, minIndex = -1;
     float value = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -324,6 +349,7 @@ BF_FocalElement  BF_getMinBel(const BF_BeliefFunction m, const int card, const S
         min.element = Sets_copyElement(powerset.elements[minIndex], m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return min;
 }
 
@@ -334,6 +360,9 @@ BF_FocalElement  BF_getMaxPl(const BF_BeliefFunction m, const int card, const Se
     int i = 0, maxIndex = -1;
     float value = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -349,6 +378,7 @@ BF_FocalElement  BF_getMaxPl(const BF_BeliefFunction m, const int card, const Se
         max.element = Sets_copyElement(powerset.elements[maxIndex], m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return max;
 }
 
@@ -359,6 +389,9 @@ BF_FocalElement  BF_getMinPl(const BF_BeliefFunction m, const int card, const Se
     int i = 0, minIndex = -1;
     float value = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -375,6 +408,7 @@ BF_FocalElement  BF_getMinPl(const BF_BeliefFunction m, const int card, const Se
         min.element = Sets_copyElement(powerset.elements[minIndex], m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return min;
 }
 
@@ -385,6 +419,9 @@ BF_FocalElement  BF_getMaxBetP(const BF_BeliefFunction m, const int card, const
     int i = 0, maxIndex = -1;
     float value = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -400,6 +437,7 @@ BF_FocalElement  BF_getMaxBetP(const BF_BeliefFunction m, const int card, const
         max.element = Sets_copyElement(powerset.elements[maxIndex], m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return max;
 }
 
@@ -410,6 +448,9 @@ BF_FocalElement  BF_getMinBetP(const BF_BeliefFunction m, const int card, const
     int i = 0, minIndex = -1;
     float value = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -426,6 +467,7 @@ BF_FocalElement  BF_getMinBetP(const BF_BeliefFunction m, const int card, const
         min.element = Sets_copyElement(powerset.elements[minIndex], m.elementSize);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return min;
 }
 
@@ -582,6 +624,8 @@ int BF_getQuickNbMaxBel(const BF_BeliefFunction m, const int card, const Sets_Se
     int nbMax = 0;
     int i = 0;
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -601,6 +645,8 @@ int BF_getQuickNbMinBel(const BF_BeliefFunction m, const int card, const Sets_Se
     int nbMin = 0;
     int i = 0;
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -620,6 +666,8 @@ int BF_getQuickNbMaxPl(const BF_BeliefFunction m, const int card, const Sets_Set
     int nbMax = 0;
     int i = 0;
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -639,6 +687,8 @@ int BF_getQuickNbMinPl(const BF_BeliefFunction m, const int card, const Sets_Set
     int nbMin = 0;
     int i = 0;
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -658,6 +708,8 @@ int BF_getQuickNbMaxBetP(const BF_BeliefFunction m, const int card, const Sets_S
     int nbMax = 0;
     int i = 0;
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -677,6 +729,8 @@ int BF_getQuickNbMinBetP(const BF_BeliefFunction m, const int card, const Sets_S
     int nbMin = 0;
     int i = 0;
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -696,12 +750,14 @@ BF_FocalElement * BF_getListMaxMass(const BF_BeliefFunction m, const int card){
     BF_FocalElement  *list = NULL;
     BF_FocalElement  max;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     max = BF_getMaxMass(m, card);
     if(max.element.values != NULL){
         list = BF_getQuickListMaxMass(m, card, max.beliefValue);
         BF_freeBeliefPoint(&max);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -711,12 +767,14 @@ BF_FocalElement * BF_getListMinMass(const BF_BeliefFunction m, const int card){
     BF_FocalElement  *list = NULL;
     BF_FocalElement  min;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     min = BF_getMinMass(m, card);
     if(min.element.values != NULL){
         list = BF_getQuickListMinMass(m, card, min.beliefValue);
         BF_freeBeliefPoint(&min);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -726,12 +784,14 @@ BF_FocalElement * BF_getListMaxBel(const BF_BeliefFunction m, const int card, co
     BF_FocalElement  *list = NULL;
     BF_FocalElement  max;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     max = BF_getMaxBel(m, card, powerset);
     if(max.element.values != NULL){
         list = BF_getQuickListMaxBel(m, card, powerset, max.beliefValue);
         BF_freeBeliefPoint(&max);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -741,12 +801,14 @@ BF_FocalElement * BF_getListMinBel(const BF_BeliefFunction m, const int card, co
     BF_FocalElement  *list = NULL;
     BF_FocalElement  min;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     min = BF_getMinBel(m, card, powerset);
     if(min.element.values != NULL){
         list = BF_getQuickListMinBel(m, card, powerset, min.beliefValue);
         BF_freeBeliefPoint(&min);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -756,12 +818,14 @@ BF_FocalElement * BF_getListMaxPl(const BF_BeliefFunction m, const int card, con
     BF_FocalElement  *list = NULL;
     BF_FocalElement  max;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     max = BF_getMaxPl(m, card, powerset);
     if(max.element.values != NULL){
         list = BF_getQuickListMaxPl(m, card, powerset, max.beliefValue);
         BF_freeBeliefPoint(&max);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -771,12 +835,14 @@ BF_FocalElement * BF_getListMinPl(const BF_BeliefFunction m, const int card, con
     BF_FocalElement  *list = NULL;
     BF_FocalElement  min;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     min = BF_getMinPl(m, card, powerset);
     if(min.element.values != NULL){
         list = BF_getQuickListMinPl(m, card, powerset, min.beliefValue);
         BF_freeBeliefPoint(&min);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -786,12 +852,14 @@ BF_FocalElement * BF_getListMaxBetP(const BF_BeliefFunction m, const int card, c
     BF_FocalElement  *list = NULL;
     BF_FocalElement  max;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     max = BF_getMaxBetP(m, card, powerset);
     if(max.element.values != NULL){
         list = BF_getQuickListMaxBetP(m, card, powerset, max.beliefValue);
         BF_freeBeliefPoint(&max);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -801,12 +869,14 @@ BF_FocalElement * BF_getListMinBetP(const BF_BeliefFunction m, const int card, c
     BF_FocalElement  *list = NULL;
     BF_FocalElement  min;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_DECISION);
     min = BF_getMinBetP(m, card, powerset);
     if(min.element.values != NULL){
         list = BF_getQuickListMinBetP(m, card, powerset, min.beliefValue);
         BF_freeBeliefPoint(&min);
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_DECISION);
     return list;
 }
 
@@ -921,7 +991,7 @@ BF_FocalElement * BF_getQuickerListMaxMass(const BF_BeliefFunction m, const int
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement ) * nbMax);
+    list = Memory_malloc(sizeof(BF_FocalElement ) * nbMax);
     DEBUG_CHECK_MALLOC(list);
 
     for(i = 0; i < m.nbFocals; i++){
@@ -945,7 +1015,7 @@ BF_FocalElement * BF_getQuickerListMinMass(const BF_BeliefFunction m, const int
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement) * nbMin);
+    list = Memory_malloc(sizeof(BF_FocalElement) * nbMin);
     DEBUG_CHECK_MALLOC(list);
 
     for(i = 0; i < m.nbFocals; i++){
@@ -969,9 +1039,11 @@ BF_FocalElement * BF_getQuickerListMaxBel(const BF_BeliefFunction m, const int c
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement ) * nbMax);
+    list = Memory_malloc(sizeof(BF_FocalElement ) * nbMax);
     DEBUG_CHECK_MALLOC(list);
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -994,9 +1066,11 @@ BF_FocalElement * BF_getQuickerListMinBel(const BF_BeliefFunction m, const int c
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement ) * nbMin);
+    list = Memory_malloc(sizeof(BF_FocalElement ) * nbMin);
     DEBUG_CHECK_MALLOC(list);
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -1019,9 +1093,11 @@ BF_FocalElement * BF_getQuickerListMaxPl(const BF_BeliefFunction m, const int ca
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement ) * nbMax);
+    list = Memory_malloc(sizeof(BF_FocalElement ) * nbMax);
     DEBUG_CHECK_MALLOC(list);
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -1044,9 +1120,11 @@ BF_FocalElement * BF_getQuickerListMinPl(const BF_BeliefFunction m, const int ca
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement ) * nbMin);
+    list = Memory_malloc(sizeof(BF_FocalElement ) * nbMin);
     DEBUG_CHECK_MALLOC(list);
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -1069,9 +1147,11 @@ BF_FocalElement * BF_getQuickerListMaxBetP(const BF_BeliefFunction m, const int
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement) * nbMax);
+    list = Memory_malloc(sizeof(BF_FocalElement) * nbMax);
     DEBUG_CHECK_MALLOC(list);
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -1094,9 +1174,11 @@ BF_FocalElement * BF_getQuickerListMinBetP(const BF_BeliefFunction m, const int
     int i = 0;
     int index = 0;
 
-    list = malloc(sizeof(BF_FocalElement) * nbMin);
+    list = Memory_malloc(sizeof(BF_FocalElement) * nbMin);
     DEBUG_CHECK_MALLOC(list);
 
+    THEGAME_COUNT(nbPowersetScans);
+    THEGAME_COUNT_N(nbScannedSubsets, powerset.card);
     for(i = 0; i < powerset.card; i++){
         if((powerset.elements[i].card <= card ||
            card == 0)                         &&
@@ -16,6 +16,9 @@
 
 
 #include "BeliefFunctions.h"
+#include <pthread.h>
+#include "Counters.h"
+#include "Checks.h"
 
 /**
  * This module does not enable the building of belief functions but only to manipulate them!
@@ -29,24 +32,604 @@
  */
 
 
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * Swaps two focal elements. The focal elements of a flat function keep their slot of values
+ * (see BF_isFlat()): the contents of the slots are swapped instead of the pointers.
+ */
+static void swapFocals(BF_FocalElement* a, BF_FocalElement* b, const int elementSize, const int flat){
+	BF_FocalElement temp = *a;
+	char value = 0;
+	int i = 0;
+
+	if(flat){
+		for(i = 0; i < elementSize; i++){
+			value = a->element.values[i];
+			a->element.values[i] = b->element.values[i];
+			b->element.values[i] = value;
+		}
+		a->element.card = b->element.card;
+		a->beliefValue = b->beliefValue;
+		b->element.card = temp.element.card;
+		b->beliefValue = temp.beliefValue;
+	}
+	else {
+		*a = *b;
+		*b = temp;
+	}
+}
+
+/**
+ * Moves down the focal element at the given index to restore the heap property (see sortFocals()).
+ */
+static void siftDown(BF_FocalElement* focals, int index, const int nbFocals, const int elementSize, const int flat){
+	int child = 0;
+
+	while((child = 2 * index + 1) < nbFocals){
+		if(child + 1 < nbFocals
+				&& Sets_compare(focals[child].element, focals[child + 1].element, elementSize) < 0){
+			child++;
+		}
+		if(Sets_compare(focals[index].element, focals[child].element, elementSize) >= 0){
+			return;
+		}
+		swapFocals(&(focals[index]), &(focals[child]), elementSize, flat);
+		index = child;
+	}
+}
+
+/**
+ * Sorts focal elements in place following Sets_compare() (heapsort, no allocation).
+ * Flat is 1 if the focal elements are those of a flat function.
+ */
+static void sortFocals(BF_FocalElement* focals, const int nbFocals, const int elementSize, const int flat){
+	int i = 0;
+
+	for(i = nbFocals / 2 - 1; i >= 0; i--){
+		siftDown(focals, i, nbFocals, elementSize, flat);
+	}
+	for(i = nbFocals - 1; i > 0; i--){
+		swapFocals(&(focals[0]), &(focals[i]), elementSize, flat);
+		siftDown(focals, 0, i, elementSize, flat);
+	}
+}
+
+/**
+ * Moves down the source at the given index of a heap of merge cursors (see mergeSortedFocals()).
+ * The heap contains source indices ordered by the current focal element of each source.
+ */
+static void siftDownCursor(int* heap, int index, const int heapSize,
+		const BF_BeliefFunction* m, const int* cursors){
+	int child = 0, temp = 0;
+
+	while((child = 2 * index + 1) < heapSize){
+		if(child + 1 < heapSize
+				&& Sets_compare(m[heap[child + 1]].focals[cursors[heap[child + 1]]].element,
+						m[heap[child]].focals[cursors[heap[child]]].element, m[0].elementSize) < 0){
+			child++;
+		}
+		if(Sets_compare(m[heap[index]].focals[cursors[heap[index]]].element,
+				m[heap[child]].focals[cursors[heap[child]]].element, m[0].elementSize) <= 0){
+			return;
+		}
+		temp = heap[index];
+		heap[index] = heap[child];
+		heap[child] = temp;
+		index = child;
+	}
+}
+
+/**
+ * Gathers the focal elements of several sorted functions in sorted order (k-way merge),
+ * weighting their masses. The elements are NOT copied and still belong to the functions.
+ */
+static void mergeSortedFocals(const BF_BeliefFunction* m, const float* weights, const int nbM,
+		BF_FocalElement* merged){
+	int* heap = NULL;
+	int* cursors = NULL;
+	int i = 0, heapSize = 0, nbMerged = 0, source = 0;
+
+	heap = Memory_malloc(sizeof(int) * nbM);
+	DEBUG_CHECK_MALLOC(heap);
+	cursors = Memory_calloc(nbM, sizeof(int));
+	DEBUG_CHECK_MALLOC(cursors);
+
+	for(i = 0; i < nbM; i++){
+		if(m[i].nbFocals > 0){
+			heap[heapSize] = i;
+			heapSize++;
+		}
+	}
+	for(i = heapSize / 2 - 1; i >= 0; i--){
+		siftDownCursor(heap, i, heapSize, m, cursors);
+	}
+	while(heapSize > 0){
+		source = heap[0];
+		merged[nbMerged] = m[source].focals[cursors[source]];
+		merged[nbMerged].beliefValue *= weights[source];
+		nbMerged++;
+		cursors[source]++;
+		/*Source exhausted, replace it by the last one: */
+		if(cursors[source] == m[source].nbFocals){
+			heapSize--;
+			heap[0] = heap[heapSize];
+		}
+		siftDownCursor(heap, 0, heapSize, m, cursors);
+	}
+
+	Memory_free(heap);
+	Memory_free(cursors);
+}
+
+
+
+/**
+ * The quantities derived from a belief function, all computed when the cache of the function
+ * is enabled (see BF_enableCache()) and only read afterwards. The cache of a flat function is
+ * kept in the header of its block. The dense vectors are indexed by the number of the element
+ * (see Sets_numberFromElement()) and are NULL above BF_MAX_CACHE_SIZE.
+ */
+struct BF_Cache{
+	/** The belief of each element (2^elementSize values) */
+	float* beliefs;
+	/** The plausibility of each element (2^elementSize values) */
+	float* plausibilities;
+	/** The commonality of each element (2^elementSize values) */
+	float* commonalities;
+	/** The pignistic probability of each atom (elementSize values, see BF_pignisticVector()) */
+	float* pignistic;
+	/** The specificity (see BF_specificity()) */
+	float specificity;
+	/** The non-specificity (see BF_nonSpecificity()) */
+	float nonSpecificity;
+	/** The discrepancy (see BF_discrepancy()) */
+	float discrepancy;
+};
+typedef struct BF_Cache BF_Cache;
+
+/**
+ * Header of the blocks of the pool, giving the bucket of the block (-1 if not pooled), its size,
+ * the allocator it comes from (blocks are given back to it and the cache allocated with it, whatever
+ * the current allocator) and the cache of the function stored in the block (NULL if disabled).
+ * The union keeps the focal elements following it correctly aligned.
+ */
+union PoolHeader{
+	struct {
+		int bucket;
+		size_t size;
+		Memory_Allocator allocator;
+		BF_Cache* cache;
+	} info;
+	void* alignPointer;
+	double alignDouble;
+};
+typedef union PoolHeader PoolHeader;
+
+/**
+ * The blocks kept for reuse by a thread, by bucket, with the statistics of the thread
+ * (the bytes kept being stats.retained).
+ */
+struct Pool{
+	PoolHeader* blocks[BF_POOL_NB_BUCKETS][BF_POOL_BUCKET_DEPTH];
+	int nbBlocks[BF_POOL_NB_BUCKETS];
+	BF_PoolStats stats;
+	/** 1 once the pool is registered to be emptied at the exit of the thread */
+	int registered;
+};
+typedef struct Pool Pool;
+
+/** The pool of the current thread. */
+static __thread Pool pool;
+
+/** The key whose destructor empties the pool of an exiting thread. */
+static pthread_key_t poolKey;
+static pthread_once_t poolKeyOnce = PTHREAD_ONCE_INIT;
+static int poolKeyCreated = 0;
+
+/**
+ * Gets a block of at least the given size (header included) from the pool of the thread.
+ * The bucket i holds blocks of BF_POOL_MIN_BLOCK_SIZE * 2^i bytes.
+ */
+static PoolHeader* poolAllocate(const size_t size){
+	PoolHeader* block = NULL;
+	size_t blockSize = BF_POOL_MIN_BLOCK_SIZE;
+	int bucket = 0;
+
+	while(blockSize < size && bucket < BF_POOL_NB_BUCKETS){
+		blockSize <<= 1;
+		bucket++;
+	}
+	/*Blocks of custom allocators (arenas...) are not pooled: */
+	if(bucket == BF_POOL_NB_BUCKETS || !Memory_isDefaultAllocator()){
+		bucket = -1;
+		blockSize = size;
+	}
+
+	if(bucket != -1 && pool.nbBlocks[bucket] > 0){
+		pool.nbBlocks[bucket]--;
+		block = pool.blocks[bucket][pool.nbBlocks[bucket]];
+		pool.stats.retained -= block->info.size;
+		pool.stats.hits++;
+	}
+	else {
+		block = Memory_malloc(blockSize);
+		DEBUG_CHECK_MALLOC(block);
+		block->info.bucket = bucket;
+		block->info.size = blockSize;
+		block->info.allocator = Memory_getAllocator();
+		pool.stats.misses++;
+	}
+	block->info.cache = NULL;
+
+	return block;
+}
+
+/**
+ * Frees a block with the allocator it comes from.
+ */
+static void poolFree(PoolHeader* block){
+	block->info.allocator.freeFunction(block, block->info.allocator.data);
+}
+
+/**
+ * Frees the blocks kept by a pool.
+ */
+static void poolDrain(Pool* p){
+	int i = 0, j = 0;
+
+	for(i = 0; i < BF_POOL_NB_BUCKETS; i++){
+		for(j = 0; j < p->nbBlocks[i]; j++){
+			poolFree(p->blocks[i][j]);
+		}
+		p->nbBlocks[i] = 0;
+	}
+	p->stats.retained = 0;
+}
+
+/**
+ * Destructor of the key, called by an exiting thread with its pool.
+ */
+static void poolDestroy(void* p){
+	poolDrain((Pool*)p);
+}
+
+static void poolCreateKey(){
+	poolKeyCreated = (pthread_key_create(&poolKey, poolDestroy) == 0);
+}
+
+/**
+ * Registers the pool of the thread to be emptied when the thread exits.
+ * @return 1 if registered, 0 if the pool cannot be emptied automatically (the block is then not kept).
+ */
+static int poolRegister(){
+	if(!pool.registered){
+		pthread_once(&poolKeyOnce, poolCreateKey);
+		pool.registered = poolKeyCreated && pthread_setspecific(poolKey, &pool) == 0;
+	}
+	return pool.registered;
+}
+
+/**
+ * Gives a block back to the pool of the thread, or frees it if its bucket or the pool is full.
+ */
+static void poolRelease(PoolHeader* block){
+	int bucket = block->info.bucket;
+
+	if(bucket != -1 && pool.nbBlocks[bucket] < BF_POOL_BUCKET_DEPTH
+			&& pool.stats.retained + block->info.size <= BF_POOL_MAX_BYTES && poolRegister()){
+		pool.blocks[bucket][pool.nbBlocks[bucket]] = block;
+		pool.nbBlocks[bucket]++;
+		pool.stats.recycled++;
+		pool.stats.retained += block->info.size;
+	}
+	else {
+		poolFree(block);
+		pool.stats.freed++;
+	}
+}
+
+/**
+ * Copies an element into the already allocated values of a focal element.
+ */
+static void copyIntoFocal(BF_FocalElement* focal, const Sets_Element e, const int elementSize){
+	memcpy(focal->element.values, e.values, sizeof(char) * elementSize);
+	focal->element.card = e.card;
+}
+
+/**
+ * Gets the header of the block of a flat function.
+ */
+static PoolHeader* getHeader(const BF_BeliefFunction m){
+	return (PoolHeader*)m.focals - 1;
+}
+
+/**
+ * Gets the cache of a function, NULL if disabled or if the function is not flat.
+ */
+static BF_Cache* getCache(const BF_BeliefFunction m){
+	if(!BF_isFlat(m)){
+		return NULL;
+	}
+	return getHeader(m)->info.cache;
+}
+
+/**
+ * Frees the vectors of a cache.
+ */
+static void emptyCache(BF_Cache* cache){
+	Memory_free(cache->beliefs);
+	Memory_free(cache->plausibilities);
+	Memory_free(cache->commonalities);
+	Memory_free(cache->pignistic);
+	memset(cache, 0, sizeof(BF_Cache));
+}
+
+/**
+ * Frees the cache of a block, if any.
+ */
+static void freeCache(PoolHeader* block){
+	if(block->info.cache != NULL){
+		Memory_pushAllocator(block->info.allocator);
+		emptyCache(block->info.cache);
+		Memory_free(block->info.cache);
+		Memory_popAllocator();
+		block->info.cache = NULL;
+	}
+}
+
+/**
+ * Moves the values of a flat function whose number of focals has been lowered right after its focal
+ * elements, so that it is recognized as flat again (see BF_isFlat()). The focal elements of a flat
+ * function keep their slot of values, the first slot being the start of the values.
+ * Without focal element, the block is given back.
+ */
+static void packFlatValues(BF_BeliefFunction* bf){
+	char* values = NULL;
+	int i = 0;
+
+	if(bf->focals == NULL){
+		return;
+	}
+	if(bf->nbFocals == 0){
+		freeCache((PoolHeader*)bf->focals - 1);
+		poolRelease((PoolHeader*)bf->focals - 1);
+		bf->focals = NULL;
+		return;
+	}
+	values = (char*)(bf->focals + bf->nbFocals);
+	memmove(values, bf->focals[0].element.values, sizeof(char) * bf->nbFocals * bf->elementSize);
+	for(i = 0; i < bf->nbFocals; i++){
+		bf->focals[i].element.values = values + i * bf->elementSize;
+	}
+}
+
+/**
+ * Keeps the focal element at index read of a function at index write (write <= read), the focal
+ * elements being compacted. A flat function keeps its slots of values, the contents are copied.
+ */
+static void keepFocal(BF_BeliefFunction* bf, const int read, const int write, const int flat){
+	if(read == write){
+		return;
+	}
+	if(flat){
+		copyIntoFocal(&(bf->focals[write]), bf->focals[read].element, bf->elementSize);
+		bf->focals[write].beliefValue = bf->focals[read].beliefValue;
+	}
+	else {
+		bf->focals[write] = bf->focals[read];
+	}
+}
+
+/**
+ * Frees the element of a focal element of a function, unless it lives in the block of a flat function.
+ */
+static void freeFocal(BF_BeliefFunction* bf, const int index, const int flat){
+	if(!flat){
+		BF_freeBeliefPoint(&(bf->focals[index]));
+	}
+}
+
+/**
+ * Sorts the focal elements of a function and merges the duplicated ones in place (the masses are summed).
+ */
+static void sortAndMergeFocals(BF_BeliefFunction* bf){
+	int read = 0, write = 0;
+	int flat = BF_isFlat(*bf);
+
+	sortFocals(bf->focals, bf->nbFocals, bf->elementSize, flat);
+	for(read = 0; read < bf->nbFocals; read++){
+		if(write > 0 && Sets_equals(bf->focals[write - 1].element, bf->focals[read].element, bf->elementSize)){
+			bf->focals[write - 1].beliefValue += bf->focals[read].beliefValue;
+			freeFocal(bf, read, flat);
+		}
+		else {
+			keepFocal(bf, read, write, flat);
+			write++;
+		}
+	}
+	bf->nbFocals = write;
+	if(flat){
+		packFlatValues(bf);
+	}
+}
+
+/**
+ * Fills the dense belief, plausibility and commonality vectors of the cache of a function.
+ * The three vectors share the dense mass vector: beliefs are sums on subsets, commonalities
+ * sums on supersets and pl(A) = bel(Omega) - bel(not A).
+ */
+static void fillCacheVectors(const BF_BeliefFunction m, BF_Cache* cache){
+	double* subsets = NULL, *supersets = NULL;
+	double belComplete = 0;
+	int size = 1 << m.elementSize, complete = size - 1;
+	int i = 0, bit = 0, index = 0;
+
+	subsets = Memory_calloc(size, sizeof(double));
+	DEBUG_CHECK_MALLOC(subsets);
+	supersets = Memory_calloc(size, sizeof(double));
+	DEBUG_CHECK_MALLOC(supersets);
+	cache->beliefs = Memory_malloc(sizeof(float) * size);
+	DEBUG_CHECK_MALLOC(cache->beliefs);
+	cache->plausibilities = Memory_malloc(sizeof(float) * size);
+	DEBUG_CHECK_MALLOC(cache->plausibilities);
+	cache->commonalities = Memory_malloc(sizeof(float) * size);
+	DEBUG_CHECK_MALLOC(cache->commonalities);
+	THEGAME_COUNT(nbPowersetScans);
+	THEGAME_COUNT_N(nbScannedSubsets, size);
+
+	/*Dense mass vector (the void set does not count in beliefs): */
+	for(i = 0; i < m.nbFocals; i++){
+		index = Sets_numberFromElement(m.focals[i].element, m.elementSize);
+		supersets[index] += m.focals[i].beliefValue;
+		if(index != 0){
+			subsets[index] += m.focals[i].beliefValue;
+		}
+	}
+	/*Sums on subsets and supersets, one atom at a time: */
+	for(bit = 1; bit < size; bit <<= 1){
+		for(i = 0; i < size; i++){
+			if(i & bit){
+				subsets[i] += subsets[i ^ bit];
+			}
+			else {
+				supersets[i] += supersets[i | bit];
+			}
+		}
+	}
+	belComplete = subsets[complete];
+	for(i = 0; i < size; i++){
+		cache->beliefs[i] = subsets[i];
+		cache->plausibilities[i] = belComplete - subsets[complete ^ i];
+		cache->commonalities[i] = supersets[i];
+	}
+
+	Memory_free(subsets);
+	Memory_free(supersets);
+}
+
+/**
+ * Computes the discrepancy of a function from its pignistic vector (see BF_discrepancy()).
+ */
+static float discrepancyFromVector(const BF_BeliefFunction m, const float* pignistic){
+	float disc = 0;
+	int i = 0;
+
+	/*The pignistic probability of each focal is a sum over its atoms: */
+	for(i = 0; i < m.nbFocals; i++){
+		disc -= m.focals[i].beliefValue * log(BF_betPFromVector(pignistic, m.focals[i].element, m.elementSize)) / log(2);
+	}
+
+	return disc;
+}
+
+/**
+ * Computes all the quantities of the cache of a flat function. The cache must not be attached
+ * to the block yet, the measures being computed from the focal elements.
+ */
+static void fillCache(const BF_BeliefFunction m, BF_Cache* cache){
+	if(m.elementSize <= BF_MAX_CACHE_SIZE){
+		fillCacheVectors(m, cache);
+	}
+	cache->pignistic = BF_pignisticVector(m);
+	cache->specificity = BF_specificity(m);
+	cache->nonSpecificity = BF_nonSpecificity(m);
+	cache->discrepancy = discrepancyFromVector(m, cache->pignistic);
+}
+
+
+
 /**
  * @name Utility functions
  * @{
  */
 
+BF_BeliefFunction BF_allocateBeliefFunction(const int nbFocals, const int elementSize){
+	BF_BeliefFunction flat = {NULL, 0, 0};
+	char* values = NULL;
+	int i = 0;
+
+	flat.elementSize = elementSize;
+	if(nbFocals <= 0){
+		return flat;
+	}
+	flat.focals = (BF_FocalElement*)(poolAllocate(sizeof(PoolHeader) + sizeof(BF_FocalElement) * nbFocals
+			+ sizeof(char) * nbFocals * elementSize) + 1);
+	flat.nbFocals = nbFocals;
+
+	values = (char*)(flat.focals + nbFocals);
+	for(i = 0; i < nbFocals; i++){
+		flat.focals[i].element.values = values + i * elementSize;
+		flat.focals[i].element.card = 0;
+		flat.focals[i].beliefValue = 0;
+	}
+
+	return flat;
+}
+
+
+
+int BF_isFlat(const BF_BeliefFunction m){
+	return m.nbFocals > 0 && m.focals != NULL && m.focals[0].element.values == (char*)(m.focals + m.nbFocals);
+}
+
+
+
+void BF_shrinkBeliefFunction(BF_BeliefFunction* m){
+	BF_BeliefFunction shrunk = {NULL, 0, 0};
+	PoolHeader* block = NULL;
+	size_t needed = 0;
+
+	packFlatValues(m);
+	if(m->focals == NULL){
+		return;
+	}
+	block = getHeader(*m);
+	needed = sizeof(PoolHeader) + (sizeof(BF_FocalElement) + sizeof(char) * m->elementSize) * m->nbFocals;
+	if(needed * 2 > block->info.size){
+		return;
+	}
+	/*The new block comes from the allocator of the old one, as its cache: */
+	Memory_pushAllocator(block->info.allocator);
+	shrunk = BF_copyBeliefFunction(*m);
+	Memory_popAllocator();
+	getHeader(shrunk)->info.cache = block->info.cache;
+	block->info.cache = NULL;
+	poolRelease(block);
+	*m = shrunk;
+}
+
+
+
+BF_PoolStats BF_getPoolStats(){
+	return pool.stats;
+}
+
+
+
+void BF_resetPoolStats(){
+	pool.stats.hits = 0;
+	pool.stats.misses = 0;
+	pool.stats.recycled = 0;
+	pool.stats.freed = 0;
+}
+
+
+
 BF_BeliefFunction BF_copyBeliefFunction(const BF_BeliefFunction m){
     BF_BeliefFunction copy;
     int i = 0;
 
-    /*Memory alocation:*/
-    copy.nbFocals = m.nbFocals;
-    copy.focals = malloc(sizeof(BF_FocalElement ) * copy.nbFocals);
-    DEBUG_CHECK_MALLOC(copy.focals);
+    /*Memory alocation, a single block: */
+    copy = BF_allocateBeliefFunction(m.nbFocals, m.elementSize);
 
-    copy.elementSize = m.elementSize;
     /*Copy: */
     for(i = 0; i < copy.nbFocals; i++){
-        copy.focals[i].element = Sets_copyElement(m.focals[i].element, m.elementSize);
+        copyIntoFocal(&(copy.focals[i]), m.focals[i].element, m.elementSize);
         copy.focals[i].beliefValue = m.focals[i].beliefValue;
     }
 
@@ -58,13 +641,9 @@ BF_BeliefFunction BF_copyBeliefFunction(const BF_BeliefFunction m){
 BF_BeliefFunction BF_getVacuousBeliefFunction(const int elementSize){
 	BF_BeliefFunction vacuous = {NULL, 0, 0};
 	
-	vacuous.nbFocals = 1;
-	vacuous.focals = malloc(sizeof(BF_FocalElement ));
-	DEBUG_CHECK_MALLOC(vacuous.focals);
-
-    vacuous.elementSize = elementSize;
-	
-	vacuous.focals[0].element = Sets_getCompleteElement(elementSize);
+	vacuous = BF_allocateBeliefFunction(1, elementSize);
+	memset(vacuous.focals[0].element.values, 1, sizeof(char) * elementSize);
+	vacuous.focals[0].element.card = elementSize;
 	vacuous.focals[0].beliefValue = 1;
 	
 	return vacuous;
@@ -73,37 +652,45 @@ BF_BeliefFunction BF_getVacuousBeliefFunction(const int elementSize){
 
 
 void BF_cleanBeliefFunction(BF_BeliefFunction* bf){
-	int i = 0, index = 0;
-	int nbZeros = 0;
-	BF_FocalElement* focals;
-	
-	/*Count the number of zeros:*/
-	for(i = 0; i < bf->nbFocals; i++){
-		if(bf->focals[i].beliefValue < BF_PRECISION){
-			nbZeros++;
+	int read = 0, write = 0, runEnd = 0;
+	float runMass = 0, sum = 0;
+	int flat = BF_isFlat(*bf);
+
+	/*Sort so that duplicates are contiguous: */
+	sortFocals(bf->focals, bf->nbFocals, bf->elementSize, flat);
+
+	/*Merge each run of equal elements and keep it only if it is a focal element: */
+	for(read = 0; read < bf->nbFocals; read = runEnd){
+		runMass = bf->focals[read].beliefValue;
+		for(runEnd = read + 1; runEnd < bf->nbFocals
+				&& Sets_equals(bf->focals[read].element, bf->focals[runEnd].element, bf->elementSize); runEnd++){
+			runMass += bf->focals[runEnd].beliefValue;
+			freeFocal(bf, runEnd, flat);
 		}
-	}
-	
-	/*Create a new list of point:*/
-	focals = malloc(sizeof(BF_FocalElement) * (bf->nbFocals - nbZeros));
-	DEBUG_CHECK_MALLOC(focals);
-	/*Recopy:*/
-	for(i = 0; i < bf->nbFocals; i++){
-		if(bf->focals[i].beliefValue >= BF_PRECISION){
-			focals[index] = bf->focals[i];
-			index++;
+		if(runMass >= BF_PRECISION){
+			keepFocal(bf, read, write, flat);
+			bf->focals[write].beliefValue = runMass;
+			sum += runMass;
+			write++;
 		}
-		else{
-			BF_freeBeliefPoint(&(bf->focals[i]));
+		else {
+			freeFocal(bf, read, flat);
 		}
 	}
-	/*Free:*/
-	free(bf->focals);
-	/*Replace:*/
-	bf->focals = focals;
-	bf->nbFocals -= nbZeros;
-	
-	BF_normalize(bf);
+	/*The array is not reallocated, only the number of focals changes: */
+	bf->nbFocals = write;
+	if(flat){
+		packFlatValues(bf);
+	}
+
+	/*Normalize: */
+	if(sum != 1 && sum > 0){
+		for(read = 0; read < bf->nbFocals; read++){
+			bf->focals[read].beliefValue /= sum;
+		}
+	}
+
+	BF_invalidateCache(bf);
 }
 
 
@@ -121,6 +708,71 @@ void BF_normalize(BF_BeliefFunction* bf){
         	bf->focals[i].beliefValue /= sum;
         }
     }
+    BF_invalidateCache(bf);
+}
+
+
+
+void BF_sortFocals(BF_BeliefFunction* bf){
+	sortFocals(bf->focals, bf->nbFocals, bf->elementSize, BF_isFlat(*bf));
+}
+
+
+
+int BF_isSorted(const BF_BeliefFunction m){
+	int i = 0;
+
+	for(i = 1; i < m.nbFocals; i++){
+		if(Sets_compare(m.focals[i - 1].element, m.focals[i].element, m.elementSize) >= 0){
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+
+void BF_enableCache(BF_BeliefFunction* bf){
+	PoolHeader* block = NULL;
+	BF_Cache* cache = NULL;
+
+	if(!BF_isFlat(*bf) || getHeader(*bf)->info.cache != NULL){
+		return;
+	}
+	block = getHeader(*bf);
+	Memory_pushAllocator(block->info.allocator);
+	cache = Memory_calloc(1, sizeof(BF_Cache));
+	DEBUG_CHECK_MALLOC(cache);
+	fillCache(*bf, cache);
+	Memory_popAllocator();
+	block->info.cache = cache;
+}
+
+
+
+void BF_invalidateCache(BF_BeliefFunction* bf){
+	PoolHeader* block = NULL;
+	BF_Cache* cache = getCache(*bf);
+
+	if(cache != NULL){
+		/*Detached while computed again: */
+		block = getHeader(*bf);
+		block->info.cache = NULL;
+		Memory_pushAllocator(block->info.allocator);
+		emptyCache(cache);
+		fillCache(*bf, cache);
+		Memory_popAllocator();
+		block->info.cache = cache;
+	}
+}
+
+
+
+void BF_disableCache(BF_BeliefFunction* bf){
+	if(BF_isFlat(*bf)){
+		freeCache(getHeader(*bf));
+	}
 }
 
 
@@ -138,88 +790,56 @@ void BF_normalize(BF_BeliefFunction* bf){
  * @{
  */
 
-BF_BeliefFunction BF_conditioning(const BF_BeliefFunction m, const Sets_Element e, const Sets_Set powerset){
-    BF_BeliefFunction conditioned = {NULL, 0, 0};
-    Sets_Element disj = {NULL, 0};
-    Sets_Element opposite = {NULL, 0};
-    Sets_Element emptySet;
-    int i = 0, j = 0, containVoid = 0;
+BF_BeliefFunction BF_conditioning(const BF_BeliefFunction m, const Sets_Element e,
+		__attribute__((unused)) const Sets_Set powerset){
+    return BF_quickConditioning(m, e);
+}
 
-    /*Get the opposite:*/
-    opposite = Sets_getOpposite(e, m.elementSize);
 
-    /*Check if the belief function contain the void element:*/
-    emptySet = Sets_getEmptyElement(m.elementSize);
-    for(i = 0; i<m.nbFocals; i++){
-        if(m.focals[i].element.card == 0){
-            containVoid = 1;
-        }
-    }
 
-    /*Memory allocation:*/
-    if(containVoid){
-        conditioned.nbFocals = m.nbFocals;
-        conditioned.focals = malloc(sizeof(BF_FocalElement )*m.nbFocals);
-        DEBUG_CHECK_MALLOC(conditioned.focals);
+BF_BeliefFunction BF_quickConditioning(const BF_BeliefFunction m, const Sets_Element e){
+    BF_BeliefFunction conditioned = {NULL, 0, 0};
+    int i = 0;
 
-		conditioned.elementSize = m.elementSize;
-    }
-    else {
-        conditioned.nbFocals = m.nbFocals + 1;
-        conditioned.focals = malloc(sizeof(BF_FocalElement )*(m.nbFocals+1));
-        DEBUG_CHECK_MALLOC(conditioned.focals);
-
-		conditioned.elementSize = m.elementSize;
-    }
-    /*Check for the new focal elements:*/
-    for(i = 0; i<conditioned.nbFocals; i++){
-        /*Initialize the value:*/
-        if(containVoid){
-            conditioned.focals[i].beliefValue = 0;
-            conditioned.focals[i].element = Sets_copyElement(m.focals[i].element, m.elementSize);
-        }
-        else {
-            if(i==0){ /*Add the void element:*/
-                conditioned.focals[0].beliefValue = 0;
-                conditioned.focals[0].element = Sets_copyElement(emptySet, m.elementSize);
-            }
-            else { /*Consider the element normaly...*/
-                conditioned.focals[i].beliefValue = 0;
-                conditioned.focals[i].element = Sets_copyElement(m.focals[i-1].element, m.elementSize);
-            }
-        }
-        /*New belief computation:*/
-        if(Sets_isSubset(conditioned.focals[i].element, e, m.elementSize)){
-            for(j = 0; j<powerset.card; j++){
-                if(Sets_isSubset(powerset.elements[j], opposite, m.elementSize)){
-                    disj = Sets_disjunction(conditioned.focals[i].element, powerset.elements[j], m.elementSize);
-                    conditioned.focals[i].beliefValue += BF_m(m, disj);
-                    Sets_freeElement(&disj);
-                }
-            }
-        }
-    }
-    /*Set to 0 everything that is not in e:*/
-    for(i = 0; i<conditioned.nbFocals; i++){
-        if(!Sets_isSubset(conditioned.focals[i].element, e, m.elementSize)){
-            conditioned.focals[i].beliefValue = 0;
-        }
+    /*Memory allocation (at most one focal per focal of m):*/
+    conditioned.nbFocals = m.nbFocals;
+    conditioned.focals = Memory_malloc(sizeof(BF_FocalElement) * m.nbFocals);
+    DEBUG_CHECK_MALLOC(conditioned.focals);
+    conditioned.elementSize = m.elementSize;
+
+    /*Transfer each mass to the intersection with e:*/
+    for(i = 0; i < m.nbFocals; i++){
+        conditioned.focals[i].element = Sets_conjunction(m.focals[i].element, e, m.elementSize);
+        conditioned.focals[i].beliefValue = m.focals[i].beliefValue;
     }
+    /*Several focals may have the same intersection:*/
+    sortAndMergeFocals(&conditioned);
 
-    /*Deallocate:*/
-    Sets_freeElement(&opposite);
-    Sets_freeElement(&emptySet);
-	
 	#ifdef CHECK_SUM
-    if(BF_checkSum(conditioned)){
-        printf("debug: in BF_conditioning(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+	if(THEGAME_VALIDATING() && BF_checkSum(conditioned)){
+		THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &conditioned, "the sum is not equal to 1");
+	}
+	#endif
+    #ifdef CHECK_VALUES
+    if(THEGAME_VALIDATING() && BF_checkValues(conditioned)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &conditioned, "at least one value is not valid");
     }
     #endif
-    #ifdef CHECK_VALUES 
-    if(BF_checkValues(conditioned)){
-    	printf("debug: in BF_conditioning(), at least one value is not valid!\n");
+
+    return conditioned;
+}
+
+
+
+BF_BeliefFunction* BF_multipleConditioning(const BF_BeliefFunction m, const Sets_Element* events, const int nbEvents){
+    BF_BeliefFunction* conditioned = NULL;
+    int i = 0;
+
+    conditioned = Memory_malloc(sizeof(BF_BeliefFunction) * nbEvents);
+    DEBUG_CHECK_MALLOC(conditioned);
+    for(i = 0; i < nbEvents; i++){
+        conditioned[i] = BF_quickConditioning(m, events[i]);
     }
-    #endif
 
     return conditioned;
 }
@@ -252,13 +872,9 @@ BF_BeliefFunction BF_weakening(const BF_BeliefFunction m, const float alpha){
     /*Weaken:*/
     if(containVoid){
         /*Weaken the believes on elements:*/
-        weakened.nbFocals = m.nbFocals;
-        weakened.focals = malloc(sizeof(BF_FocalElement) * m.nbFocals);
-        DEBUG_CHECK_MALLOC(weakened.focals);
-
-		weakened.elementSize = m.elementSize;
+        weakened = BF_allocateBeliefFunction(m.nbFocals, m.elementSize);
         for(i = 0; i<m.nbFocals; i++){
-            weakened.focals[i].element = Sets_copyElement(m.focals[i].element, m.elementSize);
+            copyIntoFocal(&(weakened.focals[i]), m.focals[i].element, m.elementSize);
             if(i != voidIndex){
                 weakened.focals[i].beliefValue = m.focals[i].beliefValue * (1 - realAlpha);
                 sum += weakened.focals[i].beliefValue;
@@ -268,18 +884,14 @@ BF_BeliefFunction BF_weakening(const BF_BeliefFunction m, const float alpha){
         weakened.focals[voidIndex].beliefValue = 1 - sum;
     }
     else {
-        weakened.nbFocals = m.nbFocals + 1; /* + void */
-        weakened.focals = malloc(sizeof(BF_FocalElement) * (m.nbFocals + 1));
-        DEBUG_CHECK_MALLOC(weakened.focals);
-
-		weakened.elementSize = m.elementSize;
+        weakened = BF_allocateBeliefFunction(m.nbFocals + 1, m.elementSize); /* + void */
         /*Put the elements: */
         for(i = 0; i<m.nbFocals; i++){
-            weakened.focals[i].element = Sets_copyElement(m.focals[i].element, m.elementSize);
+            copyIntoFocal(&(weakened.focals[i]), m.focals[i].element, m.elementSize);
             weakened.focals[i].beliefValue = m.focals[i].beliefValue * (1 - realAlpha);
         }
         /*Transfer the lost belief on void: */
-        weakened.focals[m.nbFocals].element = Sets_copyElement(emptySet, m.elementSize);
+        copyIntoFocal(&(weakened.focals[m.nbFocals]), emptySet, m.elementSize);
         weakened.focals[m.nbFocals].beliefValue = realAlpha;
     }
 
@@ -287,13 +899,13 @@ BF_BeliefFunction BF_weakening(const BF_BeliefFunction m, const float alpha){
     Sets_freeElement(&emptySet);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(weakened)){
-        printf("debug: in BF_weakening(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
+    if(THEGAME_VALIDATING() && BF_checkSum(weakened)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &weakened, "the sum is not equal to 1");
     }
     #endif
-    #ifdef CHECK_VALUES 
-    if(BF_checkValues(weakened)){
-    	printf("debug: in BF_weakening(), at least one value is not valid!\n");
+    #ifdef CHECK_VALUES
+    if(THEGAME_VALIDATING() && BF_checkValues(weakened)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &weakened, "at least one value is not valid");
     }
     #endif
 
@@ -331,13 +943,9 @@ BF_BeliefFunction BF_discounting(const BF_BeliefFunction m, const float alpha){
     /*Discount: */
     if(containComplete){
         /*Discount the believes on elements: */
-        discounted.nbFocals = m.nbFocals;
-        discounted.focals = malloc(sizeof(BF_FocalElement )*m.nbFocals);
-        DEBUG_CHECK_MALLOC(discounted.focals);
-
-		discounted.elementSize = m.elementSize;
+        discounted = BF_allocateBeliefFunction(m.nbFocals, m.elementSize);
         for(i = 0; i<m.nbFocals; i++){
-            discounted.focals[i].element = Sets_copyElement(m.focals[i].element, m.elementSize);
+            copyIntoFocal(&(discounted.focals[i]), m.focals[i].element, m.elementSize);
             if(i != completeIndex){
                 discounted.focals[i].beliefValue = m.focals[i].beliefValue * (1 - realAlpha);
                 sum += discounted.focals[i].beliefValue;
@@ -347,18 +955,14 @@ BF_BeliefFunction BF_discounting(const BF_BeliefFunction m, const float alpha){
         discounted.focals[completeIndex].beliefValue = 1 - sum;
     }
     else {
-        discounted.nbFocals = m.nbFocals + 1; /* + complete */
-        discounted.focals = malloc(sizeof(BF_FocalElement )*(m.nbFocals + 1));
-        DEBUG_CHECK_MALLOC(discounted.focals);
-
-		discounted.elementSize = m.elementSize;
+        discounted = BF_allocateBeliefFunction(m.nbFocals + 1, m.elementSize); /* + complete */
         /*Put the elements: */
         for(i = 0; i<m.nbFocals; i++){
-            discounted.focals[i].element = Sets_copyElement(m.focals[i].element, m.elementSize);
+            copyIntoFocal(&(discounted.focals[i]), m.focals[i].element, m.elementSize);
             discounted.focals[i].beliefValue = m.focals[i].beliefValue * (1 - realAlpha);
         }
         /*Transfer the lost belief on complete: */
-        discounted.focals[m.nbFocals].element = Sets_copyElement(complete, m.elementSize);
+        copyIntoFocal(&(discounted.focals[m.nbFocals]), complete, m.elementSize);
         discounted.focals[m.nbFocals].beliefValue = realAlpha;
     }
 
@@ -366,15 +970,13 @@ BF_BeliefFunction BF_discounting(const BF_BeliefFunction m, const float alpha){
     Sets_freeElement(&complete);
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(discounted)){
-        printf("debug: in BF_discounting(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
-        printf("debug: alpha = %f\n", alpha);
+    if(THEGAME_VALIDATING() && BF_checkSum(discounted)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &discounted, "the sum is not equal to 1 (alpha = %f)", alpha);
     }
     #endif
-    #ifdef CHECK_VALUES 
-    if(BF_checkValues(discounted)){
-    	printf("debug: in BF_discounting(), at least one value is not valid!\n");
-    	printf("debug: alpha = %f\n", alpha);
+    #ifdef CHECK_VALUES
+    if(THEGAME_VALIDATING() && BF_checkValues(discounted)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &discounted, "at least one value is not valid (alpha = %f)", alpha);
     }
     #endif
 
@@ -384,45 +986,70 @@ BF_BeliefFunction BF_discounting(const BF_BeliefFunction m, const float alpha){
 
 
 BF_BeliefFunction BF_difference(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
-    BF_BeliefFunction diff = {NULL, 0, 0};
-    int i = 0;
-    Sets_Set values = {NULL, 0};
+    BF_BeliefFunction functions[2];
+    float weights[2] = {1, -1};
 
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_difference(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
 
-    /*Get the set of values to considerate: */
-    values.elements = malloc(sizeof(Sets_Element) * (m1.nbFocals + m2.nbFocals));
-    DEBUG_CHECK_MALLOC(values.elements);
+    functions[0] = m1;
+    functions[1] = m2;
 
-    for(i = 0; i<m1.nbFocals; i++){
-        values.elements[i] = Sets_copyElement(m1.focals[i].element, m1.elementSize);
-        values.card++;
+    return BF_weightedSum(functions, weights, 2);
+}
+
+
+
+BF_BeliefFunction BF_weightedSum(const BF_BeliefFunction* m, const float* weights, const int nbM){
+    BF_BeliefFunction sum = {NULL, 0, 0};
+    BF_FocalElement* gathered = NULL;
+    int i = 0, j = 0, nbGathered = 0, allSorted = 1;
+
+    if(m == NULL || nbM <= 0){
+        return sum;
+    }
+    /*Gather all the focal elements in the canonical order: */
+    for(i = 0; i < nbM; i++){
+        nbGathered += m[i].nbFocals;
+        allSorted = allSorted && BF_isSorted(m[i]);
+    }
+    gathered = Memory_malloc(sizeof(BF_FocalElement) * nbGathered);
+    DEBUG_CHECK_MALLOC(gathered);
+    if(allSorted){
+        mergeSortedFocals(m, weights, nbM, gathered);
     }
-    for(i = 0; i<m2.nbFocals; i++){
-        if(!Sets_isMember(m2.focals[i].element, values, m1.elementSize)){
-            values.elements[values.card] = Sets_copyElement(m2.focals[i].element, m1.elementSize);
-            values.card++;
+    else {
+        nbGathered = 0;
+        for(i = 0; i < nbM; i++){
+            for(j = 0; j < m[i].nbFocals; j++){
+                gathered[nbGathered] = m[i].focals[j];
+                gathered[nbGathered].beliefValue *= weights[i];
+                nbGathered++;
+            }
         }
+        sortFocals(gathered, nbGathered, m[0].elementSize, 0);
     }
-    /*Allocation: */
-    diff.nbFocals = values.card;
-    diff.focals = malloc(sizeof(BF_FocalElement) * values.card);
-    DEBUG_CHECK_MALLOC(diff.focals);
 
-	diff.elementSize = m1.elementSize;
-    /*Get the differences: */
-    for(i = 0; i<values.card; i++){
-        diff.focals[i].element = Sets_copyElement(values.elements[i], m1.elementSize);
-        diff.focals[i].beliefValue = BF_m(m1, values.elements[i]) - BF_m(m2, values.elements[i]);
+    /*Sum the runs of equal elements: */
+    sum.elementSize = m[0].elementSize;
+    sum.focals = Memory_malloc(sizeof(BF_FocalElement) * nbGathered);
+    DEBUG_CHECK_MALLOC(sum.focals);
+    for(i = 0; i < nbGathered; i++){
+        if(sum.nbFocals > 0 && Sets_equals(sum.focals[sum.nbFocals - 1].element, gathered[i].element, sum.elementSize)){
+            sum.focals[sum.nbFocals - 1].beliefValue += gathered[i].beliefValue;
+        }
+        else {
+            sum.focals[sum.nbFocals].element = Sets_copyElement(gathered[i].element, sum.elementSize);
+            sum.focals[sum.nbFocals].beliefValue = gathered[i].beliefValue;
+            sum.nbFocals++;
+        }
     }
-    /*Deallocation: */
-    Sets_freeSet(&values);
+    Memory_free(gathered);
 
-    return diff;
+    return sum;
 }
 
 
@@ -439,6 +1066,7 @@ BF_BeliefFunction BF_difference(const BF_BeliefFunction m1, const BF_BeliefFunct
 float BF_m(const BF_BeliefFunction m, const Sets_Element e){
     int i = 0;
 
+    THEGAME_COUNT(nbMassLookups);
     for(i = 0; i<m.nbFocals; i++){
         if(Sets_equals(e, m.focals[i].element, m.elementSize)){
             return m.focals[i].beliefValue;
@@ -450,9 +1078,14 @@ float BF_m(const BF_BeliefFunction m, const Sets_Element e){
 
 
 float BF_bel(const BF_BeliefFunction m, const Sets_Element e){
+    BF_Cache* cache = getCache(m);
     float cred = 0;
     int i = 0;
     
+    if(cache != NULL && cache->beliefs != NULL){
+        return cache->beliefs[Sets_numberFromElement(e, m.elementSize)];
+    }
+
     /*Compute: */
     for(i = 0; i<m.nbFocals; i++){
         if(Sets_isSubset(m.focals[i].element, e, m.elementSize) && m.focals[i].element.card > 0){
@@ -466,10 +1099,15 @@ float BF_bel(const BF_BeliefFunction m, const Sets_Element e){
 
 
 float BF_pl(const BF_BeliefFunction m, const Sets_Element e){
+    BF_Cache* cache = getCache(m);
     float plaus = 0;
     int i = 0;
     Sets_Element conj;
 
+    if(cache != NULL && cache->plausibilities != NULL){
+        return cache->plausibilities[Sets_numberFromElement(e, m.elementSize)];
+    }
+
     /*Compute: */
     for(i = 0; i<m.nbFocals; i++){
         conj = Sets_conjunction(m.focals[i].element, e, m.elementSize);
@@ -484,9 +1122,14 @@ float BF_pl(const BF_BeliefFunction m, const Sets_Element e){
 
 
 float BF_q(const BF_BeliefFunction m, const Sets_Element e){
+    BF_Cache* cache = getCache(m);
     float common = 0;
     int i = 0;
 
+    if(cache != NULL && cache->commonalities != NULL){
+        return cache->commonalities[Sets_numberFromElement(e, m.elementSize)];
+    }
+
     for(i = 0; i<m.nbFocals; i++){
         if(Sets_isSubset(e, m.focals[i].element, m.elementSize)){
             common += m.focals[i].beliefValue;
@@ -499,16 +1142,63 @@ float BF_q(const BF_BeliefFunction m, const Sets_Element e){
 
 
 float BF_betP(const BF_BeliefFunction m, const Sets_Element e){
+    BF_Cache* cache = getCache(m);
     float proba = 0;
-    int i = 0;
-    Sets_Element conj;
-    
+    int i = 0, j = 0, conjCard = 0;
+
+    if(cache != NULL){
+        return BF_betPFromVector(cache->pignistic, e, m.elementSize);
+    }
+
     /*Compute: */
     for(i = 0; i<m.nbFocals; i++){
         if(m.focals[i].element.card > 0){
-            conj = Sets_conjunction(e, m.focals[i].element, m.elementSize);
-            proba += m.focals[i].beliefValue * conj.card / m.focals[i].element.card;
-            Sets_freeElement(&conj);
+            /*Cardinal of the conjunction, without building it: */
+            conjCard = 0;
+            for(j = 0; j < m.elementSize; j++){
+                conjCard += e.values[j] && m.focals[i].element.values[j];
+            }
+            proba += m.focals[i].beliefValue * conjCard / m.focals[i].element.card;
+        }
+    }
+
+    return proba;
+}
+
+
+
+float* BF_pignisticVector(const BF_BeliefFunction m){
+    float* pignistic = NULL;
+    float share = 0;
+    int i = 0, j = 0;
+
+    pignistic = Memory_calloc(m.elementSize, sizeof(float));
+    DEBUG_CHECK_MALLOC(pignistic);
+
+    /*Share the mass of each focal element between its atoms: */
+    for(i = 0; i < m.nbFocals; i++){
+        if(m.focals[i].element.card > 0){
+            share = m.focals[i].beliefValue / m.focals[i].element.card;
+            for(j = 0; j < m.elementSize; j++){
+                if(m.focals[i].element.values[j]){
+                    pignistic[j] += share;
+                }
+            }
+        }
+    }
+
+    return pignistic;
+}
+
+
+
+float BF_betPFromVector(const float* pignistic, const Sets_Element e, const int elementSize){
+    float proba = 0;
+    int i = 0;
+
+    for(i = 0; i < elementSize; i++){
+        if(e.values[i]){
+            proba += pignistic[i];
         }
     }
 
@@ -529,9 +1219,14 @@ float BF_betP(const BF_BeliefFunction m, const Sets_Element e){
 
 
 float BF_specificity(const BF_BeliefFunction m){
+    BF_Cache* cache = getCache(m);
     float spec = 0;
     int i = 0;
     
+    if(cache != NULL){
+        return cache->specificity;
+    }
+
     /*Computation: */
     for(i = 0; i<m.nbFocals; i++){
         if(m.focals[i].element.card > 0){
@@ -545,9 +1240,14 @@ float BF_specificity(const BF_BeliefFunction m){
 
 
 float BF_nonSpecificity(const BF_BeliefFunction m){
+    BF_Cache* cache = getCache(m);
     float nonSpe = 0;
     int i = 0;
    	
+    if(cache != NULL){
+        return cache->nonSpecificity;
+    }
+
     /*Computation: */
     for(i = 0; i<m.nbFocals; i++){
         if(m.focals[i].element.card > 0){
@@ -561,13 +1261,18 @@ float BF_nonSpecificity(const BF_BeliefFunction m){
 
 
 float BF_discrepancy(const BF_BeliefFunction m){
+    BF_Cache* cache = getCache(m);
     float disc = 0;
-    int i = 0;
+    float* pignistic = NULL;
 
-    for(i = 0; i<m.nbFocals; i++){
-        disc -= m.focals[i].beliefValue * log(BF_betP(m, m.focals[i].element)) / log(2);
+    if(cache != NULL){
+        return cache->discrepancy;
     }
 
+    pignistic = BF_pignisticVector(m);
+    disc = discrepancyFromVector(m, pignistic);
+    Memory_free(pignistic);
+
     return disc;
 }
 
@@ -583,10 +1288,10 @@ float BF_distance(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     Sets_Element conj, disj;
 	
 	#ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_distance(), the two mass functions aren't defined on the same frame...\n");
-    }
-    #endif
+	if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
+	}
+	#endif
 	
     /*Get void: */
     /*emptySet = Sets_getEmptyElement(m1.elementSize); */
@@ -595,11 +1300,11 @@ float BF_distance(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     diff = BF_difference(m1, m2);
 
     /*Compute the matrix: */
-    matrix = malloc(sizeof(float*) * diff.nbFocals);
+    matrix = Memory_malloc(sizeof(float*) * diff.nbFocals);
     DEBUG_CHECK_MALLOC(matrix);
 
     for(i = 0; i<diff.nbFocals; i++){
-        matrix[i] = malloc(sizeof(float) * diff.nbFocals);
+        matrix[i] = Memory_malloc(sizeof(float) * diff.nbFocals);
         DEBUG_CHECK_MALLOC(matrix);
 
         for(j = 0; j<diff.nbFocals; j++){
@@ -618,7 +1323,7 @@ float BF_distance(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     }
 
     /*Compute the distance: */
-    temp = malloc(sizeof(float) * diff.nbFocals);
+    temp = Memory_malloc(sizeof(float) * diff.nbFocals);
     DEBUG_CHECK_MALLOC(temp);
 
     for(i = 0; i<diff.nbFocals; i++){
@@ -633,11 +1338,11 @@ float BF_distance(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     dist = sqrt(0.5 * dist);
 
     /*Deallocate: */
-    free(temp);
+    Memory_free(temp);
     for(i = 0; i<diff.nbFocals; i++){
-        free(matrix[i]);
+        Memory_free(matrix[i]);
     }
-    free(matrix);
+    Memory_free(matrix);
     /*Sets_freeElement(&emptySet); */
     BF_freeBeliefFunction(&diff);
 
@@ -651,11 +1356,13 @@ float BF_globalDistance(const BF_BeliefFunction m, const BF_BeliefFunction* s, c
     int i = 0; 
     
     #ifdef CHECK_COMPATIBILITY
-    int size = m.elementSize;
-    for(i = 0; i < nbBF; i++){
-    	if(s[i].elementSize != size){
-    		printf("debug: in BF_globalDistance(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbBF; i++){
+            if(s[i].elementSize != m.elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(s[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 	
@@ -671,8 +1378,8 @@ float BF_globalDistance(const BF_BeliefFunction m, const BF_BeliefFunction* s, c
 
 float BF_similarity(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
     #ifdef CHECK_COMPATIBILITY
-    if(m1.elementSize != m2.elementSize){
-    	printf("debug: in BF_distance(), the two mass functions aren't defined on the same frame...\n");
+    if(THEGAME_VALIDATING() && m1.elementSize != m2.elementSize){
+        THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the two mass functions aren't defined on the same frame");
     }
     #endif
     
@@ -686,11 +1393,13 @@ float BF_support(const BF_BeliefFunction ref, const BF_BeliefFunction* m, const
     int i = 0; 
     
     #ifdef CHECK_COMPATIBILITY
-    int size = ref.elementSize;
-    for(i = 0; i < nbM; i++){
-    	if(m[i].elementSize != size){
-    		printf("debug: in BF_support(), at least one mass function is not compatible with others...\n");
-    	}
+    if(THEGAME_VALIDATING()){
+        for(i = 0; i < nbM; i++){
+            if(m[i].elementSize != ref.elementSize){
+                THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(m[i]), "at least one mass function is not compatible with others");
+                break;
+            }
+        }
     }
     #endif
 
@@ -711,10 +1420,6 @@ int BF_checkSum(const BF_BeliefFunction m){
         sum += m.focals[i].beliefValue;
     }
 
-    if(!(1 - BF_PRECISION < sum && sum < 1 + BF_PRECISION)){
-        printf("debug: Sum problem: %f\n", sum);
-    }
-
     /*Take into account the precision of the computations... */
     return !(1 - BF_PRECISION < sum && sum < 1 + BF_PRECISION); /*(sum != 1);*/
 }
@@ -724,18 +1429,9 @@ int BF_checkSum(const BF_BeliefFunction m){
 int BF_checkValues(const BF_BeliefFunction m){
 	int okay = 0;
 	int i = 0;
-	int problemIndex = 0;
 	
-	for(i = 0; i < m.nbFocals; i++){
-		okay = okay || (m.focals[i].beliefValue < 0 || m.focals[i].beliefValue > 1 + BF_PRECISION);
-		if(m.focals[i].beliefValue < 0 || m.focals[i].beliefValue > 1 + BF_PRECISION){
-			problemIndex = i;
-		}
-	}
-	
-	if(okay){
-		printf("debug: Value problem!\n");
-		printf("m(%s) = %f\n", m.focals[problemIndex].element.values, m.focals[problemIndex].beliefValue);
+	for(i = 0; i < m.nbFocals && !okay; i++){
+		okay = (m.focals[i].beliefValue < 0 || m.focals[i].beliefValue > 1 + BF_PRECISION);
 	}
 	
 	return okay;
@@ -751,6 +1447,59 @@ int BF_checkValues(const BF_BeliefFunction m){
 
 
 
+/**
+ * @name Memory usage
+ * @{
+ */
+
+BF_MemoryUsage BF_memoryUsage(const BF_BeliefFunction m){
+	BF_MemoryUsage usage = {0, 0, 0, 0};
+	BF_Cache* cache = getCache(m);
+	size_t nbValues = 0;
+	int i = 0;
+
+	if(BF_isFlat(m)){
+		/*The block is the one given by the pool, the values at its end: */
+		usage.elements = (size_t)m.nbFocals * m.elementSize;
+		usage.focals = getHeader(m)->info.size - usage.elements;
+	}
+	else if(m.focals != NULL){
+		usage.focals = sizeof(BF_FocalElement) * m.nbFocals;
+		for(i = 0; i < m.nbFocals; i++){
+			if(m.focals[i].element.values != NULL){
+				usage.elements += m.elementSize;
+			}
+		}
+	}
+	if(cache != NULL){
+		nbValues = (size_t)1 << m.elementSize;
+		usage.cache = sizeof(BF_Cache);
+		if(cache->beliefs != NULL){
+			usage.cache += sizeof(float) * nbValues;
+		}
+		if(cache->plausibilities != NULL){
+			usage.cache += sizeof(float) * nbValues;
+		}
+		if(cache->commonalities != NULL){
+			usage.cache += sizeof(float) * nbValues;
+		}
+		if(cache->pignistic != NULL){
+			usage.cache += sizeof(float) * m.elementSize;
+		}
+	}
+	usage.total = usage.focals + usage.elements + usage.cache;
+
+	return usage;
+}
+
+/** @} */
+
+
+
+
+
+
+
 /**
  * @name Memory deallocation
  * @{
@@ -764,11 +1513,17 @@ int BF_checkValues(const BF_BeliefFunction m){
 void BF_freeBeliefFunction(BF_BeliefFunction* bf){
     int i = 0;
 
-    for(i = 0; i<bf->nbFocals; i++){
-        BF_freeBeliefPoint(&(bf->focals[i]));
+    /*The elements of a flat function live in the same block as the focals, given back to the pool: */
+    if(BF_isFlat(*bf)){
+        freeCache(getHeader(*bf));
+        poolRelease(getHeader(*bf));
+    }
+    else {
+        for(i = 0; i<bf->nbFocals; i++){
+            BF_freeBeliefPoint(&(bf->focals[i]));
+        }
+        Memory_free(bf->focals);
     }
-
-    free(bf->focals);
 }
 
 
@@ -778,6 +1533,12 @@ void BF_freeBeliefPoint(BF_FocalElement  *bp){
 }
 
 
+
+void BF_clearPool(){
+	poolDrain(&pool);
+}
+
+
 /** @} */
 
 
@@ -802,23 +1563,23 @@ char* BF_beliefFunctionToString(const BF_BeliefFunction bf, const Sets_Reference
         elem = Sets_elementToString(bf.focals[i].element, rl);
         sprintf(temp, "m(%s) = %f\n", elem, bf.focals[i].beliefValue);
         totChar += strlen(temp);
-        free(elem);
+        Memory_free(elem);
         elem = NULL;
     }
     /*Memory allocation: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     /*Fill the string: */
     elem = Sets_elementToString(bf.focals[0].element, rl);
     sprintf(str, "m(%s) = %f\n", elem, bf.focals[0].beliefValue);
-    free(elem);
+    Memory_free(elem);
     elem = NULL;
     for(i = 1; i<bf.nbFocals; i++){
         elem = Sets_elementToString(bf.focals[i].element, rl);
         sprintf(temp, "m(%s) = %f\n", elem, bf.focals[i].beliefValue);
         strcat(str, temp);
-        free(elem);
+        Memory_free(elem);
         elem = NULL;
     }
     /*Add the end of str char: */
@@ -839,23 +1600,23 @@ char* BF_beliefFunctionToBitString(const BF_BeliefFunction bf){
         elem = Sets_elementToBitString(bf.focals[i].element, bf.elementSize);
         sprintf(temp, "m(%s) = %f\n", elem, bf.focals[i].beliefValue);
         totChar += strlen(temp);
-        free(elem);
+        Memory_free(elem);
         elem = NULL;
     }
     /*Memory allocation: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     /*Fill the string: */
     elem = Sets_elementToBitString(bf.focals[0].element, bf.elementSize);
     sprintf(str, "m(%s) = %f\n", elem, bf.focals[0].beliefValue);
-    free(elem);
+    Memory_free(elem);
     elem = NULL;
     for(i = 1; i < bf.nbFocals; i++){
         elem = Sets_elementToBitString(bf.focals[i].element, bf.elementSize);
         sprintf(temp, "m(%s) = %f\n", elem, bf.focals[i].beliefValue);
         strcat(str, temp);
-        free(elem);
+        Memory_free(elem);
         elem = NULL;
     }
     /*Add the end of str char: */
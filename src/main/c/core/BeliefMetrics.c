@@ -0,0 +1,260 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BeliefMetrics.h"
+#include "Checks.h"
+
+/**
+ * This module computes in one go the measures used to characterize a belief function.
+ *
+ * If you have no idea to what corresponds exactly a function, you should refer to the given references.
+ * @file BeliefMetrics.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief CORE: Gives functions to measure belief functions.
+ */
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * Gets log2(card) from the table, or computes it if the table is too small for the cardinality.
+ */
+static double log2Card(const BF_MetricsTable table, const int card){
+	if(card <= table.elementSize){
+		return table.log2Card[card];
+	}
+	return log(card) / log(2);
+}
+
+/**
+ * Gets log2(2^card - 1) from the table, or computes it if the table is too small for the cardinality.
+ */
+static double log2NbSubsets(const BF_MetricsTable table, const int card){
+	if(card <= table.elementSize){
+		return table.log2NbSubsets[card];
+	}
+	return log(pow(2, card) - 1) / log(2);
+}
+
+/**
+ * Gives the Jaccard index |A n B| / |A u B| of two elements, 1 for two empty sets (see BF_distance()).
+ */
+static double jaccardIndex(const Sets_Element a, const Sets_Element b, const int elementSize){
+	int j = 0, common = 0;
+
+	if(a.card == 0 && b.card == 0){
+		return 1;
+	}
+	for(j = 0; j < elementSize; j++){
+		if(a.values[j] && b.values[j]){
+			common++;
+		}
+	}
+
+	return (double)common / (a.card + b.card - common);
+}
+
+/**
+ * Gives the scalar product of two mass functions weighted by the Jaccard indexes of their focal elements:
+ * the distance of Jousselme is sqrt(0.5 * (<m1, m1> + <m2, m2> - 2 <m1, m2>)).
+ */
+static double scalarProduct(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
+	double product = 0;
+	int i = 0, j = 0;
+
+	for(i = 0; i < m1.nbFocals; i++){
+		for(j = 0; j < m2.nbFocals; j++){
+			product += (double)m1.focals[i].beliefValue * m2.focals[j].beliefValue
+					* jaccardIndex(m1.focals[i].element, m2.focals[j].element, m1.elementSize);
+		}
+	}
+
+	return product;
+}
+
+/**
+ * Gives the global distance of a function to the sources (see BF_globalDistance()), the scalar
+ * product of the function with itself being shared by the distances to all the sources.
+ */
+static float globalDistance(const BF_BeliefFunction m, const BF_BeliefFunction* s, const int nbBF){
+	double self = scalarProduct(m, m);
+	double squared = 0, distance = 0;
+	int i = 0;
+
+	#ifdef CHECK_COMPATIBILITY
+	if(THEGAME_VALIDATING()){
+		for(i = 0; i < nbBF; i++){
+			if(s[i].elementSize != m.elementSize){
+				THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, &(s[i]), "at least one mass function is not compatible with others");
+				break;
+			}
+		}
+	}
+	#endif
+
+	for(i = 0; i < nbBF; i++){
+		squared = 0.5 * (self + scalarProduct(s[i], s[i]) - 2 * scalarProduct(m, s[i]));
+		/*Rounding errors may give tiny negative values: */
+		if(squared > 0){
+			distance += sqrt(squared);
+		}
+	}
+
+	return distance / (nbBF - 1);
+}
+
+
+
+/**
+ * @name Metrics
+ * @{
+ */
+
+BF_MetricsTable BF_createMetricsTable(const int elementSize){
+	BF_MetricsTable table = {0, NULL, NULL, NULL};
+	int k = 0;
+
+	table.elementSize = elementSize;
+	table.log2Card = Memory_malloc(sizeof(double) * (elementSize + 1));
+	DEBUG_CHECK_MALLOC(table.log2Card);
+	table.log2NbSubsets = Memory_malloc(sizeof(double) * (elementSize + 1));
+	DEBUG_CHECK_MALLOC(table.log2NbSubsets);
+	table.pignistic = Memory_malloc(sizeof(float) * (elementSize + 1));
+	DEBUG_CHECK_MALLOC(table.pignistic);
+
+	table.log2Card[0] = 0;
+	table.log2NbSubsets[0] = 0;
+	for(k = 1; k <= elementSize; k++){
+		table.log2Card[k] = log(k) / log(2);
+		table.log2NbSubsets[k] = log(pow(2, k) - 1) / log(2);
+	}
+
+	return table;
+}
+
+
+
+BF_Metrics BF_getMetrics(const BF_BeliefFunction m, const BF_MetricsTable table,
+		const BF_BeliefFunction* s, const int nbBF, const int maxDegree){
+	BF_Metrics metrics = {0, 0, 0, 0, 0, 0, 0, NULL, 0};
+	float* pignistic = NULL;
+	double specificity = 0, nonSpecificity = 0, discrepancy = 0, deng = 0, entropy = 0;
+	double mass = 0, share = 0, betP = 0;
+	int i = 0, j = 0, card = 0;
+
+	#ifdef CHECK_COMPATIBILITY
+	if(THEGAME_VALIDATING() && m.elementSize != table.elementSize){
+		THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the metrics table was created for a different element size");
+	}
+	#endif
+
+	/*The buffer of the table, unless it is too small: */
+	if(m.elementSize <= table.elementSize){
+		pignistic = table.pignistic;
+	}
+	else {
+		pignistic = Memory_malloc(sizeof(float) * m.elementSize);
+		DEBUG_CHECK_MALLOC(pignistic);
+	}
+	for(j = 0; j < m.elementSize; j++){
+		pignistic[j] = 0;
+	}
+
+	/*Single pass on the focal elements: */
+	for(i = 0; i < m.nbFocals; i++){
+		mass = m.focals[i].beliefValue;
+		card = m.focals[i].element.card;
+		if(card > 0){
+			specificity += mass / card;
+			nonSpecificity += mass * log2Card(table, card);
+			if(mass > 0){
+				deng -= mass * (log(mass) / log(2) - log2NbSubsets(table, card));
+			}
+			/*Pignistic probabilities of the singletons: */
+			share = mass / card;
+			for(j = 0; j < m.elementSize; j++){
+				if(m.focals[i].element.values[j]){
+					pignistic[j] += share;
+				}
+			}
+		}
+	}
+	/*Discrepancy, the pignistic probability of each focal being a sum over its atoms: */
+	for(i = 0; i < m.nbFocals; i++){
+		if(m.focals[i].beliefValue > 0){
+			betP = BF_betPFromVector(pignistic, m.focals[i].element, m.elementSize);
+			discrepancy -= m.focals[i].beliefValue * log(betP) / log(2);
+		}
+	}
+	for(j = 0; j < m.elementSize; j++){
+		if(pignistic[j] > 0){
+			entropy -= pignistic[j] * log(pignistic[j]) / log(2);
+		}
+	}
+	if(pignistic != table.pignistic){
+		Memory_free(pignistic);
+	}
+
+	metrics.specificity = specificity;
+	metrics.nonSpecificity = nonSpecificity;
+	metrics.discrepancy = discrepancy;
+	metrics.dengEntropy = deng;
+	metrics.pignisticEntropy = entropy;
+	metrics.totalUncertainty = nonSpecificity + discrepancy;
+
+	/*Measures requiring other functions or combinations: */
+	if(s != NULL && nbBF > 1){
+		metrics.globalDistance = globalDistance(m, s, nbBF);
+	}
+	if(maxDegree > 0){
+		metrics.autoConflict = BF_autoConflict(m, maxDegree);
+		metrics.nbAutoConflict = maxDegree;
+	}
+
+	return metrics;
+}
+
+/** @} */
+
+
+
+/**
+ * @name Memory deallocation
+ * @{
+ */
+
+void BF_freeMetricsTable(BF_MetricsTable* table){
+	Memory_free(table->log2Card);
+	Memory_free(table->log2NbSubsets);
+	Memory_free(table->pignistic);
+	table->log2Card = NULL;
+	table->log2NbSubsets = NULL;
+	table->pignistic = NULL;
+}
+
+
+
+void BF_freeMetrics(BF_Metrics* metrics){
+	Memory_free(metrics->autoConflict);
+	metrics->autoConflict = NULL;
+	metrics->nbAutoConflict = 0;
+}
+
+/** @} */
@@ -16,7 +16,11 @@
  
 
 
+#include <pthread.h>
 #include "BeliefsFromBeliefs.h"
+#include "Counters.h"
+#include "Tracing.h"
+#include "Checks.h"
 
 
 /**
@@ -93,6 +97,510 @@
  */
 
 
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * Checks if a model comes from the frame of a structure: same name and same states, in the same order.
+ */
+static int comesFromFrame(const BFB_BeliefFromBelief bfb, const BFB_BeliefStructure frame){
+	int i = 0;
+
+	if(bfb.frameName == NULL || frame.frameName == NULL || strcmp(bfb.frameName, frame.frameName)
+			|| bfb.refList.card != frame.refList.card){
+		return 0;
+	}
+	for(i = 0; i < frame.refList.card; i++){
+		if(strcmp(bfb.refList.values[i], frame.refList.values[i])){
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * Stores a compiled matrix as a dense array as well if it is small enough.
+ */
+static void fillDenseMatrix(BFB_Matrix* matrix){
+	int row = 0, entry = 0;
+
+	if(matrix->nbRows > BFB_MAX_DENSE_ENTRIES / matrix->nbColumns){
+		return;
+	}
+	matrix->dense = Memory_calloc(matrix->nbRows * matrix->nbColumns, sizeof(float));
+	DEBUG_CHECK_MALLOC(matrix->dense);
+
+	for(row = 0; row < matrix->nbRows; row++){
+		for(entry = matrix->rowStarts[row]; entry < matrix->rowStarts[row + 1]; entry++){
+			matrix->dense[row * matrix->nbColumns + matrix->columns[entry]] += matrix->factors[entry];
+		}
+	}
+}
+
+/**
+ * Copies the sparse part of a compiled matrix.
+ */
+static BFB_Matrix copyMatrix(const BFB_Matrix matrix){
+	BFB_Matrix copy = {0, 0, NULL, NULL, NULL, NULL};
+	int nbEntries = matrix.rowStarts[matrix.nbRows];
+
+	copy.nbRows = matrix.nbRows;
+	copy.nbColumns = matrix.nbColumns;
+	copy.rowStarts = Memory_malloc(sizeof(int) * (matrix.nbRows + 1));
+	DEBUG_CHECK_MALLOC(copy.rowStarts);
+	copy.columns = Memory_malloc(sizeof(int) * nbEntries);
+	DEBUG_CHECK_MALLOC(copy.columns);
+	copy.factors = Memory_malloc(sizeof(float) * nbEntries);
+	DEBUG_CHECK_MALLOC(copy.factors);
+
+	memcpy(copy.rowStarts, matrix.rowStarts, sizeof(int) * (matrix.nbRows + 1));
+	memcpy(copy.columns, matrix.columns, sizeof(int) * nbEntries);
+	memcpy(copy.factors, matrix.factors, sizeof(float) * nbEntries);
+
+	return copy;
+}
+
+/**
+ * Multiplies two compiled matrices (a then b) row by row, keeping the result sparse:
+ * the entries of each row are accumulated in a dense row and only the columns
+ * reached are kept.
+ */
+static BFB_Matrix multiplyMatrices(const BFB_Matrix a, const BFB_Matrix b){
+	BFB_Matrix product = {0, 0, NULL, NULL, NULL, NULL};
+	float* row = NULL;
+	int* reached = NULL;
+	int* marks = NULL;
+	int i = 0, j = 0, k = 0, column = 0, nbReached = 0, nbEntries = 0, capacity = 0;
+
+	product.nbRows = a.nbRows;
+	product.nbColumns = b.nbColumns;
+	product.rowStarts = Memory_malloc(sizeof(int) * (product.nbRows + 1));
+	DEBUG_CHECK_MALLOC(product.rowStarts);
+	row = Memory_calloc(b.nbColumns, sizeof(float));
+	DEBUG_CHECK_MALLOC(row);
+	reached = Memory_malloc(sizeof(int) * b.nbColumns);
+	DEBUG_CHECK_MALLOC(reached);
+	marks = Memory_calloc(b.nbColumns, sizeof(int));
+	DEBUG_CHECK_MALLOC(marks);
+
+	for(i = 0; i < a.nbRows; i++){
+		/*Row i of the product: */
+		nbReached = 0;
+		for(j = a.rowStarts[i]; j < a.rowStarts[i + 1]; j++){
+			for(k = b.rowStarts[a.columns[j]]; k < b.rowStarts[a.columns[j] + 1]; k++){
+				column = b.columns[k];
+				if(!marks[column]){
+					marks[column] = 1;
+					reached[nbReached] = column;
+					nbReached++;
+				}
+				row[column] += a.factors[j] * b.factors[k];
+			}
+		}
+		/*Grow the entries geometrically: */
+		if(nbEntries + nbReached > capacity){
+			capacity = 2 * capacity > nbEntries + nbReached ? 2 * capacity : nbEntries + nbReached;
+			product.columns = Memory_realloc(product.columns, sizeof(int) * capacity);
+			DEBUG_CHECK_MALLOC(product.columns);
+			product.factors = Memory_realloc(product.factors, sizeof(float) * capacity);
+			DEBUG_CHECK_MALLOC(product.factors);
+		}
+		product.rowStarts[i] = nbEntries;
+		for(j = 0; j < nbReached; j++){
+			column = reached[j];
+			product.columns[nbEntries] = column;
+			product.factors[nbEntries] = row[column];
+			nbEntries++;
+			row[column] = 0;
+			marks[column] = 0;
+		}
+	}
+	product.rowStarts[product.nbRows] = nbEntries;
+
+	Memory_free(row);
+	Memory_free(reached);
+	Memory_free(marks);
+
+	return product;
+}
+
+/**
+ * Hashes a frame name (djb2) so that the models are found without comparing every name.
+ */
+static unsigned long hashFrameName(const char* frameName){
+	unsigned long hash = 5381;
+	const char* c = NULL;
+
+	for(c = frameName; *c != '\0'; c++){
+		hash = hash * 33 + (unsigned char)*c;
+	}
+
+	return hash;
+}
+
+/**
+ * A product of a mass by an entry of a compiled matrix, accumulated in a column.
+ */
+struct Product {
+	int column;
+	float mass;
+};
+typedef struct Product Product;
+
+/**
+ * Orders products by column. To be used with qsort().
+ */
+static int compareByColumn(const void* a, const void* b){
+	return ((const Product*)a)->column - ((const Product*)b)->column;
+}
+
+/**
+ * Sets a focal element of a flat function to the element of a given number and a mass.
+ */
+static void setFocalFromIndex(BF_FocalElement* focal, const int index, const int elementSize, const float mass){
+	int i = 0;
+
+	focal->element.card = 0;
+	for(i = 0; i < elementSize; i++){
+		focal->element.values[i] = (index >> i) & 1;
+		focal->element.card += (index >> i) & 1;
+	}
+	focal->beliefValue = mass;
+}
+
+/**
+ * Transforms a belief function with the dense array of a compiled matrix: the product of the
+ * matrix by the vector of masses, then the non-null masses are gathered in a flat belief function.
+ * The dense array only exists for small frames, so does the vector of the result.
+ */
+static BF_BeliefFunction believeFromDenseMatrix(const BFB_Matrix matrix, const BF_BeliefFunction from, const int elementSize){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	float* masses = NULL;
+	const float* row = NULL;
+	float mass = 0;
+	int i = 0, j = 0, nbFocals = 0;
+
+	masses = Memory_calloc(matrix.nbColumns, sizeof(float));
+	DEBUG_CHECK_MALLOC(masses);
+	THEGAME_COUNT(nbPowersetScans);
+	THEGAME_COUNT_N(nbScannedSubsets, matrix.nbColumns);
+
+	/*Product: */
+	for(i = 0; i < from.nbFocals; i++){
+		mass = from.focals[i].beliefValue;
+		if(mass == 0){
+			continue;
+		}
+		row = matrix.dense + Sets_numberFromElement(from.focals[i].element, from.elementSize) * matrix.nbColumns;
+		for(j = 0; j < matrix.nbColumns; j++){
+			masses[j] += mass * row[j];
+		}
+	}
+
+	/*Gather the focal elements: */
+	for(j = 0; j < matrix.nbColumns; j++){
+		if(masses[j] != 0){
+			nbFocals++;
+		}
+	}
+	bf = BF_allocateBeliefFunction(nbFocals, elementSize);
+	nbFocals = 0;
+	for(j = 0; j < matrix.nbColumns; j++){
+		if(masses[j] != 0){
+			setFocalFromIndex(&(bf.focals[nbFocals]), j, elementSize, masses[j]);
+			nbFocals++;
+		}
+	}
+	Memory_free(masses);
+
+	return bf;
+}
+
+/**
+ * Transforms a belief function with the sparse part of a compiled matrix. Only the entries of
+ * the rows of the focal elements are visited: their products are sorted by column and the
+ * products of a same column summed, so the cost does not depend on the size of the frame
+ * we're going to. The focal elements are in the order of their number, as with the dense array.
+ */
+static BF_BeliefFunction believeFromSparseMatrix(const BFB_Matrix matrix, const BF_BeliefFunction from, const int elementSize){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	Product* products = NULL;
+	float mass = 0;
+	int i = 0, j = 0, index = 0, nbProducts = 0, nbFocals = 0;
+
+	for(i = 0; i < from.nbFocals; i++){
+		if(from.focals[i].beliefValue != 0){
+			index = Sets_numberFromElement(from.focals[i].element, from.elementSize);
+			nbProducts += matrix.rowStarts[index + 1] - matrix.rowStarts[index];
+		}
+	}
+	if(nbProducts == 0){
+		return BF_allocateBeliefFunction(0, elementSize);
+	}
+	products = Memory_malloc(sizeof(Product) * nbProducts);
+	DEBUG_CHECK_MALLOC(products);
+
+	/*Products of the non-null entries: */
+	nbProducts = 0;
+	for(i = 0; i < from.nbFocals; i++){
+		mass = from.focals[i].beliefValue;
+		if(mass == 0){
+			continue;
+		}
+		index = Sets_numberFromElement(from.focals[i].element, from.elementSize);
+		for(j = matrix.rowStarts[index]; j < matrix.rowStarts[index + 1]; j++){
+			products[nbProducts].column = matrix.columns[j];
+			products[nbProducts].mass = mass * matrix.factors[j];
+			nbProducts++;
+		}
+	}
+
+	/*Sum of the products of each column, the non-null ones kept at the start: */
+	qsort(products, nbProducts, sizeof(Product), compareByColumn);
+	for(i = 0; i < nbProducts; i = j){
+		mass = 0;
+		for(j = i; j < nbProducts && products[j].column == products[i].column; j++){
+			mass += products[j].mass;
+		}
+		if(mass != 0){
+			products[nbFocals].column = products[i].column;
+			products[nbFocals].mass = mass;
+			nbFocals++;
+		}
+	}
+	bf = BF_allocateBeliefFunction(nbFocals, elementSize);
+	for(i = 0; i < nbFocals; i++){
+		setFocalFromIndex(&(bf.focals[i]), products[i].column, elementSize, products[i].mass);
+	}
+	Memory_free(products);
+
+	return bf;
+}
+
+/**
+ * Transforms a belief function with a compiled matrix, with its dense array if it has one.
+ */
+static BF_BeliefFunction believeFromMatrix(const BFB_Matrix matrix, const BF_BeliefFunction from, const int elementSize){
+	if(matrix.dense != NULL){
+		return believeFromDenseMatrix(matrix, from, elementSize);
+	}
+	return believeFromSparseMatrix(matrix, from, elementSize);
+}
+
+/**
+ * Transforms a belief function by searching the vectors of the model (for the models
+ * which are not compiled).
+ */
+static BF_BeliefFunction believeFromVectors(const BFB_BeliefFromBelief bfb, const BF_BeliefFunction from, const int elementSize){
+	BF_BeliefFunction bf;
+	int i = 0, j = 0, k = 0, l = 0;
+	int nbFocals = 0;
+	char in = 0;
+	Sets_Element emptyset;
+	float emptyMass = 0;
+	
+	/*Init: */
+	bf.nbFocals = 0;
+	bf.focals = NULL;
+	bf.elementSize = elementSize;
+	
+	/*Process the empty set: */
+	emptyset = Sets_getEmptyElement(from.elementSize);
+	emptyMass = BF_m(from, emptyset);
+	if(emptyMass > 0){
+		bf.focals = Memory_malloc(sizeof(BF_FocalElement));
+		DEBUG_CHECK_MALLOC(bf.focals);
+
+		bf.nbFocals++;
+		bf.focals[0].element = Sets_getEmptyElement(elementSize);
+		bf.focals[0].beliefValue = emptyMass;
+	}
+	
+	/*Transform: */
+	for(i = 0; i < from.nbFocals; i++){
+		for(j = 0; j < bfb.nbVectors; j++){
+			if(Sets_equals(from.focals[i].element, bfb.vectors[j].from, from.elementSize) &&
+			   !Sets_equals(from.focals[i].element, emptyset, from.elementSize)){
+				nbFocals = bf.nbFocals;
+				for(k = 0; k < bfb.vectors[j].nbTos; k++){
+					in = 0;
+					for(l = 0; l < nbFocals; l++){
+						if(Sets_equals(bf.focals[l].element, bfb.vectors[j].to[k], elementSize)){
+							in = 1;
+							bf.focals[l].beliefValue += from.focals[i].beliefValue * bfb.vectors[j].factors[k];
+							break;
+						}	
+					}
+					if(!in){
+						bf.focals = Memory_realloc(bf.focals, sizeof(BF_FocalElement) * (bf.nbFocals + 1));
+						DEBUG_CHECK_MALLOC(bf.focals);
+
+						bf.nbFocals++;
+						bf.focals[bf.nbFocals - 1].element = Sets_copyElement(bfb.vectors[j].to[k], elementSize);
+						bf.focals[bf.nbFocals - 1].beliefValue = from.focals[i].beliefValue * bfb.vectors[j].factors[k];
+					} 
+				}
+				break;
+			}
+		}
+	}
+	Sets_freeElement(&emptyset);
+
+	return bf;
+}
+
+/**
+ * Transforms a belief function with a model, compiled or not (BFB_believeFromBelief() without its trace,
+ * called for each function of the batches).
+ */
+static BF_BeliefFunction believeFromBelief(const BFB_BeliefFromBelief bfb, const BF_BeliefFunction from, const int elementSize){
+	BF_BeliefFunction bf;
+	
+	/*Compiled models are matrix products: */
+	if(bfb.matrix.nbRows > 0 && from.elementSize <= BFB_MAX_COMPILED_SIZE && elementSize <= BFB_MAX_COMPILED_SIZE &&
+	   bfb.matrix.nbRows == (1 << from.elementSize) && bfb.matrix.nbColumns == (1 << elementSize)){
+		bf = believeFromMatrix(bfb.matrix, from, elementSize);
+	}
+	else {
+		bf = believeFromVectors(bfb, from, elementSize);
+	}
+	
+	#ifdef CHECK_VALUES
+	if(THEGAME_VALIDATING() && BF_checkValues(bf)){
+		THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &bf, "at least one value is not valid");
+	}
+	#endif
+	
+	#ifdef CHECK_SUM
+	if(THEGAME_VALIDATING() && BF_checkSum(bf)){
+		THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &bf, "the sum is not equal to 1");
+	}
+	#endif
+	
+	return bf;
+}
+
+/**
+ * A slice of a batched transformation, given to one thread.
+ */
+struct BatchTask {
+	/** The model (for belief functions) */
+	const BFB_BeliefFromBelief* bfb;
+	/** The functions to transform and their results */
+	const BF_BeliefFunction* from;
+	BF_BeliefFunction* to;
+	int elementSize;
+	/** The masses to transform and their results (for dense masses) */
+	const float* masses;
+	float* results;
+	int nbBF;
+	/** The slice of entities [first, last[ */
+	int first;
+	int last;
+	/** 1 if the task runs in a thread of its own */
+	int ownThread;
+};
+typedef struct BatchTask BatchTask;
+
+/**
+ * Transforms a slice of belief functions.
+ */
+static void* believeTask(void* data){
+	BatchTask* task = data;
+	int i = 0;
+
+	for(i = task->first; i < task->last; i++){
+		task->to[i] = believeFromBelief(*(task->bfb), task->from[i], task->elementSize);
+	}
+	/*The pool of a thread which ends must be emptied: */
+	if(task->ownThread){
+		BF_clearPool();
+	}
+
+	return NULL;
+}
+
+/**
+ * Transforms a slice of dense masses: each entry of the sparse matrix is applied to the whole slice.
+ */
+static void* transformTask(void* data){
+	BatchTask* task = data;
+	const BFB_Matrix matrix = task->bfb->matrix;
+	const float* source = NULL;
+	float* destination = NULL;
+	float factor = 0;
+	int row = 0, column = 0, entry = 0, b = 0;
+
+	for(column = 0; column < matrix.nbColumns; column++){
+		destination = task->results + column * task->nbBF;
+		for(b = task->first; b < task->last; b++){
+			destination[b] = 0;
+		}
+	}
+	for(row = 0; row < matrix.nbRows; row++){
+		source = task->masses + row * task->nbBF;
+		for(entry = matrix.rowStarts[row]; entry < matrix.rowStarts[row + 1]; entry++){
+			factor = matrix.factors[entry];
+			destination = task->results + matrix.columns[entry] * task->nbBF;
+			for(b = task->first; b < task->last; b++){
+				destination[b] += factor * source[b];
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Shares the entities of a batch between threads and runs the tasks, the last one in the calling thread.
+ * A task which cannot get a thread of its own is run in the calling thread too.
+ */
+static void runBatch(void* (*work)(void*), BatchTask task, int nbThreads){
+	BatchTask tasks[BFB_MAX_THREADS];
+	pthread_t threads[BFB_MAX_THREADS];
+	int started[BFB_MAX_THREADS];
+	int i = 0;
+
+	/*Number of threads: */
+	if(nbThreads > BFB_MAX_THREADS){
+		nbThreads = BFB_MAX_THREADS;
+	}
+	if(nbThreads > task.nbBF){
+		nbThreads = task.nbBF;
+	}
+	if(nbThreads < 1 || !Memory_isDefaultAllocator()){
+		nbThreads = 1;
+	}
+
+	/*Slices: */
+	for(i = 0; i < nbThreads; i++){
+		tasks[i] = task;
+		tasks[i].first = (int)((long)task.nbBF * i / nbThreads);
+		tasks[i].last = (int)((long)task.nbBF * (i + 1) / nbThreads);
+		tasks[i].ownThread = (i < nbThreads - 1);
+		started[i] = 0;
+	}
+	for(i = 0; i < nbThreads - 1; i++){
+		started[i] = (pthread_create(&(threads[i]), NULL, work, &(tasks[i])) == 0);
+		if(!started[i]){
+			tasks[i].ownThread = 0;
+			work(&(tasks[i]));
+		}
+	}
+	work(&(tasks[nbThreads - 1]));
+	for(i = 0; i < nbThreads - 1; i++){
+		if(started[i]){
+			pthread_join(threads[i], NULL);
+		}
+	}
+}
+
+
+
 /**
  * @name Loading a model
  * @{
@@ -105,12 +613,13 @@ BFB_BeliefStructure BFB_loadBeliefStructure(const char* frameName){
     char** directories = NULL;
     int i = 0;
     
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_LOADING);
     /*Test if the model exists:  */
     strcpy(path, BFB_PATH);       /* The directory where to find the models  */
     strcat(path, frameName);      /* The name of the frame  */
     if(ReadDir_isDirectory(path)){
     	/*Copy the frame name: */
-        bs.frameName = malloc(sizeof(char)*(strlen(frameName) + 1));
+        bs.frameName = Memory_malloc(sizeof(char)*(strlen(frameName) + 1));
         DEBUG_CHECK_MALLOC(bs.frameName);
 
         strcpy(bs.frameName, frameName);
@@ -128,7 +637,7 @@ BFB_BeliefStructure BFB_loadBeliefStructure(const char* frameName){
         charsPerDir = ReadDir_charsPerDirectory(path, bs.nbBeliefs);
         directories = ReadDir_getDirectories(path, bs.nbBeliefs, charsPerDir);
         /*Load the beliefs from beliefs: */
-        bs.beliefs = malloc(sizeof(BFB_BeliefFromBelief)*bs.nbBeliefs);
+        bs.beliefs = Memory_malloc(sizeof(BFB_BeliefFromBelief)*bs.nbBeliefs);
         DEBUG_CHECK_MALLOC(bs.beliefs)
 
         for(i = 0; i < bs.nbBeliefs; i++){
@@ -139,11 +648,11 @@ BFB_BeliefStructure BFB_loadBeliefStructure(const char* frameName){
             bs.beliefs[i] = BFB_loadBeliefFromBelief(directories[i], path, bs.refList);
         }
         /*Deallocate: */
-        free(charsPerDir);
+        Memory_free(charsPerDir);
         for(i = 0; i<bs.nbBeliefs; i++){
-            free(directories[i]);
+            Memory_free(directories[i]);
         }
-        free(directories);
+        Memory_free(directories);
     }
     #ifdef DEBUG
     else {
@@ -151,11 +660,12 @@ BFB_BeliefStructure BFB_loadBeliefStructure(const char* frameName){
     }
     #endif
     
+    THEGAME_TRACE_END(THEGAME_TRACE_LOADING);
     return bs;
 }
 
 BFB_BeliefFromBelief BFB_loadBeliefFromBelief(const char* frameOfOrigin, const char* path, const Sets_ReferenceList rl){
-	BFB_BeliefFromBelief bfb;
+	BFB_BeliefFromBelief bfb = {NULL, {NULL, 0}, NULL, 0, 0, {0, 0, NULL, NULL, NULL, NULL}};
 	int i = 0, nbFiles = 0, beliefIndex = 0;
     int* charsPerFile = NULL;
     char filepath[MAX_SIZE_PATH], temp[MAX_STR_LEN];
@@ -163,11 +673,12 @@ BFB_BeliefFromBelief BFB_loadBeliefFromBelief(const char* frameOfOrigin, const c
 	
 	if(ReadDir_isDirectory(path)){
 		/*Copy the frame name: */
-        bfb.frameName = malloc(sizeof(char)*(strlen(frameOfOrigin) + 1));
+        bfb.frameName = Memory_malloc(sizeof(char)*(strlen(frameOfOrigin) + 1));
         DEBUG_CHECK_MALLOC(bfb.frameName);
 
         strcpy(bfb.frameName, frameOfOrigin);
         strcat(bfb.frameName, "\0");
+        bfb.frameHash = hashFrameName(frameOfOrigin);
         /*Load the reference list : */
         strcpy(temp, path);
         strcat(temp, "/");
@@ -180,11 +691,11 @@ BFB_BeliefFromBelief BFB_loadBeliefFromBelief(const char* frameOfOrigin, const c
         /*Load the vectors: */
         bfb.nbVectors = nbFiles - 1;
         #ifdef CHECK_MODELS
-        if(bfb.nbVectors != pow(2, bfb.refList.card) - 1){
-        	printf("debug: MODEL CHECKING = FAIL! You didn't write a file for each possible element in %s.\n", path);
+        if(THEGAME_VALIDATING() && bfb.nbVectors != pow(2, bfb.refList.card) - 1){
+        	THEGAME_reportError(THEGAME_CHECK_MODELS, __func__, NULL, "there is not a file for each possible element in %s", path);
         }
         #endif
-        bfb.vectors = malloc(sizeof(BFB_BeliefVector) * bfb.nbVectors);
+        bfb.vectors = Memory_malloc(sizeof(BFB_BeliefVector) * bfb.nbVectors);
         DEBUG_CHECK_MALLOC(bfb.vectors);
 
         for(i = 0; i < nbFiles; i++){
@@ -196,12 +707,14 @@ BFB_BeliefFromBelief BFB_loadBeliefFromBelief(const char* frameOfOrigin, const c
                 beliefIndex++;
             }
         }
+        /*Compile the vectors: */
+        bfb.matrix = BFB_compileMatrix(bfb, rl.card);
         /*Deallocate: */
-        free(charsPerFile);
+        Memory_free(charsPerFile);
         for(i = 0; i<nbFiles; i++){
-            free(filenames[i]);
+            Memory_free(filenames[i]);
         }
-        free(filenames);
+        Memory_free(filenames);
 	}
 	#ifdef DEBUG
     else{
@@ -230,7 +743,7 @@ BFB_BeliefVector BFB_loadBeliefVector(const char* fileName, const Sets_Reference
         /*Element From : */
         nbElements = atoi(lines[0]);
         lineCounter++;
-        elements = malloc(sizeof(char*)*nbElements);
+        elements = Memory_malloc(sizeof(char*)*nbElements);
         DEBUG_CHECK_MALLOC(elements);
 
         for(i = 0; i < nbElements; i++){
@@ -241,18 +754,18 @@ BFB_BeliefVector BFB_loadBeliefVector(const char* fileName, const Sets_Reference
         /*Get the number of conversions: */
         bv.nbTos = atoi(lines[lineCounter]);
         lineCounter++;
-        bv.to = malloc(sizeof(Sets_Element) * bv.nbTos);
+        bv.to = Memory_malloc(sizeof(Sets_Element) * bv.nbTos);
         DEBUG_CHECK_MALLOC(bv.to);
 
-		bv.factors = malloc(sizeof(float) * bv.nbTos);
+		bv.factors = Memory_malloc(sizeof(float) * bv.nbTos);
 		DEBUG_CHECK_MALLOC(bv.factors);
 
         /*Elements To : */
         for(i = 0; i < bv.nbTos; i++){
-        	free(elements);
+        	Memory_free(elements);
         	nbElements = atoi(lines[lineCounter]);
         	lineCounter++;
-        	elements = malloc(sizeof(char*)*nbElements);
+        	elements = Memory_malloc(sizeof(char*)*nbElements);
 		    DEBUG_CHECK_MALLOC(elements);
 
         	for(j = 0; j < nbElements; j++){
@@ -264,12 +777,12 @@ BFB_BeliefVector BFB_loadBeliefVector(const char* fileName, const Sets_Reference
 		    lineCounter++;
         }
         /*Deallocate: */
-        free(charsPerLin);
+        Memory_free(charsPerLin);
         for(i = 0; i < nbLines; i++){
-            free(lines[i]);
+            Memory_free(lines[i]);
         }
-        free(lines);
-        free(elements);
+        Memory_free(lines);
+        Memory_free(elements);
     }
     #ifdef DEBUG
     else{
@@ -278,18 +791,137 @@ BFB_BeliefVector BFB_loadBeliefVector(const char* fileName, const Sets_Reference
     #endif
     
     #ifdef CHECK_MODELS
-    for(i = 0; i < bv.nbTos; i++){
-    	sum += bv.factors[i];
-    }
-    if(sum != 1){
-    	printf("debug: CHECK MODELS FAIL!\n");
-    	printf("debug: In the file %s, the sum of factors should be 1.\n", fileName);
+    if(THEGAME_VALIDATING()){
+    	for(i = 0; i < bv.nbTos; i++){
+    		sum += bv.factors[i];
+    	}
+    	if(sum != 1){
+    		THEGAME_reportError(THEGAME_CHECK_MODELS, __func__, NULL, "the sum of factors should be 1 in %s", fileName);
+    	}
     }
     #endif
     
 	return bv;
 }
 
+BFB_Matrix BFB_compileMatrix(const BFB_BeliefFromBelief bfb, const int elementSize){
+	BFB_Matrix matrix = {0, 0, NULL, NULL, NULL, NULL};
+	int* vectorOfRow = NULL;
+	int i = 0, k = 0, row = 0, entry = 0, nbEntries = 1;
+
+	if(bfb.refList.card > BFB_MAX_COMPILED_SIZE || elementSize > BFB_MAX_COMPILED_SIZE){
+		return matrix;
+	}
+	matrix.nbRows = 1 << bfb.refList.card;
+	matrix.nbColumns = 1 << elementSize;
+
+	/*Vector of each row (the first one for duplicates, none for the empty set): */
+	vectorOfRow = Memory_malloc(sizeof(int) * matrix.nbRows);
+	DEBUG_CHECK_MALLOC(vectorOfRow);
+
+	for(row = 0; row < matrix.nbRows; row++){
+		vectorOfRow[row] = -1;
+	}
+	for(i = 0; i < bfb.nbVectors; i++){
+		row = Sets_numberFromElement(bfb.vectors[i].from, bfb.refList.card);
+		if(row != 0 && vectorOfRow[row] == -1){
+			vectorOfRow[row] = i;
+			nbEntries += bfb.vectors[i].nbTos;
+		}
+	}
+
+	/*Sparse matrix: */
+	matrix.rowStarts = Memory_malloc(sizeof(int) * (matrix.nbRows + 1));
+	DEBUG_CHECK_MALLOC(matrix.rowStarts);
+	matrix.columns = Memory_malloc(sizeof(int) * nbEntries);
+	DEBUG_CHECK_MALLOC(matrix.columns);
+	matrix.factors = Memory_malloc(sizeof(float) * nbEntries);
+	DEBUG_CHECK_MALLOC(matrix.factors);
+
+	/*The empty set stays the empty set: */
+	matrix.rowStarts[0] = 0;
+	matrix.columns[0] = 0;
+	matrix.factors[0] = 1;
+	entry = 1;
+	for(row = 1; row < matrix.nbRows; row++){
+		matrix.rowStarts[row] = entry;
+		i = vectorOfRow[row];
+		if(i != -1){
+			for(k = 0; k < bfb.vectors[i].nbTos; k++){
+				matrix.columns[entry] = Sets_numberFromElement(bfb.vectors[i].to[k], elementSize);
+				matrix.factors[entry] = bfb.vectors[i].factors[k];
+				entry++;
+			}
+		}
+	}
+	matrix.rowStarts[matrix.nbRows] = entry;
+	Memory_free(vectorOfRow);
+
+	/*Dense matrix for small frames: */
+	fillDenseMatrix(&matrix);
+
+	return matrix;
+}
+
+BFB_BeliefFromBelief BFB_composeBeliefsFromBeliefs(const BFB_BeliefFromBelief* chain, const BFB_BeliefStructure* to, const int nbBFB){
+	BFB_BeliefFromBelief composed = {NULL, {NULL, 0}, NULL, 0, 0, {0, 0, NULL, NULL, NULL, NULL}};
+	BFB_Matrix product = {0, 0, NULL, NULL, NULL, NULL}, previous;
+	int i = 0, k = 0, row = 0, elementSize = 0;
+
+	/*Check that the chain is compiled and that each model comes from the frame the previous one goes to: */
+	if(nbBFB < 1){
+		return composed;
+	}
+	for(i = 0; i < nbBFB; i++){
+		if(chain[i].matrix.nbRows == 0 || chain[i].matrix.nbColumns != (1 << to[i].refList.card)
+				|| (i > 0 && (!comesFromFrame(chain[i], to[i - 1]) || chain[i - 1].matrix.nbColumns != chain[i].matrix.nbRows))){
+			#ifdef CHECK_COMPATIBILITY
+			if(THEGAME_VALIDATING()){
+				THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the model %d is not compiled or does not follow the previous one", i);
+			}
+			#endif
+			return composed;
+		}
+	}
+
+	/*Product of the matrices: */
+	product = copyMatrix(chain[0].matrix);
+	for(i = 1; i < nbBFB; i++){
+		previous = product;
+		product = multiplyMatrices(previous, chain[i].matrix);
+		BFB_freeMatrix(&previous);
+	}
+	fillDenseMatrix(&product);
+	composed.matrix = product;
+
+	/*The composed model comes from the first frame: */
+	composed.frameName = Memory_strdup(chain[0].frameName);
+	composed.frameHash = chain[0].frameHash;
+	composed.refList = Sets_createRefListFromArray((const char* const*)chain[0].refList.values, chain[0].refList.card);
+
+	/*Vectors of the composed model (so that it can be printed), going to the last frame: */
+	elementSize = to[nbBFB - 1].refList.card;
+	composed.vectors = Memory_malloc(sizeof(BFB_BeliefVector) * (product.nbRows - 1));
+	DEBUG_CHECK_MALLOC(composed.vectors);
+
+	for(row = 1; row < product.nbRows; row++){
+		composed.vectors[composed.nbVectors].from = Sets_elementFromNumber(row, composed.refList.card);
+		composed.vectors[composed.nbVectors].nbTos = product.rowStarts[row + 1] - product.rowStarts[row];
+		composed.vectors[composed.nbVectors].to = Memory_malloc(sizeof(Sets_Element) * composed.vectors[composed.nbVectors].nbTos);
+		DEBUG_CHECK_MALLOC(composed.vectors[composed.nbVectors].to);
+		composed.vectors[composed.nbVectors].factors = Memory_malloc(sizeof(float) * composed.vectors[composed.nbVectors].nbTos);
+		DEBUG_CHECK_MALLOC(composed.vectors[composed.nbVectors].factors);
+
+		for(k = 0; k < composed.vectors[composed.nbVectors].nbTos; k++){
+			composed.vectors[composed.nbVectors].to[k] = Sets_elementFromNumber(product.columns[product.rowStarts[row] + k], elementSize);
+			composed.vectors[composed.nbVectors].factors[k] = product.factors[product.rowStarts[row] + k];
+		}
+		composed.nbVectors++;
+	}
+
+	return composed;
+}
+
 /** @} */
 
 
@@ -301,17 +933,20 @@ BFB_BeliefVector BFB_loadBeliefVector(const char* fileName, const Sets_Reference
 BF_BeliefFunction* BFB_believeFromBeliefs(const BFB_BeliefStructure bs, const char* const * const frameNames, const BF_BeliefFunction* from, const int nbBF){
 	BF_BeliefFunction* bf = NULL;
     int i = 0, j = 0, in = 0;
+    unsigned long hash = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_TRANSFORMATION);
     /*Memory allocation: */
-    bf = malloc(sizeof(BF_BeliefFunction) * nbBF);
+    bf = Memory_malloc(sizeof(BF_BeliefFunction) * nbBF);
     DEBUG_CHECK_MALLOC(bf);
 
     /*Get the functions: */
     for(i = 0; i<nbBF; i++){
     	in = 0;
+    	hash = hashFrameName(frameNames[i]);
         for(j = 0; j<bs.nbBeliefs; j++){
-            if(strcmp(bs.beliefs[j].frameName, frameNames[i]) == 0){
-                bf[i] = BFB_believeFromBelief(bs.beliefs[j], from[i], bs.refList.card);
+            if(bs.beliefs[j].frameHash == hash && strcmp(bs.beliefs[j].frameName, frameNames[i]) == 0){
+                bf[i] = believeFromBelief(bs.beliefs[j], from[i], bs.refList.card);
                 in = 1;
                 break;
             }
@@ -321,86 +956,111 @@ BF_BeliefFunction* BFB_believeFromBeliefs(const BFB_BeliefStructure bs, const ch
         }
     }
     
+    THEGAME_TRACE_END(THEGAME_TRACE_TRANSFORMATION);
 	return bf;
 }
 
 BF_BeliefFunction BFB_believeFromBelief(const BFB_BeliefFromBelief bfb, const BF_BeliefFunction from, const int elementSize){
 	BF_BeliefFunction bf;
-	int i = 0, j = 0, k = 0, l = 0;
-	int nbFocals = 0;
-	char in = 0;
-	Sets_Element emptyset;
-	float emptyMass = 0;
-	
-	/*Init: */
-	bf.nbFocals = 0;
-	bf.focals = NULL;
-	bf.elementSize = elementSize;
 	
-	/*Process the empty set: */
-	emptyset = Sets_getEmptyElement(from.elementSize);
-	emptyMass = BF_m(from, emptyset);
-	if(emptyMass > 0){
-		bf.focals = malloc(sizeof(BF_FocalElement));
-		DEBUG_CHECK_MALLOC(bf.focals);
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_TRANSFORMATION);
+	bf = believeFromBelief(bfb, from, elementSize);
+	THEGAME_TRACE_END(THEGAME_TRACE_TRANSFORMATION);
+	return bf;
+}
 
-		bf.nbFocals++;
-		bf.focals[0].element = Sets_getEmptyElement(elementSize);
-		bf.focals[0].beliefValue = emptyMass;
-	}
-	
-	/*Transform: */
-	for(i = 0; i < from.nbFocals; i++){
-		for(j = 0; j < bfb.nbVectors; j++){
-			if(Sets_equals(from.focals[i].element, bfb.vectors[j].from, from.elementSize) &&
-			   !Sets_equals(from.focals[i].element, emptyset, from.elementSize)){
-				nbFocals = bf.nbFocals;
-				for(k = 0; k < bfb.vectors[j].nbTos; k++){
-					in = 0;
-					for(l = 0; l < nbFocals; l++){
-						if(Sets_equals(bf.focals[l].element, bfb.vectors[j].to[k], elementSize)){
-							in = 1;
-							bf.focals[l].beliefValue += from.focals[i].beliefValue * bfb.vectors[j].factors[k];
-							break;
-						}	
-					}
-					if(!in){
-						bf.focals = realloc(bf.focals, sizeof(BF_FocalElement) * (bf.nbFocals + 1));
-						DEBUG_CHECK_MALLOC(bf.focals);
+BF_BeliefFunction* BFB_believeFromBeliefBatch(const BFB_BeliefFromBelief bfb, const BF_BeliefFunction* from, const int nbBF,
+		const int elementSize, const int nbThreads){
+	BatchTask task = {NULL, NULL, NULL, 0, NULL, NULL, 0, 0, 0, 0};
 
-						bf.nbFocals++;
-						bf.focals[bf.nbFocals - 1].element = Sets_copyElement(bfb.vectors[j].to[k], elementSize);
-						bf.focals[bf.nbFocals - 1].beliefValue = from.focals[i].beliefValue * bfb.vectors[j].factors[k];
-					} 
-				}
-				break;
-			}
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_TRANSFORMATION);
+	task.to = Memory_malloc(sizeof(BF_BeliefFunction) * nbBF);
+	DEBUG_CHECK_MALLOC(task.to);
+
+	task.bfb = &bfb;
+	task.from = from;
+	task.elementSize = elementSize;
+	task.nbBF = nbBF;
+	runBatch(believeTask, task, nbThreads);
+
+	THEGAME_TRACE_END(THEGAME_TRACE_TRANSFORMATION);
+	return task.to;
+}
+
+void BFB_transformMasses(const BFB_Matrix matrix, const float* masses, float* results, const int nbBF, const int nbThreads){
+	BatchTask task = {NULL, NULL, NULL, 0, NULL, NULL, 0, 0, 0, 0};
+	BFB_BeliefFromBelief bfb = {NULL, {NULL, 0}, NULL, 0, 0, {0, 0, NULL, NULL, NULL, NULL}};
+
+	if(matrix.nbRows == 0){
+		#ifdef CHECK_COMPATIBILITY
+		if(THEGAME_VALIDATING()){
+			THEGAME_reportError(THEGAME_CHECK_COMPATIBILITY, __func__, NULL, "the matrix is not compiled");
 		}
+		#endif
+		return;
 	}
-	Sets_freeElement(&emptyset);
-	
-	#ifdef CHECK_VALUES
-    if(BF_checkValues(bf)){
-    	printf("debug: in BFB_believeFromBelief(), at least one value is not valid!\n");
-    }
-	#endif
-	
-	#ifdef CHECK_SUM
-	if(BF_checkSum(bf)){
-    	printf("debug: Frame name = %s\n", bfb.frameName);
-        printf("debug: in BFB_beliefFromBelief(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
-        printf("debug: Resulting belief function:\n");
-        for(i = 0; i < bf.nbFocals; i++){
-        	printf("debug: ");
-        	for(j = 0; j < elementSize; j++){
-        		printf("%d", bf.focals[i].element.values[j]);
-        	}
-        	printf(" : %f\n", bf.focals[i].beliefValue);
-        }
-    }
-	#endif
-	
-	return bf;
+	bfb.matrix = matrix;
+	task.bfb = &bfb;
+	task.masses = masses;
+	task.results = results;
+	task.nbBF = nbBF;
+	runBatch(transformTask, task, nbThreads);
+}
+
+/** @} */
+
+
+/**
+ * @name Memory usage
+ * @{
+ */
+
+BFB_MemoryUsage BFB_memoryUsage(const BFB_BeliefStructure bs){
+	BFB_MemoryUsage usage = {0, 0, 0, 0, 0};
+	BFB_MemoryUsage model;
+	int i = 0;
+
+	if(bs.frameName != NULL){
+		usage.names = strlen(bs.frameName) + 1;
+	}
+	usage.refLists = Sets_referenceListMemoryUsage(bs.refList);
+	usage.vectors = sizeof(BFB_BeliefFromBelief) * bs.nbBeliefs;
+	for(i = 0; i < bs.nbBeliefs; i++){
+		model = BFB_beliefFromBeliefMemoryUsage(bs.beliefs[i], bs.refList.card);
+		usage.names += model.names;
+		usage.refLists += model.refLists;
+		usage.vectors += model.vectors;
+		usage.matrices += model.matrices;
+	}
+	usage.total = usage.names + usage.refLists + usage.vectors + usage.matrices;
+
+	return usage;
+}
+
+BFB_MemoryUsage BFB_beliefFromBeliefMemoryUsage(const BFB_BeliefFromBelief bfb, const int elementSize){
+	BFB_MemoryUsage usage = {0, 0, 0, 0, 0};
+	int i = 0;
+
+	if(bfb.frameName != NULL){
+		usage.names = strlen(bfb.frameName) + 1;
+	}
+	usage.refLists = Sets_referenceListMemoryUsage(bfb.refList);
+	usage.vectors = sizeof(BFB_BeliefVector) * bfb.nbVectors;
+	for(i = 0; i < bfb.nbVectors; i++){
+		usage.vectors += sizeof(char) * bfb.refList.card
+				+ (sizeof(Sets_Element) + sizeof(char) * elementSize + sizeof(float)) * bfb.vectors[i].nbTos;
+	}
+	/*The entries in use (a composed matrix may have some more capacity): */
+	if(bfb.matrix.rowStarts != NULL){
+		usage.matrices = sizeof(int) * (bfb.matrix.nbRows + 1)
+				+ (sizeof(int) + sizeof(float)) * bfb.matrix.rowStarts[bfb.matrix.nbRows];
+	}
+	if(bfb.matrix.dense != NULL){
+		usage.matrices += sizeof(float) * bfb.matrix.nbRows * bfb.matrix.nbColumns;
+	}
+	usage.total = usage.names + usage.refLists + usage.vectors + usage.matrices;
+
+	return usage;
 }
 
 /** @} */
@@ -414,34 +1074,48 @@ BF_BeliefFunction BFB_believeFromBelief(const BFB_BeliefFromBelief bfb, const BF
 void BFB_freeBeliefStructure(BFB_BeliefStructure* bs){
 	int i = 0;
 	
-	free(bs->frameName);
+	Memory_free(bs->frameName);
 	Sets_freeReferenceList(&(bs->refList));
 	for(i = 0; i < bs->nbBeliefs; i++){
 		BFB_freeBeliefFromBelief(&(bs->beliefs[i]));
 	}
-	free(bs->beliefs);
+	Memory_free(bs->beliefs);
 }
 
 void BFB_freeBeliefFromBelief(BFB_BeliefFromBelief* bfb){
 	int i = 0;
 	
-	free(bfb->frameName);
+	Memory_free(bfb->frameName);
 	Sets_freeReferenceList(&(bfb->refList));
 	for(i = 0; i < bfb->nbVectors; i++){
 		BFB_freeBeliefVector(&(bfb->vectors[i]));
 	}
-	free(bfb->vectors);
+	Memory_free(bfb->vectors);
+	BFB_freeMatrix(&(bfb->matrix));
 }
 
 void BFB_freeBeliefVector(BFB_BeliefVector* bv){
 	int i = 0;
 	
-	free(bv->factors);
+	Memory_free(bv->factors);
 	Sets_freeElement(&(bv->from));
 	for(i = 0; i < bv->nbTos; i++){
 		Sets_freeElement(&(bv->to[i]));
 	}
-	free(bv->to);
+	Memory_free(bv->to);
+}
+
+void BFB_freeMatrix(BFB_Matrix* matrix){
+	Memory_free(matrix->rowStarts);
+	Memory_free(matrix->columns);
+	Memory_free(matrix->factors);
+	Memory_free(matrix->dense);
+	matrix->rowStarts = NULL;
+	matrix->columns = NULL;
+	matrix->factors = NULL;
+	matrix->dense = NULL;
+	matrix->nbRows = 0;
+	matrix->nbColumns = 0;
 }
 
 /** @} */
@@ -458,7 +1132,7 @@ char* BFB_beliefStructureToString(const BFB_BeliefStructure bs){
 	int i = 0, totChar = 0;
 	int len = 0;
 	
-	beliefs = malloc(sizeof(char*) * bs.nbBeliefs);
+	beliefs = Memory_malloc(sizeof(char*) * bs.nbBeliefs);
 	DEBUG_CHECK_MALLOC(beliefs);
 
 	for(i = 0; i < bs.nbBeliefs; i++){
@@ -470,7 +1144,7 @@ char* BFB_beliefStructureToString(const BFB_BeliefStructure bs){
 	totChar += (strlen(bs.frameName) + 5) * 3 + 1;
 	
 	/*Print: */
-	str = malloc(sizeof(char) * (totChar+1));
+	str = Memory_malloc(sizeof(char) * (totChar+1));
 	DEBUG_CHECK_MALLOC(str);
 
 	strcpy(str, "*");
@@ -490,9 +1164,9 @@ char* BFB_beliefStructureToString(const BFB_BeliefStructure bs){
 	}
 	
 	for(i = 0; i < bs.nbBeliefs; i++){
-		free(beliefs[i]);
+		Memory_free(beliefs[i]);
 	}
-	free(beliefs);
+	Memory_free(beliefs);
 	
 	return str;
 }
@@ -505,7 +1179,7 @@ char* BFB_beliefFromBeliefToString(const BFB_BeliefFromBelief bfb, const Sets_Re
 	int len = 0;
 	
 	/*Vectors' strings: */
-	vectors = malloc(sizeof(char*) * bfb.nbVectors);
+	vectors = Memory_malloc(sizeof(char*) * bfb.nbVectors);
 	DEBUG_CHECK_MALLOC(vectors);
 
 	for(i = 0; i < bfb.nbVectors; i++){
@@ -524,7 +1198,7 @@ char* BFB_beliefFromBeliefToString(const BFB_BeliefFromBelief bfb, const Sets_Re
 	totChar += (strlen(bfb.frameName) + 12) * 2 + strlen(str2) + strlen(str3) + 17;/* + bfb.nbVectors; */
 	
 	/*Print: */
-	str = malloc(sizeof(char) * (totChar+1));
+	str = Memory_malloc(sizeof(char) * (totChar+1));
 	DEBUG_CHECK_MALLOC(str);
 
 	sprintf(str, "Subframe %s :\n", bfb.frameName);
@@ -545,14 +1219,14 @@ char* BFB_beliefFromBeliefToString(const BFB_BeliefFromBelief bfb, const Sets_Re
 	strcat(str, "\0");
 	
 	/*Free: */
-	free(str2);
-	free(str3);
+	Memory_free(str2);
+	Memory_free(str3);
 	Sets_freeSet(&valuesFrom);
 	Sets_freeSet(&valuesTo);
 	for(i = 0; i < bfb.nbVectors; i++){
-		free(vectors[i]);
+		Memory_free(vectors[i]);
 	}
-	free(vectors);
+	Memory_free(vectors);
 	
 	return str;
 }
@@ -565,16 +1239,16 @@ char* BFB_beliefVectorToString(const BFB_BeliefVector bv, const Sets_ReferenceLi
 	
 	elem = Sets_elementToString(bv.from, from);
 	sprintf(temp2, "From %s to :\n", elem);
-	free(elem);
+	Memory_free(elem);
 	
 	for(i = 0; i < bv.nbTos; i++){
 		elem = Sets_elementToString(bv.to[i], to);
 		sprintf(temp, " --> %s : %f\n", elem, bv.factors[i]);
 		strcat(temp2, temp);
-		free(elem);
+		Memory_free(elem);
 	}
 	
-	str = malloc(sizeof(char) * (strlen(temp2) + 1));
+	str = Memory_malloc(sizeof(char) * (strlen(temp2) + 1));
 	DEBUG_CHECK_MALLOC(str);
 
 	strcpy(str, temp2);
@@ -18,6 +18,7 @@
 
 
 #include "BeliefsFromRandomness.h"
+#include "Checks.h"
 
 /**
  * This module provides with methods to randomly generate mass functions. It is roughly based on common
@@ -29,7 +30,174 @@
  * @brief APPLICATION: Gives structures and main
  *        functions to create random belief functions.
  */
- 
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/**
+ * A set of distinct non-null 64 bits numbers (open addressing, linear probing).
+ */
+struct NumberSet {
+	/** The slots (0 if empty) */
+	uint64_t* slots;
+	/** The number of slots minus 1 (a power of 2 minus 1) */
+	uint64_t mask;
+};
+
+static struct NumberSet createNumberSet(const int nbNumbers){
+	struct NumberSet set = {NULL, 0};
+	uint64_t nbSlots = 16;
+
+	while(nbSlots < 2 * (uint64_t)nbNumbers){
+		nbSlots <<= 1;
+	}
+	set.slots = Memory_calloc(nbSlots, sizeof(uint64_t));
+	DEBUG_CHECK_MALLOC(set.slots);
+	set.mask = nbSlots - 1;
+
+	return set;
+}
+
+/**
+ * Adds a number to the set.
+ * @return 1 if the number has been added, 0 if it was already in the set.
+ */
+static int addNumber(struct NumberSet* set, const uint64_t number){
+	uint64_t slot = (number * UINT64_C(0x9e3779b97f4a7c15)) >> 32 & set->mask;
+
+	while(set->slots[slot] != 0){
+		if(set->slots[slot] == number){
+			return 0;
+		}
+		slot = (slot + 1) & set->mask;
+	}
+	set->slots[slot] = number;
+
+	return 1;
+}
+
+static uint64_t rotateLeft(const uint64_t x, const int k){
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitMix(uint64_t* x){
+	uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+	z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+	return z ^ (z >> 31);
+}
+
+/**
+ * Draws a number following the standard normal distribution (Box-Muller).
+ */
+static double normal(BFR_Random* random){
+	double u = 1 - BFR_uniform(random);
+	double v = BFR_uniform(random);
+
+	return sqrt(-2 * log(u)) * cos(2 * 3.14159265358979323846 * v);
+}
+
+/**
+ * Draws nbNumbers distinct numbers in [0, range[ with Floyd's algorithm (nbNumbers draws, no rejection).
+ * @param numbers The array receiving the numbers (in drawing order)
+ */
+static void drawDistinctNumbers(BFR_Random* random, const int nbNumbers, const uint64_t range, uint64_t* numbers){
+	struct NumberSet set = createNumberSet(nbNumbers);
+	uint64_t j = 0, t = 0;
+	int i = 0;
+
+	/*Numbers are stored plus one as 0 marks empty slots: */
+	for(j = range - nbNumbers; j < range; j++){
+		t = BFR_uniformInteger(random, j + 1);
+		if(!addNumber(&set, t + 1)){
+			t = j;
+			addNumber(&set, t + 1);
+		}
+		numbers[i] = t;
+		i++;
+	}
+	Memory_free(set.slots);
+}
+
+/**
+ * Draws masses following a symmetric Dirichlet distribution (normalized gamma variables).
+ */
+static void drawMasses(BFR_Random* random, const int nbMasses, const double alpha, BF_BeliefFunction* bf){
+	double* gammas = Memory_malloc(sizeof(double) * nbMasses);
+	double sum = 0;
+	int i = 0;
+
+	DEBUG_CHECK_MALLOC(gammas);
+	for(i = 0; i < nbMasses; i++){
+		gammas[i] = BFR_gamma(random, alpha);
+		sum += gammas[i];
+	}
+	/*With very small alphas, every variable may underflow: */
+	if(sum <= 0){
+		gammas[BFR_uniformInteger(random, nbMasses)] = 1;
+		sum = 1;
+	}
+	for(i = 0; i < nbMasses; i++){
+		bf->focals[i].beliefValue = gammas[i] / sum;
+	}
+	Memory_free(gammas);
+}
+
+/**
+ * Sets a focal element of a flat function from its number.
+ */
+static void setElement(Sets_Element* element, const uint64_t number, const int elementSize){
+	int i = 0;
+
+	element->card = 0;
+	for(i = 0; i < elementSize; i++){
+		element->values[i] = (number >> i) & 1;
+		element->card += element->values[i];
+	}
+}
+
+/**
+ * Draws the number of an element of the given cardinality (partial Fisher-Yates shuffle of the atoms).
+ */
+static uint64_t drawElementOfCardinality(BFR_Random* random, int* atoms, const int elementSize, const int card){
+	uint64_t number = 0;
+	int i = 0, j = 0, tmp = 0;
+
+	for(i = 0; i < card; i++){
+		j = i + BFR_uniformInteger(random, elementSize - i);
+		tmp = atoms[i];
+		atoms[i] = atoms[j];
+		atoms[j] = tmp;
+		number |= UINT64_C(1) << atoms[i];
+	}
+
+	return number;
+}
+
+static int checkParameters(const char* function, const int elementSize, const int nbFocals, const double alpha){
+	if(elementSize < 1 || elementSize > BFR_MAX_SIZE || nbFocals < 1 || alpha <= 0){
+		#ifdef CHECK_VALUES
+		if(THEGAME_VALIDATING()){
+			THEGAME_reportError(THEGAME_CHECK_VALUES, function, NULL,
+					"invalid parameters (elementSize = %d, nbFocals = %d, alpha = %f)", elementSize, nbFocals, alpha);
+		}
+		#else
+		(void)function;
+		#endif
+		return 0;
+	}
+
+	return 1;
+}
+
+
+
 /**
  * @name Utility functions
  * @{
@@ -45,6 +213,106 @@ void BFR_generateRandomSeed(){
 	srand(tm->tm_sec + tm->tm_min*60 + tm->tm_hour*3600 + tm->tm_mday*86400);
 }
 
+
+
+BFR_Random BFR_createRandom(const uint64_t seed){
+	BFR_Random random;
+	uint64_t x = seed;
+	int i = 0;
+
+	for(i = 0; i < 4; i++){
+		random.state[i] = splitMix(&x);
+	}
+
+	return random;
+}
+
+
+
+void BFR_jump(BFR_Random* random){
+	static const uint64_t jump[] = {UINT64_C(0x180ec6d33cfd0aba), UINT64_C(0xd5a61266f0c9392c),
+			UINT64_C(0xa9582618e03fc9aa), UINT64_C(0x39abdc4529b1661c)};
+	uint64_t s[4] = {0, 0, 0, 0};
+	int i = 0, b = 0;
+
+	for(i = 0; i < 4; i++){
+		for(b = 0; b < 64; b++){
+			if(jump[i] & UINT64_C(1) << b){
+				s[0] ^= random->state[0];
+				s[1] ^= random->state[1];
+				s[2] ^= random->state[2];
+				s[3] ^= random->state[3];
+			}
+			BFR_next(random);
+		}
+	}
+	for(i = 0; i < 4; i++){
+		random->state[i] = s[i];
+	}
+}
+
+
+
+uint64_t BFR_next(BFR_Random* random){
+	uint64_t* s = random->state;
+	uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotateLeft(s[3], 45);
+
+	return result;
+}
+
+
+
+double BFR_uniform(BFR_Random* random){
+	/*53 bits of mantissa: */
+	return (BFR_next(random) >> 11) * (1.0 / (UINT64_C(1) << 53));
+}
+
+
+
+uint64_t BFR_uniformInteger(BFR_Random* random, const uint64_t bound){
+	/*Rejects the lowest (2^64 mod bound) numbers to avoid the modulo bias: */
+	uint64_t threshold = (0 - bound) % bound;
+	uint64_t r = BFR_next(random);
+
+	while(r < threshold){
+		r = BFR_next(random);
+	}
+
+	return r % bound;
+}
+
+
+
+double BFR_gamma(BFR_Random* random, const double shape){
+	double d = 0, c = 0, x = 0, v = 0, u = 0;
+
+	/*Gamma(a) = Gamma(a + 1) * U^(1 / a) for a < 1: */
+	if(shape < 1){
+		return BFR_gamma(random, shape + 1) * pow(1 - BFR_uniform(random), 1 / shape);
+	}
+	d = shape - 1.0 / 3;
+	c = 1 / sqrt(9 * d);
+	while(1){
+		do {
+			x = normal(random);
+			v = 1 + c * x;
+		} while(v <= 0);
+		v = v * v * v;
+		u = 1 - BFR_uniform(random);
+		if(u < 1 - 0.0331 * x * x * x * x || log(u) < 0.5 * x * x + d * (1 - v + log(v))){
+			return d * v;
+		}
+	}
+}
+
 /**@}*/
 
 /**
@@ -60,8 +328,8 @@ BF_BeliefFunction BFR_getCrappyRandomBelief(const int elementSize){
 	
 	bf.elementSize = elementSize;
 	bf.nbFocals = rand() % (int)(pow(2, elementSize));
-	bf.focals = malloc(sizeof(BF_FocalElement) * bf.nbFocals);
-	elementNumbers = malloc(sizeof(int) * bf.nbFocals);
+	bf.focals = Memory_malloc(sizeof(BF_FocalElement) * bf.nbFocals);
+	elementNumbers = Memory_malloc(sizeof(int) * bf.nbFocals);
 	for(i = 0; i < bf.nbFocals; i++){
 		valid = 0;
 		while(!valid){
@@ -77,7 +345,7 @@ BF_BeliefFunction BFR_getCrappyRandomBelief(const int elementSize){
 		bf.focals[i].beliefValue = (float)rand() / RAND_MAX;
 	}
 	
-	free(elementNumbers);
+	Memory_free(elementNumbers);
 	BF_normalize(&bf);
 	
 	return bf;
@@ -93,8 +361,8 @@ BF_BeliefFunction BFR_getCrappyRandomBeliefWithFixedNbFocals(const int elementSi
 	if(nbFocals <= pow(2, elementSize)){
 		bf.elementSize = elementSize;
 		bf.nbFocals = nbFocals;
-		bf.focals = malloc(sizeof(BF_FocalElement) * nbFocals);
-		elementNumbers = malloc(sizeof(int) * nbFocals);
+		bf.focals = Memory_malloc(sizeof(BF_FocalElement) * nbFocals);
+		elementNumbers = Memory_malloc(sizeof(int) * nbFocals);
 		for(i = 0; i < bf.nbFocals; i++){
 			valid = 0;
 			while(!valid){
@@ -109,7 +377,7 @@ BF_BeliefFunction BFR_getCrappyRandomBeliefWithFixedNbFocals(const int elementSi
 			bf.focals[i].element = Sets_elementFromNumber(elementNumbers[i], elementSize);
 			bf.focals[i].beliefValue = (float)rand() / RAND_MAX;
 		}
-		free(elementNumbers);
+		Memory_free(elementNumbers);
 		BF_normalize(&bf);
 	}
 	
@@ -120,4 +388,187 @@ BF_BeliefFunction BFR_getCrappyRandomBeliefWithFixedNbFocals(const int elementSi
 /**@}*/
 
 
+/**
+ * @name Seeded random generators
+ * @{
+ */
+
+BF_BeliefFunction BFR_getRandomBelief(BFR_Random* random, const int elementSize, const int nbFocals, const double alpha){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	uint64_t* numbers = NULL;
+	uint64_t nbSubsets = 0;
+	int i = 0;
 
+	if(!checkParameters("BFR_getRandomBelief", elementSize, nbFocals, alpha)){
+		return bf;
+	}
+	nbSubsets = (UINT64_C(1) << elementSize) - 1;
+	if((uint64_t)nbFocals > nbSubsets){
+		return bf;
+	}
+
+	numbers = Memory_malloc(sizeof(uint64_t) * nbFocals);
+	DEBUG_CHECK_MALLOC(numbers);
+	drawDistinctNumbers(random, nbFocals, nbSubsets, numbers);
+	bf = BF_allocateBeliefFunction(nbFocals, elementSize);
+	for(i = 0; i < nbFocals; i++){
+		/*Non-empty subsets: */
+		setElement(&(bf.focals[i].element), numbers[i] + 1, elementSize);
+	}
+	drawMasses(random, nbFocals, alpha, &bf);
+	Memory_free(numbers);
+
+	return bf;
+}
+
+
+
+BF_BeliefFunction BFR_getRandomBayesianBelief(BFR_Random* random, const int elementSize, const int nbFocals, const double alpha){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	uint64_t* atoms = NULL;
+	int i = 0;
+
+	if(!checkParameters("BFR_getRandomBayesianBelief", elementSize, nbFocals, alpha) || nbFocals > elementSize){
+		return bf;
+	}
+
+	atoms = Memory_malloc(sizeof(uint64_t) * nbFocals);
+	DEBUG_CHECK_MALLOC(atoms);
+	drawDistinctNumbers(random, nbFocals, elementSize, atoms);
+	bf = BF_allocateBeliefFunction(nbFocals, elementSize);
+	for(i = 0; i < nbFocals; i++){
+		setElement(&(bf.focals[i].element), UINT64_C(1) << atoms[i], elementSize);
+	}
+	drawMasses(random, nbFocals, alpha, &bf);
+	Memory_free(atoms);
+
+	return bf;
+}
+
+
+
+BF_BeliefFunction BFR_getRandomConsonantBelief(BFR_Random* random, const int elementSize, const int nbFocals, const double alpha){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	uint64_t* cards = NULL;
+	uint64_t tmp = 0, number = 0;
+	int* atoms = NULL;
+	int i = 0, j = 0;
+
+	if(!checkParameters("BFR_getRandomConsonantBelief", elementSize, nbFocals, alpha) || nbFocals > elementSize){
+		return bf;
+	}
+
+	/*Distinct cardinalities, sorted: */
+	cards = Memory_malloc(sizeof(uint64_t) * nbFocals);
+	DEBUG_CHECK_MALLOC(cards);
+	drawDistinctNumbers(random, nbFocals, elementSize, cards);
+	for(i = 1; i < nbFocals; i++){
+		tmp = cards[i];
+		for(j = i; j > 0 && cards[j - 1] > tmp; j--){
+			cards[j] = cards[j - 1];
+		}
+		cards[j] = tmp;
+	}
+	/*The focal elements are the prefixes of a random order of the atoms: */
+	atoms = Memory_malloc(sizeof(int) * elementSize);
+	DEBUG_CHECK_MALLOC(atoms);
+	for(i = 0; i < elementSize; i++){
+		atoms[i] = i;
+	}
+	drawElementOfCardinality(random, atoms, elementSize, elementSize);
+	bf = BF_allocateBeliefFunction(nbFocals, elementSize);
+	j = 0;
+	for(i = 0; i < nbFocals; i++){
+		for(; (uint64_t)j <= cards[i]; j++){
+			number |= UINT64_C(1) << atoms[j];
+		}
+		setElement(&(bf.focals[i].element), number, elementSize);
+	}
+	drawMasses(random, nbFocals, alpha, &bf);
+	Memory_free(cards);
+	Memory_free(atoms);
+
+	return bf;
+}
+
+
+
+BF_BeliefFunction BFR_getRandomSimpleSupportBelief(BFR_Random* random, const int elementSize){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	uint64_t complete = 0;
+
+	if(!checkParameters("BFR_getRandomSimpleSupportBelief", elementSize, 2, 1) || elementSize < 2){
+		return bf;
+	}
+
+	complete = (UINT64_C(1) << elementSize) - 1;
+	bf = BF_allocateBeliefFunction(2, elementSize);
+	/*Neither the empty set nor the complete set: */
+	setElement(&(bf.focals[0].element), BFR_uniformInteger(random, complete - 1) + 1, elementSize);
+	setElement(&(bf.focals[1].element), complete, elementSize);
+	bf.focals[0].beliefValue = BFR_uniform(random);
+	bf.focals[1].beliefValue = 1 - bf.focals[0].beliefValue;
+
+	return bf;
+}
+
+
+
+BF_BeliefFunction BFR_getRandomBeliefWithProfile(BFR_Random* random, const int elementSize, const int nbFocals,
+		const double* profile, const double alpha){
+	BF_BeliefFunction bf = {NULL, 0, 0};
+	struct NumberSet set = {NULL, 0};
+	uint64_t* numbers = NULL;
+	double totalWeight = 0, weight = 0;
+	int* atoms = NULL;
+	int i = 0, card = 0, nbDraws = 0, nbNumbers = 0;
+
+	if(!checkParameters("BFR_getRandomBeliefWithProfile", elementSize, nbFocals, alpha)){
+		return bf;
+	}
+	for(i = 0; i < elementSize; i++){
+		if(profile[i] > 0){
+			totalWeight += profile[i];
+		}
+	}
+	if(totalWeight <= 0){
+		return bf;
+	}
+
+	set = createNumberSet(nbFocals);
+	numbers = Memory_malloc(sizeof(uint64_t) * nbFocals);
+	DEBUG_CHECK_MALLOC(numbers);
+	atoms = Memory_malloc(sizeof(int) * elementSize);
+	DEBUG_CHECK_MALLOC(atoms);
+	for(i = 0; i < elementSize; i++){
+		atoms[i] = i;
+	}
+	for(nbDraws = 0; nbNumbers < nbFocals && nbDraws < 8 * nbFocals; nbDraws++){
+		/*Cardinality, then an element of that cardinality: */
+		weight = BFR_uniform(random) * totalWeight;
+		card = 0;
+		for(i = 1; i <= elementSize && (card == 0 || weight >= 0); i++){
+			if(profile[i - 1] > 0){
+				card = i;
+				weight -= profile[i - 1];
+			}
+		}
+		numbers[nbNumbers] = drawElementOfCardinality(random, atoms, elementSize, card);
+		if(addNumber(&set, numbers[nbNumbers])){
+			nbNumbers++;
+		}
+	}
+
+	bf = BF_allocateBeliefFunction(nbNumbers, elementSize);
+	for(i = 0; i < nbNumbers; i++){
+		setElement(&(bf.focals[i].element), numbers[i], elementSize);
+	}
+	drawMasses(random, nbNumbers, alpha, &bf);
+	Memory_free(set.slots);
+	Memory_free(numbers);
+	Memory_free(atoms);
+
+	return bf;
+}
+
+/**@}*/
@@ -16,6 +16,8 @@
 
 
 #include "BeliefsFromSensors.h"
+#include "Tracing.h"
+#include "Checks.h"
 
 
 /**
@@ -118,7 +120,7 @@
 BFS_BeliefStructure BFS_createBeliefStructure(const char* name, const char * const * possibleValues,
 		int size) {
 	BFS_BeliefStructure beliefStructure;
-	beliefStructure.frameName = strdup(name);
+	beliefStructure.frameName = Memory_strdup(name);
 	beliefStructure.refList = Sets_createRefListFromArray(possibleValues, size);
 	beliefStructure.powerset = Sets_generatePowerSet(size);
 	beliefStructure.possibleValues = Sets_createSetFromRefList(beliefStructure.refList);
@@ -130,7 +132,7 @@ BFS_BeliefStructure BFS_createBeliefStructure(const char* name, const char * con
 void BFS_putSensorBelief(BFS_BeliefStructure *beliefStructure,
 		__attribute__((unused))const BFS_SensorBeliefs sensorBelief) {
 	BFS_SensorBeliefs *newSensorBelief;
-	newSensorBelief = realloc(beliefStructure->beliefs,
+	newSensorBelief = Memory_realloc(beliefStructure->beliefs,
 			sizeof(BFS_SensorBeliefs) * (beliefStructure->nbSensors + 1));
 	newSensorBelief[beliefStructure->nbSensors] = sensorBelief;
 	beliefStructure->beliefs = newSensorBelief;
@@ -140,7 +142,7 @@ void BFS_putSensorBelief(BFS_BeliefStructure *beliefStructure,
 
 BFS_SensorBeliefs BFS_createSensorBeliefs(const char* sensorType) {
 	BFS_SensorBeliefs sensorBeliefs;
-	sensorBeliefs.sensorType = strdup(sensorType);
+	sensorBeliefs.sensorType = Memory_strdup(sensorType);
 	sensorBeliefs.optionFlags = OP_NONE;
 	sensorBeliefs.nbOptions = 0;
 	sensorBeliefs.nbFocal = 0;
@@ -181,18 +183,19 @@ static BFS_Option BFS_createOption(BFS_OptionFlags flag, float param) {
 	BFS_Option option;
 	option.parameter = param;
 	option.type = flag;
+	option.allocator = Memory_getAllocator();
 
 	switch(flag) {
 	case OP_TEMPO_FUSION:
 	case OP_TEMPO_SPECIFICITY:
-		option.util = malloc(sizeof(BFS_Option) * 2);
+		option.util = Memory_malloc(sizeof(BFS_UtilData) * 2);
 		clock_gettime(CLOCK_ID, &(option.util[0].time));
 		option.util[1].bf.nbFocals = 0;
 		option.util[1].bf.focals = NULL;
 		option.util[1].bf.elementSize = 0;
 		break;
 	case OP_VARIATION:
-		option.util = calloc(param, sizeof(BFS_Option));
+		option.util = Memory_calloc(param, sizeof(BFS_UtilData));
 		option.parameter = (int)param;
 		break;
 	case OP_NONE:
@@ -206,7 +209,7 @@ void BFS_addOption(BFS_SensorBeliefs *sensorBeliefs, BFS_OptionFlags flag, float
 	BFS_Option *options;
 	if(OP_NONE == flag) return;
 
-	options= realloc(sensorBeliefs->options, sizeof(BFS_Option) * (sensorBeliefs->nbOptions + 1));
+	options= Memory_realloc(sensorBeliefs->options, sizeof(BFS_Option) * (sensorBeliefs->nbOptions + 1));
 	DEBUG_CHECK_MALLOC(options);
 
 	sensorBeliefs->optionFlags |= flag;
@@ -220,7 +223,7 @@ static BFS_PartOfBelief BFS_createPartOfBelief(Sets_Element elem, int elemSize,
 	BFS_PartOfBelief newPartofBelief;
 	newPartofBelief.focalElement = Sets_copyElement(elem, elemSize);
 	newPartofBelief.nbPts = 1;
-	newPartofBelief.points = malloc(sizeof(BFS_Point));
+	newPartofBelief.points = Memory_malloc(sizeof(BFS_Point));
 	newPartofBelief.points[0].belief = mass;
 	newPartofBelief.points[0].sensorValue = sensorValue;
 
@@ -230,7 +233,7 @@ static BFS_PartOfBelief BFS_createPartOfBelief(Sets_Element elem, int elemSize,
 static void insertNewFocal(BFS_SensorBeliefs* sensorBeliefs, const Sets_Element elem,
 		int elemSize, float sensorValue, float mass) {
 
-	BFS_PartOfBelief *newPartofBeliefs = realloc(sensorBeliefs->beliefOnElements,
+	BFS_PartOfBelief *newPartofBeliefs = Memory_realloc(sensorBeliefs->beliefOnElements,
 			sizeof(BFS_PartOfBelief) * (sensorBeliefs->nbFocal + 1));
 	DEBUG_CHECK_MALLOC(newPartofBeliefs);
 
@@ -254,7 +257,7 @@ static BFS_PartOfBelief * getPartOfBelief(BFS_SensorBeliefs *sensorBeliefs,
 
 static void insertExistingFocal(BFS_PartOfBelief *existingBelief, float sensorValue, float mass) {
 	int i = 0;
-	BFS_Point *newPoints = realloc(existingBelief->points,
+	BFS_Point *newPoints = Memory_realloc(existingBelief->points,
 			sizeof(BFS_Point) * (existingBelief->nbPts + 1));
 	DEBUG_CHECK_MALLOC(newPoints);
 
@@ -308,12 +311,13 @@ BFS_BeliefStructure BFS_loadBeliefStructure(const char* directory, const char* f
     char** directories = NULL;
     int i = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_LOADING);
     /*Test if the CA exists: */
     strcpy(path, directory);       /* The directory where to find the CAs */
     strcat(path, frameName);      /* The name of the CA */
     if(ReadDir_isDirectory(path)){
         /*Copy the context attribute name: */
-        bs.frameName = malloc(sizeof(char)*(strlen(frameName) + 1));
+        bs.frameName = Memory_malloc(sizeof(char)*(strlen(frameName) + 1));
         DEBUG_CHECK_MALLOC(bs.frameName);
 
         strcpy(bs.frameName, frameName);
@@ -335,7 +339,7 @@ BFS_BeliefStructure BFS_loadBeliefStructure(const char* directory, const char* f
         charsPerDir = ReadDir_charsPerDirectory(path, bs.nbSensors);
         directories = ReadDir_getDirectories(path, bs.nbSensors, charsPerDir);
         /*Load the sensors' beliefs: */
-        bs.beliefs = malloc(sizeof(BFS_SensorBeliefs)*bs.nbSensors);
+        bs.beliefs = Memory_malloc(sizeof(BFS_SensorBeliefs)*bs.nbSensors);
         DEBUG_CHECK_MALLOC(bs.beliefs);
 
         for(i = 0; i<bs.nbSensors; i++){
@@ -346,11 +350,11 @@ BFS_BeliefStructure BFS_loadBeliefStructure(const char* directory, const char* f
             bs.beliefs[i] = BFS_loadSensorBeliefs(directories[i], path, bs.refList);
         }
         /*Deallocate: */
-        free(charsPerDir);
+        Memory_free(charsPerDir);
         for(i = 0; i<bs.nbSensors; i++){
-            free(directories[i]);
+            Memory_free(directories[i]);
         }
-        free(directories);
+        Memory_free(directories);
     }
     #ifdef DEBUG
     else {
@@ -358,6 +362,7 @@ BFS_BeliefStructure BFS_loadBeliefStructure(const char* directory, const char* f
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_LOADING);
     return bs;
 }
 
@@ -374,10 +379,10 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
     #endif
 
     if(ReadDir_isDirectory(path)){
-    	temp = malloc(sizeof(char) * MAX_STR_LEN);
-    	temp2 = malloc(sizeof(char) * MAX_STR_LEN);
+    	temp = Memory_malloc(sizeof(char) * MAX_STR_LEN);
+    	temp2 = Memory_malloc(sizeof(char) * MAX_STR_LEN);
         /*Sensor type: */
-        sb.sensorType = malloc(sizeof(char)*(strlen(sensorType)+1));
+        sb.sensorType = Memory_malloc(sizeof(char)*(strlen(sensorType)+1));
         DEBUG_CHECK_MALLOC(sb.sensorType);
 
         strcpy(sb.sensorType, sensorType);
@@ -402,7 +407,7 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
         }
         sb.optionFlags = OP_NONE;
         /*Load the files: */
-        sb.beliefOnElements = malloc(sizeof(BFS_PartOfBelief)*sb.nbFocal);
+        sb.beliefOnElements = Memory_malloc(sizeof(BFS_PartOfBelief)*sb.nbFocal);
         DEBUG_CHECK_MALLOC(sb.beliefOnElements);
 
         for(i = 0; i<nbFiles; i++){
@@ -426,20 +431,21 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
                 }
                 /*Memory allocation : */
                 sb.nbOptions = atoi(lines[0]);
-                sb.options = malloc(sizeof(BFS_Option)*sb.nbOptions);
+                sb.options = Memory_malloc(sizeof(BFS_Option)*sb.nbOptions);
                 DEBUG_CHECK_MALLOC(sb.options);
 
                 for(j = 0; j < sb.nbOptions; j++){
                     sscanf(lines[1+j], "%s %s", temp, temp2);
                     sb.options[j].type = OP_NONE;
                     sb.options[j].parameter = atof(temp2);
+                    sb.options[j].allocator = Memory_getAllocator();
                     /* ------------------------------
                        Option specific parameters:
                        ------------------------------
                        Tempo-specificity:
                        Storage: time of the previous measure + a pointer to the previous BF_BeliefFunction*/
                     if(!strcmp(temp, "TEMPO-SPECIFICITY")){
-                        sb.options[j].util = malloc(sizeof(BFS_UtilData) * 2);
+                        sb.options[j].util = Memory_malloc(sizeof(BFS_UtilData) * 2);
                         DEBUG_CHECK_MALLOC(sb.options[j].util);
 
                         clock_gettime(CLOCK_ID, &(sb.options[j].util[0].time));
@@ -456,7 +462,7 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
                         if(sb.options[j].parameter == 0){
                             sb.options[j].parameter = 1;
                         }
-                        sb.options[j].util = malloc(sizeof(BFS_UtilData) * sb.options[j].parameter);
+                        sb.options[j].util = Memory_malloc(sizeof(BFS_UtilData) * sb.options[j].parameter);
                         DEBUG_CHECK_MALLOC(sb.options[j].util);
 
                         for(opIndex = 0; opIndex < sb.options[j].parameter; opIndex++){
@@ -467,7 +473,7 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
                     }
                     /*Tempo-fusion: */
                     else if(!strcmp(temp, "TEMPO-FUSION")){
-                    	sb.options[j].util = malloc(sizeof(BFS_UtilData) * 2);
+                    	sb.options[j].util = Memory_malloc(sizeof(BFS_UtilData) * 2);
                         DEBUG_CHECK_MALLOC(sb.options[j].util);
 
                         clock_gettime(CLOCK_ID, &(sb.options[j].util[0].time));
@@ -485,30 +491,29 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
                         #endif
                     }
                 }
-                free(charPerLine);
+                Memory_free(charPerLine);
                 for(j = 0; j < nbLines; j++){
-                	free(lines[j]);
+                	Memory_free(lines[j]);
                 }
-                free(lines);
+                Memory_free(lines);
             }
         }
         
         #ifdef CHECK_MODELS
-        if((sb.optionFlags & OP_TEMPO_SPECIFICITY) && (sb.optionFlags & OP_TEMPO_FUSION)){
-        	printf("debug: CHECK MODELS FAIL!\n");
-        	printf("debug: Two types of temporization are applied at the same time... It should not!\n");
-        	printf("debug: The behavior may be very strange!\n");
-        } 
+        if(THEGAME_VALIDATING() && (sb.optionFlags & OP_TEMPO_SPECIFICITY) && (sb.optionFlags & OP_TEMPO_FUSION)){
+        	THEGAME_reportError(THEGAME_CHECK_MODELS, __func__, NULL,
+        			"two types of temporization are applied at the same time in %s, the behavior may be very strange", path);
+        }
         #endif
         
         /*Deallocate: */
-        free(charsPerFile);
+        Memory_free(charsPerFile);
         for(i = 0; i<nbFiles; i++){
-            free(filenames[i]);
+            Memory_free(filenames[i]);
         }
-        free(filenames);
-        free(temp);
-        free(temp2);
+        Memory_free(filenames);
+        Memory_free(temp);
+        Memory_free(temp2);
     }
     #ifdef DEBUG
     else{
@@ -517,10 +522,10 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
     #endif
     
     #ifdef CHECK_MODELS
-    for(i = 0; i < sb.nbFocal; i++){
+    for(i = 0; THEGAME_VALIDATING() && i < sb.nbFocal; i++){
     	for(j = 0; j < sb.beliefOnElements[i].nbPts; j++){
     		projection.nbFocals = sb.nbFocal;
-    		projection.focals = malloc(sizeof(BF_FocalElement) * projection.nbFocals);
+    		projection.focals = Memory_malloc(sizeof(BF_FocalElement) * projection.nbFocals);
     		if(projection.focals == NULL){
     			printf("debug: malloc failed in BFS_loadSensorBeliefs() for \"projection.focals\".\n");
     		}
@@ -533,10 +538,8 @@ BFS_SensorBeliefs BFS_loadSensorBeliefs(const char* sensorType, const char* path
 			}
     		
     		if(BF_checkSum(projection)){
-    			printf("debug: MODEL CHECKING = FAIL!\n");
-    			printf("debug: One thing doesn't equal 1 where it should...\n");
-    			printf("debug: A wrong model has been given in %s\n", path);
-    			printf("debug: The error seems to appear for the sensor value %f\n", fakeMeasure);
+    			THEGAME_reportError(THEGAME_CHECK_MODELS, __func__, &projection,
+    					"the sum is not equal to 1 in %s for the sensor value %f", path, fakeMeasure);
     		}
     		
     		BF_freeBeliefFunction(&projection);
@@ -564,7 +567,7 @@ BFS_PartOfBelief BFS_loadPartOfBelief(const char* fileName, const Sets_Reference
         /*Nb of pts: */
         pob.nbPts = atoi(lines[1 + nbElements]);
         /*Create element: */
-        elements = malloc(sizeof(char*)*nbElements);
+        elements = Memory_malloc(sizeof(char*)*nbElements);
         DEBUG_CHECK_MALLOC(elements);
 
         for(i = 0; i<nbElements; i++){
@@ -572,19 +575,19 @@ BFS_PartOfBelief BFS_loadPartOfBelief(const char* fileName, const Sets_Reference
         }
         pob.focalElement = Sets_createElementFromStrings((const char* const * const)elements, nbElements, rl);
         /*Create pts: */
-        pob.points = malloc(sizeof(BFS_Point)*pob.nbPts);
+        pob.points = Memory_malloc(sizeof(BFS_Point)*pob.nbPts);
         DEBUG_CHECK_MALLOC(pob.points);
 
         for(i = 0; i<pob.nbPts; i++){
             sscanf(lines[2+nbElements+i], "%f %f", &(pob.points[i].sensorValue),&(pob.points[i].belief));
         }
         /*Deallocate: */
-        free(charsPerLin);
+        Memory_free(charsPerLin);
         for(i = 0; i<nbLines; i++){
-            free(lines[i]);
+            Memory_free(lines[i]);
         }
-        free(lines);
-        free(elements);
+        Memory_free(lines);
+        Memory_free(elements);
     }
     #ifdef DEBUG
     else{
@@ -593,11 +596,11 @@ BFS_PartOfBelief BFS_loadPartOfBelief(const char* fileName, const Sets_Reference
     #endif
     
     #ifdef CHECK_MODELS
-    for(i = 0; i < pob.nbPts - 1; i++){
+    for(i = 0; THEGAME_VALIDATING() && i < pob.nbPts - 1; i++){
     	if(!(pob.points[i].sensorValue < pob.points[i+1].sensorValue)){
-    		printf("debug: MODEL CHECKING = FAIL!\n");
-    		printf("debug: The values should be given in the right order in the beliefs from sensors models...\n");
-    		printf("debug: THe problem is in the file %s\n", fileName);
+    		THEGAME_reportError(THEGAME_CHECK_MODELS, __func__, NULL,
+    				"the values are not given in the right order in %s", fileName);
+    		break;
     	}
     }
     #endif
@@ -618,8 +621,9 @@ BF_BeliefFunction* BFS_getEvidence(const BFS_BeliefStructure bs,
     BF_BeliefFunction* evidences = NULL;
     int i = 0, j = 0, in = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_EVIDENCE);
     /*Memory allocation: */
-    evidences = malloc(sizeof(BF_BeliefFunction) * nbMeasures);
+    evidences = Memory_malloc(sizeof(BF_BeliefFunction) * nbMeasures);
     DEBUG_CHECK_MALLOC(evidences);
 
     /*Get the functions: */
@@ -636,6 +640,7 @@ BF_BeliefFunction* BFS_getEvidence(const BFS_BeliefStructure bs,
         }
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_EVIDENCE);
     return evidences;
 }
 
@@ -645,8 +650,9 @@ BF_BeliefFunction* BFS_getEvidenceElapsedTime(const BFS_BeliefStructure bs,
     BF_BeliefFunction* evidences = NULL;
     int i = 0, j = 0, in = 0;
 
+    THEGAME_TRACE_BEGIN(THEGAME_TRACE_EVIDENCE);
     /*Memory allocation: */
-    evidences = malloc(sizeof(BF_BeliefFunction) * nbMeasures);
+    evidences = Memory_malloc(sizeof(BF_BeliefFunction) * nbMeasures);
     DEBUG_CHECK_MALLOC(evidences);
 
     /*Get the functions: */
@@ -664,6 +670,7 @@ BF_BeliefFunction* BFS_getEvidenceElapsedTime(const BFS_BeliefStructure bs,
         }
     }
 
+    THEGAME_TRACE_END(THEGAME_TRACE_EVIDENCE);
     return evidences;
 }
 
@@ -675,14 +682,12 @@ BF_BeliefFunction BFS_getProjection(const BFS_SensorBeliefs sb, const double sen
     double modifiedMeasure = 0;
     int parameterIndex = 0;
     int i = 0;
-    #ifdef CHECK_SUM
-    int l = 0;
-    #endif
 	
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_PROJECTION);
 	if(sensorMeasure != NO_MEASURE){
 		/*Memory allocation: */
 		projection.nbFocals = sb.nbFocal;
-		projection.focals = malloc(sizeof(BF_FocalElement) * sb.nbFocal);
+		projection.focals = Memory_malloc(sizeof(BF_FocalElement) * sb.nbFocal);
 		DEBUG_CHECK_MALLOC(projection.focals);
 
 		projection.elementSize = elementSize;
@@ -742,7 +747,9 @@ BF_BeliefFunction BFS_getProjection(const BFS_SensorBeliefs sb, const double sen
             projection = temp;
         /*First measure: */
         }else{
+            Memory_pushAllocator(sb.options[parameterIndex].allocator);
             sb.options[parameterIndex].util[1].bf = BF_copyBeliefFunction(projection);
+            Memory_popAllocator();
             clock_gettime(CLOCK_ID, &(sb.options[parameterIndex].util[0].time));
         }
     }
@@ -769,32 +776,25 @@ BF_BeliefFunction BFS_getProjection(const BFS_SensorBeliefs sb, const double sen
             projection = temp;
         /*First measure: */
         }else{
+            Memory_pushAllocator(sb.options[parameterIndex].allocator);
             sb.options[parameterIndex].util[1].bf = BF_copyBeliefFunction(projection);
+            Memory_popAllocator();
             clock_gettime(CLOCK_ID, &(sb.options[parameterIndex].util[0].time));
         }
     }
 
     #ifdef CHECK_SUM
-    if(BF_checkSum(projection)){
-    	printf("debug: Sensor type = %s\n", sb.sensorType);
-    	printf("debug: Sensor measure = %f\n", sensorMeasure);
-        printf("debug: in BFS_getProjection(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
-        printf("debug: Resulting belief function:\n");
-        for(i = 0; i < projection.nbFocals; i++){
-        	printf("debug: ");
-        	for(l = 0; l < elementSize; l++){
-        		printf("%d", projection.focals[i].element.values[l]);
-        	}
-        	printf(" : %f\n", projection.focals[i].beliefValue);
-        }
+    if(THEGAME_VALIDATING() && BF_checkSum(projection)){
+        THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &projection, "the sum is not equal to 1");
     }
     #endif
     #ifdef CHECK_VALUES
-    if(BF_checkValues(projection)){
-    	printf("debug: in BFS_getProjection(), at least one value is not valid!\n");
+    if(THEGAME_VALIDATING() && BF_checkValues(projection)){
+        THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &projection, "at least one value is not valid");
     }
     #endif
 
+    THEGAME_TRACE_END(THEGAME_TRACE_PROJECTION);
     return projection;
 }
 
@@ -805,14 +805,12 @@ BF_BeliefFunction BFS_getProjectionElapsedTime(const BFS_SensorBeliefs sensorBel
 	double modifiedMeasure = 0;
 	int parameterIndex = 0;
 	int i = 0;
-	#ifdef CHECK_SUM
-	int l = 0;
-	#endif
 
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_PROJECTION);
 	if(sensorMeasure != NO_MEASURE){
 		/*Memory allocation: */
 		projection.nbFocals = sensorBelief.nbFocal;
-		projection.focals = malloc(sizeof(BF_FocalElement) * sensorBelief.nbFocal);
+		projection.focals = Memory_malloc(sizeof(BF_FocalElement) * sensorBelief.nbFocal);
 		DEBUG_CHECK_MALLOC(projection.focals);
 
 		projection.elementSize = elementSize;
@@ -873,7 +871,9 @@ BF_BeliefFunction BFS_getProjectionElapsedTime(const BFS_SensorBeliefs sensorBel
 			projection = temp;
 		/*First measure: */
 		}else{
+			Memory_pushAllocator(sensorBelief.options[parameterIndex].allocator);
 			sensorBelief.options[parameterIndex].util[1].bf = BF_copyBeliefFunction(projection);
+			Memory_popAllocator();
 		}
 	}
 	else if(sensorBelief.optionFlags & OP_TEMPO_FUSION){
@@ -893,31 +893,24 @@ BF_BeliefFunction BFS_getProjectionElapsedTime(const BFS_SensorBeliefs sensorBel
 			projection = temp;
 		/*First measure: */
 		}else{
+			Memory_pushAllocator(sensorBelief.options[parameterIndex].allocator);
 			sensorBelief.options[parameterIndex].util[1].bf = BF_copyBeliefFunction(projection);
+			Memory_popAllocator();
 		}
 	}
 
 	#ifdef CHECK_SUM
-	if(BF_checkSum(projection)){
-		printf("debug: Sensor type = %s\n", sensorBelief.sensorType);
-		printf("debug: Sensor measure = %f\n", sensorMeasure);
-		printf("debug: in BFS_getProjection(), the sum is not equal to 1.\ndebug: There may be a problem in the model.\n");
-		printf("debug: Resulting belief function:\n");
-		for(i = 0; i < projection.nbFocals; i++){
-			printf("debug: ");
-			for(l = 0; l < elementSize; l++){
-				printf("%d", projection.focals[i].element.values[l]);
-			}
-			printf(" : %f\n", projection.focals[i].beliefValue);
-		}
+	if(THEGAME_VALIDATING() && BF_checkSum(projection)){
+		THEGAME_reportError(THEGAME_CHECK_SUM, __func__, &projection, "the sum is not equal to 1");
 	}
 	#endif
 	#ifdef CHECK_VALUES
-	if(BF_checkValues(projection)){
-		printf("debug: in BFS_getProjection(), at least one value is not valid!\n");
+	if(THEGAME_VALIDATING() && BF_checkValues(projection)){
+		THEGAME_reportError(THEGAME_CHECK_VALUES, __func__, &projection, "at least one value is not valid");
 	}
 	#endif
 
+	THEGAME_TRACE_END(THEGAME_TRACE_PROJECTION);
 	return projection;
 }
 
@@ -1005,8 +998,11 @@ BF_BeliefFunction BFS_temporization_specificityElapsedTime(const BF_BeliefFuncti
     temp = BF_discounting(oldOne, alpha);
     /*Compare specificity: */
     if(BF_specificity(newOne) > BF_specificity(temp)){
+        /*The state stays with the allocator of the option: */
+        Memory_pushAllocator(op->allocator);
         BF_freeBeliefFunction(&(op->util[1].bf));
         op->util[1].bf = BF_copyBeliefFunction(newOne);
+        Memory_popAllocator();
         result = BF_copyBeliefFunction(newOne);
     }
     else {
@@ -1027,30 +1023,107 @@ BF_BeliefFunction BFS_temporization_fusion(const BF_BeliefFunction oldOne,
 BF_BeliefFunction BFS_temporization_fusionElapsedTime(const BF_BeliefFunction oldOne,
 		const BF_BeliefFunction newOne, const float timeFactor, BFS_Option* op, float elapsedTime) {
 	float alpha = 0;
-    BF_BeliefFunction temp = {NULL, 0, 0};
     BF_BeliefFunction result = {NULL, 0, 0};
-    
-    /*Compute the alpha factor:   */     
+
+    /*Compute the alpha factor:   */
     alpha = elapsedTime / timeFactor;
     /*If the new one corresponds to a loss of evidence:*/
     if(newOne.focals == NULL){
     	return BF_discounting(oldOne, alpha);
     }
-    /*Discount: */
-    temp = BF_discounting(oldOne, alpha);
-    /*Fuse the discounted old one with the new one: */
-    result = BF_DuboisPradeCombination(temp, newOne);
+    /*Discount the old one and fuse it with the new one in a single pass (as the state, with the allocator of the option): */
+    Memory_pushAllocator(op->allocator);
+    result = BF_discountedDuboisPradeCombination(oldOne, alpha, newOne);
     /*Clean as combination may create multiple elements...*/
     /*BF_cleanBeliefFunction(&result);*/
-    /*Save: */
+    /*Save (oldOne may be the saved state, so only free it now): */
     BF_freeBeliefFunction(&(op->util[1].bf));
-    op->util[1].bf = BF_copyBeliefFunction(result);
-    BF_freeBeliefFunction(&temp);
-    
-    return result;
+    op->util[1].bf = result;
+    Memory_popAllocator();
+
+    return BF_copyBeliefFunction(result);
+}
+
+const BF_BeliefFunction* BFS_temporization_fusionInPlace(const BF_BeliefFunction newOne,
+		const float timeFactor, BFS_Option* op, const float elapsedTime){
+    BF_BeliefFunction result = {NULL, 0, 0};
+    float alpha = elapsedTime / timeFactor;
+
+    /*The state stays with the allocator of the option: */
+    Memory_pushAllocator(op->allocator);
+    /*First measure: */
+    if(op->util[1].bf.focals == NULL){
+        if(newOne.focals != NULL){
+            op->util[1].bf = BF_copyBeliefFunction(newOne);
+        }
+    }
+    else {
+        /*Loss of evidence or new measure: */
+        if(newOne.focals == NULL){
+            result = BF_discounting(op->util[1].bf, alpha);
+        }
+        else {
+            result = BF_discountedDuboisPradeCombination(op->util[1].bf, alpha, newOne);
+        }
+        BF_freeBeliefFunction(&(op->util[1].bf));
+        op->util[1].bf = result;
+    }
+    Memory_popAllocator();
+
+    return &(op->util[1].bf);
 }
 
 
+/** @} */
+
+/**
+ * @name Memory usage
+ * @{
+ */
+
+BFS_MemoryUsage BFS_memoryUsage(const BFS_BeliefStructure bs){
+    BFS_MemoryUsage usage = {0, 0, 0, 0, 0, 0, 0, 0};
+    BFS_SensorBeliefs* sb = NULL;
+    BFS_Option* o = NULL;
+    int i = 0, j = 0;
+
+    if(bs.frameName != NULL){
+        usage.names = strlen(bs.frameName) + 1;
+    }
+    usage.refList = Sets_referenceListMemoryUsage(bs.refList);
+    usage.possibleValues = Sets_setMemoryUsage(bs.possibleValues, bs.refList.card);
+    usage.powerset = Sets_setMemoryUsage(bs.powerset, bs.refList.card);
+    usage.sensors = sizeof(BFS_SensorBeliefs) * bs.nbSensors;
+    for(i = 0; i < bs.nbSensors; i++){
+        sb = &(bs.beliefs[i]);
+        if(sb->sensorType != NULL){
+            usage.names += strlen(sb->sensorType) + 1;
+        }
+        usage.curves += sizeof(BFS_PartOfBelief) * sb->nbFocal;
+        for(j = 0; j < sb->nbFocal; j++){
+            usage.curves += sizeof(char) * bs.refList.card + sizeof(BFS_Point) * sb->beliefOnElements[j].nbPts;
+        }
+        usage.options += sizeof(BFS_Option) * sb->nbOptions;
+        for(j = 0; j < sb->nbOptions; j++){
+            o = &(sb->options[j]);
+            if(o->util == NULL){
+                continue;
+            }
+            /*Time of the last measure and last belief function, or the last measures: */
+            if((o->type & OP_TEMPO_SPECIFICITY) || (o->type & OP_TEMPO_FUSION)){
+                usage.options += sizeof(BFS_UtilData) * 2 + BF_memoryUsage(o->util[1].bf).total;
+            }
+            else if(o->type & OP_VARIATION){
+                usage.options += sizeof(BFS_UtilData) * (int)o->parameter;
+            }
+        }
+    }
+    usage.total = usage.names + usage.refList + usage.possibleValues + usage.powerset
+            + usage.sensors + usage.curves + usage.options;
+
+    return usage;
+}
+
 /** @} */
 
 /**
@@ -1065,7 +1138,7 @@ BF_BeliefFunction BFS_temporization_fusionElapsedTime(const BF_BeliefFunction ol
 void BFS_freeBeliefStructure(BFS_BeliefStructure* bs){
     int i = 0;
 
-    free(bs->frameName);
+    Memory_free(bs->frameName);
 
     Sets_freeReferenceList(&(bs->refList));
     Sets_freeSet(&(bs->possibleValues));
@@ -1073,32 +1146,34 @@ void BFS_freeBeliefStructure(BFS_BeliefStructure* bs){
     for(i = 0; i<bs->nbSensors; i++){
         BFS_freeSensorBeliefs(&(bs->beliefs)[i]);
     }
-    free(bs->beliefs);
+    Memory_free(bs->beliefs);
 }
 
 void BFS_freeOption(BFS_Option* o){
+    Memory_pushAllocator(o->allocator);
     if((o->type & OP_TEMPO_SPECIFICITY) || (o->type & OP_TEMPO_FUSION)){
     	BF_freeBeliefFunction(&(o->util[1].bf));
     }
-    free(o->util);
+    Memory_free(o->util);
+    Memory_popAllocator();
 }
 
 void BFS_freeSensorBeliefs(BFS_SensorBeliefs* sb){
     int i = 0;
 
-    free(sb->sensorType);
+    Memory_free(sb->sensorType);
     for(i = 0; i<sb->nbFocal; i++){
         BFS_freePartOfBelief(&(sb->beliefOnElements[i]));
     }
-    free(sb->beliefOnElements);
+    Memory_free(sb->beliefOnElements);
     for(i = 0; i<sb->nbOptions; i++){
         BFS_freeOption(&(sb->options[i]));
     }
-    free(sb->options);
+    Memory_free(sb->options);
 }
 
 void BFS_freePartOfBelief(BFS_PartOfBelief* pob){
-    free(pob->points);
+    Memory_free(pob->points);
     Sets_freeElement(&(pob->focalElement));
 }
 
@@ -1129,7 +1204,7 @@ char* BFS_partOfBeliefToString(const BFS_PartOfBelief pob, const Sets_ReferenceL
     }
 
     /*Fill the string: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     sprintf(str, "Focal: %s\nPoints:\n", elem);
@@ -1141,7 +1216,7 @@ char* BFS_partOfBeliefToString(const BFS_PartOfBelief pob, const Sets_ReferenceL
     strcat(str, "\0");
 
     /*Deallocate: */
-    free(elem);
+    Memory_free(elem);
 
     return str;
 }
@@ -1159,7 +1234,7 @@ char* BFS_optionToString(const BFS_Option o){
     else if(o.type & OP_TEMPO_FUSION){
     	sprintf(temp, "Tempo-fusion (%f)", o.parameter);
     }
-    str = malloc(sizeof(char)*strlen(temp)+1);
+    str = Memory_malloc(sizeof(char)*strlen(temp)+1);
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     strcpy(str, temp);
@@ -1175,7 +1250,7 @@ char* BFS_sensorBeliefsToString(const BFS_SensorBeliefs sb, const Sets_Reference
     char* separator = "---------------------\n";
 
     /*Get the strings of parts of belief: */
-    pobStr = malloc(sizeof(char*)*sb.nbFocal);
+    pobStr = Memory_malloc(sizeof(char*)*sb.nbFocal);
     DEBUG_CHECK_MALLOC_OR_RETURN(pobStr, NULL);
 
     for(i = 0; i<sb.nbFocal; i++){
@@ -1186,7 +1261,7 @@ char* BFS_sensorBeliefsToString(const BFS_SensorBeliefs sb, const Sets_Reference
     }
     /*Get the strings of options: */
     if(sb.nbOptions){
-        opStr = malloc(sizeof(char*)*sb.nbOptions);
+        opStr = Memory_malloc(sizeof(char*)*sb.nbOptions);
         DEBUG_CHECK_MALLOC_OR_RETURN(opStr, NULL);
 
         for(i = 0; i<sb.nbOptions; i++){
@@ -1203,7 +1278,7 @@ char* BFS_sensorBeliefsToString(const BFS_SensorBeliefs sb, const Sets_Reference
     totChar += 25 + strlen(sb.sensorType) + sb.nbFocal - 1 + 3*strlen(separator);
 
     /*Fill the string: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     /*Header: */
@@ -1229,13 +1304,13 @@ char* BFS_sensorBeliefsToString(const BFS_SensorBeliefs sb, const Sets_Reference
 
     /*Deallocate: */
     for(i = 0; i<sb.nbFocal; i++){
-        free(pobStr[i]);
+        Memory_free(pobStr[i]);
     }
-    free(pobStr);
+    Memory_free(pobStr);
     for(i = 0; i<sb.nbOptions; i++){
-        free(opStr[i]);
+        Memory_free(opStr[i]);
     }
-    free(opStr);
+    Memory_free(opStr);
 
     return str;
 }
@@ -1246,7 +1321,7 @@ char* BFS_beliefStructureToString(const BFS_BeliefStructure bs){
     int i = 0, totChar = 0;
 
     /*Get the strings of sensor beliefs: */
-    sbStr = malloc(sizeof(char*)*bs.nbSensors);
+    sbStr = Memory_malloc(sizeof(char*)*bs.nbSensors);
     DEBUG_CHECK_MALLOC_OR_RETURN(sbStr, NULL);
 
     for(i = 0; i<bs.nbSensors; i++){
@@ -1262,7 +1337,7 @@ char* BFS_beliefStructureToString(const BFS_BeliefStructure bs){
     totChar += strlen(set) + strlen(powerset) + strlen(bs.frameName) + bs.nbSensors - 1 + 50;
 
     /*Fill the string: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     sprintf(str, "Context attribute:\n%s\nPossible values:\n%s\nPowerset:\n%s\n\n", bs.frameName, set, powerset);
@@ -1277,11 +1352,11 @@ char* BFS_beliefStructureToString(const BFS_BeliefStructure bs){
 
     /*Deallocate: */
     for(i = 0; i<bs.nbSensors; i++){
-        free(sbStr[i]);
+        Memory_free(sbStr[i]);
     }
-    free(sbStr);
-    free(set);
-    free(powerset);
+    Memory_free(sbStr);
+    Memory_free(set);
+    Memory_free(powerset);
 
     return str;
 }
@@ -0,0 +1,321 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Memory.h"
+#include "Counters.h"
+
+/**
+ * This module gives the allocator used by the whole library and an arena allocator.
+ * @file Memory.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Gives the allocator of the library and an arena allocator.
+ */
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+static void* defaultMalloc(size_t size, __attribute__((unused)) void* data){
+	return malloc(size);
+}
+
+static void* defaultRealloc(void* pointer, size_t size, __attribute__((unused)) void* data){
+	return realloc(pointer, size);
+}
+
+static void defaultFree(void* pointer, __attribute__((unused)) void* data){
+	free(pointer);
+}
+
+/** The allocator of the library. */
+static Memory_Allocator allocator = {defaultMalloc, defaultRealloc, defaultFree, NULL};
+
+/** The allocators pushed by the current thread, the last one being used. */
+static __thread Memory_Allocator pushedAllocators[MEMORY_MAX_PUSHED_ALLOCATORS];
+/** The number of pushes not popped yet by the current thread (may exceed the stored ones). */
+static __thread int nbPushedAllocators = 0;
+
+/**
+ * Gets the allocator used by the current thread.
+ */
+static const Memory_Allocator* currentAllocator(){
+	if(nbPushedAllocators == 0){
+		return &allocator;
+	}
+	if(nbPushedAllocators > MEMORY_MAX_PUSHED_ALLOCATORS){
+		return &(pushedAllocators[MEMORY_MAX_PUSHED_ALLOCATORS - 1]);
+	}
+	return &(pushedAllocators[nbPushedAllocators - 1]);
+}
+
+/**
+ * Rounds a size up to the alignment of arenas.
+ */
+static size_t alignSize(const size_t size){
+	return (size + MEMORY_ARENA_ALIGNMENT - 1) / MEMORY_ARENA_ALIGNMENT * MEMORY_ARENA_ALIGNMENT;
+}
+
+static void* arenaMalloc(size_t size, void* data){
+	Memory_Arena* arena = data;
+	size_t total = MEMORY_ARENA_ALIGNMENT + alignSize(size);
+	char* header = NULL;
+
+	if(arena->size - arena->used < total){
+		return NULL;
+	}
+	header = arena->buffer + arena->used;
+	*((size_t*)header) = size;
+	arena->last = arena->used;
+	arena->used += total;
+	if(arena->used > arena->peak){
+		arena->peak = arena->used;
+	}
+
+	return header + MEMORY_ARENA_ALIGNMENT;
+}
+
+static void arenaFree(void* pointer, void* data){
+	Memory_Arena* arena = data;
+	char* header = NULL;
+
+	if(pointer == NULL){
+		return;
+	}
+	/*Only the last block can be given back: */
+	header = (char*)pointer - MEMORY_ARENA_ALIGNMENT;
+	if(header == arena->buffer + arena->last){
+		arena->used = arena->last;
+		arena->last = arena->size;
+	}
+}
+
+static void* arenaRealloc(void* pointer, size_t size, void* data){
+	Memory_Arena* arena = data;
+	char* header = NULL;
+	void* moved = NULL;
+	size_t oldSize = 0, total = 0;
+
+	if(pointer == NULL){
+		return arenaMalloc(size, data);
+	}
+	header = (char*)pointer - MEMORY_ARENA_ALIGNMENT;
+	oldSize = *((size_t*)header);
+	/*The last block grows or shrinks in place: */
+	if(header == arena->buffer + arena->last){
+		total = MEMORY_ARENA_ALIGNMENT + alignSize(size);
+		if(arena->size - arena->last < total){
+			return NULL;
+		}
+		*((size_t*)header) = size;
+		arena->used = arena->last + total;
+		if(arena->used > arena->peak){
+			arena->peak = arena->used;
+		}
+		return pointer;
+	}
+	/*Otherwise, moved to a new block: */
+	moved = arenaMalloc(size, data);
+	if(moved != NULL){
+		memcpy(moved, pointer, oldSize < size ? oldSize : size);
+	}
+
+	return moved;
+}
+
+
+
+/**
+ * @name Allocator of the library
+ * @{
+ */
+
+void Memory_setAllocator(const Memory_Allocator newAllocator){
+	allocator = newAllocator;
+}
+
+
+
+void Memory_pushAllocator(const Memory_Allocator pushed){
+	if(nbPushedAllocators < MEMORY_MAX_PUSHED_ALLOCATORS){
+		pushedAllocators[nbPushedAllocators] = pushed;
+	}
+	#ifdef DEBUG
+	else {
+		printf("debug: more than %d allocators pushed, the last one is kept.\n", MEMORY_MAX_PUSHED_ALLOCATORS);
+	}
+	#endif
+	nbPushedAllocators++;
+}
+
+
+
+void Memory_popAllocator(){
+	if(nbPushedAllocators > 0){
+		nbPushedAllocators--;
+	}
+}
+
+
+
+Memory_Allocator Memory_getAllocator(){
+	return *currentAllocator();
+}
+
+
+
+Memory_Allocator Memory_getDefaultAllocator(){
+	Memory_Allocator defaultAllocator = {defaultMalloc, defaultRealloc, defaultFree, NULL};
+
+	return defaultAllocator;
+}
+
+
+
+int Memory_isDefaultAllocator(){
+	return currentAllocator()->mallocFunction == defaultMalloc;
+}
+
+
+
+void* Memory_malloc(const size_t size){
+	const Memory_Allocator* current = currentAllocator();
+
+	THEGAME_COUNT(nbAllocations);
+	THEGAME_COUNT_N(nbAllocatedBytes, size);
+	return current->mallocFunction(size, current->data);
+}
+
+
+
+void* Memory_calloc(const size_t nbElements, const size_t size){
+	const Memory_Allocator* current = currentAllocator();
+	void* pointer = NULL;
+
+	THEGAME_COUNT(nbAllocations);
+	THEGAME_COUNT_N(nbAllocatedBytes, nbElements * size);
+	if(current->mallocFunction == defaultMalloc){
+		return calloc(nbElements, size);
+	}
+	pointer = current->mallocFunction(nbElements * size, current->data);
+	if(pointer != NULL){
+		memset(pointer, 0, nbElements * size);
+	}
+
+	return pointer;
+}
+
+
+
+void* Memory_realloc(void* pointer, const size_t size){
+	const Memory_Allocator* current = currentAllocator();
+
+	THEGAME_COUNT(nbAllocations);
+	THEGAME_COUNT_N(nbAllocatedBytes, size);
+	return current->reallocFunction(pointer, size, current->data);
+}
+
+
+
+void Memory_free(void* pointer){
+	const Memory_Allocator* current = currentAllocator();
+
+	current->freeFunction(pointer, current->data);
+}
+
+
+
+char* Memory_strdup(const char* str){
+	size_t length = strlen(str) + 1;
+	char* copy = Memory_malloc(length);
+
+	if(copy != NULL){
+		memcpy(copy, str, length);
+	}
+
+	return copy;
+}
+
+/** @} */
+
+
+
+/**
+ * @name Arenas
+ * @{
+ */
+
+Memory_Arena Memory_createArena(const size_t size){
+	Memory_Arena arena = {NULL, 0, 0, 0, 0, 1};
+
+	arena.buffer = malloc(size);
+	DEBUG_CHECK_MALLOC(arena.buffer);
+	if(arena.buffer != NULL){
+		arena.size = size;
+	}
+	arena.last = arena.size;
+
+	return arena;
+}
+
+
+
+Memory_Arena Memory_createArenaFromBuffer(void* buffer, const size_t size){
+	Memory_Arena arena = {NULL, 0, 0, 0, 0, 0};
+	size_t offset = (MEMORY_ARENA_ALIGNMENT - (size_t)buffer % MEMORY_ARENA_ALIGNMENT) % MEMORY_ARENA_ALIGNMENT;
+
+	/*The blocks start on an aligned address: */
+	if(size > offset){
+		arena.buffer = (char*)buffer + offset;
+		arena.size = size - offset;
+	}
+	arena.last = arena.size;
+
+	return arena;
+}
+
+
+
+Memory_Allocator Memory_getArenaAllocator(Memory_Arena* arena){
+	Memory_Allocator arenaAllocator = {arenaMalloc, arenaRealloc, arenaFree, NULL};
+
+	arenaAllocator.data = arena;
+
+	return arenaAllocator;
+}
+
+
+
+void Memory_resetArena(Memory_Arena* arena){
+	arena->used = 0;
+	arena->last = arena->size;
+}
+
+
+
+void Memory_freeArena(Memory_Arena* arena){
+	if(arena->ownsBuffer){
+		free(arena->buffer);
+	}
+	arena->buffer = NULL;
+	arena->size = 0;
+	arena->used = 0;
+	arena->last = 0;
+}
+
+/** @} */
@@ -86,7 +86,7 @@ int* ReadDir_charsPerDirectory(const char* path, const int nbDir){
     dir = opendir(path);
     if (dir != NULL) {
         /*Allocate memory: */
-        charsPerDir = malloc(sizeof(int)*nbDir);
+        charsPerDir = Memory_malloc(sizeof(int)*nbDir);
         DEBUG_CHECK_MALLOC_OR_RETURN(charsPerDir, NULL);
 
         /*Get subdirectories: */
@@ -121,13 +121,13 @@ char** ReadDir_getDirectories(const char* path, const int nbDir, const int* char
     dir = opendir(path);
     if (dir != NULL) {
         /*Allocate memory: */
-        directories = malloc(sizeof(char*) * nbDir);
+        directories = Memory_malloc(sizeof(char*) * nbDir);
         if (directories == NULL) {
             printf("debug: malloc failed in ReadDir_getDirectories() for \"directories\"\n");
             return NULL;
 	    }
 	    for(i = 0; i < nbDir; i++){
-	    	directories[i] = malloc(sizeof(char) * (charsPerDir[i] + 1));
+	    	directories[i] = Memory_malloc(sizeof(char) * (charsPerDir[i] + 1));
 	    	if (directories[i] == NULL) {
             	printf("debug: malloc failed in ReadDir_getDirectories() for \"directories[i]\"\n");
                 return NULL;
@@ -209,7 +209,7 @@ int* ReadDir_charsPerFilename(const char* path, const int nbFiles){
     dir = opendir(path);
     if (dir != NULL) {
         /*Allocate memory: */
-        charsPerFilenam = malloc(sizeof(int)*nbFiles);
+        charsPerFilenam = Memory_malloc(sizeof(int)*nbFiles);
         if (charsPerFilenam == NULL) {
             printf("debug: malloc failed in ReadDir_charsPerFilename() for \"charsPerFilenam\".\n");
             return NULL;
@@ -245,13 +245,13 @@ char** ReadDir_getFilenames(const char* path, const int nbFiles, const int* char
     dir = opendir(path);
     if (dir != NULL) {
         /*Allocate memory: */
-        filenames = malloc(sizeof(char*) * nbFiles);
+        filenames = Memory_malloc(sizeof(char*) * nbFiles);
         if (filenames == NULL) {
             printf("debug: malloc failed in ReadDir_getFilenames() for \"filenames\".\n");
             return NULL;
 	    }
 	    for(i = 0; i < nbFiles; i++){
-	    	filenames[i] = malloc(sizeof(char) * (charsPerFilenam[i] + 1));
+	    	filenames[i] = Memory_malloc(sizeof(char) * (charsPerFilenam[i] + 1));
             if (filenames[i] == NULL) {
             	printf("debug: malloc failed in ReadDir_getFilenames() for \"filenames[i]\".\n");
                 return NULL;
@@ -65,7 +65,7 @@ int* ReadFile_charsPerLine(const char* fileName, const int nbLines){
     f = fopen(fileName, "r");
     if(f != NULL){
         /*Allocate memory: */
-        result = malloc(sizeof(int)*nbLines);
+        result = Memory_malloc(sizeof(int)*nbLines);
         DEBUG_CHECK_MALLOC_OR_RETURN(result, NULL);
 
         /*Get the first char: */
@@ -106,12 +106,12 @@ char** ReadFile_readLines(const char* fileName, const int nbLines, const int* ch
     f = fopen(fileName, "r");
     if(f != NULL){
         /*Memory allocation : */
-        lines = malloc(sizeof(char*)*nbLines);
+        lines = Memory_malloc(sizeof(char*)*nbLines);
         DEBUG_CHECK_MALLOC_OR_RETURN(lines, NULL);
 
         /*Get the lines: */
         for(i=0; i<nbLines; i++){
-            lines[i] = malloc(sizeof(char)*charsPerLine[i]+1);
+            lines[i] = Memory_malloc(sizeof(char)*charsPerLine[i]+1);
             DEBUG_CHECK_MALLOC_OR_RETURN(lines[i], NULL);
 
             fgets(lines[i], charsPerLine[i]+1, f);
@@ -17,6 +17,8 @@
 #include <string.h>
 
 #include "Sets.h"
+#include "Counters.h"
+#include "Checks.h"
 
 
 /**
@@ -56,12 +58,12 @@ Sets_ReferenceList Sets_loadRefList(const char* fileName){
 
     /*Memory allocation: */
     loadedList.card = card;
-    loadedList.values = malloc(sizeof(char*) * loadedList.card);
+    loadedList.values = Memory_malloc(sizeof(char*) * loadedList.card);
     DEBUG_CHECK_MALLOC(loadedList.values);
 
     for(i = 0; i < nbLines; i++){
     	if(charPerLine[i] != 0){
-		    loadedList.values[current] = malloc(sizeof(char) * charPerLine[i] + 1);
+		    loadedList.values[current] = Memory_malloc(sizeof(char) * charPerLine[i] + 1);
 		    DEBUG_CHECK_MALLOC(loadedList.values[current]);
 
 		    strcpy(loadedList.values[current], lines[i]);
@@ -71,11 +73,11 @@ Sets_ReferenceList Sets_loadRefList(const char* fileName){
     }
 
     /*Free: */
-    free(charPerLine);
+    Memory_free(charPerLine);
     for(i = 0; i<nbLines; i++){
-        free(lines[i]);
+        Memory_free(lines[i]);
     }
-    free(lines);
+    Memory_free(lines);
 
     return loadedList;
 }
@@ -84,12 +86,12 @@ Sets_ReferenceList Sets_createRefListFromArray(const char* const * values, int s
 	Sets_ReferenceList refList;
 	int i = 0;
 	refList.card = 0;
-	refList.values = malloc(sizeof(char**) * size);
+	refList.values = Memory_malloc(sizeof(char**) * size);
 	DEBUG_CHECK_MALLOC_OR_RETURN(refList.values, refList);
 
 	refList.card = size;
 	for (i = 0; i < size; ++i) {
-		refList.values[i] = strdup(values[i]);
+		refList.values[i] = Memory_strdup(values[i]);
 	}
 	return refList;
 }
@@ -116,13 +118,13 @@ Sets_Set Sets_createSet(const int nbAtoms){
     int i = 0, j = 0;
     
     createdSet.card = nbAtoms;
-    createdSet.elements = malloc(sizeof(Sets_Element) * createdSet.card);
+    createdSet.elements = Memory_malloc(sizeof(Sets_Element) * createdSet.card);
     DEBUG_CHECK_MALLOC(createdSet.elements);
     
     /*Create the elements: */
     for(i = 0; i < createdSet.card; i++){
         createdSet.elements[i].card = 1;
-        createdSet.elements[i].values = malloc(sizeof(char) * createdSet.card);
+        createdSet.elements[i].values = Memory_malloc(sizeof(char) * createdSet.card);
         DEBUG_CHECK_MALLOC(createdSet.elements[i].values);
 
         for(j = 0; j < createdSet.card; j++){
@@ -140,14 +142,14 @@ Sets_Set Sets_createPowerSet(const Sets_Set set){
 
     /*Powerset allocation: */
     powerset.card = pow(2, set.card);
-    powerset.elements = malloc(sizeof(Sets_Element) * powerset.card);
+    powerset.elements = Memory_malloc(sizeof(Sets_Element) * powerset.card);
     DEBUG_CHECK_MALLOC(powerset.elements);
 
     /* ***********************
        Building the elements:
        ***********************
        Empty set:*/
-    powerset.elements[0].values = malloc(sizeof(char) * set.card);
+    powerset.elements[0].values = Memory_malloc(sizeof(char) * set.card);
     DEBUG_CHECK_MALLOC(powerset.elements[0].values);
 
     for(j = 0; j<set.card; j++){
@@ -159,7 +161,7 @@ Sets_Set Sets_createPowerSet(const Sets_Set set){
         /*Reset the sum: */
         sum = 0;
         /*Allocate memory: */
-        powerset.elements[i].values = malloc(sizeof(char) * set.card);
+        powerset.elements[i].values = Memory_malloc(sizeof(char) * set.card);
         DEBUG_CHECK_MALLOC(powerset.elements[i].values);
 
         /*Compute the binary value: */
@@ -178,11 +180,11 @@ Sets_Set Sets_generatePowerSet(const int elementSize){
     int i = 0, j = 0;
 
     /*Generate a simple set: */
-    set.elements = malloc(sizeof(Sets_Element) * elementSize);
+    set.elements = Memory_malloc(sizeof(Sets_Element) * elementSize);
     set.card = elementSize;
     for(i = 0; i < elementSize; i++){
         set.elements[i].card = 1;
-        set.elements[i].values = malloc(sizeof(char) * elementSize);
+        set.elements[i].values = Memory_malloc(sizeof(char) * elementSize);
         DEBUG_CHECK_MALLOC(set.elements[i].values);
 
         for(j = 0; j < elementSize; j++){
@@ -209,7 +211,7 @@ Sets_Element Sets_createElementFromStrings(const char* const * const values, con
     #endif
 	
 	#ifdef CHECK_MODELS
-	for(i = 0; i < nbValues; i++){
+	for(i = 0; THEGAME_VALIDATING() && i < nbValues; i++){
 		valid = 0;
 		for(j = 0; j < rl.card; j++){
 			if(!strcmp(values[i], rl.values[j])){
@@ -218,19 +220,14 @@ Sets_Element Sets_createElementFromStrings(const char* const * const values, con
 			}
 		}
 		if(!valid){
-		   	printf("debug: CHECK MODELS FAIL!\n");
-		   	printf("debug: In function Sets_createElementFromStrings(), \"%s\" is invalid...\n", values[i]);
-		   	printf("debug: It does not correspond to any value in the given ReferenceList.\n");
-		   	printf("debug: Given reference list:\n");
-		   	for(j = 0; j < rl.card; j++){
-		   		printf("debug: %s\n", rl.values[j]);
-		   	}
+			THEGAME_reportError(THEGAME_CHECK_MODELS, __func__, NULL,
+					"\"%s\" does not correspond to any value of the reference list", values[i]);
 		}
 	}
     #endif
 	
     /*Memory allocation: */
-    newElem.values = malloc(sizeof(char) * rl.card);
+    newElem.values = Memory_malloc(sizeof(char) * rl.card);
     DEBUG_CHECK_MALLOC(newElem.values);
 
     /*Fill the element: */
@@ -254,7 +251,7 @@ Sets_Element Sets_createElementFromBits(const char* values, const int size){
     Sets_Element newElem = {NULL, 0};
     int i = 0;
 
-    newElem.values = malloc(sizeof(char) * size);
+    newElem.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(newElem.values);
 
     for(i = 0; i < size; i++){
@@ -271,7 +268,7 @@ Sets_Element Sets_copyElement(const Sets_Element e, const int size){
 
     /*Copy the element: */
     copy.card = e.card;
-    copy.values = malloc(sizeof(char) * size);
+    copy.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(copy.values);
 
     for(i = 0; i < size; i++){
@@ -286,7 +283,7 @@ Sets_Element Sets_getEmptyElement(const int size){
     int i = 0;
 
     /*Allocate memory: */
-    emptySet.values = malloc(sizeof(char) * size);
+    emptySet.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(emptySet.values);
 
     /*Put zeros: */
@@ -302,7 +299,7 @@ Sets_Element Sets_getCompleteElement(const int size){
     int i = 0;
 
     /*Allocate memory: */
-    complete.values = malloc(sizeof(char) * size);
+    complete.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(complete.values);
 
     /*Put ones: */
@@ -318,9 +315,10 @@ Sets_Element Sets_getOpposite(const Sets_Element e, const int size){
     Sets_Element opposite = {NULL, 0};
     int i = 0;
 
+    THEGAME_COUNT(nbSetOperations);
     /*Create opposite: */
     opposite.card = size - e.card;
-    opposite.values = malloc(sizeof(char) * size);
+    opposite.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(opposite.values);
 
     for(i = 0; i < size; i++){
@@ -332,18 +330,14 @@ Sets_Element Sets_getOpposite(const Sets_Element e, const int size){
 
 Sets_Element Sets_elementFromNumber(const int number, const int nbDigits){
 	Sets_Element e = {NULL, 0};
-	int nb = number;
 	int i = 0;
 	
-	e.values = malloc(sizeof(char) * nbDigits);
+	e.values = Memory_malloc(sizeof(char) * nbDigits);
 	DEBUG_CHECK_MALLOC(e.values);
 
 	for(i = 0; i < nbDigits; i++){
-		e.values[i] = nb % 2 ;
-		nb /= 2;
-		if(e.values[i]){
-			e.card++;
-		}
+		e.values[i] = (number >> i) & 1;
+		e.card += e.values[i];
 	}
 	
 	return e;
@@ -353,7 +347,9 @@ int Sets_numberFromElement(const Sets_Element e, const int nbDigits){
 	int nb = 0, i = 0;
 	
 	for(i = 0; i < nbDigits; i++){
-		nb += e.values[i] * pow(2, i);
+		if(e.values[i]){
+			nb |= 1 << i;
+		}
 	}
 	
 	return nb;
@@ -377,8 +373,9 @@ Sets_Element Sets_conjunction(const Sets_Element e1, const Sets_Element e2, cons
     Sets_Element conj = {NULL, 0};
     int i = 0, sum = 0;
 
+    THEGAME_COUNT(nbSetOperations);
     /*Memory allocation: */
-    conj.values = malloc(sizeof(char) * size);
+    conj.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(conj.values);
 
     /*Compare both elements: */
@@ -396,8 +393,9 @@ Sets_Element Sets_disjunction(const Sets_Element e1, const Sets_Element e2, cons
     Sets_Element disj = {NULL, 0};
     int i = 0, sum = 0;
 
+    THEGAME_COUNT(nbSetOperations);
     /*Memory allocation: */
-    disj.values = malloc(sizeof(char) * size);
+    disj.values = Memory_malloc(sizeof(char) * size);
     DEBUG_CHECK_MALLOC(disj.values);
 
     /*Compare both elements: */
@@ -415,6 +413,7 @@ Sets_Element Sets_disjunction(const Sets_Element e1, const Sets_Element e2, cons
 int Sets_equals(const Sets_Element e1, const Sets_Element e2, const int size){
     int equality = 1, i = 0;
 
+    THEGAME_COUNT(nbSetOperations);
     if(e1.card == e2.card){
         for(i = 0; i < size; i++){
             equality = equality && (e1.values[i] == e2.values[i]);
@@ -427,6 +426,19 @@ int Sets_equals(const Sets_Element e1, const Sets_Element e2, const int size){
     return equality;
 }
 
+int Sets_compare(const Sets_Element e1, const Sets_Element e2, const int size){
+    int i = 0;
+
+    THEGAME_COUNT(nbSetOperations);
+    for(i = size - 1; i >= 0; i--){
+        if(e1.values[i] != e2.values[i]){
+            return e1.values[i] - e2.values[i];
+        }
+    }
+
+    return 0;
+}
+
 int Sets_isMember(const Sets_Element e, const Sets_Set s, const int size){
     int member = 0, i = 0;
 
@@ -440,6 +452,7 @@ int Sets_isMember(const Sets_Element e, const Sets_Set s, const int size){
 int Sets_isSubset(const Sets_Element e1, const Sets_Element e2, const int size){
     int valuesInCommon = 0, i = 0;
 
+    THEGAME_COUNT(nbSetOperations);
     for(i = 0; i < size; i++){
         valuesInCommon += e1.values[i] && e2.values[i];
     }
@@ -449,6 +462,42 @@ int Sets_isSubset(const Sets_Element e1, const Sets_Element e2, const int size){
 
 /** @} */
 
+/**
+ * @name Memory usage
+ * @{
+ */
+
+/*
+ +--------------+
+ | Memory usage |
+ +--------------+
+*/
+
+size_t Sets_referenceListMemoryUsage(const Sets_ReferenceList rl){
+    size_t bytes = 0;
+    int i = 0;
+
+    if(rl.values == NULL){
+        return 0;
+    }
+    bytes = sizeof(char*) * rl.card;
+    for(i = 0; i < rl.card; i++){
+        bytes += strlen(rl.values[i]) + 1;
+    }
+
+    return bytes;
+}
+
+size_t Sets_setMemoryUsage(const Sets_Set s, const int elementSize){
+    if(s.elements == NULL){
+        return 0;
+    }
+
+    return (sizeof(Sets_Element) + sizeof(char) * elementSize) * s.card;
+}
+
+/** @} */
+
 /**
  * @name Memory deallocation
  * @{
@@ -464,13 +513,13 @@ void Sets_freeReferenceList(Sets_ReferenceList* rl){
     int i = 0;
 
     for(i = 0; i < rl->card; i++){
-        free(rl->values[i]);
+        Memory_free(rl->values[i]);
     }
-    free(rl->values);
+    Memory_free(rl->values);
 }
 
 void Sets_freeElement(Sets_Element* e){
-    free(e->values);
+    Memory_free(e->values);
 }
 
 void Sets_freeSet(Sets_Set* s){
@@ -481,7 +530,7 @@ void Sets_freeSet(Sets_Set* s){
         Sets_freeElement(&(s->elements[i]));
     }
     /*Deallocation of the elements table: */
-    free(s->elements);
+    Memory_free(s->elements);
 }
 
 /** @} */
@@ -504,7 +553,7 @@ char* Sets_elementToString(const Sets_Element e, const Sets_ReferenceList rl){
 
     /*Empty set: */
     if(e.card == 0){
-        str = malloc(sizeof(char) * 7);
+        str = Memory_malloc(sizeof(char) * 7);
         DEBUG_CHECK_MALLOC(str);
 
         strcpy(str, "{void}\0");
@@ -522,7 +571,7 @@ char* Sets_elementToString(const Sets_Element e, const Sets_ReferenceList rl){
         /*Add the braquets and the union symbols: */
         totChar += 4 + 3*(sum - 1);
         /*Allocate memory: */
-        str = malloc(sizeof(char)*totChar);
+        str = Memory_malloc(sizeof(char)*totChar);
         DEBUG_CHECK_MALLOC(str);
         /*Create the string: */
         sprintf(str, "{%s", rl.values[firstElement]);
@@ -542,7 +591,7 @@ char* Sets_elementToBitString(const Sets_Element e, int size){
 	char* str = NULL;
 	int i = 0;
 	
-	str = malloc(sizeof(char) * (size + 1));
+	str = Memory_malloc(sizeof(char) * (size + 1));
 	DEBUG_CHECK_MALLOC(str);
 
 	for(i = 0; i < size; i++){
@@ -559,7 +608,7 @@ char* Sets_setToString(const Sets_Set s, const Sets_ReferenceList rl){
     int i = 0, totChar = 0;
 
     /*Allocate memory for elements strings: */
-    elements = malloc(sizeof(char*)*s.card);
+    elements = Memory_malloc(sizeof(char*)*s.card);
     DEBUG_CHECK_MALLOC_OR_RETURN(elements, NULL);
 
     /*Count the number of chars: */
@@ -570,7 +619,7 @@ char* Sets_setToString(const Sets_Set s, const Sets_ReferenceList rl){
     totChar += 3 + 2*(s.card - 1);
 
     /*Allocate memory for the string: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     /*Fill the string: */
@@ -583,9 +632,9 @@ char* Sets_setToString(const Sets_Set s, const Sets_ReferenceList rl){
 
     /*Deallocate useless memory: */
     for(i = 0; i<s.card; i++){
-        free(elements[i]);
+        Memory_free(elements[i]);
     }
-    free(elements);
+    Memory_free(elements);
 
     return str;
 }
@@ -596,7 +645,7 @@ char* Sets_setToBitString(const Sets_Set s, int size){
     int i = 0, totChar = 0;
 
     /*Allocate memory for elements strings: */
-    elements = malloc(sizeof(char*)*s.card);
+    elements = Memory_malloc(sizeof(char*)*s.card);
     DEBUG_CHECK_MALLOC_OR_RETURN(elements, NULL);
 
     /*Count the number of chars: */
@@ -607,7 +656,7 @@ char* Sets_setToBitString(const Sets_Set s, int size){
     totChar += 3 + 2*(s.card - 1);
 
     /*Allocate memory for the string: */
-    str = malloc(sizeof(char)*(totChar+1));
+    str = Memory_malloc(sizeof(char)*(totChar+1));
     DEBUG_CHECK_MALLOC_OR_RETURN(str, NULL);
 
     /*Fill the string: */
@@ -620,9 +669,9 @@ char* Sets_setToBitString(const Sets_Set s, int size){
 
     /*Deallocate useless memory: */
     for(i = 0; i<s.card; i++){
-        free(elements[i]);
+        Memory_free(elements[i]);
     }
-    free(elements);
+    Memory_free(elements);
 
     return str;
 }
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Counters.h"
+
+/**
+ * This module gives per-thread counters of the work done by the library.
+ * @file Stats.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Gives per-thread counters of the work done by the library.
+ */
+
+#ifdef THEGAME_STATS
+__thread THEGAME_Stats THEGAME_threadStats;
+#endif
+
+
+/**
+ * @name Statistics
+ * @{
+ */
+
+int THEGAME_isStatsEnabled(){
+	#ifdef THEGAME_STATS
+	return 1;
+	#else
+	return 0;
+	#endif
+}
+
+
+
+THEGAME_Stats THEGAME_getStats(){
+	#ifdef THEGAME_STATS
+	return THEGAME_threadStats;
+	#else
+	THEGAME_Stats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+	return stats;
+	#endif
+}
+
+
+
+void THEGAME_resetStats(){
+	#ifdef THEGAME_STATS
+	THEGAME_Stats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+	THEGAME_threadStats = stats;
+	#endif
+}
+
+/** @} */
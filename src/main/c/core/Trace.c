@@ -0,0 +1,432 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Tracing.h"
+
+/**
+ * This module traces the main entry points of the library in per-thread ring buffers
+ * and log-linear histograms of latencies, the histograms of the threads being published
+ * to process-wide ones when they end.
+ * @file Trace.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Gives per-thread tracing of the entry points and latency histograms.
+ */
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+/** The names of the stages. */
+static const char* const stageNames[THEGAME_TRACE_NB_STAGES] = {
+	"evidence", "projection", "combination", "decision", "transformation", "loading"
+};
+
+/** The histogram given when nothing is traced. */
+static const THEGAME_Histogram emptyHistogram;
+
+/**
+ * Gets the bucket of a latency: the latencies below THEGAME_HISTOGRAM_SUB_BUCKETS have their own bucket,
+ * then each power of 2 is split in THEGAME_HISTOGRAM_SUB_BUCKETS buckets.
+ */
+static int getBucket(uint64_t latency){
+	int shift = 0;
+
+	if(latency >= ((uint64_t)1 << THEGAME_HISTOGRAM_MAX_BITS)){
+		latency = ((uint64_t)1 << THEGAME_HISTOGRAM_MAX_BITS) - 1;
+	}
+	if(latency < THEGAME_HISTOGRAM_SUB_BUCKETS){
+		return (int)latency;
+	}
+	/*Keeps the THEGAME_HISTOGRAM_SUB_BITS + 1 highest bits: */
+	shift = 63 - __builtin_clzll(latency) - THEGAME_HISTOGRAM_SUB_BITS;
+
+	return (shift + 1) * THEGAME_HISTOGRAM_SUB_BUCKETS + (int)(latency >> shift) - THEGAME_HISTOGRAM_SUB_BUCKETS;
+}
+
+/**
+ * Gets the highest latency of a bucket.
+ */
+static uint64_t getHighestLatency(const int bucket){
+	int shift = bucket / THEGAME_HISTOGRAM_SUB_BUCKETS - 1;
+
+	if(bucket < THEGAME_HISTOGRAM_SUB_BUCKETS){
+		return bucket;
+	}
+
+	return (((uint64_t)(bucket % THEGAME_HISTOGRAM_SUB_BUCKETS + THEGAME_HISTOGRAM_SUB_BUCKETS) + 1) << shift) - 1;
+}
+
+#ifdef THEGAME_TRACE
+
+/**
+ * The trace of a thread.
+ */
+struct ThreadTrace {
+	/** The ring buffer of events */
+	THEGAME_TraceEvent events[THEGAME_TRACE_RING_SIZE];
+	/** The number of events recorded since the last reset */
+	unsigned long nbEvents;
+	/** The starts of the calls in progress */
+	uint64_t starts[THEGAME_TRACE_MAX_DEPTH];
+	/** The number of calls in progress */
+	int depth;
+	/** The number of calls in progress per stage (only the outermost call of a stage is in its histogram) */
+	int active[THEGAME_TRACE_NB_STAGES];
+	/** 1 if the histograms are published when the thread ends */
+	int registered;
+	/** The identifier of the thread in Chrome traces (0 until the first call) */
+	int id;
+	/** The histograms of the stages */
+	THEGAME_Histogram histograms[THEGAME_TRACE_NB_STAGES];
+};
+
+/** The trace of the calling thread. */
+static __thread struct ThreadTrace trace;
+
+/** The number of threads having traced something. */
+static int nbThreads = 0;
+
+/** The histograms published by the threads. */
+static THEGAME_Histogram processHistograms[THEGAME_TRACE_NB_STAGES];
+
+/** The lock of the published histograms. */
+static pthread_mutex_t processLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** The key whose destructor publishes the histograms of a thread which ends. */
+static pthread_key_t traceKey;
+
+/** Creates traceKey only once. */
+static pthread_once_t traceKeyOnce = PTHREAD_ONCE_INIT;
+
+/** 1 if traceKey has been created. */
+static int traceKeyCreated = 0;
+
+/**
+ * Adds the histograms of a thread to the published ones and empties them.
+ */
+static void publishTrace(struct ThreadTrace* threadTrace){
+	int i = 0;
+
+	pthread_mutex_lock(&processLock);
+	for(i = 0; i < THEGAME_TRACE_NB_STAGES; i++){
+		THEGAME_mergeHistograms(&(processHistograms[i]), &(threadTrace->histograms[i]));
+	}
+	pthread_mutex_unlock(&processLock);
+	memset(threadTrace->histograms, 0, sizeof(threadTrace->histograms));
+}
+
+/**
+ * Publishes the histograms of a thread which ends (destructor of traceKey).
+ */
+static void publishEndingTrace(void* data){
+	publishTrace(data);
+}
+
+/**
+ * Creates traceKey.
+ */
+static void createTraceKey(){
+	traceKeyCreated = (pthread_key_create(&traceKey, publishEndingTrace) == 0);
+}
+
+/**
+ * Gets the current time in nanoseconds.
+ */
+static uint64_t now(){
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+#endif /* THEGAME_TRACE */
+
+
+
+/**
+ * @name Hooks
+ * @{
+ */
+
+#ifdef THEGAME_TRACE
+
+void THEGAME_traceBegin(const THEGAME_TraceStage stage){
+	if(trace.id == 0){
+		trace.id = __sync_add_and_fetch(&nbThreads, 1);
+	}
+	if(!trace.registered){
+		pthread_once(&traceKeyOnce, createTraceKey);
+		trace.registered = traceKeyCreated && pthread_setspecific(traceKey, &trace) == 0;
+	}
+	trace.active[stage]++;
+	if(trace.depth < THEGAME_TRACE_MAX_DEPTH){
+		trace.starts[trace.depth] = now();
+	}
+	trace.depth++;
+}
+
+
+
+void THEGAME_traceEnd(const char* name, const THEGAME_TraceStage stage){
+	uint64_t end = now();
+	THEGAME_TraceEvent* event = NULL;
+
+	if(trace.depth == 0){
+		return;
+	}
+	trace.depth--;
+	if(trace.active[stage] > 0){
+		trace.active[stage]--;
+	}
+	if(trace.depth >= THEGAME_TRACE_MAX_DEPTH){
+		return;
+	}
+	event = &(trace.events[trace.nbEvents % THEGAME_TRACE_RING_SIZE]);
+	event->name = name;
+	event->stage = stage;
+	event->start = trace.starts[trace.depth];
+	event->duration = end - event->start;
+	trace.nbEvents++;
+	/*The nested calls of the same stage are already in the latency of the outermost one: */
+	if(trace.active[stage] == 0){
+		THEGAME_recordLatency(&(trace.histograms[stage]), event->duration);
+	}
+}
+
+#endif /* THEGAME_TRACE */
+
+/** @} */
+
+
+
+/**
+ * @name Tracing
+ * @{
+ */
+
+int THEGAME_isTraceEnabled(){
+	#ifdef THEGAME_TRACE
+	return 1;
+	#else
+	return 0;
+	#endif
+}
+
+
+
+const char* THEGAME_getStageName(const THEGAME_TraceStage stage){
+	if(stage < 0 || stage >= THEGAME_TRACE_NB_STAGES){
+		return "unknown";
+	}
+
+	return stageNames[stage];
+}
+
+
+
+const THEGAME_Histogram* THEGAME_getLatencies(const THEGAME_TraceStage stage){
+	if(stage < 0 || stage >= THEGAME_TRACE_NB_STAGES){
+		return &emptyHistogram;
+	}
+	#ifdef THEGAME_TRACE
+	return &(trace.histograms[stage]);
+	#else
+	return &emptyHistogram;
+	#endif
+}
+
+
+
+void THEGAME_getProcessLatencies(const THEGAME_TraceStage stage, THEGAME_Histogram* into){
+	memset(into, 0, sizeof(THEGAME_Histogram));
+	if(stage < 0 || stage >= THEGAME_TRACE_NB_STAGES){
+		return;
+	}
+	#ifdef THEGAME_TRACE
+	pthread_mutex_lock(&processLock);
+	*into = processHistograms[stage];
+	pthread_mutex_unlock(&processLock);
+	THEGAME_mergeHistograms(into, &(trace.histograms[stage]));
+	#endif
+}
+
+
+
+void THEGAME_publishLatencies(){
+	#ifdef THEGAME_TRACE
+	publishTrace(&trace);
+	#endif
+}
+
+
+
+uint64_t THEGAME_getPercentile(const THEGAME_Histogram* histogram, const double percentile){
+	unsigned long rank = 0, seen = 0;
+	uint64_t latency = 0;
+	int i = 0;
+
+	if(histogram->count == 0){
+		return 0;
+	}
+	/*The rank of the percentile, from 1 to count: */
+	if(percentile >= 100){
+		rank = histogram->count;
+	}
+	else if(percentile > 0){
+		rank = (unsigned long)(percentile / 100 * histogram->count + 0.999999);
+	}
+	if(rank == 0){
+		rank = 1;
+	}
+	for(i = 0; i < THEGAME_HISTOGRAM_SIZE; i++){
+		seen += histogram->counts[i];
+		if(seen >= rank){
+			latency = getHighestLatency(i);
+			break;
+		}
+	}
+
+	return latency < histogram->max ? latency : histogram->max;
+}
+
+
+
+void THEGAME_recordLatency(THEGAME_Histogram* histogram, const uint64_t latency){
+	if(histogram->count == 0 || latency < histogram->min){
+		histogram->min = latency;
+	}
+	if(latency > histogram->max){
+		histogram->max = latency;
+	}
+	histogram->counts[getBucket(latency)]++;
+	histogram->count++;
+	histogram->sum += latency;
+}
+
+
+
+void THEGAME_mergeHistograms(THEGAME_Histogram* into, const THEGAME_Histogram* from){
+	int i = 0;
+
+	if(from->count == 0){
+		return;
+	}
+	if(into->count == 0 || from->min < into->min){
+		into->min = from->min;
+	}
+	if(from->max > into->max){
+		into->max = from->max;
+	}
+	for(i = 0; i < THEGAME_HISTOGRAM_SIZE; i++){
+		into->counts[i] += from->counts[i];
+	}
+	into->count += from->count;
+	into->sum += from->sum;
+}
+
+
+
+int THEGAME_getTraceEvents(THEGAME_TraceEvent* events, const int maxEvents){
+	#ifdef THEGAME_TRACE
+	unsigned long nbEvents = trace.nbEvents, first = 0;
+	int i = 0;
+
+	if(nbEvents > THEGAME_TRACE_RING_SIZE){
+		nbEvents = THEGAME_TRACE_RING_SIZE;
+	}
+	if(maxEvents < 0){
+		return 0;
+	}
+	if(nbEvents > (unsigned long)maxEvents){
+		nbEvents = maxEvents;
+	}
+	/*The most recent events, from the oldest to the newest: */
+	first = trace.nbEvents - nbEvents;
+	for(i = 0; i < (int)nbEvents; i++){
+		events[i] = trace.events[(first + i) % THEGAME_TRACE_RING_SIZE];
+	}
+
+	return (int)nbEvents;
+	#else
+	(void)events;
+	(void)maxEvents;
+	return 0;
+	#endif
+}
+
+
+
+int THEGAME_writeChromeTrace(FILE* file){
+	int nbWritten = 0;
+	#ifdef THEGAME_TRACE
+	const THEGAME_TraceEvent* event = NULL;
+	unsigned long nbEvents = trace.nbEvents, first = 0, i = 0;
+	int pid = (int)getpid();
+
+	if(nbEvents > THEGAME_TRACE_RING_SIZE){
+		nbEvents = THEGAME_TRACE_RING_SIZE;
+	}
+	first = trace.nbEvents - nbEvents;
+	#endif
+
+	fprintf(file, "{\"traceEvents\":[");
+	#ifdef THEGAME_TRACE
+	/*Complete events, times in microseconds: */
+	for(i = 0; i < nbEvents; i++){
+		event = &(trace.events[(first + i) % THEGAME_TRACE_RING_SIZE]);
+		fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+				i == 0 ? "" : ",", event->name, THEGAME_getStageName(event->stage),
+				event->start / 1000.0, event->duration / 1000.0, pid, trace.id);
+		nbWritten++;
+	}
+	#endif
+	fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+	return nbWritten;
+}
+
+
+
+void THEGAME_resetTrace(){
+	#ifdef THEGAME_TRACE
+	/*The calls in progress are kept: */
+	trace.nbEvents = 0;
+	memset(trace.histograms, 0, sizeof(trace.histograms));
+	#endif
+}
+
+
+
+void THEGAME_resetProcessLatencies(){
+	#ifdef THEGAME_TRACE
+	pthread_mutex_lock(&processLock);
+	memset(processHistograms, 0, sizeof(processHistograms));
+	pthread_mutex_unlock(&processLock);
+	memset(trace.histograms, 0, sizeof(trace.histograms));
+	#endif
+}
+
+/** @} */
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdarg.h>
+
+#include "Checks.h"
+#include "BeliefFunctions.h"
+
+/**
+ * This module selects at runtime how the checks of the library are reported.
+ * @file Validation.c
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Selects at runtime how the checks of the library are reported.
+ */
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+THEGAME_ValidationLevel THEGAME_validationLevel = THEGAME_VALIDATION_OFF;
+
+/** The function receiving the errors. */
+static THEGAME_ValidationCallback validationCallback = THEGAME_printValidationError;
+
+/** The data given to the function. */
+static void* validationData = NULL;
+
+/** The numbers of errors per type of checks. */
+static unsigned long nbErrors[THEGAME_NB_CHECKS];
+
+/** The names of the types of checks. */
+static const char* const checkNames[THEGAME_NB_CHECKS] = {
+	"CHECK_MODELS", "CHECK_VALUES", "CHECK_SUM", "CHECK_COMPATIBILITY"
+};
+
+
+
+void THEGAME_reportError(const THEGAME_CheckType check, const char* function,
+		const struct BF_BeliefFunction* beliefFunction, const char* format, ...){
+	THEGAME_ValidationError error = {THEGAME_CHECK_MODELS, NULL, NULL, NULL};
+	char message[MAX_STR_LEN];
+	va_list arguments;
+
+	__sync_fetch_and_add(&(nbErrors[check]), 1);
+	if(THEGAME_validationLevel != THEGAME_VALIDATION_CALLBACK){
+		return;
+	}
+	va_start(arguments, format);
+	vsnprintf(message, MAX_STR_LEN, format, arguments);
+	va_end(arguments);
+
+	error.check = check;
+	error.function = function;
+	error.message = message;
+	error.beliefFunction = beliefFunction;
+	validationCallback(&error, validationData);
+}
+
+
+
+/**
+ * @name Validation
+ * @{
+ */
+
+void THEGAME_setValidationLevel(const THEGAME_ValidationLevel level){
+	THEGAME_validationLevel = level;
+}
+
+
+
+THEGAME_ValidationLevel THEGAME_getValidationLevel(){
+	return THEGAME_validationLevel;
+}
+
+
+
+void THEGAME_setValidationCallback(THEGAME_ValidationCallback callback, void* data){
+	if(callback == NULL){
+		validationCallback = THEGAME_printValidationError;
+		validationData = NULL;
+	}
+	else {
+		validationCallback = callback;
+		validationData = data;
+	}
+}
+
+
+
+void THEGAME_printValidationError(const THEGAME_ValidationError* error, __attribute__((unused)) void* data){
+	char* str = NULL;
+
+	fprintf(stderr, "debug: %s fail in %s(), %s.\n", checkNames[error->check], error->function, error->message);
+	if(error->beliefFunction != NULL && error->beliefFunction->focals != NULL){
+		str = BF_beliefFunctionToBitString(*(error->beliefFunction));
+		fprintf(stderr, "debug: Faulty belief function:\n%s\n", str);
+		Memory_free(str);
+	}
+}
+
+
+
+unsigned long THEGAME_getNbValidationErrors(const THEGAME_CheckType check){
+	if(check < 0 || check >= THEGAME_NB_CHECKS){
+		return 0;
+	}
+
+	return nbErrors[check];
+}
+
+
+
+void THEGAME_resetValidationErrors(){
+	int i = 0;
+
+	for(i = 0; i < THEGAME_NB_CHECKS; i++){
+		nbErrors[i] = 0;
+	}
+}
+
+/** @} */
@@ -21,6 +21,7 @@
 
 #include "XmlBeliefFromSensors.h"
 #include "BeliefFunctions.h"
+#include "Tracing.h"
 
 
 /*
@@ -63,7 +64,7 @@ static char** getWorldArray(xmlDoc *doc, xmlXPathContext *context) {
 			context);
 	int i = 0;
 	int size = xPathRequest->nodesetval->nodeNr;
-	char** valuesArray = malloc(sizeof(char*) * size);
+	char** valuesArray = Memory_malloc(sizeof(char*) * size);
 	for (i = 0; i < size; ++i) {
 		valuesArray[i] = (char*) xmlNodeListGetString(doc,
 				xPathRequest->nodesetval->nodeTab[i]->children, 1);
@@ -182,12 +183,12 @@ static char** getWorldArrayForPoint(xmlNode *massNode, int *size) {
 	for(i = 0; i < setStrSize; i++) {
 		if(setStr[i] == ' ') worldNb++;
 	}
-	worlds = malloc(sizeof(char*) * worldNb);
+	worlds = Memory_malloc(sizeof(char*) * worldNb);
 
 	world = strtok((char*)setStr," ");
 	i = 0;
 	while (world != NULL) {
-		worlds[i] = strdup(world);
+		worlds[i] = Memory_strdup(world);
 		world = strtok (NULL, " ");
 		i++;
 	}
@@ -266,9 +267,9 @@ static void parsePoint(Sets_ReferenceList refList, BFS_SensorBeliefs *sensorBeli
 			BFS_addPointTosensorBelief(sensorBelief, elem, refList.card, value, mass);
 
 			for (i = 0; i < size; ++i) {
-				free(values[i]);
+				Memory_free(values[i]);
 			}
-			free(values);
+			Memory_free(values);
 			Sets_freeElement(&elem);
 		}
 	}
@@ -319,7 +320,7 @@ static int loadSensorBeliefs(Sets_ReferenceList refList, BFS_SensorBeliefs **sen
 	int i;
 	BFS_SensorBeliefs  sensorBelief;
 	int beliefNb = xPathRequest->nodesetval->nodeNr;
-	*sensorBeliefs = malloc(sizeof(BFS_SensorBeliefs) * (beliefNb));
+	*sensorBeliefs = Memory_malloc(sizeof(BFS_SensorBeliefs) * (beliefNb));
 	DEBUG_CHECK_MALLOC(sensorBeliefs);
 
 	for (i = 0; i < beliefNb; ++i) {
@@ -393,26 +394,32 @@ static void addBeliefstoStructure(BFS_BeliefStructure *beliefStructure,  xmlDoc
 		sensorBelief = getSensorBelief(sensorBeliefs, beliefNb,	beliefStructure->refList.card,
 				currentNode);
 		BFS_putSensorBelief(beliefStructure, sensorBelief);
-		free(sensorName);
+		xmlFree(sensorName);
 	}
 
 	xmlXPathFreeObject(xPathRequest);
 	for (i = 0; i < beliefNb; ++i) {
 		BFS_freeSensorBeliefs(&sensorBeliefs[i]);
 	}
-	free(sensorBeliefs);
+	Memory_free(sensorBeliefs);
 
 }
 
 BFS_BeliefStructure BFS_loadBeliefStructureFromXml(char *path) {
 	BFS_BeliefStructure belief;
-	xmlDoc *doc = xmlParseFile(path);
-	xmlXPathContext *context = xmlXPathNewContext(doc);
-	char* frameName = extractFrameName(context);
-	char** worldArray = getWorldArray(doc, context);
-	int worldNb = getWorldNb(context);
+	xmlDoc *doc = NULL;
+	xmlXPathContext *context = NULL;
+	char* frameName = NULL;
+	char** worldArray = NULL;
+	int worldNb = 0;
 	int i;
 
+	THEGAME_TRACE_BEGIN(THEGAME_TRACE_LOADING);
+	doc = xmlParseFile(path);
+	context = xmlXPathNewContext(doc);
+	frameName = extractFrameName(context);
+	worldArray = getWorldArray(doc, context);
+	worldNb = getWorldNb(context);
 	belief = BFS_createBeliefStructure(frameName,
 			(const char * const *) worldArray, worldNb);
 	addBeliefstoStructure(&belief, doc, context);
@@ -420,12 +427,13 @@ BFS_BeliefStructure BFS_loadBeliefStructureFromXml(char *path) {
 	/*
 	 * free everything
 	 */
-	free(frameName);
+	xmlFree(frameName);
 	for (i = 0; i < worldNb; ++i) {
-		free(worldArray[i]);
+		xmlFree(worldArray[i]);
 	}
-	free(worldArray);
+	Memory_free(worldArray);
 	xmlXPathFreeContext(context);
 	xmlFreeDoc(doc);
+	THEGAME_TRACE_END(THEGAME_TRACE_LOADING);
 	return belief;
 }
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef DEF_CHECKS
+#define DEF_CHECKS
+
+#include "config.h"
+#include "Validation.h"
+
+/**
+ * @file Checks.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Reports the errors found by the checks of the library (see Validation.h).
+ */
+
+/** The validation level of the library. */
+extern THEGAME_ValidationLevel THEGAME_validationLevel;
+
+/**
+ * @def THEGAME_VALIDATING
+ * Tells if the checks have to be done. Tested once per call, out of the loops, so that
+ * skipped checks cost nothing more.
+ */
+#define THEGAME_VALIDATING() (THEGAME_validationLevel != THEGAME_VALIDATION_OFF)
+
+/**
+ * Reports an error found by a check: counts it and gives it to the callback if required.
+ * @param check The type of the check
+ * @param function The name of the function which found the error
+ * @param beliefFunction The faulty belief function, NULL if none
+ * @param format The description of the error, as in printf()
+ */
+void THEGAME_reportError(const THEGAME_CheckType check, const char* function,
+		const struct BF_BeliefFunction* beliefFunction, const char* format, ...)
+		__attribute__((format(printf, 4, 5)));
+
+#endif
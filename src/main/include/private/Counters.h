@@ -0,0 +1,54 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef DEF_COUNTERS
+#define DEF_COUNTERS
+
+#include "config.h"
+#include "Stats.h"
+
+/**
+ * @file Counters.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Macros incrementing the counters of the calling thread (see Stats.h).
+ */
+
+#ifdef THEGAME_STATS
+
+/** The counters of the calling thread. */
+extern __thread THEGAME_Stats THEGAME_threadStats;
+
+/**
+ * @def THEGAME_COUNT
+ * Increments a counter of THEGAME_Stats.
+ */
+#define THEGAME_COUNT(counter) (THEGAME_threadStats.counter++)
+/**
+ * @def THEGAME_COUNT_N
+ * Adds a number to a counter of THEGAME_Stats.
+ */
+#define THEGAME_COUNT_N(counter, n) (THEGAME_threadStats.counter += (n))
+
+#else /* THEGAME_STATS */
+
+#define THEGAME_COUNT(counter) ((void)0)
+#define THEGAME_COUNT_N(counter, n) ((void)0)
+
+#endif /* THEGAME_STATS */
+
+#endif
@@ -22,6 +22,7 @@
 #include <string.h>
 #include <dirent.h>
 #include "config.h"
+#include "Memory.h"
 
 /**
  * @file ReadDirectory.h
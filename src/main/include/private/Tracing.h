@@ -0,0 +1,65 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef DEF_TRACING
+#define DEF_TRACING
+
+#include "config.h"
+#include "Trace.h"
+
+/**
+ * @file Tracing.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Macros tracing the entry points in the calling thread (see Trace.h).
+ */
+
+#ifdef THEGAME_TRACE
+
+/**
+ * Records the start of a traced call (only used through THEGAME_TRACE_BEGIN).
+ * @param stage The stage of the function
+ */
+void THEGAME_traceBegin(const THEGAME_TraceStage stage);
+
+/**
+ * Records the end of the last traced call (only used through THEGAME_TRACE_END).
+ * @param name The name of the function
+ * @param stage The stage of the function
+ */
+void THEGAME_traceEnd(const char* name, const THEGAME_TraceStage stage);
+
+/**
+ * @def THEGAME_TRACE_BEGIN
+ * Starts tracing the calling function in the given stage. Must be followed by THEGAME_TRACE_END
+ * with the same stage on each return.
+ */
+#define THEGAME_TRACE_BEGIN(stage) THEGAME_traceBegin((stage))
+/**
+ * @def THEGAME_TRACE_END
+ * Stops tracing the calling function and records it in the given stage.
+ */
+#define THEGAME_TRACE_END(stage) THEGAME_traceEnd(__func__, (stage))
+
+#else /* THEGAME_TRACE */
+
+#define THEGAME_TRACE_BEGIN(stage) ((void)0)
+#define THEGAME_TRACE_END(stage) ((void)0)
+
+#endif /* THEGAME_TRACE */
+
+#endif
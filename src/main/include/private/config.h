@@ -44,7 +44,7 @@
  * @def CHECK_MODELS
  * Uncomment it before compiling to check the validity of models in the 
  * applicative modules. Requires some more computation during the loading
- * phase.
+ * phase. As the other checks, only done if enabled at runtime (see THEGAME_setValidationLevel()).
  */
 #define CHECK_MODELS
 /**
@@ -62,6 +62,18 @@
  * Uncomment it before compiling to check the compatibility of fused mass functions.
  */
 #define CHECK_COMPATIBILITY
+/**
+ * @def THEGAME_STATS
+ * Uncomment it before compiling (or configure with cmake -DTHEGAME_STATS=ON) to count the
+ * allocations and operations of each thread (see THEGAME_getStats()). Otherwise, the counters compile out.
+ */
+/*#define THEGAME_STATS*/
+/**
+ * @def THEGAME_TRACE
+ * Uncomment it before compiling (or configure with cmake -DTHEGAME_TRACE=ON) to trace the entry points
+ * of each thread and keep histograms of their latencies (see Trace.h). Otherwise, the hooks compile out.
+ */
+/*#define THEGAME_TRACE*/
 
 
 
@@ -302,6 +314,31 @@
  * @li The debug code has been cleaned (Thx Aurélien!)
  * @li ... there are certainly things I forgot...
  *
+ * @section v07_subsec V0.7
+ * Mostly performance work:
+ * @li The temporization by fusion discounts and combines in a single pass (BF_discountedDuboisPradeCombination()), and can update the state of the option without copying it (BFS_temporization_fusionInPlace())
+ * @li A new module BeliefApproximations.c/h bounds the number of focal elements of belief functions
+ * (summarization, k-l-x, consonant and Bayesian approximations)
+ * @li BF_cleanBeliefFunction() works in place and merges duplicated focal elements
+ * @li Focal elements can be kept sorted (BF_sortFocals()), averages and differences are then computed by merging (BF_weightedSum())
+ * @li A new module BeliefMetrics.c/h computes all the measures of a belief function at once (BF_getMetrics()), including Deng and pignistic entropies
+ * @li Belief functions have an optional cache of derived quantities (BF_enableCache()), computed at once and then only read, so that several threads can query a cached function
+ * @li Copied, discounted and weakened belief functions are stored in a single block (flat layout), recognized by the address of their values (BF_isFlat()): the structure BF_BeliefFunction is unchanged
+ * @li Flat belief functions come from a per-thread pool of recycled blocks (BF_allocateBeliefFunction()), used by the Smets and Dubois & Prade combinations, holding at most BF_POOL_MAX_BYTES and emptied when the thread exits
+ * @li A new module Memory.c/h gives the allocator of the whole library, which can be replaced for the whole library (Memory_setAllocator()) or for a scope of a thread (Memory_pushAllocator()), and an arena allocator
+ * @li The models of BeliefsFromBeliefs.c/h are compiled into sparse matrices (BFB_compileMatrix()), transformations are matrix products, chains of models can be composed (BFB_composeBeliefsFromBeliefs())
+ * @li Many belief functions can be transformed at once with the same model, in several threads (BFB_believeFromBeliefBatch(), BFB_transformMasses())
+ * @li A benchmark target bench-thegame measures the public functions (time and allocations per operation) and writes the results in JSON
+ * @li Seeded and thread-safe random generators (BFR_createRandom()) giving random, Bayesian, consonant and simple support belief functions or following a cardinality profile, with Dirichlet masses
+ * @li A generator of synthetic models (modelgen-thegame) writes large models in the directory, XML and beliefs from beliefs formats, the benchmarks measure their loading
+ * @li Per-thread counters of allocations, set operations, combinations, mass lookups and powerset scans (THEGAME_getStats()), compiled with THEGAME_STATS
+ * @li Per-thread tracing of the entry points with log-linear latency histograms (THEGAME_getPercentile()), published to process-wide ones when the threads end (THEGAME_getProcessLatencies()), and Chrome trace-event output (THEGAME_writeChromeTrace()), compiled with THEGAME_TRACE
+ * @li The checks (CHECK_MODELS, CHECK_VALUES, CHECK_SUM, CHECK_COMPATIBILITY) are enabled at runtime (THEGAME_setValidationLevel()): off by default, counted only, or reported to a callback instead of stdout
+ * @li A replay benchmark (replay-thegame) runs timestamped sensor streams through the complete pipeline (evidence, fusion, transformation, decision) and gives the throughput and p50/p99/p999 latencies per tick
+ * @li A differential test (differential-thegame, run by ctest without Check) compares the optimized functions to reference implementations on random belief functions and gives their speedups
+ * @li The benchmarks can be compared to a baseline (bench-thegame --baseline), the optional perf tests of ctest (-DTHEGAME_PERF_TESTS=ON, then ctest -L perf) compare a short subset to a baseline regenerated on each machine with the target perf_baseline
+ * @li Memory footprints of belief functions and loaded models, by component (BF_memoryUsage(), BFS_memoryUsage(), BFB_memoryUsage())
+ *
  * @section Version_contact Contact
  * Bastien Pietropaoli @n
  *
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DEF_BELIEFAPPROXIMATIONS
+#define DEF_BELIEFAPPROXIMATIONS
+
+#include "BeliefFunctions.h"
+
+/**
+ * This module offers approximations of belief functions with a bounded number of focal elements.
+ * Combining belief functions again and again (for instance with the temporization by fusion)
+ * makes the number of focal elements grow, and with it the cost of every operation.
+ * The approximations given here bound this number and can report the error made,
+ * measured as the Jousselme distance (BF_distance()) between the original function
+ * and its approximation.
+ *
+ * If you have no idea to what corresponds exactly a function, you should refer to the given references.
+ * @file BeliefApproximations.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief CORE: Gives functions to approximate belief functions.
+ */
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+
+/**
+ * @name Approximations with a bounded number of focal elements
+ * @{
+ */
+
+/**
+ * Approximates a belief function by summarization as defined in J. D. Lowrance, T. D. Garvey
+ * & T. M. Strat 1986 (A framework for evidential-reasoning systems). The maxFocals - 1 focal
+ * elements with the highest masses are kept, the others are merged into their union which
+ * receives the sum of their masses.
+ * @param m The BF_BeliefFunction to approximate
+ * @param maxFocals The maximum number of focal elements of the approximation (at least 1)
+ * @param error If not NULL, receives the Jousselme distance between m and its approximation
+ * @return The approximation of m with at most maxFocals focal elements
+ */
+BF_BeliefFunction BF_summarize(const BF_BeliefFunction m, const int maxFocals, float* error);
+
+/**
+ * Approximates a belief function with the k-l-x method as defined in B. Tessem 1993
+ * (Approximations for efficient computation in the theory of evidence). The focal
+ * elements with the highest masses are kept: at least k of them, at most l of them, and
+ * no more once the dropped mass is lower than x. The kept masses are then normalized.
+ * @param m The BF_BeliefFunction to approximate
+ * @param k The minimum number of focal elements to keep
+ * @param l The maximum number of focal elements to keep
+ * @param x The maximum mass that may be dropped
+ * @param error If not NULL, receives the Jousselme distance between m and its approximation
+ * @return The approximation of m with at most l focal elements
+ */
+BF_BeliefFunction BF_klxApproximation(const BF_BeliefFunction m, const int k, const int l,
+		const float x, float* error);
+
+/** @} */
+
+/**
+ * @name Consonant and Bayesian approximations
+ * @{
+ */
+
+/**
+ * Gives an outer consonant approximation of a belief function. The atoms are ordered
+ * by decreasing plausibility, which defines a chain of nested sets A1 ⊂ A2 ⊂ ... ⊂ An.
+ * The mass of each focal element B is transfered to the smallest Ai containing B.
+ * The result is consonant, has at most n + 1 focal elements (the mass of the empty set is kept)
+ * and is less committed than m (every focal element is enlarged).
+ * @param m The BF_BeliefFunction to approximate
+ * @param error If not NULL, receives the Jousselme distance between m and its approximation
+ * @return The outer consonant approximation of m
+ */
+BF_BeliefFunction BF_outerConsonantApproximation(const BF_BeliefFunction m, float* error);
+
+/**
+ * Gives an inner consonant approximation of a belief function. The atoms are ordered
+ * by decreasing plausibility, which defines a chain of nested sets A1 ⊂ A2 ⊂ ... ⊂ An.
+ * The mass of each focal element B is transfered to the biggest Ai contained in B.
+ * The result is consonant and more committed than m (every focal element is reduced).
+ * @note The mass of focal elements which do not contain A1 is transfered to the empty set.
+ * @param m The BF_BeliefFunction to approximate
+ * @param error If not NULL, receives the Jousselme distance between m and its approximation
+ * @return The inner consonant approximation of m
+ */
+BF_BeliefFunction BF_innerConsonantApproximation(const BF_BeliefFunction m, float* error);
+
+/**
+ * Gives the Bayesian approximation of a belief function as defined in F. Voorbraak 1989
+ * (A computationally efficient approximation of Dempster-Shafer theory): the mass of each
+ * singleton is its normalized plausibility.
+ * @param m The BF_BeliefFunction to approximate
+ * @param error If not NULL, receives the Jousselme distance between m and its approximation
+ * @return The Bayesian approximation of m (only singletons as focal elements)
+ */
+BF_BeliefFunction BF_bayesianApproximation(const BF_BeliefFunction m, float* error);
+
+/**
+ * Gives the pignistic approximation of a belief function: the mass of each singleton
+ * is its pignistic probability (see BF_betP()), normalized by the mass that is not on the empty set.
+ * @param m The BF_BeliefFunction to approximate
+ * @param error If not NULL, receives the Jousselme distance between m and its approximation
+ * @return The pignistic approximation of m (only singletons as focal elements)
+ */
+BF_BeliefFunction BF_pignisticApproximation(const BF_BeliefFunction m, float* error);
+
+/** @} */
+
+#endif
@@ -55,6 +55,14 @@ enum BF_CombinationRule
 typedef enum BF_CombinationRule BF_CombinationRule;
 
 
+/**
+ * @def BF_MAX_COMMONALITY_SIZE
+ * The maximum size of elements for which BF_autoConflict() works on the dense
+ * commonality vector (2^size values). Above, successive combinations are used.
+ */
+#define BF_MAX_COMMONALITY_SIZE 16
+
+
 
 /*
   +-----------+
@@ -156,6 +164,19 @@ BF_BeliefFunction BF_fullDuboisPradeCombination(const BF_BeliefFunction* m, cons
  */
 BF_BeliefFunction BF_DuboisPradeCombination(const BF_BeliefFunction m1, const BF_BeliefFunction m2);
 
+/**
+ * Discounts a belief function and combines it with another one using the Dubois & Prade rule,
+ * in a single pass. The result is the same as BF_DuboisPradeCombination(BF_discounting(m1, alpha), m2)
+ * but the discounted function is never built: the discount is applied while the products
+ * are accumulated. This is the kernel of the temporization by fusion (see BeliefsFromSensors).
+ * @param m1 The BF_BeliefFunction to discount before the combination
+ * @param alpha The discounting factor (bounded to [0, 1] as in BF_discounting())
+ * @param m2 The BF_BeliefFunction to combine with the discounted one
+ * @return The resulting BF_BeliefFunction corresponding to the accumulation of evidences
+ */
+BF_BeliefFunction BF_discountedDuboisPradeCombination(const BF_BeliefFunction m1, const float alpha,
+		const BF_BeliefFunction m2);
+
 /**
  * Combines a list of belief functions into one. The combination rule used
  * is defined in C. K. Murphy 1999 (Combining belief functions when evidence conflicts).
@@ -250,6 +271,10 @@ BF_BeliefFunction BF_combination(const BF_BeliefFunction m1, const BF_BeliefFunc
  * The rule is defined in A. Martin 2009 (Modelisation et gestion du conflit
  * dans la theorie des fonctions de croyance (French)). The combination rule
  * used is the one defined above.
+ * The self-combination of degree k is q^k in the commonality space. Thus, as long as
+ * the size of elements does not exceed BF_MAX_COMMONALITY_SIZE, the commonality function
+ * is computed once and only the mass of the void set is retrieved for each degree
+ * (Moebius inversion: m(void) = sum over A of (-1)^|A| q(A)^k).
  * @param m The BF_BeliefFunction to work on
  * @param maxDegree The maximum degree of self-conflict required (the maximum
  *        of self-combination that will be done)
@@ -38,6 +38,40 @@
  */
 #define BF_PRECISION 0.000002
 
+/**
+ * @def BF_MAX_CACHE_SIZE
+ * The maximum size of elements for which the cache of a belief function (see BF_enableCache())
+ * stores the dense belief, plausibility and commonality vectors (2^size values each).
+ * Above, only the pignistic vector and the scalar measures are cached.
+ */
+#define BF_MAX_CACHE_SIZE 16
+
+/**
+ * @def BF_POOL_NB_BUCKETS
+ * The number of buckets of the pool of flat belief functions (see BF_allocateBeliefFunction()).
+ * The bucket i holds blocks of BF_POOL_MIN_BLOCK_SIZE * 2^i bytes. Bigger blocks are not pooled.
+ */
+#define BF_POOL_NB_BUCKETS 16
+
+/**
+ * @def BF_POOL_MIN_BLOCK_SIZE
+ * The size in bytes of the blocks of the first bucket of the pool.
+ */
+#define BF_POOL_MIN_BLOCK_SIZE 64
+
+/**
+ * @def BF_POOL_BUCKET_DEPTH
+ * The maximum number of blocks kept for reuse in each bucket of the pool, per thread.
+ */
+#define BF_POOL_BUCKET_DEPTH 8
+
+/**
+ * @def BF_POOL_MAX_BYTES
+ * The maximum number of bytes held by the blocks kept for reuse by the pool of a thread.
+ * Blocks given back beyond it are freed.
+ */
+#define BF_POOL_MAX_BYTES (1 << 20)
+
 
 /*
   +------------+
@@ -62,6 +96,40 @@ struct BF_FocalElement{
 typedef struct BF_FocalElement BF_FocalElement;
 
 
+/**
+ * The statistics of the pool of flat belief functions of a thread (see BF_getPoolStats()).
+ * @struct BF_PoolStats
+ */
+struct BF_PoolStats{
+    /** The number of blocks taken from the pool */
+    unsigned long hits;
+    /** The number of blocks allocated because the pool had none of the right size */
+    unsigned long misses;
+    /** The number of blocks given back to the pool */
+    unsigned long recycled;
+    /** The number of blocks freed because their bucket or the pool was full (or they were too big) */
+    unsigned long freed;
+    /** The bytes currently held by the blocks kept for reuse (not reset by BF_resetPoolStats()) */
+    size_t retained;
+};
+typedef struct BF_PoolStats BF_PoolStats;
+
+/**
+ * The bytes held by a belief function, by component (see BF_memoryUsage()).
+ * @struct BF_MemoryUsage
+ */
+struct BF_MemoryUsage{
+    /** The focal elements (with the header and the unused end of the block of a flat function) */
+    size_t focals;
+    /** The values of the elements */
+    size_t elements;
+    /** The cache and its vectors (0 if disabled) */
+    size_t cache;
+    /** The sum of the components */
+    size_t total;
+};
+typedef struct BF_MemoryUsage BF_MemoryUsage;
+
 /**
  * The real belief function. There are several ways to build
  * belief functions (for instance using the BeliefsFromSensors
@@ -71,6 +139,12 @@ typedef struct BF_FocalElement BF_FocalElement;
  * @param focals The focal elements of the mass function
  * @param nbFocals The number of focals
  * @param elementSize The number of possible worlds in the frame of discernment.
+ * The functions given by the library (copies, combinations, discountings...) have the flat
+ * layout: the focal elements and their values are stored in a single block, the values of the
+ * focal element i starting at (char*)(focals + nbFocals) + i * elementSize (see BF_isFlat()).
+ * Their values must not be freed or reallocated one by one: only BF_freeBeliefFunction() frees
+ * them, in a single call. Belief functions built by hand (one allocation for the focal elements
+ * and one for each element) are still supported by all the functions.
  * @struct BF_BeliefFunction
  */
 struct BF_BeliefFunction{
@@ -96,7 +170,55 @@ typedef struct BF_BeliefFunction BF_BeliefFunction;
  */
 
 /**
- * Copies a BF_BeliefFunction.
+ * Allocates a BF_BeliefFunction with the flat layout (see BF_BeliefFunction). The block is taken
+ * from a pool of recycled blocks, bucketed by size and kept per thread: freeing a flat function
+ * with BF_freeBeliefFunction() gives its block back to the pool of the calling thread. Thus, the
+ * intermediate functions of the fusion loops do not go through malloc() and free(). A thread keeps
+ * at most BF_POOL_MAX_BYTES in its pool, which is emptied when the thread exits.
+ * The functions of the library returning flat functions use it. Blocks are only pooled with the
+ * default allocator (see Memory.h), custom allocators get every request. A block is always freed
+ * by the allocator it comes from, even if another allocator is used since, and the cache of the
+ * function (see BF_enableCache()) is allocated with it too.
+ * If fewer focal elements than allocated are used, nbFocals must be lowered and the function
+ * finished with BF_shrinkBeliefFunction(). Without focal element, no block is allocated.
+ * @param nbFocals The number of focal elements
+ * @param elementSize The number of bits used to represend elements
+ * @return A BF_BeliefFunction whose focal elements are void with a null mass. Must be freed after use.
+ */
+BF_BeliefFunction BF_allocateBeliefFunction(const int nbFocals, const int elementSize);
+
+/**
+ * Checks if a BF_BeliefFunction has the flat layout (see BF_BeliefFunction). Flat functions are
+ * recognized by the address of their first values, right after the focal elements.
+ * @param m The BF_BeliefFunction to check
+ * @return 1 if the function is flat, 0 otherwise (or if it has no focal element).
+ */
+int BF_isFlat(const BF_BeliefFunction m);
+
+/**
+ * Finishes a function allocated with BF_allocateBeliefFunction() for an upper bound of focal elements
+ * whose nbFocals has then been lowered (the first nbFocals focal elements being used): the values are
+ * moved right after the focal elements, so that the function is recognized as flat again, and the
+ * function is moved into a block of the right size if its block is at least twice as big as needed.
+ * A function left without focal element gives its block back. The cache is kept.
+ * @param m A pointer to the BF_BeliefFunction to shrink, allocated with BF_allocateBeliefFunction()
+ */
+void BF_shrinkBeliefFunction(BF_BeliefFunction* m);
+
+/**
+ * Gets the statistics of the pool of the calling thread.
+ * @return The statistics since the start of the thread or the last call to BF_resetPoolStats().
+ */
+BF_PoolStats BF_getPoolStats();
+
+/**
+ * Resets the counters of the statistics of the pool of the calling thread.
+ */
+void BF_resetPoolStats();
+
+/**
+ * Copies a BF_BeliefFunction. The copy has the flat layout: the focal elements and
+ * all their values are stored in a single allocation.
  * @param m The BF_BeliefFunction to copy
  * @return A new BF_BeliefFunction. Must be freed after use.
  */
@@ -111,8 +233,10 @@ BF_BeliefFunction BF_getVacuousBeliefFunction(const int elementSize);
 
 /**
  * Cleans the BF_BeliefFunction given from all the non-focal elements.
- * If there are zeros, the list of BF_FocalElement is freed and replaced
- * by a clean one. Thus, it modifies the given BF_BeliefFunction.
+ * The focal elements are sorted (see Sets_compare()), the duplicated elements are merged,
+ * the elements with a mass lower than BF_PRECISION are removed and the function is normalized.
+ * Everything is done in place, without allocation: the list of BF_FocalElement keeps its
+ * size in memory, only the number of focals changes. Thus, it modifies the given BF_BeliefFunction.
  * @param bf A pointer to a BF_BeliefFunction
  */
 void BF_cleanBeliefFunction(BF_BeliefFunction* bf);
@@ -123,6 +247,55 @@ void BF_cleanBeliefFunction(BF_BeliefFunction* bf);
  */
 void BF_normalize(BF_BeliefFunction* bf);
 
+/**
+ * Sorts the focal elements of the given BF_BeliefFunction in the canonical order
+ * given by Sets_compare(). It modifies it, without allocation. Belief functions
+ * kept sorted (and without duplicates, see BF_cleanBeliefFunction()) benefit from
+ * merge-based implementations of BF_weightedSum() and of the functions relying on it.
+ * @param bf A pointer to the BF_BeliefFunction to sort
+ */
+void BF_sortFocals(BF_BeliefFunction* bf);
+
+/**
+ * Checks if the focal elements of a BF_BeliefFunction are sorted in the canonical
+ * order given by Sets_compare(), without duplicates.
+ * @param m The BF_BeliefFunction to check
+ * @return 1 if the focal elements are sorted, 0 otherwise.
+ */
+int BF_isSorted(const BF_BeliefFunction m);
+
+/**
+ * Enables the cache of the given BF_BeliefFunction: the belief, plausibility and commonality of
+ * every element (up to BF_MAX_CACHE_SIZE), the pignistic vector, the specificity, the non-specificity
+ * and the discrepancy are computed at once. Then, BF_bel(), BF_pl(), BF_q(), BF_betP(), BF_specificity(),
+ * BF_nonSpecificity() and BF_discrepancy() only read them. Worth it for functions queried many
+ * times (decisions, for instance). The cache belongs to the function: it is not shared with copies
+ * and is freed by BF_freeBeliefFunction(). The cache is kept in the block of the function, thus
+ * only flat functions (see BF_isFlat()) can be cached: for the others, use a copy (BF_copyBeliefFunction()).
+ * Does nothing if the cache is already enabled or if the function is not flat.
+ *
+ * Threads: once the cache is enabled, the queries never write it, so a cached function can be queried
+ * by several threads at once. Enabling, computing again (BF_invalidateCache()) or disabling the cache,
+ * as well as modifying the function, must not happen while other threads query it.
+ * @param bf A pointer to the BF_BeliefFunction
+ */
+void BF_enableCache(BF_BeliefFunction* bf);
+
+/**
+ * Computes again the cache of the given BF_BeliefFunction (if enabled) after a modification of
+ * the function. The functions of this module modifying a belief function (BF_cleanBeliefFunction(),
+ * BF_normalize()) call it. It must be called after any direct modification of the focal elements or
+ * of their masses. Not to be called while other threads query the function (see BF_enableCache()).
+ * @param bf A pointer to the BF_BeliefFunction
+ */
+void BF_invalidateCache(BF_BeliefFunction* bf);
+
+/**
+ * Disables the cache of the given BF_BeliefFunction and frees it.
+ * @param bf A pointer to the BF_BeliefFunction
+ */
+void BF_disableCache(BF_BeliefFunction* bf);
+
 /** @} */
 
 
@@ -139,13 +312,38 @@ void BF_normalize(BF_BeliefFunction* bf);
  * Get the new resulting BF_BeliefFunction knowing that an certain element
  * is true. The rule used is defined in P. Smets 1999 (The transferable
  * belief model for belief representation).
+ * @note The powerset is not required anymore, this function is kept for compatibility.
+ * Use BF_quickConditioning() instead.
  * @param m The BF_BeliefFunction to work on
  * @param e The element which is true
- * @param powerset The set of values the BF_BeliefFunction is applied on
+ * @param powerset Not used anymore
  * @return A conditioned BF_BeliefFunction knowing that e is true
  */
 BF_BeliefFunction BF_conditioning(const BF_BeliefFunction m, const Sets_Element e, const Sets_Set powerset);
 
+/**
+ * Get the new resulting BF_BeliefFunction knowing that an certain element
+ * is true. The rule used is defined in P. Smets 1999 (The transferable
+ * belief model for belief representation): the mass of each focal element
+ * is transfered to its intersection with e (thus, to the void set if they do not intersect).
+ * Only one pass on the focal elements is done, the powerset is not required.
+ * The focal elements of the result are sorted (see BF_sortFocals()).
+ * @param m The BF_BeliefFunction to work on
+ * @param e The element which is true
+ * @return A conditioned BF_BeliefFunction knowing that e is true. Must be freed after use.
+ */
+BF_BeliefFunction BF_quickConditioning(const BF_BeliefFunction m, const Sets_Element e);
+
+/**
+ * Conditions a BF_BeliefFunction on several elements at once (see BF_quickConditioning()).
+ * @param m The BF_BeliefFunction to work on
+ * @param events The elements to condition on
+ * @param nbEvents The number of elements
+ * @return An array of nbEvents conditioned BF_BeliefFunction, in the order of the events.
+ * Each function and the array must be freed after use.
+ */
+BF_BeliefFunction* BF_multipleConditioning(const BF_BeliefFunction m, const Sets_Element* events, const int nbEvents);
+
 /**
  * Weakens a belief function given a coefficient alpha in [0,1]. All
  * believes on focal elements will be multiplied by a factor of (1 - alpha).
@@ -177,6 +375,20 @@ BF_BeliefFunction BF_discounting(const BF_BeliefFunction m, const float alpha);
  */
 BF_BeliefFunction BF_difference(const BF_BeliefFunction m1, const BF_BeliefFunction m2);
 
+/**
+ * Get the weighted sum of several BeliefFunctions (represented as a BF_BeliefFunction but
+ * is an actual one only if the weights sum to 1). Every element that is focal in at least
+ * one of the functions is in the result, which is sorted (see BF_sortFocals()).
+ * If all the functions are sorted (see BF_isSorted()), the focal elements are merged in
+ * O(F log(nbM)) where F is the total number of focal elements. Otherwise, they are sorted first.
+ * Without any function (nbM <= 0), the result has no focal element.
+ * @param m The BeliefFunctions to sum
+ * @param weights The weight of each function
+ * @param nbM The number of functions
+ * @return The weighted sum of the functions. Must be freed after use.
+ */
+BF_BeliefFunction BF_weightedSum(const BF_BeliefFunction* m, const float* weights, const int nbM);
+
 /** @} */
 
 /**
@@ -236,6 +448,25 @@ float BF_q(const BF_BeliefFunction m, const Sets_Element e);
  */
 float BF_betP(const BF_BeliefFunction m, const Sets_Element e);
 
+/**
+ * Get the pignistic probability of every singleton given a BF_BeliefFunction
+ * in a single pass on the focal elements (see BF_betP()). The pignistic probability
+ * of any element is then the sum of the values of its atoms (see BF_betPFromVector()).
+ * @param m The BF_BeliefFunction to work on
+ * @return An array of m.elementSize probabilities, the i-th one being the one of the i-th atom.
+ * Must be freed after use.
+ */
+float* BF_pignisticVector(const BF_BeliefFunction m);
+
+/**
+ * Get the pignistic probability of an element from a vector given by BF_pignisticVector().
+ * @param pignistic The pignistic probabilities of the singletons
+ * @param e The Element to work on
+ * @param elementSize The size of the elements
+ * @return The pignistic probability of the element
+ */
+float BF_betPFromVector(const float* pignistic, const Sets_Element e, const int elementSize);
+
 /** @} */
 
 /**
@@ -334,6 +565,23 @@ int BF_checkValues(const BF_BeliefFunction m);
 /** @} */
 
 
+/**
+ * @name Memory usage
+ * @{
+ */
+
+/**
+ * Gets the bytes held by a belief function, by component. The sizes are the ones
+ * requested to the allocator (its own overhead is not counted). The block of a flat
+ * function is counted whole, as it is taken from the pool.
+ * @param m The belief function
+ * @return The bytes held by the focal elements, their values and the cache
+ */
+BF_MemoryUsage BF_memoryUsage(const BF_BeliefFunction m);
+
+/** @} */
+
+
 /* !!! Deallocate memory given to believes !!! */
 
 /**
@@ -342,7 +590,7 @@ int BF_checkValues(const BF_BeliefFunction m);
  */
 
 /**
- * Frees the memory used for the BF_BeliefFunction.
+ * Frees the memory used for the BF_BeliefFunction (including its cache).
  * @param bs A pointer to the BF_BeliefFunction to free
  */
 void BF_freeBeliefFunction(BF_BeliefFunction* bf);
@@ -353,6 +601,12 @@ void BF_freeBeliefFunction(BF_BeliefFunction* bf);
  */
 void BF_freeBeliefPoint(BF_FocalElement *bp);
 
+/**
+ * Frees the blocks kept for reuse by the pool of the calling thread (see BF_allocateBeliefFunction()).
+ * The pool of a thread started with pthread_create() is emptied when it exits anyway.
+ */
+void BF_clearPool();
+
 /** @} */
 
 /* !!! Conversion into strings !!! */
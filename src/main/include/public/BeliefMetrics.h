@@ -0,0 +1,158 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DEF_BELIEFMETRICS
+#define DEF_BELIEFMETRICS
+
+#include "BeliefCombinations.h"
+
+/**
+ * This module computes in one go the measures used to characterize a belief function
+ * (specificity, non-specificity, discrepancy, entropies, distance to other sources, auto-conflict...).
+ * Calling each function of BeliefFunctions separately means one pass on the focal elements per
+ * measure and the same logarithms computed again and again. Here, the measures based on focal
+ * elements are computed in a single pass sharing a table of logarithms computed once per frame,
+ * the distance to other sources shares the terms of the measured function between the sources.
+ *
+ * If you have no idea to what corresponds exactly a function, you should refer to the given references.
+ * @file BeliefMetrics.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief CORE: Gives functions to measure belief functions.
+ */
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * The logarithms required by the measures, for each possible cardinality of a frame,
+ * and the buffer of the pignistic probabilities of the singletons reused by each measure.
+ * Build it once per frame with BF_createMetricsTable(). As its buffer is written by
+ * BF_getMetrics(), a table is used by one thread at a time.
+ * @struct BF_MetricsTable
+ */
+struct BF_MetricsTable {
+	/** The size of the elements of the frame */
+	int elementSize;
+	/** log2(k) for k in [0, elementSize] (0 for k = 0) */
+	double* log2Card;
+	/** log2(2^k - 1), the number of non-empty subsets of a set of k atoms (0 for k = 0) */
+	double* log2NbSubsets;
+	/** The pignistic probabilities of the singletons (elementSize values, overwritten by each measure) */
+	float* pignistic;
+};
+typedef struct BF_MetricsTable BF_MetricsTable;
+
+/**
+ * The measures of a belief function computed by BF_getMetrics().
+ * @struct BF_Metrics
+ */
+struct BF_Metrics {
+	/** See BF_specificity() */
+	float specificity;
+	/** See BF_nonSpecificity() */
+	float nonSpecificity;
+	/** See BF_discrepancy() */
+	float discrepancy;
+	/**
+	 * Deng entropy as defined in Y. Deng 2016 (Deng entropy):
+	 * -sum of m(A) log2(m(A) / (2^|A| - 1))
+	 */
+	float dengEntropy;
+	/**
+	 * Shannon entropy of the pignistic probabilities of singletons (ambiguity measure
+	 * as defined in A.-L. Jousselme et al. 2006 (Measuring ambiguity in the evidence theory))
+	 */
+	float pignisticEntropy;
+	/**
+	 * Total uncertainty as the sum of the non-specificity and the discrepancy
+	 * (the two kinds of uncertainty distinguished by G. J. Klir 1994)
+	 */
+	float totalUncertainty;
+	/** See BF_globalDistance() (0 if no other source is given) */
+	float globalDistance;
+	/** See BF_autoConflict() (NULL if the maximum degree is 0) */
+	float* autoConflict;
+	/** The number of values in autoConflict */
+	int nbAutoConflict;
+};
+typedef struct BF_Metrics BF_Metrics;
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+/**
+ * @name Metrics
+ * @{
+ */
+
+/**
+ * Builds the table of logarithms for a given frame.
+ * @param elementSize The size of the elements of the frame
+ * @return The table of logarithms. Must be freed after use with BF_freeMetricsTable().
+ */
+BF_MetricsTable BF_createMetricsTable(const int elementSize);
+
+/**
+ * Computes all the measures of a belief function. The measures depending only on the focal
+ * elements are computed in a single pass (plus one for the discrepancy which requires the
+ * pignistic probabilities of all singletons, kept in the buffer of the table). The global
+ * distance is the one of BF_globalDistance(), the scalar product of m with itself being computed
+ * once for all the sources and the Jaccard indexes without allocation. The auto-conflict is
+ * computed with BF_autoConflict(). Thus, it is not slower than the separate functions.
+ * @note The focal elements with a null mass are ignored (0 log(0) = 0), thus the discrepancy
+ * is defined even when BF_discrepancy() is not.
+ * @param m The BF_BeliefFunction to measure
+ * @param table The table of logarithms of the frame of m (see BF_createMetricsTable()), the logarithms it lacks are computed
+ * (and its buffer replaced by a temporary one if too small)
+ * @param s The sources to compute the global distance with (may be NULL)
+ * @param nbBF The number of sources in s
+ * @param maxDegree The maximum degree of auto-conflict (0 to skip it)
+ * @return The measures. Must be freed after use with BF_freeMetrics().
+ */
+BF_Metrics BF_getMetrics(const BF_BeliefFunction m, const BF_MetricsTable table,
+		const BF_BeliefFunction* s, const int nbBF, const int maxDegree);
+
+/** @} */
+
+/**
+ * @name Memory deallocation
+ * @{
+ */
+
+/**
+ * Frees a table of logarithms.
+ * @param table The table to free
+ */
+void BF_freeMetricsTable(BF_MetricsTable* table);
+
+/**
+ * Frees the memory used by measures.
+ * @param metrics The measures to free
+ */
+void BF_freeMetrics(BF_Metrics* metrics);
+
+/** @} */
+
+#endif
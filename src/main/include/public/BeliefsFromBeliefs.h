@@ -112,6 +112,27 @@
  */
 #define BFB_VALUES_NAME "values"
 
+/**
+ * @def BFB_MAX_COMPILED_SIZE
+ * The maximum size of the frames of discernment for which the transformations are compiled
+ * into matrices (see BFB_Matrix). Above, the transformations search the belief vectors.
+ */
+#define BFB_MAX_COMPILED_SIZE 16
+
+/**
+ * @def BFB_MAX_DENSE_ENTRIES
+ * The maximum number of entries (2^|from| x 2^|to|) of a compiled matrix for which the
+ * matrix is also stored as a dense array, faster to multiply for small frames.
+ */
+#define BFB_MAX_DENSE_ENTRIES 4096
+
+/**
+ * @def BFB_MAX_THREADS
+ * The maximum number of threads used by the batched transformations
+ * (see BFB_believeFromBeliefBatch() and BFB_transformMasses()).
+ */
+#define BFB_MAX_THREADS 64
+
 
 /*
   +------------+
@@ -136,12 +157,40 @@ struct BFB_BeliefVector{
 typedef struct BFB_BeliefVector BFB_BeliefVector;
 
 
+/**
+ * The compiled form of the belief vectors of a BFB_BeliefFromBelief: a sparse matrix in
+ * the CSR (compressed sparse row) format. Rows and columns are indexed by the number of the
+ * elements (see Sets_numberFromElement()), rows in the frame we're coming from, columns in the
+ * frame we're going to. The entries of the row r are the indices rowStarts[r] to rowStarts[r + 1] - 1
+ * of columns and factors. The transformation of a belief function is then a product of
+ * the matrix by the vector of its masses.
+ * @param nbRows The number of rows (2^|from|, 0 if the matrix is not compiled)
+ * @param nbColumns The number of columns (2^|to|)
+ * @param rowStarts The index of the first entry of each row (nbRows + 1 values)
+ * @param columns The column of each entry
+ * @param factors The factor of each entry
+ * @param dense The matrix as a dense array (nbRows x nbColumns, row by row) for small frames, NULL otherwise
+ * @struct BFB_Matrix
+ */
+struct BFB_Matrix{
+	int nbRows;
+	int nbColumns;
+	int* rowStarts;
+	int* columns;
+	float* factors;
+	float* dense;
+};
+typedef struct BFB_Matrix BFB_Matrix;
+
+
 /**
  * The matrix to convert belief on a frame of discernment in a belief on another
  * frame of discernment.
  * @param frameName The name of the frame of discernment from which we start
  * @param refList The reference list for the explicitation of the states names in the frame
  * @param vectors The list of vectors corresponding to the matrix
+ * @param frameHash The hash of the frame name, to find the model of a frame quickly
+ * @param matrix The vectors compiled into a sparse matrix (see BFB_compileMatrix())
  * @struct BFB_BeliefFromBelief
  */
 struct BFB_BeliefFromBelief{
@@ -149,6 +198,8 @@ struct BFB_BeliefFromBelief{
 	Sets_ReferenceList refList;
 	BFB_BeliefVector* vectors;
 	int nbVectors;
+	unsigned long frameHash;
+	BFB_Matrix matrix;
 };
 typedef struct BFB_BeliefFromBelief BFB_BeliefFromBelief;
 
@@ -171,6 +222,26 @@ struct BFB_BeliefStructure{
 typedef struct BFB_BeliefStructure BFB_BeliefStructure;
 
 
+/**
+ * The bytes held by a belief structure or one of its models, by component
+ * (see BFB_memoryUsage()).
+ * @struct BFB_MemoryUsage
+ */
+struct BFB_MemoryUsage{
+	/** The names of the frames */
+	size_t names;
+	/** The reference lists of the frames */
+	size_t refLists;
+	/** The belief vectors: elements and factors */
+	size_t vectors;
+	/** The compiled matrices, sparse and dense parts */
+	size_t matrices;
+	/** The sum of the components */
+	size_t total;
+};
+typedef struct BFB_MemoryUsage BFB_MemoryUsage;
+
+
 /*
   +-----------+
   | FUNCTIONS |
@@ -235,6 +306,35 @@ BFB_BeliefFromBelief BFB_loadBeliefFromBelief(const char* frameOfOrigin, const c
  */
 BFB_BeliefVector BFB_loadBeliefVector(const char* fileName, const Sets_ReferenceList rlFrom, const Sets_ReferenceList rlTo);
 
+/**
+ * Compiles the belief vectors of a BFB_BeliefFromBelief into a sparse matrix (see BFB_Matrix).
+ * Called when loading a model, thus it is only needed for models built by hand.
+ * The empty set is always transformed into the empty set. If several vectors have the same
+ * element of origin, the first one is used. If one of the frames is bigger than
+ * BFB_MAX_COMPILED_SIZE, the matrix is not compiled (nbRows = 0).
+ * @param bfb The BFB_BeliefFromBelief to compile
+ * @param elementSize The number of digits of the elements of the frame we're going to
+ * @return The compiled matrix. Must be freed after use with BFB_freeMatrix().
+ */
+BFB_Matrix BFB_compileMatrix(const BFB_BeliefFromBelief bfb, const int elementSize);
+
+/**
+ * Composes a chain of models into a single one: the first model transforms beliefs from a frame F0
+ * to a frame F1, the second one from F1 to F2, etc. As the transformations are linear, the composed
+ * model is the product of their matrices, computed once (and kept sparse) instead of building the
+ * intermediate belief functions at each transformation. The models must be compiled (see BFB_compileMatrix()).
+ * As a model does not know the frame it goes to, the structure of each model is given too: each model
+ * must come from the frame of the structure of the previous one (same name and same states), the chain
+ * is not composed otherwise.
+ * @param chain The models to compose, in order
+ * @param to The structures the models belong to (to[i] being the frame chain[i] goes to)
+ * @param nbBFB The number of models in the chain
+ * @return The composed BFB_BeliefFromBelief, coming from the frame of the first model (same name and reference list)
+ *         and going to the frame of the last structure. Its frameName is NULL if the chain cannot be composed.
+ *         Must be freed after use.
+ */
+BFB_BeliefFromBelief BFB_composeBeliefsFromBeliefs(const BFB_BeliefFromBelief* chain, const BFB_BeliefStructure* to, const int nbBFB);
+
 /** @} */
 
 
@@ -258,12 +358,69 @@ BF_BeliefFunction* BFB_believeFromBeliefs(const BFB_BeliefStructure bs, const ch
 
 /**
  * Get the BF_BeliefFunction resulting of the transformation given a specific model.
+ * If the model is compiled (see BFB_compileMatrix()), the transformation is a product of its
+ * matrix by the masses. The resulting focal elements are ordered by number and the ones with
+ * a null mass are not kept.
  * @param bfb The BFB_BeliefFromBelief model to use for the transformation
  * @param from The BF_BeliefFunction to transform
  * @param elementSize The number of digits to use in the resulting belief function.
+ * @return The transformed BF_BeliefFunction. Must be freed after use.
  */
 BF_BeliefFunction BFB_believeFromBelief(const BFB_BeliefFromBelief bfb, const BF_BeliefFunction from, const int elementSize);
 
+/**
+ * Get the BF_BeliefFunctions resulting of the transformation of many belief functions (one per
+ * entity, a room for instance) with the same model. The belief functions are shared between
+ * threads, each one transforming a contiguous slice of them. Threads are only used with the
+ * default allocator (see Memory_setAllocator()), custom allocators may not be thread-safe.
+ * @param bfb The BFB_BeliefFromBelief model to use for the transformation
+ * @param from The BF_BeliefFunctions to transform
+ * @param nbBF The number of belief functions to transform
+ * @param elementSize The number of digits to use in the resulting belief functions
+ * @param nbThreads The number of threads to use (1 to work in the calling thread only)
+ * @return The list of transformed BF_BeliefFunctions (in the same order). Must be freed after use.
+ */
+BF_BeliefFunction* BFB_believeFromBeliefBatch(const BFB_BeliefFromBelief bfb, const BF_BeliefFunction* from, const int nbBF,
+		const int elementSize, const int nbThreads);
+
+/**
+ * Transforms the dense mass vectors of many entities at once with a compiled matrix (see BFB_Matrix).
+ * The masses are stored subset by subset: the mass of the element number e for the entity b is
+ * masses[e * nbBF + b]. The transformation is then a product of the sparse matrix by a dense
+ * matrix, each entry of the sparse matrix being applied to all the entities in a row.
+ * The entities are shared between threads (see BFB_believeFromBeliefBatch()).
+ * @param matrix The compiled matrix of the model
+ * @param masses The masses to transform (matrix.nbRows x nbBF values)
+ * @param results The transformed masses (matrix.nbColumns x nbBF values), overwritten
+ * @param nbBF The number of entities
+ * @param nbThreads The number of threads to use (1 to work in the calling thread only)
+ */
+void BFB_transformMasses(const BFB_Matrix matrix, const float* masses, float* results, const int nbBF, const int nbThreads);
+
+/** @} */
+
+
+/**
+ * @name Memory usage
+ * @{
+ */
+
+/**
+ * Gets the bytes held by a belief structure, by component, its models included.
+ * The sizes are the ones requested to the allocator (its own overhead is not counted).
+ * @param bs The belief structure
+ * @return The bytes held by each component of the structure
+ */
+BFB_MemoryUsage BFB_memoryUsage(const BFB_BeliefStructure bs);
+
+/**
+ * Gets the bytes held by a model of belief from belief, by component.
+ * @param bfb The model
+ * @param elementSize The size of the elements of the frame we're going to
+ * @return The bytes held by each component of the model
+ */
+BFB_MemoryUsage BFB_beliefFromBeliefMemoryUsage(const BFB_BeliefFromBelief bfb, const int elementSize);
+
 /** @} */
 
 
@@ -290,6 +447,12 @@ void BFB_freeBeliefFromBelief(BFB_BeliefFromBelief* bfb);
  */
 void BFB_freeBeliefVector(BFB_BeliefVector* bv);
 
+/**
+ * Frees the memory used for the BFB_Matrix.
+ * @param matrix A pointer to the BFB_Matrix to free
+ */
+void BFB_freeMatrix(BFB_Matrix* matrix);
+
 /** @} */
 
 
@@ -34,6 +34,38 @@
  *        functions to create random belief functions.
  */
 
+
+/**
+ * @def BFR_MAX_SIZE
+ * The maximum number of possible worlds for the seeded generators (elements are drawn as 64 bits numbers).
+ */
+#define BFR_MAX_SIZE 63
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * The state of a random number generator (xoshiro256**). Each thread should use its own state:
+ * the generators of this module using a BFR_Random are reproducible given the seed and thread-safe.
+ * @struct BFR_Random
+ */
+struct BFR_Random {
+	/** The 256 bits of the state */
+	uint64_t state[4];
+};
+typedef struct BFR_Random BFR_Random;
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
 /**
  * @name Utility functions
  * @{
@@ -45,6 +77,50 @@
  */
 void BFR_generateRandomSeed();
 
+/**
+ * Creates the state of a random number generator from a seed.
+ * @param seed The seed (the same seed gives the same numbers)
+ * @return The state of the generator.
+ */
+BFR_Random BFR_createRandom(const uint64_t seed);
+
+/**
+ * Advances a generator by 2^128 numbers. Used to get non-overlapping sequences for several threads
+ * from a single seed: the first thread uses the created state, the second one the state after a jump, etc.
+ * @param random The state to advance
+ */
+void BFR_jump(BFR_Random* random);
+
+/**
+ * Draws a random 64 bits number.
+ * @param random The state of the generator
+ * @return A uniformly distributed 64 bits number.
+ */
+uint64_t BFR_next(BFR_Random* random);
+
+/**
+ * Draws a random number in [0, 1[.
+ * @param random The state of the generator
+ * @return A uniformly distributed number in [0, 1[.
+ */
+double BFR_uniform(BFR_Random* random);
+
+/**
+ * Draws a random integer in [0, bound[ (without modulo bias).
+ * @param random The state of the generator
+ * @param bound The exclusive upper bound (> 0)
+ * @return A uniformly distributed integer in [0, bound[.
+ */
+uint64_t BFR_uniformInteger(BFR_Random* random, const uint64_t bound);
+
+/**
+ * Draws a random number following a gamma distribution of scale 1 (Marsaglia and Tsang).
+ * @param random The state of the generator
+ * @param shape The shape of the distribution (> 0)
+ * @return A random number following Gamma(shape, 1).
+ */
+double BFR_gamma(BFR_Random* random, const double shape);
+
 /**@}*/
 
 /**
@@ -55,7 +131,8 @@ void BFR_generateRandomSeed();
 /**
  * Generates a crappy random belief function with a random number of focals elements,
  * random focal elements and random mass values. It is crap as the mass values and the
- * size of focal elements are not well distributed.
+ * size of focal elements are not well distributed. It uses rand(): see BFR_getRandomBelief()
+ * for a reproducible and thread-safe generator.
  * @param elementSize The number of possible states/worlds.
  * @return A random belief function. 
  */
@@ -73,6 +150,73 @@ BF_BeliefFunction BFR_getCrappyRandomBeliefWithFixedNbFocals(const int elementSi
 
 /**@}*/
 
+/**
+ * @name Seeded random generators
+ * The following generators use an explicit BFR_Random state. The distinct focal elements are drawn in
+ * O(nbFocals) with Floyd's algorithm (no rejection loop) and the masses follow a symmetric Dirichlet distribution
+ * of parameter alpha: alpha = 1 gives masses uniformly distributed on the simplex, small values of alpha
+ * concentrate the mass on few focal elements and high values tend to equal masses.
+ * The functions are flat (see BF_allocateBeliefFunction()), elementSize cannot exceed BFR_MAX_SIZE and
+ * a null BF_BeliefFunction is returned if nbFocals is too high for the distribution.
+ * @{
+ */
+
+/**
+ * Generates a random belief function with nbFocals distinct non-empty focal elements uniformly drawn.
+ * @param random The state of the generator
+ * @param elementSize The number of possible states/worlds
+ * @param nbFocals The number of focal elements (<= 2^elementSize - 1)
+ * @param alpha The parameter of the Dirichlet distribution of the masses (> 0)
+ * @return A random belief function. Must be freed after use.
+ */
+BF_BeliefFunction BFR_getRandomBelief(BFR_Random* random, const int elementSize, const int nbFocals, const double alpha);
+
+/**
+ * Generates a random Bayesian belief function (focal elements are singletons).
+ * @param random The state of the generator
+ * @param elementSize The number of possible states/worlds
+ * @param nbFocals The number of focal elements (<= elementSize)
+ * @param alpha The parameter of the Dirichlet distribution of the masses (> 0)
+ * @return A random Bayesian belief function. Must be freed after use.
+ */
+BF_BeliefFunction BFR_getRandomBayesianBelief(BFR_Random* random, const int elementSize, const int nbFocals, const double alpha);
+
+/**
+ * Generates a random consonant belief function (focal elements are nested).
+ * @param random The state of the generator
+ * @param elementSize The number of possible states/worlds
+ * @param nbFocals The number of focal elements (<= elementSize)
+ * @param alpha The parameter of the Dirichlet distribution of the masses (> 0)
+ * @return A random consonant belief function. Must be freed after use.
+ */
+BF_BeliefFunction BFR_getRandomConsonantBelief(BFR_Random* random, const int elementSize, const int nbFocals, const double alpha);
+
+/**
+ * Generates a random simple support function: a random focal element A (neither empty nor complete)
+ * with a mass uniformly drawn in [0, 1[, the rest on the complete set.
+ * @param random The state of the generator
+ * @param elementSize The number of possible states/worlds (>= 2)
+ * @return A random simple support function. Must be freed after use.
+ */
+BF_BeliefFunction BFR_getRandomSimpleSupportBelief(BFR_Random* random, const int elementSize);
+
+/**
+ * Generates a random belief function whose focal elements follow a cardinality profile: the cardinality
+ * of each focal element is drawn with the given weights, then the element is uniformly drawn among the
+ * elements of that cardinality (distinct elements are kept).
+ * @param random The state of the generator
+ * @param elementSize The number of possible states/worlds
+ * @param nbFocals The number of focal elements
+ * @param profile The weights of the cardinalities: profile[c - 1] for the cardinality c (elementSize values)
+ * @param alpha The parameter of the Dirichlet distribution of the masses (> 0)
+ * @return A random belief function. Must be freed after use. It has less than nbFocals focal elements
+ *         if the profile does not allow enough distinct elements (after 8 * nbFocals draws).
+ */
+BF_BeliefFunction BFR_getRandomBeliefWithProfile(BFR_Random* random, const int elementSize, const int nbFocals,
+		const double* profile, const double alpha);
+
+/**@}*/
+
 
 #endif
 
@@ -228,12 +228,15 @@ typedef union BFS_UtilData BFS_UtilData;
  * @param type The type of option, there can be only one!
  * @param parameter A parameter to apply to the option
  * @param util A list of BFS_UtilData to store specific data for the option
+ * @param allocator The allocator the option is created with, which keeps the state of the
+ * temporization whatever the allocator used by the calls (see Memory.h)
  * @struct BFS_Option
  */
 struct BFS_Option{
     BFS_OptionFlags type;
     float parameter;
     BFS_UtilData* util;
+    Memory_Allocator allocator;
 };
 typedef struct BFS_Option BFS_Option;
 
@@ -284,6 +287,31 @@ struct BFS_BeliefStructure{
 typedef struct BFS_BeliefStructure BFS_BeliefStructure;
 
 
+/**
+ * The bytes held by a belief structure, by component (see BFS_memoryUsage()).
+ * @struct BFS_MemoryUsage
+ */
+struct BFS_MemoryUsage{
+    /** The name of the frame and the types of the sensors */
+    size_t names;
+    /** The reference list */
+    size_t refList;
+    /** The set of possible values */
+    size_t possibleValues;
+    /** The powerset (2^card(refList) elements) */
+    size_t powerset;
+    /** The array of sensors */
+    size_t sensors;
+    /** The curves of the sensors: focal elements and points */
+    size_t curves;
+    /** The options of the sensors with their state (stored measures and belief functions) */
+    size_t options;
+    /** The sum of the components */
+    size_t total;
+};
+typedef struct BFS_MemoryUsage BFS_MemoryUsage;
+
+
 
 /*
   +-----------+
@@ -392,7 +420,8 @@ void BFS_addPointTosensorBelief(BFS_SensorBeliefs *sensorBeliefs, Sets_Element e
  * @param frameName The name of the frame of discernment (Name of the directory to look for.)
  * @return The complete BFS_BeliefStructure containing all the beliefs that may be used
  *         to estimate the real world state. The BFS_BeliefStructure is empty if an error occurs.
- *         (The frameName attribute should be NULL in case of error.) Must be freed after use.
+ *         (The frameName attribute should be NULL in case of error.) Must be freed after use, with the
+ *         allocator used to load it (which keeps the state of its temporization options, see Memory.h).
  */
 BFS_BeliefStructure BFS_loadBeliefStructure(const char * directory, const char* frameName);
 
@@ -577,6 +606,38 @@ BF_BeliefFunction BFS_temporization_fusion(const BF_BeliefFunction oldOne,
 BF_BeliefFunction BFS_temporization_fusionElapsedTime(const BF_BeliefFunction oldOne,
 		const BF_BeliefFunction newOne, const float timeFactor, BFS_Option* op,
 		const float elapsedTime);
+
+/**
+ * Applies the temporization of BFS_temporization_fusionElapsedTime() directly to the
+ * belief function stored in the option, without copying the result. The stored function
+ * is discounted and fused with the new one (or only discounted if newOne.focals == NULL,
+ * the next elapsed time then being counted from this call). The first call stores a copy
+ * of the new function.
+ * @param newOne The last BF_BeliefFunction corresponding to the last received measure
+ * @param timeFactor The factor used to discount over time (linear discount over time for now)
+ * @param op A pointer to the temporization option storing the state
+ * @param elapsedTime time since the last measure in seconds
+ * @return A pointer to the state of the option, valid until the next update of the option
+ * or BFS_freeOption(). It must not be freed.
+ */
+const BF_BeliefFunction* BFS_temporization_fusionInPlace(const BF_BeliefFunction newOne,
+		const float timeFactor, BFS_Option* op, const float elapsedTime);
+/** @} */
+
+/**
+ * @name Memory usage
+ * @{
+ */
+
+/**
+ * Gets the bytes held by a belief structure, by component. The sizes are the ones
+ * requested to the allocator (its own overhead is not counted). The belief functions
+ * stored by the temporization options are counted as with BF_memoryUsage().
+ * @param bs The belief structure
+ * @return The bytes held by each component of the structure
+ */
+BFS_MemoryUsage BFS_memoryUsage(const BFS_BeliefStructure bs);
+
 /** @} */
 
 /* !!! Deallocate memory given to beliefs !!! */
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DEF_MEMORY
+#define DEF_MEMORY
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+
+/**
+ * This module gives the allocator used by the whole library. By default, it is the
+ * standard malloc(), realloc() and free(). Another allocator can be set for the whole
+ * library with Memory_setAllocator(), or for a scope of the calling thread with
+ * Memory_pushAllocator() and Memory_popAllocator(), for instance an arena (see
+ * Memory_createArena()): the temporaries of a whole processing step are then released
+ * at once with Memory_resetArena(), and the library can work in a fixed preallocated region.
+ *
+ * Memory allocated with an allocator must be freed with the same allocator: what is allocated
+ * in a scope must be freed in the same scope (or released with the arena). When a custom
+ * allocator is used, the memory given by the library must be freed with Memory_free() (or
+ * the functions freeing the structures, BF_freeBeliefFunction() for instance) and not with free().
+ * The state kept by the library between calls stays with the allocator it was created with,
+ * whatever the allocator of the scope of the calls:
+ * @li the blocks of flat belief functions and their cache (see BF_allocateBeliefFunction()),
+ * @li the state of the temporization options of the belief structures (see BFS_Option), which
+ * keep the allocator the structure was loaded with. A structure must be freed with this allocator.
+ *
+ * @file Memory.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Gives the allocator of the library and an arena allocator.
+ */
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * @def MEMORY_ARENA_ALIGNMENT
+ * The alignment of the blocks given by arenas (in bytes). Each block is preceded
+ * by a header of this size holding its size.
+ */
+#define MEMORY_ARENA_ALIGNMENT 16
+
+/**
+ * @def MEMORY_MAX_PUSHED_ALLOCATORS
+ * The maximum number of allocators pushed at the same time by a thread (see Memory_pushAllocator()).
+ */
+#define MEMORY_MAX_PUSHED_ALLOCATORS 16
+
+/**
+ * A function allocating memory.
+ * @param size The number of bytes to allocate
+ * @param data The data of the allocator
+ * @return A pointer to the allocated memory, NULL if the allocation failed.
+ */
+typedef void* (*Memory_mallocFunction)(size_t size, void* data);
+
+/**
+ * A function reallocating memory.
+ * @param pointer The memory to reallocate (NULL to allocate)
+ * @param size The new number of bytes
+ * @param data The data of the allocator
+ * @return A pointer to the reallocated memory, NULL if the reallocation failed.
+ */
+typedef void* (*Memory_reallocFunction)(void* pointer, size_t size, void* data);
+
+/**
+ * A function freeing memory.
+ * @param pointer The memory to free (may be NULL)
+ * @param data The data of the allocator
+ */
+typedef void (*Memory_freeFunction)(void* pointer, void* data);
+
+/**
+ * An allocator: the three functions managing memory and their data.
+ * @struct Memory_Allocator
+ */
+struct Memory_Allocator {
+	/** The function allocating memory */
+	Memory_mallocFunction mallocFunction;
+	/** The function reallocating memory */
+	Memory_reallocFunction reallocFunction;
+	/** The function freeing memory */
+	Memory_freeFunction freeFunction;
+	/** The data given to the functions (an arena for instance) */
+	void* data;
+};
+typedef struct Memory_Allocator Memory_Allocator;
+
+/**
+ * A bump-pointer arena: blocks are allocated one after the other in a single region
+ * and released all at once with Memory_resetArena(). Freeing or reallocating the last
+ * allocated block is done in place, freeing other blocks does nothing.
+ * @struct Memory_Arena
+ */
+struct Memory_Arena {
+	/** The region */
+	char* buffer;
+	/** The size of the region in bytes */
+	size_t size;
+	/** The number of bytes currently used (headers included) */
+	size_t used;
+	/** The maximum number of bytes used since the creation of the arena */
+	size_t peak;
+	/** The offset of the header of the last allocated block (size if none) */
+	size_t last;
+	/** 1 if the region has been allocated by the arena, 0 if given by the user */
+	int ownsBuffer;
+};
+typedef struct Memory_Arena Memory_Arena;
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+/**
+ * @name Allocator of the library
+ * @{
+ */
+
+/**
+ * Sets the allocator used by the whole library, in the threads which have not pushed an allocator.
+ * Not thread-safe: should be set once, before using the library.
+ * @param allocator The allocator to use
+ */
+void Memory_setAllocator(const Memory_Allocator allocator);
+
+/**
+ * Uses an allocator in the calling thread until the matching call to Memory_popAllocator().
+ * Pushes can be nested, up to MEMORY_MAX_PUSHED_ALLOCATORS (deeper pushes keep the last allocator).
+ * The memory allocated in the scope must be freed before the pop, or released with the allocator.
+ * @param allocator The allocator to use
+ */
+void Memory_pushAllocator(const Memory_Allocator allocator);
+
+/**
+ * Ends the scope of the allocator last pushed by the calling thread (see Memory_pushAllocator()).
+ */
+void Memory_popAllocator();
+
+/**
+ * Gets the allocator currently used by the library in the calling thread.
+ * @return The last allocator pushed by the thread, or the allocator of the library if none
+ */
+Memory_Allocator Memory_getAllocator();
+
+/**
+ * Gets the default allocator of the library (malloc(), realloc() and free()).
+ * @return The default allocator
+ */
+Memory_Allocator Memory_getDefaultAllocator();
+
+/**
+ * Checks if the library uses the default allocator in the calling thread.
+ * @return 1 if the current allocator is the default one, 0 otherwise.
+ */
+int Memory_isDefaultAllocator();
+
+/**
+ * Allocates memory with the allocator of the library.
+ * @param size The number of bytes to allocate
+ * @return A pointer to the allocated memory, NULL if the allocation failed.
+ */
+void* Memory_malloc(const size_t size);
+
+/**
+ * Allocates memory set to 0 with the allocator of the library.
+ * @param nbElements The number of elements
+ * @param size The size of an element
+ * @return A pointer to the allocated memory, NULL if the allocation failed.
+ */
+void* Memory_calloc(const size_t nbElements, const size_t size);
+
+/**
+ * Reallocates memory with the allocator of the library.
+ * @param pointer The memory to reallocate (NULL to allocate)
+ * @param size The new number of bytes
+ * @return A pointer to the reallocated memory, NULL if the reallocation failed.
+ */
+void* Memory_realloc(void* pointer, const size_t size);
+
+/**
+ * Frees memory with the allocator of the library.
+ * @param pointer The memory to free (may be NULL)
+ */
+void Memory_free(void* pointer);
+
+/**
+ * Duplicates a string with the allocator of the library.
+ * @param str The string to duplicate
+ * @return A copy of the string. Must be freed after use with Memory_free().
+ */
+char* Memory_strdup(const char* str);
+
+/** @} */
+
+/**
+ * @name Arenas
+ * @{
+ */
+
+/**
+ * Creates an arena over a region allocated with malloc().
+ * @param size The size of the region in bytes
+ * @return The arena. Must be freed after use with Memory_freeArena().
+ */
+Memory_Arena Memory_createArena(const size_t size);
+
+/**
+ * Creates an arena over a region given by the user (a static buffer for instance).
+ * The arena never allocates anything else: allocations fail once the region is full.
+ * @param buffer The region
+ * @param size The size of the region in bytes
+ * @return The arena. The region is not freed by Memory_freeArena().
+ */
+Memory_Arena Memory_createArenaFromBuffer(void* buffer, const size_t size);
+
+/**
+ * Gets an allocator allocating in the given arena, to give to Memory_pushAllocator() or Memory_setAllocator().
+ * @param arena A pointer to the arena, which must live as long as the allocator is used
+ * @return The allocator
+ */
+Memory_Allocator Memory_getArenaAllocator(Memory_Arena* arena);
+
+/**
+ * Releases all the blocks of an arena at once. The peak is kept.
+ * @param arena A pointer to the arena
+ */
+void Memory_resetArena(Memory_Arena* arena);
+
+/**
+ * Frees an arena (and its region if allocated by the arena).
+ * @param arena A pointer to the arena
+ */
+void Memory_freeArena(Memory_Arena* arena);
+
+/** @} */
+
+#endif
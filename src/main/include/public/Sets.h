@@ -210,7 +210,8 @@ Sets_Element Sets_getOpposite(const Sets_Element e, const int size);
 Sets_Element Sets_elementFromNumber(const int number, const int nbDigits);
 
 /**
- * Gives the number corresponding to the binary form of an Element.
+ * Gives the number corresponding to the binary form of an Element (the atom i being the bit i).
+ * It is the index of the element in the dense vectors of the library (cache, commonalities, matrices).
  * @param e The Sets_Element to convert.
  * @param nbDigits The number of digits used for the binary form.
  * @result The number corresponding to the binary form of the given Element.
@@ -259,6 +260,16 @@ Sets_Element Sets_disjunction(const Sets_Element e1, const Sets_Element e2, cons
  */
 int Sets_equals(const Sets_Element e1, const Sets_Element e2, const int size);
 
+/**
+ * Orders two elements. The order is the one of the numbers given by Sets_numberFromElement()
+ * (the last value being the most significant bit), so that sorting elements with it gives a canonical order.
+ * @param e1 The first element
+ * @param e2 The second element to compare to
+ * @param size The size of the elements
+ * @return A negative number if e1 < e2, 0 if e1 = e2, a positive number if e1 > e2.
+ */
+int Sets_compare(const Sets_Element e1, const Sets_Element e2, const int size);
+
 /**
  * Tests if the element is a member of the set.
  * @param e The element to test
@@ -280,6 +291,33 @@ int Sets_isSubset(const Sets_Element e1, const Sets_Element e2, const int size);
 /** @} */
 
 
+/* !!! Memory usage !!! */
+
+
+/**
+ * @name Memory usage
+ * The bytes requested to the allocator are counted (see Memory.h), without its own overhead.
+ * @{
+ */
+
+/**
+ * Gets the number of bytes held by a reference list (the array and the names).
+ * @param rl The reference list
+ * @return The number of bytes.
+ */
+size_t Sets_referenceListMemoryUsage(const Sets_ReferenceList rl);
+
+/**
+ * Gets the number of bytes held by a set (the array of elements and their values).
+ * @param s The set
+ * @param elementSize The size of the elements
+ * @return The number of bytes.
+ */
+size_t Sets_setMemoryUsage(const Sets_Set s, const int elementSize);
+
+/** @} */
+
+
 /* !!! Deallocation of the memory !!! */
 
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef DEF_STATS
+#define DEF_STATS
+
+#include "config.h"
+
+/**
+ * This module gives counters of the work done by the library in the calling thread, to attribute
+ * the time spent in the library: allocations, set operations, combinations, lookups of masses and
+ * scans of powersets. The counters are only compiled with THEGAME_STATS (see config.h or the CMake
+ * option THEGAME_STATS): otherwise, they compile out and the statistics are always null.
+ *
+ * Example:
+ * @code
+ * THEGAME_resetStats();
+ * combined = BF_DempsterCombination(m1, m2);
+ * stats = THEGAME_getStats();
+ * printf("%lu focal elements per combination\n", stats.nbCombinedFocals / stats.nbCombinations);
+ * @endcode
+ * @file Stats.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Gives per-thread counters of the work done by the library.
+ */
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * The counters of a thread.
+ * @struct THEGAME_Stats
+ */
+struct THEGAME_Stats {
+	/** The number of allocations and reallocations through the allocator of the library (see Memory_malloc()),
+	 *  the blocks reused by the pool of flat belief functions not being counted */
+	unsigned long nbAllocations;
+	/** The number of bytes allocated or reallocated */
+	unsigned long nbAllocatedBytes;
+	/** The number of operations on elements (conjunctions, disjunctions, opposites, comparisons, inclusions) */
+	unsigned long nbSetOperations;
+	/** The number of conjunctive or disjunctive combinations of two functions (the other rules are built on them) */
+	unsigned long nbCombinations;
+	/** The number of products of focal elements computed by the combinations */
+	unsigned long nbCombinationProducts;
+	/** The number of focal elements produced by the combinations */
+	unsigned long nbCombinedFocals;
+	/** The number of lookups of masses with BF_m() */
+	unsigned long nbMassLookups;
+	/** The number of scans of powersets (decisions and dense transforms) */
+	unsigned long nbPowersetScans;
+	/** The number of subsets visited by these scans */
+	unsigned long nbScannedSubsets;
+};
+typedef struct THEGAME_Stats THEGAME_Stats;
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+/**
+ * @name Statistics
+ * @{
+ */
+
+/**
+ * Checks if the counters have been compiled.
+ * @return 1 if the library has been compiled with THEGAME_STATS, 0 otherwise.
+ */
+int THEGAME_isStatsEnabled();
+
+/**
+ * Gets the counters of the calling thread.
+ * @return The counters since the start of the thread or the last call to THEGAME_resetStats()
+ *         (null counters without THEGAME_STATS).
+ */
+THEGAME_Stats THEGAME_getStats();
+
+/**
+ * Resets the counters of the calling thread.
+ */
+void THEGAME_resetStats();
+
+/** @} */
+
+#endif
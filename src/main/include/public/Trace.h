@@ -0,0 +1,259 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef DEF_TRACE
+#define DEF_TRACE
+
+#include <stdio.h>
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * This module traces the main entry points of the library: building evidence and projections
+ * from sensors, combinations, decisions, transformations by beliefs from beliefs and loading
+ * of models. Each traced call records its start and duration (in nanoseconds, monotonic clock)
+ * in a ring buffer of the calling thread and adds its latency to the histogram of its stage.
+ * The histograms are log-linear (as HDR histograms): each power of 2 is split in
+ * THEGAME_HISTOGRAM_SUB_BUCKETS buckets, percentiles are then given with a relative error
+ * below 1 / THEGAME_HISTOGRAM_SUB_BUCKETS, which keeps the tail of the distribution visible.
+ *
+ * The tracing is per thread: no lock is taken, a thread only writes its own buffer and
+ * histograms, and THEGAME_getLatencies() only reads those of the calling thread. When a thread
+ * ends (the workers of BFB_believeFromBeliefBatch() for instance), its histograms are published
+ * under a lock to the histograms of the process, read by THEGAME_getProcessLatencies()
+ * (a thread which lives on can publish its own with THEGAME_publishLatencies()).
+ * Nested calls (BF_DempsterCombination() calling BF_SmetsCombination() for instance) are
+ * recorded as nested events, but only the outermost call of a stage is added to its histogram:
+ * one call to BF_DempsterCombination() is one combination.
+ *
+ * The hooks are only compiled with THEGAME_TRACE (see config.h or the CMake option THEGAME_TRACE):
+ * otherwise, they compile out and the histograms are always empty.
+ *
+ * Example:
+ * @code
+ * THEGAME_resetTrace();
+ * for(tick = 0; tick < nbTicks; tick++){
+ *     evidences = BFS_getEvidence(bs, sensorTypes, measures[tick], nbSensors);
+ *     ...
+ * }
+ * printf("p99 = %lu ns\n", (unsigned long)THEGAME_getPercentile(THEGAME_getLatencies(THEGAME_TRACE_EVIDENCE), 99));
+ * THEGAME_writeChromeTrace(file);
+ * @endcode
+ * @file Trace.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Gives per-thread tracing of the entry points and latency histograms.
+ */
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * @def THEGAME_TRACE_RING_SIZE
+ * The number of events kept by the ring buffer of each thread (the oldest ones are overwritten).
+ */
+#define THEGAME_TRACE_RING_SIZE 1024
+
+/**
+ * @def THEGAME_TRACE_MAX_DEPTH
+ * The maximum number of nested traced calls (deeper calls are not recorded).
+ */
+#define THEGAME_TRACE_MAX_DEPTH 32
+
+/**
+ * @def THEGAME_HISTOGRAM_SUB_BITS
+ * The number of bits of precision of the histograms.
+ */
+#define THEGAME_HISTOGRAM_SUB_BITS 5
+
+/**
+ * @def THEGAME_HISTOGRAM_SUB_BUCKETS
+ * The number of buckets per power of 2.
+ */
+#define THEGAME_HISTOGRAM_SUB_BUCKETS (1 << THEGAME_HISTOGRAM_SUB_BITS)
+
+/**
+ * @def THEGAME_HISTOGRAM_MAX_BITS
+ * The number of bits of the largest latency of the histograms (2^40 ns, about 18 minutes, longer ones are clamped).
+ */
+#define THEGAME_HISTOGRAM_MAX_BITS 40
+
+/**
+ * @def THEGAME_HISTOGRAM_SIZE
+ * The number of buckets of the histograms.
+ */
+#define THEGAME_HISTOGRAM_SIZE ((THEGAME_HISTOGRAM_MAX_BITS - THEGAME_HISTOGRAM_SUB_BITS + 1) * THEGAME_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * The stages of the traced entry points.
+ * @enum THEGAME_TraceStage
+ */
+enum THEGAME_TraceStage {
+	/** BFS_getEvidence() and BFS_getEvidenceElapsedTime() */
+	THEGAME_TRACE_EVIDENCE,
+	/** BFS_getProjection() and BFS_getProjectionElapsedTime() */
+	THEGAME_TRACE_PROJECTION,
+	/** The combination rules (BF_DempsterCombination(), BF_fullSmetsCombination()...) */
+	THEGAME_TRACE_COMBINATION,
+	/** The decisions (BF_getMax(), BF_getMinList(), BF_getMaxBetP(), BF_getListMinPl()...) */
+	THEGAME_TRACE_DECISION,
+	/** The transformations by beliefs from beliefs (BFB_believeFromBelief()...) */
+	THEGAME_TRACE_TRANSFORMATION,
+	/** The loading of models (BFS_loadBeliefStructure(), BFB_loadBeliefStructure()...) */
+	THEGAME_TRACE_LOADING,
+	/** The number of stages */
+	THEGAME_TRACE_NB_STAGES
+};
+typedef enum THEGAME_TraceStage THEGAME_TraceStage;
+
+/**
+ * A traced call.
+ * @struct THEGAME_TraceEvent
+ */
+struct THEGAME_TraceEvent {
+	/** The name of the function */
+	const char* name;
+	/** The stage of the function */
+	THEGAME_TraceStage stage;
+	/** The start of the call (in nanoseconds, monotonic clock) */
+	uint64_t start;
+	/** The duration of the call (in nanoseconds) */
+	uint64_t duration;
+};
+typedef struct THEGAME_TraceEvent THEGAME_TraceEvent;
+
+/**
+ * A log-linear histogram of latencies.
+ * @struct THEGAME_Histogram
+ */
+struct THEGAME_Histogram {
+	/** The number of latencies per bucket */
+	unsigned int counts[THEGAME_HISTOGRAM_SIZE];
+	/** The number of latencies */
+	unsigned long count;
+	/** The smallest latency (in nanoseconds) */
+	uint64_t min;
+	/** The largest latency (in nanoseconds) */
+	uint64_t max;
+	/** The sum of the latencies (in nanoseconds) */
+	double sum;
+};
+typedef struct THEGAME_Histogram THEGAME_Histogram;
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+/**
+ * @name Tracing
+ * @{
+ */
+
+/**
+ * Checks if the tracing hooks have been compiled.
+ * @return 1 if the library has been compiled with THEGAME_TRACE, 0 otherwise.
+ */
+int THEGAME_isTraceEnabled();
+
+/**
+ * Gets the name of a stage (used as category in Chrome traces).
+ * @param stage The stage
+ * @return The name of the stage, "unknown" if not a stage.
+ */
+const char* THEGAME_getStageName(const THEGAME_TraceStage stage);
+
+/**
+ * Gets the histogram of the latencies of a stage in the calling thread.
+ * @param stage The stage
+ * @return The histogram since the start of the thread or the last call to THEGAME_resetTrace()
+ *         (an empty histogram without THEGAME_TRACE or if not a stage).
+ */
+const THEGAME_Histogram* THEGAME_getLatencies(const THEGAME_TraceStage stage);
+
+/**
+ * Gets the histogram of the latencies of a stage in the process: the histograms published by
+ * the threads which have ended, or called THEGAME_publishLatencies(), and those of the calling thread.
+ * @param stage The stage
+ * @param into The histogram receiving the latencies (emptied without THEGAME_TRACE or if not a stage)
+ */
+void THEGAME_getProcessLatencies(const THEGAME_TraceStage stage, THEGAME_Histogram* into);
+
+/**
+ * Adds the histograms of the calling thread to those of the process and empties them
+ * (done when a thread ends).
+ */
+void THEGAME_publishLatencies();
+
+/**
+ * Gets a percentile of a histogram.
+ * @param histogram The histogram
+ * @param percentile The percentile (between 0 and 100, 99 for p99)
+ * @return The highest latency of the bucket of the percentile (in nanoseconds, never more than the
+ *         largest latency), 0 if the histogram is empty.
+ */
+uint64_t THEGAME_getPercentile(const THEGAME_Histogram* histogram, const double percentile);
+
+/**
+ * Adds a latency to a histogram (to keep the histogram of the ticks of an application for instance).
+ * @param histogram The histogram, set to 0 before the first latency
+ * @param latency The latency (in nanoseconds)
+ */
+void THEGAME_recordLatency(THEGAME_Histogram* histogram, const uint64_t latency);
+
+/**
+ * Adds a histogram to another one (to aggregate the histograms of several threads for instance).
+ * @param into The histogram to add to
+ * @param from The histogram to add
+ */
+void THEGAME_mergeHistograms(THEGAME_Histogram* into, const THEGAME_Histogram* from);
+
+/**
+ * Gets the events of the calling thread still in its ring buffer.
+ * @param events The array receiving the events, from the oldest to the newest
+ * @param maxEvents The size of the array
+ * @return The number of events copied (the most recent ones).
+ */
+int THEGAME_getTraceEvents(THEGAME_TraceEvent* events, const int maxEvents);
+
+/**
+ * Writes the events of the calling thread still in its ring buffer in the Chrome trace-event format
+ * (a JSON document to open with chrome://tracing or Perfetto).
+ * @param file The file to write to
+ * @return The number of events written.
+ */
+int THEGAME_writeChromeTrace(FILE* file);
+
+/**
+ * Empties the ring buffer and the histograms of the calling thread.
+ */
+void THEGAME_resetTrace();
+
+/**
+ * Empties the histograms published to the process and those of the calling thread.
+ */
+void THEGAME_resetProcessLatencies();
+
+/** @} */
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef DEF_VALIDATION
+#define DEF_VALIDATION
+
+#include "config.h"
+
+/**
+ * This module selects at runtime what the library does with the checks compiled with CHECK_MODELS,
+ * CHECK_VALUES, CHECK_SUM and CHECK_COMPATIBILITY (see config.h): nothing (the default, the checks
+ * are then skipped and cost a single test per call), only counting the errors, or counting them and
+ * giving each of them to a callback. The default callback, THEGAME_printValidationError(), prints
+ * the errors on stderr.
+ *
+ * Example:
+ * @code
+ * THEGAME_setValidationCallback(myCallback, myData);
+ * THEGAME_setValidationLevel(THEGAME_VALIDATION_CALLBACK);
+ * bs = BFS_loadBeliefStructure(path, frameName);
+ * if(THEGAME_getNbValidationErrors(THEGAME_CHECK_MODELS) > 0){
+ *     ...
+ * }
+ * THEGAME_setValidationLevel(THEGAME_VALIDATION_OFF);
+ * @endcode
+ * @file Validation.h
+ * @author Bastien Pietropaoli (bastien.pietropaoli@inria.fr)
+ * @brief UTILITY: Selects at runtime how the checks of the library are reported.
+ */
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+struct BF_BeliefFunction;
+
+/**
+ * What the library does with its checks.
+ * @enum THEGAME_ValidationLevel
+ */
+enum THEGAME_ValidationLevel {
+	/** The checks are skipped (default) */
+	THEGAME_VALIDATION_OFF,
+	/** The checks are done and their errors counted */
+	THEGAME_VALIDATION_COUNT,
+	/** The checks are done, their errors counted and given to the callback */
+	THEGAME_VALIDATION_CALLBACK
+};
+typedef enum THEGAME_ValidationLevel THEGAME_ValidationLevel;
+
+/**
+ * The types of checks.
+ * @enum THEGAME_CheckType
+ */
+enum THEGAME_CheckType {
+	/** The validity of the models when loading them (CHECK_MODELS) */
+	THEGAME_CHECK_MODELS,
+	/** The validity of the belief values (CHECK_VALUES) */
+	THEGAME_CHECK_VALUES,
+	/** The sum of mass functions (CHECK_SUM) */
+	THEGAME_CHECK_SUM,
+	/** The compatibility of the frames of fused mass functions (CHECK_COMPATIBILITY) */
+	THEGAME_CHECK_COMPATIBILITY,
+	/** The number of types of checks */
+	THEGAME_NB_CHECKS
+};
+typedef enum THEGAME_CheckType THEGAME_CheckType;
+
+/**
+ * An error found by a check.
+ * @struct THEGAME_ValidationError
+ */
+struct THEGAME_ValidationError {
+	/** The type of the check */
+	THEGAME_CheckType check;
+	/** The name of the function which found the error */
+	const char* function;
+	/** The description of the error */
+	const char* message;
+	/** The faulty belief function, NULL if the error is not about a belief function */
+	const struct BF_BeliefFunction* beliefFunction;
+};
+typedef struct THEGAME_ValidationError THEGAME_ValidationError;
+
+/**
+ * A function receiving the errors found by the checks. The error (and the belief function it points to)
+ * is only valid during the call. The callback is called by the thread which found the error.
+ * @param error The error
+ * @param data The data given to THEGAME_setValidationCallback()
+ */
+typedef void (*THEGAME_ValidationCallback)(const THEGAME_ValidationError* error, void* data);
+
+
+/*
+  +-----------+
+  | FUNCTIONS |
+  +-----------+
+*/
+
+/**
+ * @name Validation
+ * @{
+ */
+
+/**
+ * Sets what the library does with its checks. Not thread-safe: should be set when the library is not used
+ * by other threads.
+ * @param level The validation level
+ */
+void THEGAME_setValidationLevel(const THEGAME_ValidationLevel level);
+
+/**
+ * Gets what the library does with its checks.
+ * @return The validation level.
+ */
+THEGAME_ValidationLevel THEGAME_getValidationLevel();
+
+/**
+ * Sets the function receiving the errors with THEGAME_VALIDATION_CALLBACK. Not thread-safe.
+ * @param callback The function, NULL for THEGAME_printValidationError()
+ * @param data The data given to the function
+ */
+void THEGAME_setValidationCallback(THEGAME_ValidationCallback callback, void* data);
+
+/**
+ * Prints an error on stderr, with the faulty belief function if any. The default callback.
+ * @param error The error
+ * @param data Unused
+ */
+void THEGAME_printValidationError(const THEGAME_ValidationError* error, void* data);
+
+/**
+ * Gets the number of errors found by a type of checks since the start or the last call
+ * to THEGAME_resetValidationErrors() (in all the threads).
+ * @param check The type of checks
+ * @return The number of errors, 0 if not a type of checks.
+ */
+unsigned long THEGAME_getNbValidationErrors(const THEGAME_CheckType check);
+
+/**
+ * Sets the numbers of errors to 0.
+ */
+void THEGAME_resetValidationErrors();
+
+/** @} */
+
+#endif
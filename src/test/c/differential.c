@@ -0,0 +1,1060 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * differential.c
+ *
+ * Differential testing of the optimized functions of the library: each fast path is run side by side
+ * with a reference implementation on random belief functions (DIFF_NB_TRIALS trials for each frame of
+ * DIFF_MIN_SIZE to DIFF_MAX_SIZE atoms). The references are either the straightforward functions of the
+ * library (for instance the discounting followed by the combination of Dubois & Prade for
+ * BF_discountedDuboisPradeCombination()) or the definitions computed here on dense vectors indexed by the
+ * number of the elements (see Sets_numberFromElement()).
+ *
+ * The results must agree within BF_PRECISION (relative to the values greater than 1, like entropies):
+ * the masses of all the focal elements of both results, or the values returned. The decisions are
+ * compared on their value, ties being broken differently. The time of both implementations is measured
+ * and the speedup (reference / fast) is reported:
+ *
+ * BF_SmetsCombination                      size  8: max error 1.49e-08, speedup 5.21
+ * ...
+ * 0 disagreement(s)
+ *
+ * The results can also be written in JSON with --output file:
+ * {"differential": [
+ *   {"name": "BF_SmetsCombination", "size": 8, "trials": 20, "failures": 0, "max_error": 1.49e-08,
+ *    "reference_ns": 48120.4, "fast_ns": 9236.1, "speedup": 5.21},
+ *   ...
+ * ]}
+ *
+ * A new fast path is tested by adding its case (a reference and a fast operation) to the table below.
+ * The program fails (for ctest) if any result disagrees.
+ *
+ * Usage: differential-thegame [--min-size n] [--max-size n] [--trials n] [--seed n] [--filter name] [--output file]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "BeliefCombinations.h"
+#include "BeliefDecisions.h"
+#include "BeliefFunctions.h"
+#include "BeliefMetrics.h"
+#include "BeliefsFromBeliefs.h"
+#include "BeliefsFromRandomness.h"
+#include "Memory.h"
+
+
+/*
+  +------------+
+  | PARAMETERS |
+  +------------+
+*/
+
+/** The random seed, to reproduce the failures. */
+#define DIFF_SEED 42
+/** The default number of random inputs per frame. */
+#define DIFF_NB_TRIALS 20
+/** The default sizes of the frames. */
+#define DIFF_MIN_SIZE 2
+#define DIFF_MAX_SIZE 8
+/** The maximum size of the frames (dense vectors and powersets are used). */
+#define DIFF_MAX_DENSE_SIZE 12
+/** The maximum number of focal elements of the random belief functions. */
+#define DIFF_MAX_FOCALS 16
+/** The minimum time measured for each implementation and each input (in seconds). */
+#define DIFF_MIN_TIME 0.0002
+/** The maximum number of values returned by an operation. */
+#define DIFF_MAX_VALUES (3 << DIFF_MAX_DENSE_SIZE)
+/** The maximum degree of auto-conflict compared. */
+#define DIFF_AUTO_CONFLICT_DEGREE 4
+/** The number of entities of the batched transformations (and threads used). */
+#define DIFF_BATCH_SIZE 2
+
+
+/*
+  +------------+
+  | STRUCTURES |
+  +------------+
+*/
+
+/**
+ * The inputs of the operations, drawn for each trial.
+ */
+struct Diff_Context {
+	int size;
+	BF_BeliefFunction m1, m2;
+	/* m1 and m2 with sorted focal elements: */
+	BF_BeliefFunction sorted1, sorted2;
+	Sets_Element e;
+	float alpha;
+	/* Maximum cardinality of the decisions (0 for no limit): */
+	int card;
+	Sets_Set powerset;
+	BF_MetricsTable table;
+	/* Random models of beliefs from beliefs (compiled), bfb going from the frame "f0" to "f1", bfb2 from "f1" to "f2": */
+	BFB_BeliefFromBelief bfb, bfb2;
+	/* The structures of the frames "f1" and "f2" (for the composition of bfb and bfb2): */
+	BFB_BeliefStructure to[2];
+};
+typedef struct Diff_Context Diff_Context;
+
+/**
+ * The result of an operation: a belief function (if hasFunction) and/or values.
+ */
+struct Diff_Result {
+	int hasFunction;
+	BF_BeliefFunction function;
+	int nbValues;
+	float values[DIFF_MAX_VALUES];
+};
+typedef struct Diff_Result Diff_Result;
+
+typedef void (*Diff_Operation)(const Diff_Context* c, Diff_Result* r);
+
+/**
+ * A fast path and its reference.
+ */
+struct Diff_Case {
+	const char* name;
+	Diff_Operation reference;
+	Diff_Operation fast;
+};
+typedef struct Diff_Case Diff_Case;
+
+
+/*
+  +------------+
+  | REFERENCES |
+  +------------+
+*/
+
+/**
+ * Converts a belief function to a dense vector of 2^size masses.
+ */
+static void toDense(const BF_BeliefFunction m, double* dense){
+	int i = 0;
+
+	memset(dense, 0, sizeof(double) * (1 << m.elementSize));
+	for(i = 0; i < m.nbFocals; i++){
+		dense[Sets_numberFromElement(m.focals[i].element, m.elementSize)] += m.focals[i].beliefValue;
+	}
+}
+
+/**
+ * Converts a dense vector of 2^size masses to a belief function (the masses equal to 0 are not focal).
+ */
+static BF_BeliefFunction fromDense(const double* dense, const int size){
+	BF_BeliefFunction m = {NULL, 0, 0};
+	int i = 0;
+
+	m.elementSize = size;
+	m.focals = Memory_malloc(sizeof(BF_FocalElement) * (1 << size));
+	for(i = 0; i < (1 << size); i++){
+		if(dense[i] != 0){
+			m.focals[m.nbFocals].element = Sets_elementFromNumber(i, size);
+			m.focals[m.nbFocals].beliefValue = dense[i];
+			m.nbFocals++;
+		}
+	}
+
+	return m;
+}
+
+/**
+ * The conjunctive combination by definition: m(A) = sum of m1(B) m2(C) for B inter C = A.
+ */
+static BF_BeliefFunction denseConjunction(const BF_BeliefFunction m1, const BF_BeliefFunction m2){
+	BF_BeliefFunction combined = {NULL, 0, 0};
+	double *d1 = NULL, *d2 = NULL, *result = NULL;
+	int nb = 1 << m1.elementSize, a = 0, b = 0;
+
+	d1 = malloc(sizeof(double) * nb);
+	d2 = malloc(sizeof(double) * nb);
+	result = calloc(nb, sizeof(double));
+	toDense(m1, d1);
+	toDense(m2, d2);
+	for(a = 0; a < nb; a++){
+		for(b = 0; b < nb; b++){
+			result[a & b] += d1[a] * d2[b];
+		}
+	}
+	combined = fromDense(result, m1.elementSize);
+	free(d1);
+	free(d2);
+	free(result);
+
+	return combined;
+}
+
+/**
+ * Dempster's combination by definition: the conjunctive combination without the conflict, normalized.
+ */
+static void denseDempster(const double* d1, const double* d2, double* result, const int size){
+	int nb = 1 << size, a = 0, b = 0;
+	double conflict = 0;
+
+	memset(result, 0, sizeof(double) * nb);
+	for(a = 0; a < nb; a++){
+		for(b = 0; b < nb; b++){
+			result[a & b] += d1[a] * d2[b];
+		}
+	}
+	conflict = result[0];
+	result[0] = 0;
+	for(a = 1; a < nb; a++){
+		result[a] /= 1 - conflict;
+	}
+}
+
+/**
+ * Jousselme's distance by definition: sqrt(1/2 (m1 - m2) D (m1 - m2)) with D(A, B) = |A inter B| / |A union B|
+ * (and D(empty set, empty set) = 1), on the subsets where m1 and m2 differ.
+ */
+static double denseDistance(const double* d1, const double* d2, const int size){
+	int nb = 1 << size, nbDiffering = 0, a = 0, b = 0;
+	int* differing = malloc(sizeof(int) * nb);
+	double distance = 0, jaccard = 0;
+
+	for(a = 0; a < nb; a++){
+		if(d1[a] != d2[a]){
+			differing[nbDiffering++] = a;
+		}
+	}
+	for(a = 0; a < nbDiffering; a++){
+		for(b = 0; b < nbDiffering; b++){
+			jaccard = (differing[a] | differing[b]) == 0 ? 1 :
+					(double)__builtin_popcount(differing[a] & differing[b]) / __builtin_popcount(differing[a] | differing[b]);
+			distance += (d1[differing[a]] - d2[differing[a]]) * jaccard * (d1[differing[b]] - d2[differing[b]]);
+		}
+	}
+	free(differing);
+
+	return sqrt(0.5 * distance);
+}
+
+/**
+ * Transforms dense masses with the belief vectors of a model: the mass of each subset goes to the
+ * targets of its vector, the mass of the empty set stays on the empty set.
+ */
+static void denseBelieve(const BFB_BeliefFromBelief bfb, const double* from, double* to, const int toSize){
+	int i = 0, k = 0, number = 0;
+
+	memset(to, 0, sizeof(double) * (1 << toSize));
+	to[0] = from[0];
+	for(i = 0; i < bfb.nbVectors; i++){
+		number = Sets_numberFromElement(bfb.vectors[i].from, bfb.refList.card);
+		if(number != 0){
+			for(k = 0; k < bfb.vectors[i].nbTos; k++){
+				to[Sets_numberFromElement(bfb.vectors[i].to[k], toSize)] += bfb.vectors[i].factors[k] * from[number];
+			}
+		}
+	}
+}
+
+static void referenceSmets(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = denseConjunction(c->m1, c->m2);
+}
+
+static void fastSmets(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = BF_SmetsCombination(c->m1, c->m2);
+}
+
+static void referenceDiscountedDuboisPrade(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction discounted = BF_discounting(c->m1, c->alpha);
+
+	r->hasFunction = 1;
+	r->function = BF_DuboisPradeCombination(discounted, c->m2);
+	BF_freeBeliefFunction(&discounted);
+}
+
+static void fastDiscountedDuboisPrade(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = BF_discountedDuboisPradeCombination(c->m1, c->alpha, c->m2);
+}
+
+static void referenceConditioning(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction categorical = {NULL, 0, 0};
+	BF_FocalElement focal;
+
+	/*Conditioning is the conjunctive combination with the categorical function on e: */
+	focal.element = c->e;
+	focal.beliefValue = 1;
+	categorical.focals = &focal;
+	categorical.nbFocals = 1;
+	categorical.elementSize = c->size;
+	r->hasFunction = 1;
+	r->function = denseConjunction(c->m1, categorical);
+}
+
+static void fastConditioning(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = BF_quickConditioning(c->m1, c->e);
+}
+
+static void referenceWeightedSum(const Diff_Context* c, Diff_Result* r){
+	double *d1 = NULL, *d2 = NULL;
+	int nb = 1 << c->size, a = 0;
+
+	d1 = malloc(sizeof(double) * nb);
+	d2 = malloc(sizeof(double) * nb);
+	toDense(c->m1, d1);
+	toDense(c->m2, d2);
+	for(a = 0; a < nb; a++){
+		d1[a] = c->alpha * d1[a] + (1 - c->alpha) * d2[a];
+	}
+	r->hasFunction = 1;
+	r->function = fromDense(d1, c->size);
+	free(d1);
+	free(d2);
+}
+
+static void fastWeightedSum(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction functions[2];
+	float weights[2];
+
+	functions[0] = c->sorted1;
+	functions[1] = c->sorted2;
+	weights[0] = c->alpha;
+	weights[1] = 1 - c->alpha;
+	r->hasFunction = 1;
+	r->function = BF_weightedSum(functions, weights, 2);
+}
+
+static void fastUnsortedWeightedSum(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction functions[2];
+	float weights[2];
+
+	functions[0] = c->m1;
+	functions[1] = c->m2;
+	weights[0] = c->alpha;
+	weights[1] = 1 - c->alpha;
+	r->hasFunction = 1;
+	r->function = BF_weightedSum(functions, weights, 2);
+}
+
+static void referenceAverage(const Diff_Context* c, Diff_Result* r){
+	double *d1 = NULL, *d2 = NULL;
+	int nb = 1 << c->size, a = 0;
+
+	d1 = malloc(sizeof(double) * nb);
+	d2 = malloc(sizeof(double) * nb);
+	toDense(c->m1, d1);
+	toDense(c->m2, d2);
+	for(a = 0; a < nb; a++){
+		d1[a] = (d1[a] + d2[a]) / 2;
+	}
+	r->hasFunction = 1;
+	r->function = fromDense(d1, c->size);
+	free(d1);
+	free(d2);
+}
+
+static void fastAverage(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = BF_averageCombination(c->m1, c->m2);
+}
+
+static void referenceDifference(const Diff_Context* c, Diff_Result* r){
+	double *d1 = NULL, *d2 = NULL;
+	int nb = 1 << c->size, a = 0;
+
+	d1 = malloc(sizeof(double) * nb);
+	d2 = malloc(sizeof(double) * nb);
+	toDense(c->m1, d1);
+	toDense(c->m2, d2);
+	for(a = 0; a < nb; a++){
+		d1[a] -= d2[a];
+	}
+	r->hasFunction = 1;
+	r->function = fromDense(d1, c->size);
+	free(d1);
+	free(d2);
+}
+
+static void fastDifference(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = BF_difference(c->m1, c->m2);
+}
+
+static void referenceChen(const Diff_Context* c, Diff_Result* r){
+	const BF_BeliefFunction* sources[3];
+	double *dense[3], *average = NULL, *combined = NULL, *temp = NULL;
+	double supports[3], supportSum = 0;
+	int nb = 1 << c->size, i = 0, j = 0, a = 0;
+
+	/*The sources are m1, m2 and m2 again: */
+	sources[0] = &(c->m1);
+	sources[1] = &(c->m2);
+	sources[2] = &(c->m2);
+	for(i = 0; i < 3; i++){
+		dense[i] = malloc(sizeof(double) * nb);
+		toDense(*(sources[i]), dense[i]);
+	}
+	/*Supports (sum of the similarities 0.5 cos(pi d + 1), as in BF_similarity(), minus 1) and credibilities: */
+	for(i = 0; i < 3; i++){
+		supports[i] = -1;
+		for(j = 0; j < 3; j++){
+			supports[i] += 0.5 * cos(3.14159 * denseDistance(dense[i], dense[j], c->size) + 1);
+		}
+		supportSum += supports[i];
+	}
+	average = calloc(nb, sizeof(double));
+	for(i = 0; i < 3; i++){
+		for(a = 0; a < nb; a++){
+			average[a] += supports[i] / supportSum * dense[i][a];
+		}
+	}
+	/*Two Dempster's combinations of the average with itself: */
+	combined = malloc(sizeof(double) * nb);
+	temp = malloc(sizeof(double) * nb);
+	denseDempster(average, average, temp, c->size);
+	denseDempster(temp, average, combined, c->size);
+	r->hasFunction = 1;
+	r->function = fromDense(combined, c->size);
+	for(i = 0; i < 3; i++){
+		free(dense[i]);
+	}
+	free(average);
+	free(combined);
+	free(temp);
+}
+
+static void fastChen(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction sources[3];
+
+	sources[0] = c->m1;
+	sources[1] = c->m2;
+	sources[2] = c->m2;
+	r->hasFunction = 1;
+	r->function = BF_fullChenCombination(sources, 3);
+}
+
+static void referenceClean(const Diff_Context* c, Diff_Result* r){
+	double *d1 = NULL, *d2 = NULL, sum = 0;
+	int nb = 1 << c->size, a = 0;
+
+	/*The masses of both functions, summed, with a mass below the precision on e: */
+	d1 = malloc(sizeof(double) * nb);
+	d2 = malloc(sizeof(double) * nb);
+	toDense(c->m1, d1);
+	toDense(c->m2, d2);
+	for(a = 0; a < nb; a++){
+		d1[a] = (float)(c->alpha * d1[a]) + (float)((1 - c->alpha) * d2[a]);
+	}
+	d1[Sets_numberFromElement(c->e, c->size)] += (float)(BF_PRECISION / 4);
+	/*Without the masses below the precision, normalized: */
+	for(a = 0; a < nb; a++){
+		if(d1[a] < BF_PRECISION){
+			d1[a] = 0;
+		}
+		sum += d1[a];
+	}
+	for(a = 0; a < nb; a++){
+		d1[a] /= sum;
+	}
+	r->hasFunction = 1;
+	r->function = fromDense(d1, c->size);
+	free(d1);
+	free(d2);
+}
+
+static void fastClean(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction mixed = {NULL, 0, 0};
+	int i = 0;
+
+	/*The focal elements of both functions, with duplicates, and e with a mass below the precision: */
+	mixed.elementSize = c->size;
+	mixed.focals = malloc(sizeof(BF_FocalElement) * (c->m1.nbFocals + c->m2.nbFocals + 1));
+	for(i = 0; i < c->m1.nbFocals; i++){
+		mixed.focals[mixed.nbFocals].element = c->m1.focals[i].element;
+		mixed.focals[mixed.nbFocals++].beliefValue = c->alpha * c->m1.focals[i].beliefValue;
+	}
+	for(i = 0; i < c->m2.nbFocals; i++){
+		mixed.focals[mixed.nbFocals].element = c->m2.focals[i].element;
+		mixed.focals[mixed.nbFocals++].beliefValue = (1 - c->alpha) * c->m2.focals[i].beliefValue;
+	}
+	mixed.focals[mixed.nbFocals].element = c->e;
+	mixed.focals[mixed.nbFocals++].beliefValue = BF_PRECISION / 4;
+	r->hasFunction = 1;
+	r->function = BF_copyBeliefFunction(mixed);
+	BF_cleanBeliefFunction(&(r->function));
+	free(mixed.focals);
+}
+
+static void referenceAutoConflict(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction combined = BF_SmetsCombination(c->m1, c->m1), temp;
+	Sets_Element emptySet = Sets_getEmptyElement(c->size);
+	int i = 0;
+
+	/*Successive self-combinations: */
+	for(i = 0; i < DIFF_AUTO_CONFLICT_DEGREE; i++){
+		r->values[i] = BF_m(combined, emptySet);
+		temp = BF_SmetsCombination(combined, c->m1);
+		BF_freeBeliefFunction(&combined);
+		combined = temp;
+	}
+	r->nbValues = DIFF_AUTO_CONFLICT_DEGREE;
+	BF_freeBeliefFunction(&combined);
+	Sets_freeElement(&emptySet);
+}
+
+static void fastAutoConflict(const Diff_Context* c, Diff_Result* r){
+	float* autoConflict = BF_autoConflict(c->m1, DIFF_AUTO_CONFLICT_DEGREE);
+
+	memcpy(r->values, autoConflict, sizeof(float) * DIFF_AUTO_CONFLICT_DEGREE);
+	r->nbValues = DIFF_AUTO_CONFLICT_DEGREE;
+	Memory_free(autoConflict);
+}
+
+static void referenceBetP(const Diff_Context* c, Diff_Result* r){
+	double* dense = malloc(sizeof(double) * (1 << c->size));
+	double betP = 0;
+	int i = 0, a = 0, number = 0;
+
+	/*betP(A) = sum of m(B) |A inter B| / |B| for B not empty: */
+	toDense(c->m1, dense);
+	for(i = 0; i < c->powerset.card; i++){
+		number = Sets_numberFromElement(c->powerset.elements[i], c->size);
+		betP = 0;
+		for(a = 1; a < (1 << c->size); a++){
+			betP += dense[a] * __builtin_popcount(number & a) / __builtin_popcount(a);
+		}
+		r->values[i] = betP;
+	}
+	r->nbValues = c->powerset.card;
+	free(dense);
+}
+
+static void fastBetP(const Diff_Context* c, Diff_Result* r){
+	float* pignistic = BF_pignisticVector(c->m1);
+	int i = 0;
+
+	for(i = 0; i < c->powerset.card; i++){
+		r->values[i] = BF_betPFromVector(pignistic, c->powerset.elements[i], c->size);
+	}
+	r->nbValues = c->powerset.card;
+	Memory_free(pignistic);
+}
+
+static void referenceMeasures(const Diff_Context* c, Diff_Result* r){
+	int i = 0;
+
+	for(i = 0; i < c->powerset.card; i++){
+		r->values[3 * i] = BF_bel(c->m1, c->powerset.elements[i]);
+		r->values[3 * i + 1] = BF_pl(c->m1, c->powerset.elements[i]);
+		r->values[3 * i + 2] = BF_q(c->m1, c->powerset.elements[i]);
+	}
+	r->nbValues = 3 * c->powerset.card;
+}
+
+static void fastMeasures(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction cached = BF_copyBeliefFunction(c->m1);
+	int i = 0;
+
+	BF_enableCache(&cached);
+	for(i = 0; i < c->powerset.card; i++){
+		r->values[3 * i] = BF_bel(cached, c->powerset.elements[i]);
+		r->values[3 * i + 1] = BF_pl(cached, c->powerset.elements[i]);
+		r->values[3 * i + 2] = BF_q(cached, c->powerset.elements[i]);
+	}
+	r->nbValues = 3 * c->powerset.card;
+	BF_freeBeliefFunction(&cached);
+}
+
+static void referenceMetrics(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction sources[2];
+
+	sources[0] = c->m1;
+	sources[1] = c->m2;
+	r->values[0] = BF_specificity(c->m1);
+	r->values[1] = BF_nonSpecificity(c->m1);
+	r->values[2] = BF_discrepancy(c->m1);
+	r->values[3] = BF_globalDistance(c->m1, sources, 2);
+	r->nbValues = 4;
+}
+
+static void fastMetrics(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction sources[2];
+	BF_Metrics metrics;
+
+	sources[0] = c->m1;
+	sources[1] = c->m2;
+	metrics = BF_getMetrics(c->m1, c->table, sources, 2, 0);
+	r->values[0] = metrics.specificity;
+	r->values[1] = metrics.nonSpecificity;
+	r->values[2] = metrics.discrepancy;
+	r->values[3] = metrics.globalDistance;
+	r->nbValues = 4;
+	BF_freeMetrics(&metrics);
+}
+
+static void referenceMaxMass(const Diff_Context* c, Diff_Result* r){
+	double* dense = malloc(sizeof(double) * (1 << c->size));
+	int a = 0;
+
+	/*The largest mass of a non empty subset of at most card atoms: */
+	toDense(c->m1, dense);
+	r->values[0] = 0;
+	for(a = 1; a < (1 << c->size); a++){
+		if((c->card == 0 || __builtin_popcount(a) <= c->card) && dense[a] > r->values[0]){
+			r->values[0] = dense[a];
+		}
+	}
+	r->nbValues = 1;
+	free(dense);
+}
+
+static void fastMaxMass(const Diff_Context* c, Diff_Result* r){
+	BF_FocalElement max = BF_getMaxMass(c->m1, c->card);
+
+	r->values[0] = max.beliefValue;
+	r->nbValues = 1;
+	if(max.element.values != NULL){
+		Sets_freeElement(&(max.element));
+	}
+}
+
+static void referenceBelieveFromBelief(const Diff_Context* c, Diff_Result* r){
+	BFB_BeliefFromBelief vectors = c->bfb;
+
+	/*Without the matrix, the belief vectors are used: */
+	vectors.matrix.nbRows = 0;
+	r->hasFunction = 1;
+	r->function = BFB_believeFromBelief(vectors, c->m1, c->size);
+}
+
+static void referenceDenseBelieveFromBelief(const Diff_Context* c, Diff_Result* r){
+	double *from = NULL, *to = NULL;
+
+	from = malloc(sizeof(double) * (1 << c->size));
+	to = malloc(sizeof(double) * (1 << c->size));
+	toDense(c->m1, from);
+	denseBelieve(c->bfb, from, to, c->size);
+	r->hasFunction = 1;
+	r->function = fromDense(to, c->size);
+	free(from);
+	free(to);
+}
+
+static void fastBelieveFromBelief(const Diff_Context* c, Diff_Result* r){
+	r->hasFunction = 1;
+	r->function = BFB_believeFromBelief(c->bfb, c->m1, c->size);
+}
+
+static void referenceChain(const Diff_Context* c, Diff_Result* r){
+	double *from = NULL, *middle = NULL, *to = NULL;
+
+	/*Both transformations, one after the other: */
+	from = malloc(sizeof(double) * (1 << c->size));
+	middle = malloc(sizeof(double) * (1 << c->size));
+	to = malloc(sizeof(double) * (1 << c->size));
+	toDense(c->m1, from);
+	denseBelieve(c->bfb, from, middle, c->size);
+	denseBelieve(c->bfb2, middle, to, c->size);
+	r->hasFunction = 1;
+	r->function = fromDense(to, c->size);
+	free(from);
+	free(middle);
+	free(to);
+}
+
+static void fastChain(const Diff_Context* c, Diff_Result* r){
+	BFB_BeliefFromBelief chain[2], composed;
+
+	chain[0] = c->bfb;
+	chain[1] = c->bfb2;
+	composed = BFB_composeBeliefsFromBeliefs(chain, c->to, 2);
+	r->hasFunction = 1;
+	r->function = BFB_believeFromBelief(composed, c->m1, c->size);
+	BFB_freeBeliefFromBelief(&composed);
+}
+
+/**
+ * Transforms m1 and m2 by definition: their dense masses, one after the other, in the values.
+ */
+static void referenceBatch(const Diff_Context* c, Diff_Result* r){
+	double *from = NULL, *to = NULL;
+	int nb = 1 << c->size, b = 0, a = 0;
+
+	from = malloc(sizeof(double) * nb);
+	to = malloc(sizeof(double) * nb);
+	for(b = 0; b < DIFF_BATCH_SIZE; b++){
+		toDense(b == 0 ? c->m1 : c->m2, from);
+		denseBelieve(c->bfb, from, to, c->size);
+		for(a = 0; a < nb; a++){
+			r->values[b * nb + a] = to[a];
+		}
+	}
+	r->nbValues = DIFF_BATCH_SIZE * nb;
+	free(from);
+	free(to);
+}
+
+static void fastBatch(const Diff_Context* c, Diff_Result* r){
+	BF_BeliefFunction from[DIFF_BATCH_SIZE];
+	BF_BeliefFunction* to = NULL;
+	double* dense = malloc(sizeof(double) * (1 << c->size));
+	int nb = 1 << c->size, b = 0, a = 0;
+
+	from[0] = c->m1;
+	from[1] = c->m2;
+	to = BFB_believeFromBeliefBatch(c->bfb, from, DIFF_BATCH_SIZE, c->size, DIFF_BATCH_SIZE);
+	for(b = 0; b < DIFF_BATCH_SIZE; b++){
+		toDense(to[b], dense);
+		for(a = 0; a < nb; a++){
+			r->values[b * nb + a] = dense[a];
+		}
+		BF_freeBeliefFunction(&(to[b]));
+	}
+	r->nbValues = DIFF_BATCH_SIZE * nb;
+	Memory_free(to);
+	free(dense);
+}
+
+static void fastTransformMasses(const Diff_Context* c, Diff_Result* r){
+	double* dense = malloc(sizeof(double) * (1 << c->size));
+	float *masses = NULL, *results = NULL;
+	int nb = 1 << c->size, b = 0, a = 0;
+
+	/*The masses of the entities subset by subset: */
+	masses = malloc(sizeof(float) * nb * DIFF_BATCH_SIZE);
+	results = malloc(sizeof(float) * nb * DIFF_BATCH_SIZE);
+	for(b = 0; b < DIFF_BATCH_SIZE; b++){
+		toDense(b == 0 ? c->m1 : c->m2, dense);
+		for(a = 0; a < nb; a++){
+			masses[a * DIFF_BATCH_SIZE + b] = dense[a];
+		}
+	}
+	BFB_transformMasses(c->bfb.matrix, masses, results, DIFF_BATCH_SIZE, DIFF_BATCH_SIZE);
+	for(b = 0; b < DIFF_BATCH_SIZE; b++){
+		for(a = 0; a < nb; a++){
+			r->values[b * nb + a] = results[a * DIFF_BATCH_SIZE + b];
+		}
+	}
+	r->nbValues = DIFF_BATCH_SIZE * nb;
+	free(dense);
+	free(masses);
+	free(results);
+}
+
+
+static const Diff_Case cases[] = {
+	{"BF_SmetsCombination", referenceSmets, fastSmets},
+	{"BF_discountedDuboisPradeCombination", referenceDiscountedDuboisPrade, fastDiscountedDuboisPrade},
+	{"BF_quickConditioning", referenceConditioning, fastConditioning},
+	{"BF_weightedSum", referenceWeightedSum, fastWeightedSum},
+	{"BF_weightedSum/unsorted", referenceWeightedSum, fastUnsortedWeightedSum},
+	{"BF_averageCombination", referenceAverage, fastAverage},
+	{"BF_fullChenCombination", referenceChen, fastChen},
+	{"BF_difference", referenceDifference, fastDifference},
+	{"BF_cleanBeliefFunction", referenceClean, fastClean},
+	{"BF_autoConflict", referenceAutoConflict, fastAutoConflict},
+	{"BF_betPFromVector", referenceBetP, fastBetP},
+	{"BF_enableCache", referenceMeasures, fastMeasures},
+	{"BF_getMetrics", referenceMetrics, fastMetrics},
+	{"BF_getMaxMass", referenceMaxMass, fastMaxMass},
+	{"BFB_believeFromBelief", referenceBelieveFromBelief, fastBelieveFromBelief},
+	{"BFB_believeFromBelief/dense", referenceDenseBelieveFromBelief, fastBelieveFromBelief},
+	{"BFB_composeBeliefsFromBeliefs", referenceChain, fastChain},
+	{"BFB_believeFromBeliefBatch", referenceBatch, fastBatch},
+	{"BFB_transformMasses", referenceBatch, fastTransformMasses}
+};
+#define DIFF_NB_CASES ((int)(sizeof(cases) / sizeof(cases[0])))
+
+
+/*
+  +-------------------+
+  | PRIVATE FUNCTIONS |
+  +-------------------+
+*/
+
+static double now(){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void freeResult(Diff_Result* r){
+	if(r->hasFunction){
+		BF_freeBeliefFunction(&(r->function));
+	}
+	r->hasFunction = 0;
+	r->nbValues = 0;
+}
+
+/**
+ * Runs an operation until the time is long enough, keeps the result of the first run.
+ * @return The time per operation (in seconds).
+ */
+static double run(const Diff_Operation operation, const Diff_Context* c, Diff_Result* r){
+	Diff_Result temp;
+	double start = now(), elapsed = 0;
+	long iterations = 1;
+
+	memset(r, 0, sizeof(Diff_Result));
+	operation(c, r);
+	elapsed = now() - start;
+	while(elapsed < DIFF_MIN_TIME){
+		memset(&temp, 0, sizeof(Diff_Result));
+		operation(c, &temp);
+		freeResult(&temp);
+		iterations++;
+		elapsed = now() - start;
+	}
+
+	return elapsed / iterations;
+}
+
+static double getError(const double reference, const double fast){
+	double error = fabs(reference - fast);
+	double magnitude = fabs(reference) > fabs(fast) ? fabs(reference) : fabs(fast);
+
+	/*Relative error for the values greater than 1: */
+	return magnitude > 1 ? error / magnitude : error;
+}
+
+/**
+ * Compares two results (the belief functions as dense vectors, duplicated focal elements being summed).
+ * @return The largest difference between the masses or the values.
+ */
+static double compare(const Diff_Result* reference, const Diff_Result* fast){
+	double *d1 = NULL, *d2 = NULL;
+	double maxError = 0, error = 0;
+	int i = 0;
+
+	if(reference->hasFunction != fast->hasFunction || reference->nbValues != fast->nbValues){
+		return INFINITY;
+	}
+	if(reference->hasFunction){
+		if(reference->function.elementSize != fast->function.elementSize){
+			return INFINITY;
+		}
+		d1 = malloc(sizeof(double) * (1 << reference->function.elementSize));
+		d2 = malloc(sizeof(double) * (1 << reference->function.elementSize));
+		toDense(reference->function, d1);
+		toDense(fast->function, d2);
+		for(i = 0; i < (1 << reference->function.elementSize); i++){
+			error = getError(d1[i], d2[i]);
+			maxError = error > maxError ? error : maxError;
+		}
+		free(d1);
+		free(d2);
+	}
+	for(i = 0; i < reference->nbValues; i++){
+		error = getError(reference->values[i], fast->values[i]);
+		if(isnan(error) && !(isnan(reference->values[i]) && isnan(fast->values[i]))){
+			return INFINITY;
+		}
+		maxError = error > maxError ? error : maxError;
+	}
+
+	return maxError;
+}
+
+/**
+ * Builds a random model of beliefs from beliefs on a frame: each subset A goes to
+ * u m(B) + (1 - u) m(Omega), B being a random subset other than Omega.
+ */
+static BFB_BeliefFromBelief createRandomModel(BFR_Random* random, const char* frameName, const int size){
+	BFB_BeliefFromBelief bfb = {NULL, {NULL, 0}, NULL, 0, 0, {0, 0, NULL, NULL, NULL, NULL}};
+	char names[DIFF_MAX_DENSE_SIZE][8];
+	const char* atoms[DIFF_MAX_DENSE_SIZE];
+	int i = 0;
+
+	for(i = 0; i < size; i++){
+		sprintf(names[i], "w%d", i);
+		atoms[i] = names[i];
+	}
+	bfb.frameName = Memory_strdup(frameName);
+	bfb.refList = Sets_createRefListFromArray(atoms, size);
+	bfb.nbVectors = (1 << size) - 1;
+	bfb.vectors = Memory_malloc(sizeof(BFB_BeliefVector) * bfb.nbVectors);
+	for(i = 0; i < bfb.nbVectors; i++){
+		bfb.vectors[i].from = Sets_elementFromNumber(i + 1, size);
+		bfb.vectors[i].nbTos = 2;
+		bfb.vectors[i].to = Memory_malloc(sizeof(Sets_Element) * 2);
+		bfb.vectors[i].factors = Memory_malloc(sizeof(float) * 2);
+		bfb.vectors[i].to[0] = Sets_elementFromNumber(BFR_uniformInteger(random, (1 << size) - 1), size);
+		bfb.vectors[i].to[1] = Sets_getCompleteElement(size);
+		bfb.vectors[i].factors[0] = BFR_uniform(random);
+		bfb.vectors[i].factors[1] = 1 - bfb.vectors[i].factors[0];
+	}
+	bfb.matrix = BFB_compileMatrix(bfb, size);
+
+	return bfb;
+}
+
+static void createContext(Diff_Context* c, BFR_Random* random){
+	int nbFocals = 1 + BFR_uniformInteger(random, DIFF_MAX_FOCALS);
+
+	if(nbFocals > (1 << c->size) - 1){
+		nbFocals = (1 << c->size) - 1;
+	}
+	c->m1 = BFR_getRandomBelief(random, c->size, nbFocals, 1);
+	c->m2 = BFR_getRandomBelief(random, c->size, nbFocals, 1);
+	c->sorted1 = BF_copyBeliefFunction(c->m1);
+	c->sorted2 = BF_copyBeliefFunction(c->m2);
+	BF_sortFocals(&(c->sorted1));
+	BF_sortFocals(&(c->sorted2));
+	c->e = Sets_elementFromNumber(1 + BFR_uniformInteger(random, (1 << c->size) - 1), c->size);
+	c->alpha = BFR_uniform(random);
+	c->card = BFR_uniformInteger(random, c->size + 1);
+	c->bfb = createRandomModel(random, "f0", c->size);
+	c->bfb2 = createRandomModel(random, "f1", c->size);
+	/*The structures only give the frames (the states are the same): */
+	c->to[0].frameName = (char*)"f1";
+	c->to[0].refList = c->bfb.refList;
+	c->to[0].beliefs = NULL;
+	c->to[0].nbBeliefs = 0;
+	c->to[1] = c->to[0];
+	c->to[1].frameName = (char*)"f2";
+}
+
+static void freeContext(Diff_Context* c){
+	BF_freeBeliefFunction(&(c->m1));
+	BF_freeBeliefFunction(&(c->m2));
+	BF_freeBeliefFunction(&(c->sorted1));
+	BF_freeBeliefFunction(&(c->sorted2));
+	Sets_freeElement(&(c->e));
+	BFB_freeBeliefFromBelief(&(c->bfb));
+	BFB_freeBeliefFromBelief(&(c->bfb2));
+}
+
+
+/*
+  +------+
+  | MAIN |
+  +------+
+*/
+
+int main(int argc, char** argv){
+	Diff_Context c;
+	Diff_Result reference, fast;
+	BFR_Random random;
+	FILE* output = NULL;
+	const char* filter = NULL;
+	double referenceTime[DIFF_NB_CASES], fastTime[DIFF_NB_CASES], maxError[DIFF_NB_CASES];
+	double error = 0;
+	int failures[DIFF_NB_CASES];
+	int minSize = DIFF_MIN_SIZE, maxSize = DIFF_MAX_SIZE, nbTrials = DIFF_NB_TRIALS;
+	int i = 0, trial = 0, size = 0, nbFailures = 0, first = 1;
+	uint64_t seed = DIFF_SEED;
+
+	/*Arguments: */
+	for(i = 1; i < argc - 1; i += 2){
+		if(strcmp(argv[i], "--min-size") == 0){
+			minSize = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--max-size") == 0){
+			maxSize = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--trials") == 0){
+			nbTrials = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--seed") == 0){
+			seed = strtoull(argv[i + 1], NULL, 10);
+		}
+		else if(strcmp(argv[i], "--filter") == 0){
+			filter = argv[i + 1];
+		}
+		else if(strcmp(argv[i], "--output") == 0){
+			output = fopen(argv[i + 1], "w");
+			if(output == NULL){
+				fprintf(stderr, "Cannot open %s.\n", argv[i + 1]);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	if(minSize < 1){
+		minSize = 1;
+	}
+	if(maxSize > DIFF_MAX_DENSE_SIZE){
+		maxSize = DIFF_MAX_DENSE_SIZE;
+	}
+
+	random = BFR_createRandom(seed);
+	if(output != NULL){
+		fprintf(output, "{\"differential\": [");
+	}
+	for(size = minSize; size <= maxSize; size++){
+		memset(&c, 0, sizeof(Diff_Context));
+		c.size = size;
+		c.powerset = Sets_generatePowerSet(size);
+		c.table = BF_createMetricsTable(size);
+		memset(referenceTime, 0, sizeof(referenceTime));
+		memset(fastTime, 0, sizeof(fastTime));
+		memset(maxError, 0, sizeof(maxError));
+		memset(failures, 0, sizeof(failures));
+
+		for(trial = 0; trial < nbTrials; trial++){
+			createContext(&c, &random);
+			for(i = 0; i < DIFF_NB_CASES; i++){
+				if(filter != NULL && strstr(cases[i].name, filter) == NULL){
+					continue;
+				}
+				referenceTime[i] += run(cases[i].reference, &c, &reference);
+				fastTime[i] += run(cases[i].fast, &c, &fast);
+				error = compare(&reference, &fast);
+				if(!(error <= BF_PRECISION)){
+					failures[i]++;
+					fprintf(stderr, "%s disagrees with its reference (size %d, trial %d, seed %lu): error %g\n",
+							cases[i].name, size, trial, (unsigned long)seed, error);
+				}
+				maxError[i] = error > maxError[i] ? error : maxError[i];
+				freeResult(&reference);
+				freeResult(&fast);
+			}
+			freeContext(&c);
+		}
+
+		/*Results of the frame: */
+		for(i = 0; i < DIFF_NB_CASES; i++){
+			if(filter != NULL && strstr(cases[i].name, filter) == NULL){
+				continue;
+			}
+			nbFailures += failures[i];
+			printf("%-40s size %2d: max error %.2e, speedup %.2f%s\n", cases[i].name, size, maxError[i],
+					referenceTime[i] / fastTime[i], failures[i] > 0 ? " FAILED" : "");
+			if(output != NULL){
+				fprintf(output, "%s\n  {\"name\": \"%s\", \"size\": %d, \"trials\": %d, \"failures\": %d, \"max_error\": %g, "
+						"\"reference_ns\": %.1f, \"fast_ns\": %.1f, \"speedup\": %.2f}",
+						first ? "" : ",", cases[i].name, size, nbTrials, failures[i], maxError[i],
+						referenceTime[i] * 1e9 / nbTrials, fastTime[i] * 1e9 / nbTrials, referenceTime[i] / fastTime[i]);
+				first = 0;
+			}
+		}
+		Sets_freeSet(&(c.powerset));
+		BF_freeMetricsTable(&(c.table));
+	}
+	if(output != NULL){
+		fprintf(output, "\n]}\n");
+		fclose(output);
+	}
+	BF_clearPool();
+
+	printf("%d disagreement(s)\n", nbFailures);
+
+	return nbFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
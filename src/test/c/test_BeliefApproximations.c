@@ -0,0 +1,178 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * test_BeliefApproximations.c
+ */
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "BeliefApproximations.h"
+#include "BeliefsFromSensors.h"
+
+#include "unit_tests.h"
+
+
+BFS_BeliefStructure beliefStructure;
+BF_BeliefFunction *evidences = NULL;
+
+
+static void setup() {
+    char const *sensorTypes[] = {"S1", "S2"};
+    double sensorMeasures[] = {300.0, 400.0};
+	beliefStructure = BFS_loadBeliefStructure(BELIEF_DEFINITION_PATH, "unittest");
+
+	evidences = BFS_getEvidence(beliefStructure, sensorTypes, sensorMeasures, SENSOR_NB);
+}
+
+static void teardown() {
+	int i;
+	BFS_freeBeliefStructure(&beliefStructure);
+	for(i = 0; i < SENSOR_NB; i++){
+		BF_freeBeliefFunction(&(evidences[i]));
+	}
+	free(evidences);
+}
+
+
+/*
+ * Bounded approximations
+ * ======================
+ */
+
+START_TEST(summarizeMergesTheSmallestMassesIntoTheirUnion) {
+	/*
+	 * evidences[1] : m(AuC) = 0.4, m(C) = 0.4, m(A) = 0.1, m(B) = 0.1, m(AuBuC) = 0
+	 * With 2 focals, the biggest mass is kept and all the others go to AuBuC.
+	 */
+	float error = -1;
+	BF_BeliefFunction summarized = BF_summarize(evidences[1], 2, &error);
+
+	ck_assert_int_eq(2, summarized.nbFocals);
+	assert_flt_equals(0.6f, BF_m(summarized, AuBuC), BF_PRECISION);
+	ck_assert(!BF_checkSum(summarized));
+	assert_flt_equals(BF_distance(evidences[1], summarized), error, BF_PRECISION);
+	BF_freeBeliefFunction(&summarized);
+}
+END_TEST
+
+START_TEST(summarizeDoesNothingUnderTheBound) {
+	float error = -1;
+	BF_BeliefFunction summarized = BF_summarize(evidences[0], evidences[0].nbFocals, &error);
+
+	ck_assert_int_eq(evidences[0].nbFocals, summarized.nbFocals);
+	assert_flt_equals(0.0f, error, BF_PRECISION);
+	BF_freeBeliefFunction(&summarized);
+}
+END_TEST
+
+START_TEST(klxKeepsAtMostLFocals) {
+	/* evidences[0] : m(A) = 0.75, m(AuB) = 0.15, m(B) = 0.1, m(C) = 0 */
+	BF_BeliefFunction approximation = BF_klxApproximation(evidences[0], 1, 2, 0.0f, NULL);
+
+	ck_assert_int_eq(2, approximation.nbFocals);
+	assert_flt_equals(0.75f / 0.9f, BF_m(approximation, A), BF_PRECISION);
+	assert_flt_equals(0.15f / 0.9f, BF_m(approximation, AuB), BF_PRECISION);
+	BF_freeBeliefFunction(&approximation);
+}
+END_TEST
+
+
+/*
+ * Consonant and Bayesian approximations
+ * =====================================
+ */
+
+START_TEST(outerConsonantApproximationIsNested) {
+	/* Order by plausibility: C, A, B */
+	BF_BeliefFunction consonant = BF_outerConsonantApproximation(evidences[1], NULL);
+
+	assert_flt_equals(0.4f, BF_m(consonant, C), BF_PRECISION);
+	assert_flt_equals(0.5f, BF_m(consonant, AuC), BF_PRECISION);
+	assert_flt_equals(0.1f, BF_m(consonant, AuBuC), BF_PRECISION);
+	ck_assert(!BF_checkSum(consonant));
+	BF_freeBeliefFunction(&consonant);
+}
+END_TEST
+
+START_TEST(innerConsonantApproximationIsNested) {
+	/* Order by plausibility: C, A, B. A and B do not contain C. */
+	BF_BeliefFunction consonant = BF_innerConsonantApproximation(evidences[1], NULL);
+
+	assert_flt_equals(0.2f, BF_m(consonant, VOID), BF_PRECISION);
+	assert_flt_equals(0.4f, BF_m(consonant, C), BF_PRECISION);
+	assert_flt_equals(0.4f, BF_m(consonant, AuC), BF_PRECISION);
+	BF_freeBeliefFunction(&consonant);
+}
+END_TEST
+
+START_TEST(bayesianApproximationsOnlyHaveSingletons) {
+	int i = 0;
+	BF_BeliefFunction bayesian = BF_bayesianApproximation(evidences[0], NULL);
+	BF_BeliefFunction pignistic = BF_pignisticApproximation(evidences[0], NULL);
+
+	for(i = 0; i < bayesian.nbFocals; i++){
+		ck_assert_int_eq(1, bayesian.focals[i].element.card);
+	}
+	for(i = 0; i < pignistic.nbFocals; i++){
+		ck_assert_int_eq(1, pignistic.focals[i].element.card);
+	}
+	/* pl(A) = 0.9, pl(B) = 0.25 */
+	assert_flt_equals(0.9f / 1.15f, BF_m(bayesian, A), BF_PRECISION);
+	assert_flt_equals(BF_betP(evidences[0], A), BF_m(pignistic, A), BF_PRECISION);
+	BF_freeBeliefFunction(&bayesian);
+	BF_freeBeliefFunction(&pignistic);
+}
+END_TEST
+
+
+TCase* createBoundedTestCase() {
+	TCase* testCase = tcase_create("Bounded");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, summarizeMergesTheSmallestMassesIntoTheirUnion);
+	tcase_add_test(testCase, summarizeDoesNothingUnderTheBound);
+	tcase_add_test(testCase, klxKeepsAtMostLFocals);
+	return testCase;
+}
+
+TCase* createConsonantAndBayesianTestCase() {
+	TCase* testCase = tcase_create("ConsonantAndBayesian");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, outerConsonantApproximationIsNested);
+	tcase_add_test(testCase, innerConsonantApproximationIsNested);
+	tcase_add_test(testCase, bayesianApproximationsOnlyHaveSingletons);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("BeliefApproximations");
+	suite_add_tcase(suite, createBoundedTestCase());
+	suite_add_tcase(suite, createConsonantAndBayesianTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -23,6 +23,7 @@
 
 #include <check.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 #include "BeliefCombinations.h"
 #include "BeliefsFromSensors.h"
@@ -93,12 +94,247 @@ START_TEST(DempsterCombinationValuesAreOk) {
 }
 END_TEST
 
+/* ##Average */
+START_TEST(AverageCombinationValuesAreOk) {
+	/*
+	 * expected values :
+	 * m(A) = (0.75 + 0.1) / 2
+	 * m(B) = (0.1 + 0.1) / 2
+	 * m(AuB) = 0.15 / 2
+	 * m(C) = 0.4 / 2
+	 * m(AuC) = 0.4 / 2
+	 */
+	BF_BeliefFunction average = BF_averageCombination(evidences[0], evidences[1]);
+	BF_BeliefFunction sorted[SENSOR_NB];
+	BF_BeliefFunction sortedAverage;
+	int i;
+
+	assert_flt_equals(0.425f, BF_m(average, A), BF_PRECISION);
+	assert_flt_equals(0.1f, BF_m(average, B), BF_PRECISION);
+	assert_flt_equals(0.075f, BF_m(average, AuB), BF_PRECISION);
+	assert_flt_equals(0.2f, BF_m(average, C), BF_PRECISION);
+	assert_flt_equals(0.2f, BF_m(average, AuC), BF_PRECISION);
+	ck_assert(BF_isSorted(average));
+
+	/* The merge of sorted functions must give the same result */
+	for(i = 0; i < SENSOR_NB; i++){
+		sorted[i] = BF_copyBeliefFunction(evidences[i]);
+		BF_sortFocals(&(sorted[i]));
+		ck_assert(BF_isSorted(sorted[i]));
+	}
+	sortedAverage = BF_fullAverageCombination(sorted, SENSOR_NB);
+	ck_assert_int_eq(average.nbFocals, sortedAverage.nbFocals);
+	for(i = 0; i < average.nbFocals; i++){
+		ck_assert(Sets_equals(average.focals[i].element, sortedAverage.focals[i].element, ATOM_NB));
+		assert_flt_equals(average.focals[i].beliefValue, sortedAverage.focals[i].beliefValue, BF_PRECISION);
+	}
+
+	for(i = 0; i < SENSOR_NB; i++){
+		BF_freeBeliefFunction(&(sorted[i]));
+	}
+	BF_freeBeliefFunction(&sortedAverage);
+	BF_freeBeliefFunction(&average);
+}
+END_TEST
+
+/* ##Discounted Dubois & Prade */
+START_TEST(DiscountedDuboisPradeMatchesDiscountThenCombine) {
+	/*
+	 * The fused kernel must give the same result as discounting first
+	 * and combining afterwards, with or without a complete set in m1.
+	 */
+	float alphas[] = {0.0f, 0.3f, 1.0f};
+	BF_BeliefFunction discounted, expected, fused;
+	int i, j, k;
+
+	for(i = 0; i < SENSOR_NB; i++){
+		for(j = 0; j < 3; j++){
+			discounted = BF_discounting(evidences[i], alphas[j]);
+			expected = BF_DuboisPradeCombination(discounted, evidences[1 - i]);
+			fused = BF_discountedDuboisPradeCombination(evidences[i], alphas[j], evidences[1 - i]);
+			ck_assert_int_eq(expected.nbFocals, fused.nbFocals);
+			for(k = 0; k < expected.nbFocals; k++){
+				assert_flt_equals(expected.focals[k].beliefValue,
+						BF_m(fused, expected.focals[k].element), BF_PRECISION);
+			}
+			BF_freeBeliefFunction(&discounted);
+			BF_freeBeliefFunction(&expected);
+			BF_freeBeliefFunction(&fused);
+		}
+	}
+}
+END_TEST
+
+
+/* ##Auto-conflict */
+START_TEST(AutoConflictMatchesSuccessiveCombinations) {
+	/*
+	 * Degree i is the void mass of the combination of i + 2 copies of the function.
+	 */
+	const int maxDegree = 5;
+	BF_BeliefFunction temp, temp2;
+	float* conflicts;
+	int i, j;
+
+	for(i = 0; i < SENSOR_NB; i++){
+		conflicts = BF_autoConflict(evidences[i], maxDegree);
+		temp = BF_SmetsCombination(evidences[i], evidences[i]);
+		for(j = 0; j < maxDegree; j++){
+			assert_flt_equals(BF_m(temp, VOID), conflicts[j], BF_PRECISION);
+			temp2 = BF_SmetsCombination(temp, evidences[i]);
+			BF_freeBeliefFunction(&temp);
+			temp = temp2;
+		}
+		BF_freeBeliefFunction(&temp);
+		free(conflicts);
+	}
+}
+END_TEST
+
+
+START_TEST(CombinationLoopReusesPooledBlocks) {
+	BF_BeliefFunction combined;
+	BF_PoolStats stats;
+	int i;
+
+	BF_clearPool();
+	BF_resetPoolStats();
+	for(i = 0; i < 5; i++){
+		combined = BF_SmetsCombination(evidences[0], evidences[1]);
+		BF_freeBeliefFunction(&combined);
+	}
+	stats = BF_getPoolStats();
+
+	/*
+	 * Only the first combination allocates, the others reuse its blocks: the block of the
+	 * products and the smaller one the result is moved into after the merges.
+	 */
+	ck_assert_int_eq(2, stats.misses);
+	ck_assert_int_eq(8, stats.hits);
+	ck_assert_int_eq(10, stats.recycled);
+	BF_clearPool();
+}
+END_TEST
+
+START_TEST(PoolKeepsAtMostItsMaximumBytes) {
+	BF_BeliefFunction functions[8];
+	BF_PoolStats stats;
+	int i;
+
+	BF_clearPool();
+	BF_resetPoolStats();
+	/* Blocks of more than BF_POOL_MAX_BYTES / 4 bytes: */
+	for(i = 0; i < 8; i++){
+		functions[i] = BF_allocateBeliefFunction(BF_POOL_MAX_BYTES / 4 / sizeof(BF_FocalElement), ATOM_NB);
+	}
+	for(i = 0; i < 8; i++){
+		BF_freeBeliefFunction(&(functions[i]));
+	}
+	stats = BF_getPoolStats();
+
+	ck_assert_int_eq(8, stats.recycled + stats.freed);
+	ck_assert(stats.freed >= 5);
+	ck_assert(stats.retained > 0 && stats.retained <= BF_POOL_MAX_BYTES);
+	BF_resetPoolStats();
+	ck_assert(stats.retained == BF_getPoolStats().retained);
+	BF_clearPool();
+	ck_assert(BF_getPoolStats().retained == 0);
+}
+END_TEST
+
+/*
+ * Combines in a thread that exits without BF_clearPool(): its pool is emptied at exit.
+ */
+static void* combineInThread(void* retained){
+	BF_BeliefFunction combined = BF_SmetsCombination(evidences[0], evidences[1]);
+
+	BF_freeBeliefFunction(&combined);
+	*((size_t*)retained) = BF_getPoolStats().retained;
+	return NULL;
+}
+
+START_TEST(PoolOfExitingThreadIsEmptied) {
+	pthread_t thread;
+	size_t retained = 0;
+
+	ck_assert_int_eq(0, pthread_create(&thread, NULL, combineInThread, &retained));
+	pthread_join(thread, NULL);
+	/* Nothing leaks (checked with the sanitizers), the pool of the thread did keep blocks: */
+	ck_assert(retained > 0);
+}
+END_TEST
+
+START_TEST(CombinationReachingAllSubsetsIsOk) {
+	/* m(X) = 1/8 for the 8 subsets: the combinations produce all the subsets */
+	BF_BeliefFunction all = BF_allocateBeliefFunction(8, ATOM_NB);
+	BF_BeliefFunction combined;
+	int i = 0, j = 0;
+
+	for(i = 0; i < 8; i++){
+		for(j = 0; j < ATOM_NB; j++){
+			all.focals[i].element.values[j] = (i >> j) & 1;
+			all.focals[i].element.card += (i >> j) & 1;
+		}
+		all.focals[i].beliefValue = 0.125;
+	}
+
+	combined = BF_SmetsCombination(all, all);
+	ck_assert_int_eq(8, combined.nbFocals);
+	ck_assert_int_eq(0, BF_checkSum(combined));
+	BF_freeBeliefFunction(&combined);
+	combined = BF_DuboisPradeCombination(all, all);
+	ck_assert_int_eq(8, combined.nbFocals);
+	ck_assert_int_eq(0, BF_checkSum(combined));
+	BF_freeBeliefFunction(&combined);
+	BF_freeBeliefFunction(&all);
+}
+END_TEST
+
+START_TEST(CombinationResultIsShrunkAfterMerges) {
+	/* 64 products merged into the 8 subsets: the block is sized for 8 focal elements */
+	BF_BeliefFunction all = BF_allocateBeliefFunction(8, ATOM_NB);
+	BF_BeliefFunction combined, copy;
+	int i = 0, j = 0;
+
+	for(i = 0; i < 8; i++){
+		for(j = 0; j < ATOM_NB; j++){
+			all.focals[i].element.values[j] = (i >> j) & 1;
+			all.focals[i].element.card += (i >> j) & 1;
+		}
+		all.focals[i].beliefValue = 0.125;
+	}
+	combined = BF_DuboisPradeCombination(all, all);
+	copy = BF_copyBeliefFunction(combined);
+	ck_assert(BF_memoryUsage(combined).total == BF_memoryUsage(copy).total);
+	BF_freeBeliefFunction(&copy);
+
+	/* Same thing when focal elements are dropped: */
+	combined.nbFocals = 2;
+	BF_shrinkBeliefFunction(&combined);
+	ck_assert(BF_isFlat(combined));
+	copy = BF_copyBeliefFunction(combined);
+	ck_assert(BF_memoryUsage(combined).total == BF_memoryUsage(copy).total);
+	ck_assert(Sets_equals(all.focals[1].element, combined.focals[1].element, ATOM_NB));
+
+	BF_freeBeliefFunction(&copy);
+	BF_freeBeliefFunction(&combined);
+	BF_freeBeliefFunction(&all);
+}
+END_TEST
 
 TCase* createFusionTestCase() {
 TCase* testCaseFusion = tcase_create("Fusion");
 tcase_add_checked_fixture(testCaseFusion, setup, teardown);
 tcase_add_test(testCaseFusion, SmetsCombinationValuesAreOk);
 tcase_add_test(testCaseFusion, DempsterCombinationValuesAreOk);
+tcase_add_test(testCaseFusion, AverageCombinationValuesAreOk);
+tcase_add_test(testCaseFusion, DiscountedDuboisPradeMatchesDiscountThenCombine);
+tcase_add_test(testCaseFusion, AutoConflictMatchesSuccessiveCombinations);
+tcase_add_test(testCaseFusion, CombinationLoopReusesPooledBlocks);
+tcase_add_test(testCaseFusion, PoolKeepsAtMostItsMaximumBytes);
+tcase_add_test(testCaseFusion, PoolOfExitingThreadIsEmptied);
+tcase_add_test(testCaseFusion, CombinationReachingAllSubsetsIsOk);
+tcase_add_test(testCaseFusion, CombinationResultIsShrunkAfterMerges);
 return testCaseFusion;
 }
 
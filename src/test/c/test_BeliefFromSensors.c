@@ -304,6 +304,35 @@ START_TEST(testTempoFusion) {
 }
 END_TEST
 
+START_TEST(testTempoFusionInPlace) {
+	BFS_SensorBeliefs *beliefS4 = getSensorBelief(beliefStructure,"S4");
+	BFS_Option *option = &(beliefS4->options[0]);
+	BF_BeliefFunction function = BFS_getProjection(*beliefS4, 100, ATOM_NB);
+	const BF_BeliefFunction *state = BFS_temporization_fusionInPlace(function, option->parameter, option, 0.5);
+
+	/* Same result as testTempoFusion, kept in the option: */
+	ck_assert(state == &(option->util[1].bf));
+	assert_flt_equals(0.625, valueFor(*state, A), BF_PRECISION);
+	BF_freeBeliefFunction(&function);
+}
+END_TEST
+
+START_TEST(memoryUsageIsBrokenDownByComponent) {
+	BFS_MemoryUsage usage = BFS_memoryUsage(beliefStructure);
+
+	/* "A", "B", "C" and the powerset of 8 elements of 3 values: */
+	ck_assert(usage.refList == 3 * (sizeof(char*) + 2));
+	ck_assert(usage.possibleValues == 3 * (sizeof(Sets_Element) + 3));
+	ck_assert(usage.powerset == 8 * (sizeof(Sets_Element) + 3));
+	ck_assert(usage.sensors == 4 * sizeof(BFS_SensorBeliefs));
+	ck_assert(usage.curves > 0);
+	/* S3 has a temporization: */
+	ck_assert(usage.options >= 2 * sizeof(BFS_UtilData));
+	ck_assert(usage.total == usage.names + usage.refList + usage.possibleValues + usage.powerset
+			+ usage.sensors + usage.curves + usage.options);
+}
+END_TEST
+
 static TCase* createParsingTestcase() {
 	TCase* testCaseParsing = tcase_create("Parsing");
 	tcase_add_checked_fixture(testCaseParsing, setup, teardown);
@@ -316,6 +345,7 @@ static TCase* createParsingTestcase() {
 	tcase_add_test(testCaseParsing, sensorNbFocalsIsOk);
 	tcase_add_test(testCaseParsing, sensorValuesAreOk1);
 	tcase_add_test(testCaseParsing, sensorValuesAreOk2);
+	tcase_add_test(testCaseParsing, memoryUsageIsBrokenDownByComponent);
 	return testCaseParsing;
 }
 
@@ -327,6 +357,7 @@ static TCase* createBeliefProjectionsTestCase() {
 	tcase_add_test(testCaseProjections, ProjectionFocalValues);
 	tcase_add_test(testCaseProjections, testTempoSpecificity);
 	tcase_add_test(testCaseProjections, testTempoFusion);
+	tcase_add_test(testCaseProjections, testTempoFusionInPlace);
 
 	return testCaseProjections;
 
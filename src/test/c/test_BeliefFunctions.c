@@ -24,6 +24,8 @@
 
 #include <check.h>
 #include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "BeliefFunctions.h"
 #include "BeliefsFromSensors.h"
@@ -175,6 +177,294 @@ START_TEST(getListMinMassReturnsTheRightFocals) {
 }
 END_TEST
 
+/*
+ * Utility Tests
+ * =============
+ */
+
+START_TEST(cleanMergesDuplicatesAndRemovesZeros) {
+	/* A and AuB appear twice, C is not a focal element */
+	Sets_Element elements[] = {AuB, A, C, A, B, AuB};
+	float masses[] = {0.1f, 0.3f, 0.0000001f, 0.2f, 0.3f, 0.1f};
+	BF_BeliefFunction bf = {NULL, 0, ATOM_NB};
+	int i;
+
+	bf.nbFocals = 6;
+	bf.focals = malloc(sizeof(BF_FocalElement) * bf.nbFocals);
+	for(i = 0; i < bf.nbFocals; i++){
+		bf.focals[i].element = Sets_copyElement(elements[i], ATOM_NB);
+		bf.focals[i].beliefValue = masses[i];
+	}
+	BF_cleanBeliefFunction(&bf);
+
+	ck_assert_int_eq(3, bf.nbFocals);
+	/* Canonical order: A, B, AuB */
+	ck_assert(Sets_equals(A, bf.focals[0].element, ATOM_NB));
+	ck_assert(Sets_equals(B, bf.focals[1].element, ATOM_NB));
+	ck_assert(Sets_equals(AuB, bf.focals[2].element, ATOM_NB));
+	assert_flt_equals(0.5f, BF_m(bf, A), BF_PRECISION);
+	assert_flt_equals(0.3f, BF_m(bf, B), BF_PRECISION);
+	assert_flt_equals(0.2f, BF_m(bf, AuB), BF_PRECISION);
+	BF_freeBeliefFunction(&bf);
+}
+END_TEST
+
+/*
+ * Operation Tests
+ * ===============
+ */
+
+START_TEST(conditioningTransfersMassesToIntersections) {
+	/*
+	 * evidences[1] : m(AuC) = 0.4, m(C) = 0.4, m(A) = 0.1, m(B) = 0.1
+	 * Knowing AuB: m(A) = 0.1 + 0.4, m(B) = 0.1, m(void) = 0.4
+	 */
+	BF_BeliefFunction conditioned = BF_quickConditioning(evidences[1], AuB);
+
+	assert_flt_equals(0.5f, BF_m(conditioned, A), BF_PRECISION);
+	assert_flt_equals(0.1f, BF_m(conditioned, B), BF_PRECISION);
+	assert_flt_equals(0.4f, BF_m(conditioned, VOID), BF_PRECISION);
+	assert_flt_equals(0.0f, BF_m(conditioned, AuB), BF_PRECISION);
+	ck_assert(BF_isSorted(conditioned));
+	BF_freeBeliefFunction(&conditioned);
+}
+END_TEST
+
+START_TEST(multipleConditioningGivesOneFunctionPerEvent) {
+	/*
+	 * evidences[0] : m(A) = 0.75, m(AuB) = 0.15, m(B) = 0.1
+	 * Knowing A: m(A) = 0.9, m(void) = 0.1
+	 * Knowing B: m(B) = 0.25, m(void) = 0.75
+	 */
+	Sets_Element events[] = {A, B};
+	BF_BeliefFunction* conditioned = BF_multipleConditioning(evidences[0], events, 2);
+
+	assert_flt_equals(0.9f, BF_m(conditioned[0], A), BF_PRECISION);
+	assert_flt_equals(0.1f, BF_m(conditioned[0], VOID), BF_PRECISION);
+	assert_flt_equals(0.25f, BF_m(conditioned[1], B), BF_PRECISION);
+	assert_flt_equals(0.75f, BF_m(conditioned[1], VOID), BF_PRECISION);
+	BF_freeBeliefFunction(&(conditioned[0]));
+	BF_freeBeliefFunction(&(conditioned[1]));
+	free(conditioned);
+}
+END_TEST
+
+START_TEST(weightedSumOfNoFunctionIsEmpty) {
+	BF_BeliefFunction sum = BF_weightedSum(NULL, NULL, 0);
+
+	ck_assert_int_eq(0, sum.nbFocals);
+	ck_assert(sum.focals == NULL);
+	BF_freeBeliefFunction(&sum);
+}
+END_TEST
+
+START_TEST(pignisticVectorGivesBetPOfAnyElement) {
+	/* evidences[0] : m(A) = 0.75, m(AuB) = 0.15, m(B) = 0.1 */
+	Sets_Element elements[] = {A, B, C, AuB, AuC, BuC, AuBuC};
+	float* pignistic = BF_pignisticVector(evidences[0]);
+	int i;
+
+	assert_flt_equals(0.825f, pignistic[0], BF_PRECISION);
+	assert_flt_equals(0.175f, pignistic[1], BF_PRECISION);
+	assert_flt_equals(0.0f, pignistic[2], BF_PRECISION);
+	for(i = 0; i < 7; i++){
+		assert_flt_equals(BF_betP(evidences[0], elements[i]),
+				BF_betPFromVector(pignistic, elements[i], ATOM_NB), BF_PRECISION);
+	}
+	free(pignistic);
+}
+END_TEST
+
+START_TEST(discrepancyIsBasedOnBetP) {
+	float expected = 0;
+	int i;
+
+	for(i = 0; i < evidences[1].nbFocals; i++){
+		expected -= evidences[1].focals[i].beliefValue
+				* log(BF_betP(evidences[1], evidences[1].focals[i].element)) / log(2);
+	}
+	assert_flt_equals(expected, BF_discrepancy(evidences[1]), BF_PRECISION);
+}
+END_TEST
+
+START_TEST(cacheGivesTheSameValuesAndIsComputedAgain) {
+	Sets_Element elements[] = {VOID, A, B, C, AuB, AuC, BuC, AuBuC};
+	BF_BeliefFunction cached = BF_copyBeliefFunction(evidences[0]);
+	BF_BeliefFunction plain;
+	size_t filled = 0;
+	int i;
+
+	/* Everything is computed when enabled: */
+	BF_enableCache(&cached);
+	filled = BF_memoryUsage(cached).cache;
+	ck_assert(filled >= (3 * 8 + ATOM_NB) * sizeof(float));
+	for(i = 0; i < 8; i++){
+		assert_flt_equals(BF_bel(evidences[0], elements[i]), BF_bel(cached, elements[i]), BF_PRECISION);
+		assert_flt_equals(BF_pl(evidences[0], elements[i]), BF_pl(cached, elements[i]), BF_PRECISION);
+		assert_flt_equals(BF_q(evidences[0], elements[i]), BF_q(cached, elements[i]), BF_PRECISION);
+		assert_flt_equals(BF_betP(evidences[0], elements[i]), BF_betP(cached, elements[i]), BF_PRECISION);
+	}
+	assert_flt_equals(BF_specificity(evidences[0]), BF_specificity(cached), BF_PRECISION);
+	assert_flt_equals(BF_nonSpecificity(evidences[0]), BF_nonSpecificity(cached), BF_PRECISION);
+	ck_assert(BF_memoryUsage(cached).cache == filled);
+	/* No mass on an element without pignistic probability, for the discrepancy: */
+	plain = BF_copyBeliefFunction(evidences[1]);
+	BF_enableCache(&plain);
+	assert_flt_equals(BF_discrepancy(evidences[1]), BF_discrepancy(plain), BF_PRECISION);
+	BF_freeBeliefFunction(&plain);
+
+	/* Modifying the function computes the cache again: */
+	cached.focals[0].beliefValue *= 2;
+	BF_normalize(&cached);
+	ck_assert(BF_memoryUsage(cached).cache == filled);
+	/* Copies do not share the cache: */
+	plain = BF_copyBeliefFunction(cached);
+	ck_assert(BF_memoryUsage(plain).cache == 0);
+	for(i = 0; i < 8; i++){
+		assert_flt_equals(BF_bel(plain, elements[i]), BF_bel(cached, elements[i]), BF_PRECISION);
+		assert_flt_equals(BF_betP(plain, elements[i]), BF_betP(cached, elements[i]), BF_PRECISION);
+	}
+	assert_flt_equals(BF_specificity(plain), BF_specificity(cached), BF_PRECISION);
+
+	BF_freeBeliefFunction(&plain);
+	BF_freeBeliefFunction(&cached);
+}
+END_TEST
+
+/**
+ * Queries all the elements of a cached function and counts the differences with the given function.
+ */
+static void* queryCachedFunction(void* data){
+	Sets_Element elements[] = {VOID, A, B, C, AuB, AuC, BuC, AuBuC};
+	BF_BeliefFunction* functions = data;
+	long nbDifferences = 0;
+	int i, j;
+
+	for(j = 0; j < 1000; j++){
+		for(i = 0; i < 8; i++){
+			nbDifferences += fabs(BF_bel(functions[0], elements[i]) - BF_bel(functions[1], elements[i])) > BF_PRECISION;
+			nbDifferences += fabs(BF_pl(functions[0], elements[i]) - BF_pl(functions[1], elements[i])) > BF_PRECISION;
+			nbDifferences += fabs(BF_betP(functions[0], elements[i]) - BF_betP(functions[1], elements[i])) > BF_PRECISION;
+		}
+	}
+
+	return (void*)nbDifferences;
+}
+
+START_TEST(cachedFunctionIsReadByManyThreads) {
+	BF_BeliefFunction functions[2];
+	pthread_t threads[4];
+	void* nbDifferences = NULL;
+	int i;
+
+	functions[0] = BF_copyBeliefFunction(evidences[0]);
+	functions[1] = evidences[0];
+	BF_enableCache(&(functions[0]));
+	for(i = 0; i < 4; i++){
+		ck_assert_int_eq(0, pthread_create(&(threads[i]), NULL, queryCachedFunction, functions));
+	}
+	for(i = 0; i < 4; i++){
+		pthread_join(threads[i], &nbDifferences);
+		ck_assert(nbDifferences == NULL);
+	}
+	BF_freeBeliefFunction(&(functions[0]));
+}
+END_TEST
+
+START_TEST(functionBuiltByHandIsNotFlat) {
+	BF_BeliefFunction m;
+
+	/* Built field by field, as before the flat layout: */
+	m.elementSize = ATOM_NB;
+	m.nbFocals = 3;
+	m.focals = malloc(sizeof(BF_FocalElement) * m.nbFocals);
+	m.focals[0].element = Sets_copyElement(AuB, ATOM_NB);
+	m.focals[0].beliefValue = 0.5;
+	m.focals[1].element = Sets_copyElement(A, ATOM_NB);
+	m.focals[1].beliefValue = 0.3;
+	m.focals[2].element = Sets_copyElement(AuB, ATOM_NB);
+	m.focals[2].beliefValue = 0.2;
+	ck_assert(!BF_isFlat(m));
+	/* Not flat, not cached: */
+	BF_enableCache(&m);
+	ck_assert(BF_memoryUsage(m).cache == 0);
+	assert_flt_equals(1.0f, BF_bel(m, AuB), BF_PRECISION);
+	BF_cleanBeliefFunction(&m);
+	ck_assert_int_eq(2, m.nbFocals);
+	ck_assert(!BF_isFlat(m));
+	BF_freeBeliefFunction(&m);
+}
+END_TEST
+
+START_TEST(copyIsFlatAndCanBeCleaned) {
+	BF_BeliefFunction copy = BF_copyBeliefFunction(evidences[0]);
+	int i, nbFocals;
+
+	ck_assert(BF_isFlat(copy));
+	ck_assert_int_eq(evidences[0].nbFocals, copy.nbFocals);
+	for(i = 0; i < copy.nbFocals; i++){
+		ck_assert(Sets_equals(evidences[0].focals[i].element, copy.focals[i].element, ATOM_NB));
+		assert_flt_equals(evidences[0].focals[i].beliefValue, copy.focals[i].beliefValue, BF_PRECISION);
+		/* The values of the elements are contiguous, right after the focals: */
+		ck_assert(copy.focals[i].element.values == (char*)(copy.focals + copy.nbFocals) + i * ATOM_NB);
+	}
+	/* The elements are never freed one by one, the function stays flat: */
+	BF_cleanBeliefFunction(&copy);
+	ck_assert(BF_isFlat(copy));
+	assert_flt_equals(BF_m(evidences[0], A), BF_m(copy, A), BF_PRECISION);
+	/* Even when focal elements are removed: */
+	nbFocals = copy.nbFocals;
+	copy.focals[0].beliefValue = 0;
+	BF_cleanBeliefFunction(&copy);
+	ck_assert_int_eq(nbFocals - 1, copy.nbFocals);
+	ck_assert(BF_isFlat(copy));
+	for(i = 0; i < copy.nbFocals; i++){
+		ck_assert(copy.focals[i].element.values == (char*)(copy.focals + copy.nbFocals) + i * ATOM_NB);
+	}
+	BF_freeBeliefFunction(&copy);
+}
+END_TEST
+
+START_TEST(memoryUsageCountsFocalsElementsAndCache) {
+	BF_BeliefFunction copy = BF_copyBeliefFunction(evidences[0]);
+	BF_MemoryUsage usage = BF_memoryUsage(copy);
+
+	ck_assert(usage.elements == (size_t)copy.nbFocals * ATOM_NB);
+	ck_assert(usage.focals >= sizeof(BF_FocalElement) * copy.nbFocals);
+	ck_assert(usage.cache == 0);
+	ck_assert(usage.total == usage.focals + usage.elements + usage.cache);
+
+	/* The dense vectors of the cache hold 2^ATOM_NB values each, the pignistic vector ATOM_NB: */
+	BF_enableCache(&copy);
+	usage = BF_memoryUsage(copy);
+	ck_assert(usage.cache >= (3 * (1 << ATOM_NB) + ATOM_NB) * sizeof(float));
+	ck_assert(usage.total == usage.focals + usage.elements + usage.cache);
+	BF_freeBeliefFunction(&copy);
+}
+END_TEST
+
+TCase* createOperationTestCase() {
+TCase* testCaseOperation = tcase_create("Operation");
+tcase_add_checked_fixture(testCaseOperation, setup, teardown);
+tcase_add_test(testCaseOperation, conditioningTransfersMassesToIntersections);
+tcase_add_test(testCaseOperation, multipleConditioningGivesOneFunctionPerEvent);
+tcase_add_test(testCaseOperation, weightedSumOfNoFunctionIsEmpty);
+tcase_add_test(testCaseOperation, pignisticVectorGivesBetPOfAnyElement);
+tcase_add_test(testCaseOperation, discrepancyIsBasedOnBetP);
+tcase_add_test(testCaseOperation, cacheGivesTheSameValuesAndIsComputedAgain);
+tcase_add_test(testCaseOperation, cachedFunctionIsReadByManyThreads);
+tcase_add_test(testCaseOperation, functionBuiltByHandIsNotFlat);
+tcase_add_test(testCaseOperation, copyIsFlatAndCanBeCleaned);
+tcase_add_test(testCaseOperation, memoryUsageCountsFocalsElementsAndCache);
+return testCaseOperation;
+}
+
+TCase* createUtilityTestCase() {
+TCase* testCaseUtility = tcase_create("Utility");
+tcase_add_test(testCaseUtility, cleanMergesDuplicatesAndRemovesZeros);
+return testCaseUtility;
+}
+
 TCase* createManipulationTestCase() {
 TCase* testCaseManipulation = tcase_create("Manipulation");
 tcase_add_checked_fixture(testCaseManipulation, setup, teardown);
@@ -196,6 +486,8 @@ return testCaseManipulation;
 Suite *createSuite(void) {
 	Suite *suite = suite_create("BeliefFunctions");
 	suite_add_tcase(suite, createManipulationTestCase());
+	suite_add_tcase(suite, createUtilityTestCase());
+	suite_add_tcase(suite, createOperationTestCase());
 
 	return suite;
 }
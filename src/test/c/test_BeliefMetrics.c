@@ -0,0 +1,140 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * test_BeliefMetrics.c
+ */
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "BeliefMetrics.h"
+#include "BeliefsFromSensors.h"
+
+#include "unit_tests.h"
+
+
+BFS_BeliefStructure beliefStructure;
+BF_BeliefFunction *evidences = NULL;
+BF_MetricsTable table;
+
+
+static void setup() {
+    char const *sensorTypes[] = {"S1", "S2"};
+    double sensorMeasures[] = {300.0, 400.0};
+	beliefStructure = BFS_loadBeliefStructure(BELIEF_DEFINITION_PATH, "unittest");
+
+	evidences = BFS_getEvidence(beliefStructure, sensorTypes, sensorMeasures, SENSOR_NB);
+	table = BF_createMetricsTable(evidences[0].elementSize);
+}
+
+static void teardown() {
+	int i;
+	BFS_freeBeliefStructure(&beliefStructure);
+	for(i = 0; i < SENSOR_NB; i++){
+		BF_freeBeliefFunction(&(evidences[i]));
+	}
+	free(evidences);
+	BF_freeMetricsTable(&table);
+}
+
+
+/*
+ * Metrics
+ * =======
+ */
+
+START_TEST(metricsMatchTheSeparateMeasures) {
+	/* evidences[1] : m(AuC) = 0.4, m(C) = 0.4, m(A) = 0.1, m(B) = 0.1, m(AuBuC) = 0 */
+	int i = 0;
+	float* autoConflict = BF_autoConflict(evidences[1], 3);
+	BF_Metrics metrics = BF_getMetrics(evidences[1], table, evidences, SENSOR_NB, 3);
+
+	assert_flt_equals(BF_specificity(evidences[1]), metrics.specificity, BF_PRECISION);
+	assert_flt_equals(BF_nonSpecificity(evidences[1]), metrics.nonSpecificity, BF_PRECISION);
+	assert_flt_equals(BF_discrepancy(evidences[1]), metrics.discrepancy, BF_PRECISION);
+	assert_flt_equals(metrics.nonSpecificity + metrics.discrepancy, metrics.totalUncertainty, BF_PRECISION);
+	assert_flt_equals(BF_globalDistance(evidences[1], evidences, SENSOR_NB), metrics.globalDistance, BF_PRECISION);
+	ck_assert_int_eq(3, metrics.nbAutoConflict);
+	for(i = 0; i < 3; i++){
+		assert_flt_equals(autoConflict[i], metrics.autoConflict[i], BF_PRECISION);
+	}
+
+	free(autoConflict);
+	BF_freeMetrics(&metrics);
+	ck_assert(metrics.autoConflict == NULL);
+}
+END_TEST
+
+START_TEST(metricsGiveDengAndPignisticEntropies) {
+	/*
+	 * evidences[0] : m(A) = 0.75, m(AuB) = 0.15, m(B) = 0.1, m(C) = 0
+	 * Deng: -0.75 log2(0.75) - 0.15 log2(0.15 / 3) - 0.1 log2(0.1)
+	 * BetP: A = 0.825, B = 0.175, C = 0
+	 */
+	float deng = -0.75 * log(0.75) / log(2) - 0.15 * log(0.05) / log(2) - 0.1 * log(0.1) / log(2);
+	float entropy = -0.825 * log(0.825) / log(2) - 0.175 * log(0.175) / log(2);
+	BF_Metrics metrics = BF_getMetrics(evidences[0], table, NULL, 0, 0);
+
+	assert_flt_equals(deng, metrics.dengEntropy, BF_PRECISION);
+	assert_flt_equals(entropy, metrics.pignisticEntropy, BF_PRECISION);
+	assert_flt_equals(0.0f, metrics.globalDistance, BF_PRECISION);
+	ck_assert(metrics.autoConflict == NULL);
+	BF_freeMetrics(&metrics);
+}
+END_TEST
+
+START_TEST(metricsWithATooSmallTableAreComputed) {
+	/* A table for singletons only: the logarithms of the bigger cardinalities are computed */
+	BF_MetricsTable smallTable = BF_createMetricsTable(1);
+	BF_Metrics metrics = BF_getMetrics(evidences[0], smallTable, NULL, 0, 0);
+	BF_Metrics expected = BF_getMetrics(evidences[0], table, NULL, 0, 0);
+
+	assert_flt_equals(expected.nonSpecificity, metrics.nonSpecificity, BF_PRECISION);
+	assert_flt_equals(expected.dengEntropy, metrics.dengEntropy, BF_PRECISION);
+	BF_freeMetrics(&metrics);
+	BF_freeMetrics(&expected);
+	BF_freeMetricsTable(&smallTable);
+}
+END_TEST
+
+
+TCase* createMetricsTestCase() {
+	TCase* testCase = tcase_create("Metrics");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, metricsMatchTheSeparateMeasures);
+	tcase_add_test(testCase, metricsGiveDengAndPignisticEntropies);
+	tcase_add_test(testCase, metricsWithATooSmallTableAreComputed);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("BeliefMetrics");
+	suite_add_tcase(suite, createMetricsTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * test_BeliefsFromBeliefs.c
+ */
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "BeliefsFromBeliefs.h"
+#include "Validation.h"
+
+#include "unit_tests.h"
+
+
+/*
+ * Model data/beliefsFromBeliefs/Sleeping: Posture = {Seated, Standing, LyingDown} -> Sleeping = {yes, no}
+ * Model data/beliefsFromBeliefs/Awake: Sleeping = {yes, no} -> Awake = {awake, asleep}
+ */
+static char YES_VAL[] = {1, 0};
+static char NO_VAL[] = {0, 1};
+static char YESUNO_VAL[] = {1, 1};
+static Sets_Element YES = {YES_VAL, 1};
+static Sets_Element NO = {NO_VAL, 1};
+static Sets_Element YESUNO = {YESUNO_VAL, 2};
+
+BFB_BeliefStructure beliefStructure;
+BFB_BeliefStructure awakeStructure;
+BF_BeliefFunction posture;
+
+
+static void setup() {
+	beliefStructure = BFB_loadBeliefStructure("Sleeping");
+	awakeStructure = BFB_loadBeliefStructure("Awake");
+
+	/* m(Seated) = 0.5, m(LyingDown) = 0.3, m(Seated u Standing u LyingDown) = 0.2 */
+	posture = BF_allocateBeliefFunction(3, ATOM_NB);
+	memcpy(posture.focals[0].element.values, A.values, ATOM_NB);
+	posture.focals[0].element.card = A.card;
+	posture.focals[0].beliefValue = 0.5;
+	memcpy(posture.focals[1].element.values, C.values, ATOM_NB);
+	posture.focals[1].element.card = C.card;
+	posture.focals[1].beliefValue = 0.3;
+	memcpy(posture.focals[2].element.values, AuBuC.values, ATOM_NB);
+	posture.focals[2].element.card = AuBuC.card;
+	posture.focals[2].beliefValue = 0.2;
+}
+
+static void teardown() {
+	BFB_freeBeliefStructure(&beliefStructure);
+	BFB_freeBeliefStructure(&awakeStructure);
+	BF_freeBeliefFunction(&posture);
+}
+
+
+/*
+ * Transformations
+ * ===============
+ */
+
+START_TEST(modelIsCompiledIntoAMatrix) {
+	BFB_Matrix matrix = beliefStructure.beliefs[0].matrix;
+
+	ck_assert_int_eq(1, beliefStructure.nbBeliefs);
+	ck_assert_int_eq(8, matrix.nbRows);
+	ck_assert_int_eq(4, matrix.nbColumns);
+	ck_assert(matrix.dense != NULL);
+	/* One entry for the empty set, then the conversions of the 7 files: */
+	ck_assert_int_eq(1 + 3 + 1 + 2 + 3 + 2 + 1 + 1, matrix.rowStarts[matrix.nbRows]);
+}
+END_TEST
+
+START_TEST(transformIsAMatrixProduct) {
+	/* yes: 0.5 * 0.1 + 0.3 * 0.7, no: 0.5 * 0.7 + 0.3 * 0.1, yes u no: 0.5 * 0.2 + 0.3 * 0.2 + 0.2 */
+	BF_BeliefFunction sleeping = BFB_believeFromBelief(beliefStructure.beliefs[0], posture, beliefStructure.refList.card);
+
+	ck_assert_int_eq(3, sleeping.nbFocals);
+	assert_flt_equals(0.26f, BF_m(sleeping, YES), BF_PRECISION);
+	assert_flt_equals(0.38f, BF_m(sleeping, NO), BF_PRECISION);
+	assert_flt_equals(0.36f, BF_m(sleeping, YESUNO), BF_PRECISION);
+	BF_freeBeliefFunction(&sleeping);
+}
+END_TEST
+
+START_TEST(denseSparseAndVectorsGiveTheSameFunction) {
+	BFB_BeliefFromBelief sparse = beliefStructure.beliefs[0], vectors = beliefStructure.beliefs[0];
+	BF_BeliefFunction dense, fromSparse, fromVectors;
+	Sets_Element* elements[] = {&YES, &NO, &YESUNO};
+	int i = 0;
+
+	sparse.matrix.dense = NULL;
+	vectors.matrix.nbRows = 0;
+	dense = BFB_believeFromBelief(beliefStructure.beliefs[0], posture, beliefStructure.refList.card);
+	fromSparse = BFB_believeFromBelief(sparse, posture, beliefStructure.refList.card);
+	fromVectors = BFB_believeFromBelief(vectors, posture, beliefStructure.refList.card);
+
+	for(i = 0; i < 3; i++){
+		assert_flt_equals(BF_m(dense, *elements[i]), BF_m(fromSparse, *elements[i]), BF_PRECISION);
+		assert_flt_equals(BF_m(dense, *elements[i]), BF_m(fromVectors, *elements[i]), BF_PRECISION);
+	}
+
+	BF_freeBeliefFunction(&dense);
+	BF_freeBeliefFunction(&fromSparse);
+	BF_freeBeliefFunction(&fromVectors);
+}
+END_TEST
+
+START_TEST(framesAreFoundByName) {
+	char const *frameNames[] = {"Unknown", "Posture"};
+	BF_BeliefFunction from[2];
+	BF_BeliefFunction* sleeping = NULL;
+
+	from[0] = posture;
+	from[1] = posture;
+	sleeping = BFB_believeFromBeliefs(beliefStructure, frameNames, from, 2);
+
+	/* No model for the first frame: */
+	ck_assert_int_eq(1, sleeping[0].nbFocals);
+	assert_flt_equals(1.0f, BF_m(sleeping[0], YESUNO), BF_PRECISION);
+	assert_flt_equals(0.26f, BF_m(sleeping[1], YES), BF_PRECISION);
+
+	BF_freeBeliefFunction(&(sleeping[0]));
+	BF_freeBeliefFunction(&(sleeping[1]));
+	free(sleeping);
+}
+END_TEST
+
+START_TEST(chainIsComposedIntoOneModel) {
+	/* awake: 0.38, asleep: 0.26 * 0.9, awake u asleep: 0.26 * 0.1 + 0.36 (same elements as no, yes and yes u no) */
+	BFB_BeliefFromBelief chain[2];
+	BFB_BeliefStructure to[2];
+	BFB_BeliefFromBelief composed;
+	BF_BeliefFunction sleeping, awake, direct;
+	Sets_Element* elements[] = {&YES, &NO, &YESUNO};
+	int i = 0;
+
+	chain[0] = beliefStructure.beliefs[0];
+	chain[1] = awakeStructure.beliefs[0];
+	to[0] = beliefStructure;
+	to[1] = awakeStructure;
+	composed = BFB_composeBeliefsFromBeliefs(chain, to, 2);
+	ck_assert_str_eq("Posture", composed.frameName);
+	ck_assert_int_eq(8, composed.matrix.nbRows);
+	ck_assert_int_eq(4, composed.matrix.nbColumns);
+	ck_assert_int_eq(7, composed.nbVectors);
+
+	sleeping = BFB_believeFromBelief(beliefStructure.beliefs[0], posture, beliefStructure.refList.card);
+	awake = BFB_believeFromBelief(awakeStructure.beliefs[0], sleeping, awakeStructure.refList.card);
+	direct = BFB_believeFromBelief(composed, posture, awakeStructure.refList.card);
+	assert_flt_equals(0.38f, BF_m(direct, YES), BF_PRECISION);
+	assert_flt_equals(0.234f, BF_m(direct, NO), BF_PRECISION);
+	assert_flt_equals(0.386f, BF_m(direct, YESUNO), BF_PRECISION);
+	for(i = 0; i < 3; i++){
+		assert_flt_equals(BF_m(awake, *elements[i]), BF_m(direct, *elements[i]), BF_PRECISION);
+	}
+
+	BF_freeBeliefFunction(&sleeping);
+	BF_freeBeliefFunction(&awake);
+	BF_freeBeliefFunction(&direct);
+	BFB_freeBeliefFromBelief(&composed);
+}
+END_TEST
+
+START_TEST(chainOfUnrelatedFramesIsNotComposed) {
+	BFB_BeliefFromBelief chain[2];
+	BFB_BeliefStructure to[2];
+	BFB_BeliefFromBelief composed;
+
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_COUNT);
+	THEGAME_resetValidationErrors();
+	chain[0] = beliefStructure.beliefs[0];
+	chain[1] = beliefStructure.beliefs[0];
+	to[0] = beliefStructure;
+	to[1] = beliefStructure;
+	composed = BFB_composeBeliefsFromBeliefs(chain, to, 2);
+	ck_assert(composed.frameName == NULL);
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_COMPATIBILITY) == 1);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_OFF);
+}
+END_TEST
+
+START_TEST(chainOfDifferentFramesOfTheSameSizeIsNotComposed) {
+	/* Sleeping -> Awake twice: the matrices have the same size, but the second model does not come from Awake */
+	BFB_BeliefFromBelief chain[2];
+	BFB_BeliefStructure to[2];
+	BFB_BeliefFromBelief composed;
+
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_COUNT);
+	THEGAME_resetValidationErrors();
+	chain[0] = awakeStructure.beliefs[0];
+	chain[1] = awakeStructure.beliefs[0];
+	to[0] = awakeStructure;
+	to[1] = awakeStructure;
+	ck_assert_int_eq(chain[0].matrix.nbColumns, chain[1].matrix.nbRows);
+	composed = BFB_composeBeliefsFromBeliefs(chain, to, 2);
+	ck_assert(composed.frameName == NULL);
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_COMPATIBILITY) == 1);
+
+	/* Nor a model given with a structure it does not go to: */
+	THEGAME_resetValidationErrors();
+	chain[0] = beliefStructure.beliefs[0];
+	chain[1] = awakeStructure.beliefs[0];
+	to[0] = awakeStructure;
+	to[1] = awakeStructure;
+	composed = BFB_composeBeliefsFromBeliefs(chain, to, 2);
+	ck_assert(composed.frameName == NULL);
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_COMPATIBILITY) == 1);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_OFF);
+}
+END_TEST
+
+
+/*
+ * Batches
+ * =======
+ */
+
+START_TEST(batchGivesTheSameFunctionsAsSingleCalls) {
+	BF_BeliefFunction from[7];
+	BF_BeliefFunction* batch = NULL;
+	BF_BeliefFunction single;
+	Sets_Element* elements[] = {&YES, &NO, &YESUNO};
+	int i = 0, j = 0;
+
+	for(i = 0; i < 7; i++){
+		from[i] = BF_discounting(posture, i / 10.0);
+	}
+	batch = BFB_believeFromBeliefBatch(beliefStructure.beliefs[0], from, 7, beliefStructure.refList.card, 3);
+
+	for(i = 0; i < 7; i++){
+		single = BFB_believeFromBelief(beliefStructure.beliefs[0], from[i], beliefStructure.refList.card);
+		for(j = 0; j < 3; j++){
+			assert_flt_equals(BF_m(single, *elements[j]), BF_m(batch[i], *elements[j]), BF_PRECISION);
+		}
+		BF_freeBeliefFunction(&single);
+		BF_freeBeliefFunction(&(batch[i]));
+		BF_freeBeliefFunction(&(from[i]));
+	}
+	free(batch);
+}
+END_TEST
+
+START_TEST(denseMassesAreTransformedTogether) {
+	/* Two entities: posture, and m(Standing) = 1 (index 2) */
+	BFB_Matrix matrix = beliefStructure.beliefs[0].matrix;
+	float masses[8 * 2] = {0};
+	float results[4 * 2];
+	int i = 0;
+
+	masses[1 * 2 + 0] = 0.5;
+	masses[4 * 2 + 0] = 0.3;
+	masses[7 * 2 + 0] = 0.2;
+	masses[2 * 2 + 1] = 1;
+	for(i = 0; i < 4 * 2; i++){
+		results[i] = -1;
+	}
+	BFB_transformMasses(matrix, masses, results, 2, 2);
+
+	assert_flt_equals(0.0f, results[0 * 2 + 0], BF_PRECISION);
+	assert_flt_equals(0.26f, results[1 * 2 + 0], BF_PRECISION);
+	assert_flt_equals(0.38f, results[2 * 2 + 0], BF_PRECISION);
+	assert_flt_equals(0.36f, results[3 * 2 + 0], BF_PRECISION);
+	assert_flt_equals(0.0f, results[1 * 2 + 1], BF_PRECISION);
+	assert_flt_equals(1.0f, results[2 * 2 + 1], BF_PRECISION);
+	assert_flt_equals(0.0f, results[3 * 2 + 1], BF_PRECISION);
+}
+END_TEST
+
+START_TEST(uncompiledMatrixIsReported) {
+	BFB_Matrix empty = {0, 0, NULL, NULL, NULL, NULL};
+	float masses[2] = {0, 1};
+	float results[2] = {-1, -1};
+
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_COUNT);
+	THEGAME_resetValidationErrors();
+	BFB_transformMasses(empty, masses, results, 1, 1);
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_COMPATIBILITY) == 1);
+	assert_flt_equals(-1.0f, results[0], 0);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_OFF);
+}
+END_TEST
+
+START_TEST(memoryUsageCountsVectorsAndMatrices) {
+	BFB_MemoryUsage usage = BFB_memoryUsage(beliefStructure);
+	BFB_MemoryUsage model = BFB_beliefFromBeliefMemoryUsage(beliefStructure.beliefs[0], beliefStructure.refList.card);
+
+	/* 8 rows, 14 entries and the dense 8 x 4 matrix: */
+	ck_assert(model.matrices == sizeof(int) * 9 + (sizeof(int) + sizeof(float)) * 14 + sizeof(float) * 8 * 4);
+	ck_assert(model.vectors > 0);
+	ck_assert(model.total == model.names + model.refLists + model.vectors + model.matrices);
+	/* The structure adds its name, its reference list and the array of models: */
+	ck_assert(usage.matrices == model.matrices);
+	ck_assert(usage.vectors == model.vectors + sizeof(BFB_BeliefFromBelief));
+	ck_assert(usage.total == model.total + strlen("Sleeping") + 1
+			+ Sets_referenceListMemoryUsage(beliefStructure.refList) + sizeof(BFB_BeliefFromBelief));
+}
+END_TEST
+
+
+TCase* createTransformationTestCase() {
+	TCase* testCase = tcase_create("Transformation");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, modelIsCompiledIntoAMatrix);
+	tcase_add_test(testCase, transformIsAMatrixProduct);
+	tcase_add_test(testCase, denseSparseAndVectorsGiveTheSameFunction);
+	tcase_add_test(testCase, framesAreFoundByName);
+	tcase_add_test(testCase, chainIsComposedIntoOneModel);
+	tcase_add_test(testCase, chainOfUnrelatedFramesIsNotComposed);
+	tcase_add_test(testCase, chainOfDifferentFramesOfTheSameSizeIsNotComposed);
+	tcase_add_test(testCase, memoryUsageCountsVectorsAndMatrices);
+	return testCase;
+}
+
+TCase* createBatchTestCase() {
+	TCase* testCase = tcase_create("Batch");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, batchGivesTheSameFunctionsAsSingleCalls);
+	tcase_add_test(testCase, denseMassesAreTransformedTogether);
+	tcase_add_test(testCase, uncompiledMatrixIsReported);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("BeliefsFromBeliefs");
+	suite_add_tcase(suite, createTransformationTestCase());
+	suite_add_tcase(suite, createBatchTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * test_BeliefsFromRandomness.c
+ */
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "BeliefsFromRandomness.h"
+
+#include "unit_tests.h"
+
+
+#define RANDOM_SIZE 10
+#define RANDOM_NB_FOCALS 50
+
+
+/**
+ * Checks that a function is normalized, without empty or duplicated focal elements.
+ */
+static void assertValid(const BF_BeliefFunction bf){
+	float sum = 0;
+	int i = 0, j = 0;
+
+	ck_assert(bf.focals != NULL);
+	for(i = 0; i < bf.nbFocals; i++){
+		ck_assert(bf.focals[i].element.card > 0);
+		ck_assert(bf.focals[i].beliefValue >= 0);
+		sum += bf.focals[i].beliefValue;
+		for(j = 0; j < i; j++){
+			ck_assert(!Sets_equals(bf.focals[i].element, bf.focals[j].element, bf.elementSize));
+		}
+	}
+	assert_flt_equals(1.0f, sum, BF_PRECISION);
+}
+
+
+/*
+ * Generator
+ * =========
+ */
+
+START_TEST(sameSeedGivesSameNumbers) {
+	BFR_Random first = BFR_createRandom(42), second = BFR_createRandom(42), other = BFR_createRandom(43);
+	int i = 0, nbDifferent = 0;
+
+	for(i = 0; i < 100; i++){
+		ck_assert(BFR_next(&first) == BFR_next(&second));
+		nbDifferent += BFR_next(&second) != BFR_next(&other);
+		BFR_next(&first);
+	}
+	ck_assert_int_eq(100, nbDifferent);
+}
+END_TEST
+
+START_TEST(jumpGivesAnotherSequence) {
+	BFR_Random first = BFR_createRandom(42), second = BFR_createRandom(42);
+	int i = 0, nbDifferent = 0;
+
+	BFR_jump(&second);
+	for(i = 0; i < 100; i++){
+		nbDifferent += BFR_next(&first) != BFR_next(&second);
+	}
+	ck_assert_int_eq(100, nbDifferent);
+}
+END_TEST
+
+START_TEST(uniformNumbersAreInRange) {
+	BFR_Random random = BFR_createRandom(7);
+	double u = 0, sum = 0;
+	int i = 0, counts[3] = {0, 0, 0};
+
+	for(i = 0; i < 30000; i++){
+		u = BFR_uniform(&random);
+		ck_assert(u >= 0 && u < 1);
+		sum += u;
+		counts[BFR_uniformInteger(&random, 3)]++;
+	}
+	assert_flt_equals(0.5f, sum / 30000, 0.01f);
+	for(i = 0; i < 3; i++){
+		ck_assert(counts[i] > 9500 && counts[i] < 10500);
+	}
+}
+END_TEST
+
+START_TEST(gammaHasTheRightMean) {
+	BFR_Random random = BFR_createRandom(7);
+	double shapes[] = {0.2, 1, 4.5};
+	double sum = 0;
+	int i = 0, s = 0;
+
+	/* The mean of Gamma(a, 1) is a: */
+	for(s = 0; s < 3; s++){
+		sum = 0;
+		for(i = 0; i < 20000; i++){
+			sum += BFR_gamma(&random, shapes[s]);
+		}
+		assert_flt_equals(shapes[s], sum / 20000, 0.05f * (shapes[s] > 1 ? shapes[s] : 1));
+	}
+}
+END_TEST
+
+
+/*
+ * Distributions
+ * =============
+ */
+
+START_TEST(randomBeliefIsReproducible) {
+	BFR_Random first = BFR_createRandom(42), second = BFR_createRandom(42);
+	BF_BeliefFunction a = BFR_getRandomBelief(&first, RANDOM_SIZE, RANDOM_NB_FOCALS, 1);
+	BF_BeliefFunction b = BFR_getRandomBelief(&second, RANDOM_SIZE, RANDOM_NB_FOCALS, 1);
+	int i = 0;
+
+	ck_assert_int_eq(RANDOM_NB_FOCALS, a.nbFocals);
+	ck_assert_int_eq(RANDOM_SIZE, a.elementSize);
+	ck_assert(BF_isFlat(a));
+	assertValid(a);
+	ck_assert_int_eq(a.nbFocals, b.nbFocals);
+	for(i = 0; i < a.nbFocals; i++){
+		ck_assert(Sets_equals(a.focals[i].element, b.focals[i].element, RANDOM_SIZE));
+		ck_assert(a.focals[i].beliefValue == b.focals[i].beliefValue);
+	}
+
+	BF_freeBeliefFunction(&a);
+	BF_freeBeliefFunction(&b);
+}
+END_TEST
+
+START_TEST(randomBeliefCanTakeAllSubsets) {
+	BFR_Random random = BFR_createRandom(1);
+	BF_BeliefFunction bf = BFR_getRandomBelief(&random, 4, 15, 0.5);
+	BF_BeliefFunction tooMany = BFR_getRandomBelief(&random, 4, 16, 0.5);
+
+	ck_assert_int_eq(15, bf.nbFocals);
+	assertValid(bf);
+	ck_assert(tooMany.focals == NULL);
+
+	BF_freeBeliefFunction(&bf);
+}
+END_TEST
+
+START_TEST(bayesianBeliefHasSingletons) {
+	BFR_Random random = BFR_createRandom(3);
+	BF_BeliefFunction bf = BFR_getRandomBayesianBelief(&random, RANDOM_SIZE, RANDOM_SIZE, 1);
+	int i = 0;
+
+	ck_assert_int_eq(RANDOM_SIZE, bf.nbFocals);
+	assertValid(bf);
+	for(i = 0; i < bf.nbFocals; i++){
+		ck_assert_int_eq(1, bf.focals[i].element.card);
+	}
+
+	BF_freeBeliefFunction(&bf);
+}
+END_TEST
+
+START_TEST(consonantBeliefIsNested) {
+	BFR_Random random = BFR_createRandom(5);
+	BF_BeliefFunction bf = BFR_getRandomConsonantBelief(&random, RANDOM_SIZE, 6, 1);
+	int i = 0;
+
+	ck_assert_int_eq(6, bf.nbFocals);
+	assertValid(bf);
+	for(i = 1; i < bf.nbFocals; i++){
+		ck_assert(bf.focals[i - 1].element.card < bf.focals[i].element.card);
+		ck_assert(Sets_isSubset(bf.focals[i - 1].element, bf.focals[i].element, RANDOM_SIZE));
+	}
+
+	BF_freeBeliefFunction(&bf);
+}
+END_TEST
+
+START_TEST(simpleSupportBeliefHasTheCompleteSet) {
+	BFR_Random random = BFR_createRandom(9);
+	BF_BeliefFunction bf = BFR_getRandomSimpleSupportBelief(&random, RANDOM_SIZE);
+
+	ck_assert_int_eq(2, bf.nbFocals);
+	assertValid(bf);
+	ck_assert(bf.focals[0].element.card < RANDOM_SIZE);
+	ck_assert_int_eq(RANDOM_SIZE, bf.focals[1].element.card);
+
+	BF_freeBeliefFunction(&bf);
+}
+END_TEST
+
+START_TEST(profileGivesTheCardinalities) {
+	BFR_Random random = BFR_createRandom(11);
+	double profile[RANDOM_SIZE] = {0, 3, 0, 0, 0, 0, 0, 0, 0, 1};
+	BF_BeliefFunction bf = BFR_getRandomBeliefWithProfile(&random, RANDOM_SIZE, 20, profile, 1);
+	int i = 0;
+
+	ck_assert_int_eq(20, bf.nbFocals);
+	assertValid(bf);
+	for(i = 0; i < bf.nbFocals; i++){
+		ck_assert(bf.focals[i].element.card == 2 || bf.focals[i].element.card == RANDOM_SIZE);
+	}
+
+	BF_freeBeliefFunction(&bf);
+}
+END_TEST
+
+
+TCase* createGeneratorTestCase() {
+	TCase* testCase = tcase_create("Generator");
+	tcase_add_test(testCase, sameSeedGivesSameNumbers);
+	tcase_add_test(testCase, jumpGivesAnotherSequence);
+	tcase_add_test(testCase, uniformNumbersAreInRange);
+	tcase_add_test(testCase, gammaHasTheRightMean);
+	return testCase;
+}
+
+TCase* createDistributionsTestCase() {
+	TCase* testCase = tcase_create("Distributions");
+	tcase_add_test(testCase, randomBeliefIsReproducible);
+	tcase_add_test(testCase, randomBeliefCanTakeAllSubsets);
+	tcase_add_test(testCase, bayesianBeliefHasSingletons);
+	tcase_add_test(testCase, consonantBeliefIsNested);
+	tcase_add_test(testCase, simpleSupportBeliefHasTheCompleteSet);
+	tcase_add_test(testCase, profileGivesTheCardinalities);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("BeliefsFromRandomness");
+	suite_add_tcase(suite, createGeneratorTestCase());
+	suite_add_tcase(suite, createDistributionsTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * test_Memory.c
+ */
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "Memory.h"
+#include "BeliefCombinations.h"
+#include "BeliefsFromSensors.h"
+
+#include "unit_tests.h"
+
+
+/*
+ * Arenas
+ * ======
+ */
+
+START_TEST(arenaHoldsTheTemporariesOfTheLibrary) {
+	Memory_Arena arena = Memory_createArena(1 << 16);
+	BF_BeliefFunction vacuous, discounted, combined;
+
+	Memory_pushAllocator(Memory_getArenaAllocator(&arena));
+	ck_assert(!Memory_isDefaultAllocator());
+
+	vacuous = BF_getVacuousBeliefFunction(ATOM_NB);
+	discounted = BF_discounting(vacuous, 0.5);
+	combined = BF_SmetsCombination(vacuous, discounted);
+	ck_assert_int_eq(1, combined.nbFocals);
+	assert_flt_equals(1.0f, combined.focals[0].beliefValue, BF_PRECISION);
+	ck_assert(arena.used > 0);
+	ck_assert(arena.peak >= arena.used);
+
+	/* Everything is released at once: */
+	Memory_resetArena(&arena);
+	ck_assert(arena.used == 0);
+	ck_assert(arena.peak > 0);
+
+	Memory_popAllocator();
+	ck_assert(Memory_isDefaultAllocator());
+	Memory_freeArena(&arena);
+}
+END_TEST
+
+START_TEST(arenaFromBufferFailsWhenFull) {
+	static char buffer[256];
+	Memory_Arena arena = Memory_createArenaFromBuffer(buffer, sizeof(buffer));
+	Memory_Allocator allocator = Memory_getArenaAllocator(&arena);
+	char *first = NULL, *second = NULL, *grown = NULL;
+
+	first = allocator.mallocFunction(96, allocator.data);
+	second = allocator.mallocFunction(96, allocator.data);
+	ck_assert(first != NULL);
+	ck_assert(second != NULL);
+	ck_assert(((size_t)first) % MEMORY_ARENA_ALIGNMENT == 0);
+	ck_assert(allocator.mallocFunction(96, allocator.data) == NULL);
+
+	/* The last block is reallocated and freed in place: */
+	grown = allocator.reallocFunction(second, 100, allocator.data);
+	ck_assert(grown == second);
+	allocator.freeFunction(second, allocator.data);
+	ck_assert(allocator.mallocFunction(96, allocator.data) == second);
+
+	Memory_freeArena(&arena);
+}
+END_TEST
+
+START_TEST(pooledBlocksGoBackToTheirAllocator) {
+	Memory_Arena arena = Memory_createArena(1 << 16);
+	BF_BeliefFunction fromArena, fromDefault;
+
+	/* A block of the arena freed after the default allocator is back: */
+	Memory_pushAllocator(Memory_getArenaAllocator(&arena));
+	fromArena = BF_getVacuousBeliefFunction(ATOM_NB);
+	Memory_popAllocator();
+	fromDefault = BF_getVacuousBeliefFunction(ATOM_NB);
+	BF_freeBeliefFunction(&fromArena);
+	ck_assert(arena.used == 0);
+
+	/* A pooled block cleared while the arena is pushed: */
+	BF_freeBeliefFunction(&fromDefault);
+	Memory_pushAllocator(Memory_getArenaAllocator(&arena));
+	BF_clearPool();
+	Memory_popAllocator();
+	Memory_freeArena(&arena);
+}
+END_TEST
+
+
+START_TEST(cacheStaysWithTheAllocatorOfTheFunction) {
+	Memory_Arena arena = Memory_createArena(1 << 16);
+	BF_BeliefFunction vacuous = BF_getVacuousBeliefFunction(ATOM_NB);
+	BF_BeliefFunction copy = BF_copyBeliefFunction(vacuous);
+
+	/* Enabled in the scope of the arena, the cache is allocated as the function: */
+	Memory_pushAllocator(Memory_getArenaAllocator(&arena));
+	BF_enableCache(&copy);
+	ck_assert(arena.used == 0);
+	Memory_popAllocator();
+
+	BF_freeBeliefFunction(&copy);
+	BF_freeBeliefFunction(&vacuous);
+	Memory_freeArena(&arena);
+}
+END_TEST
+
+START_TEST(pushedAllocatorsAreNested) {
+	Memory_Arena outer = Memory_createArena(1 << 12), inner = Memory_createArena(1 << 12);
+	char* pointer = NULL;
+
+	Memory_pushAllocator(Memory_getArenaAllocator(&outer));
+	Memory_pushAllocator(Memory_getArenaAllocator(&inner));
+	pointer = Memory_malloc(16);
+	ck_assert(pointer != NULL && inner.used > 0 && outer.used == 0);
+	Memory_popAllocator();
+	pointer = Memory_malloc(16);
+	ck_assert(pointer != NULL && outer.used > 0);
+	Memory_popAllocator();
+	ck_assert(Memory_isDefaultAllocator());
+
+	Memory_freeArena(&inner);
+	Memory_freeArena(&outer);
+}
+END_TEST
+
+/*
+ * Gets the evidence of the sensors with a temporization of the unit test structure.
+ */
+static BF_BeliefFunction* getTemporizedEvidence(const BFS_BeliefStructure bs, const double measure){
+	const char* const sensorTypes[] = {"S3", "S4"};
+	const double sensorMeasures[] = {measure, measure};
+
+	return BFS_getEvidenceElapsedTime(bs, sensorTypes, sensorMeasures, 2, 0.5);
+}
+
+START_TEST(temporizationStateSurvivesArenaResets) {
+	Memory_Arena arena = Memory_createArena(1 << 16);
+	BFS_BeliefStructure inArena = BFS_loadBeliefStructure(BELIEF_DEFINITION_PATH, STRUCTURE_NAME);
+	BFS_BeliefStructure reference = BFS_loadBeliefStructure(BELIEF_DEFINITION_PATH, STRUCTURE_NAME);
+	const char* const sensorTypes[] = {"S3", "S4"};
+	const double sensorMeasures[] = {100, 100};
+	const double measures[] = {100, 300, NO_MEASURE, 200};
+	BF_BeliefFunction *evidence = NULL, *expected = NULL;
+	int tick = 0, i = 0, j = 0;
+
+	/* Each tick in the arena, reset after it, the state of the temporization being kept by the structure: */
+	for(tick = 0; tick < 4; tick++){
+		expected = getTemporizedEvidence(reference, measures[tick]);
+		Memory_pushAllocator(Memory_getArenaAllocator(&arena));
+		evidence = getTemporizedEvidence(inArena, measures[tick]);
+		for(i = 0; i < 2; i++){
+			for(j = 0; j < (1 << ATOM_NB); j++){
+				assert_flt_equals(BF_m(expected[i], inArena.powerset.elements[j]),
+						BF_m(evidence[i], inArena.powerset.elements[j]), BF_PRECISION);
+			}
+		}
+		Memory_resetArena(&arena);
+		Memory_popAllocator();
+		for(i = 0; i < 2; i++){
+			BF_freeBeliefFunction(&(expected[i]));
+		}
+		Memory_free(expected);
+	}
+
+	/* With the real time too: */
+	Memory_pushAllocator(Memory_getArenaAllocator(&arena));
+	evidence = BFS_getEvidence(inArena, sensorTypes, sensorMeasures, 2);
+	ck_assert_int_eq(ATOM_NB, evidence[1].elementSize);
+	Memory_resetArena(&arena);
+	Memory_popAllocator();
+
+	BFS_freeBeliefStructure(&inArena);
+	BFS_freeBeliefStructure(&reference);
+	Memory_freeArena(&arena);
+}
+END_TEST
+
+
+TCase* createArenaTestCase() {
+	TCase* testCase = tcase_create("Arena");
+	tcase_add_test(testCase, arenaHoldsTheTemporariesOfTheLibrary);
+	tcase_add_test(testCase, arenaFromBufferFailsWhenFull);
+	tcase_add_test(testCase, pooledBlocksGoBackToTheirAllocator);
+	tcase_add_test(testCase, cacheStaysWithTheAllocatorOfTheFunction);
+	tcase_add_test(testCase, pushedAllocatorsAreNested);
+	tcase_add_test(testCase, temporizationStateSurvivesArenaResets);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("Memory");
+	suite_add_tcase(suite, createArenaTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
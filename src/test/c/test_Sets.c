@@ -58,6 +58,17 @@ START_TEST(testDisjunction2) {
 }
 END_TEST
 
+START_TEST(testCompare) {
+	/*
+	 * The order is the one of the numbers of the elements: A(1) < B(2) < AuB(3) < C(4)
+	 */
+	ck_assert(Sets_compare(A, B, ATOM_NB) < 0);
+	ck_assert(Sets_compare(AuB, B, ATOM_NB) > 0);
+	ck_assert(Sets_compare(AuB, C, ATOM_NB) < 0);
+	ck_assert_int_eq(0, Sets_compare(AuC, AuC, ATOM_NB));
+}
+END_TEST
+
 Suite *createSuite(void) {
 	Suite *suite = suite_create("Sets");
 
@@ -67,6 +78,7 @@ Suite *createSuite(void) {
 	TCase* testCaseManipulation = tcase_create("Manipulation");
 	tcase_add_test(testCaseManipulation, testDisjunction1);
 	tcase_add_test(testCaseManipulation, testDisjunction2);
+	tcase_add_test(testCaseManipulation, testCompare);
 
 
 	suite_add_tcase(suite, testCaseCreation);
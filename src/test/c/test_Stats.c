@@ -0,0 +1,160 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * test_Stats.c
+ */
+
+#include <check.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "Stats.h"
+#include "BeliefCombinations.h"
+#include "BeliefDecisions.h"
+#include "BeliefsFromRandomness.h"
+
+#include "unit_tests.h"
+
+
+BF_BeliefFunction m1, m2;
+
+
+static void setup() {
+	BFR_Random random = BFR_createRandom(42);
+
+	m1 = BFR_getRandomBelief(&random, ATOM_NB, 4, 1);
+	m2 = BFR_getRandomBelief(&random, ATOM_NB, 3, 1);
+}
+
+static void teardown() {
+	BF_freeBeliefFunction(&m1);
+	BF_freeBeliefFunction(&m2);
+}
+
+/**
+ * Checks that all the counters are null.
+ */
+static void assertNullStats(const THEGAME_Stats stats){
+	ck_assert(stats.nbAllocations == 0);
+	ck_assert(stats.nbAllocatedBytes == 0);
+	ck_assert(stats.nbSetOperations == 0);
+	ck_assert(stats.nbCombinations == 0);
+	ck_assert(stats.nbCombinationProducts == 0);
+	ck_assert(stats.nbCombinedFocals == 0);
+	ck_assert(stats.nbMassLookups == 0);
+	ck_assert(stats.nbPowersetScans == 0);
+	ck_assert(stats.nbScannedSubsets == 0);
+}
+
+static void* combineInThread(__attribute__((unused)) void* data){
+	BF_BeliefFunction combined = BF_SmetsCombination(m1, m2);
+
+	BF_freeBeliefFunction(&combined);
+	BF_clearPool();
+
+	return NULL;
+}
+
+
+/*
+ * Counters
+ * ========
+ */
+
+START_TEST(countersFollowTheOperations) {
+	Sets_Set powerset = Sets_generatePowerSet(ATOM_NB);
+	Sets_Element empty = Sets_getEmptyElement(ATOM_NB);
+	BF_BeliefFunction combined = {NULL, 0, 0};
+	BF_FocalElement max;
+	THEGAME_Stats stats;
+
+	THEGAME_resetStats();
+	combined = BF_SmetsCombination(m1, m2);
+	BF_m(combined, empty);
+	max = BF_getMaxBel(combined, 1, powerset);
+	stats = THEGAME_getStats();
+
+	if(THEGAME_isStatsEnabled()){
+		ck_assert(stats.nbAllocations > 0);
+		ck_assert(stats.nbAllocatedBytes > 0);
+		ck_assert(stats.nbSetOperations > 0);
+		ck_assert(stats.nbCombinations == 1);
+		ck_assert(stats.nbCombinationProducts == 12);
+		ck_assert(stats.nbCombinedFocals == (unsigned long)combined.nbFocals);
+		ck_assert(stats.nbMassLookups == 1);
+		ck_assert(stats.nbPowersetScans >= 1);
+		ck_assert(stats.nbScannedSubsets >= (unsigned long)powerset.card);
+	}
+	else {
+		assertNullStats(stats);
+	}
+
+	Sets_freeElement(&(max.element));
+	Sets_freeElement(&empty);
+	Sets_freeSet(&powerset);
+	BF_freeBeliefFunction(&combined);
+}
+END_TEST
+
+START_TEST(resetClearsTheCounters) {
+	BF_BeliefFunction combined = BF_SmetsCombination(m1, m2);
+
+	BF_freeBeliefFunction(&combined);
+	THEGAME_resetStats();
+	assertNullStats(THEGAME_getStats());
+}
+END_TEST
+
+START_TEST(countersArePerThread) {
+	pthread_t thread;
+
+	THEGAME_resetStats();
+	ck_assert_int_eq(0, pthread_create(&thread, NULL, combineInThread, NULL));
+	ck_assert_int_eq(0, pthread_join(thread, NULL));
+	/* The combination of the other thread is not counted here: */
+	ck_assert(THEGAME_getStats().nbCombinations == 0);
+}
+END_TEST
+
+
+TCase* createCountersTestCase() {
+	TCase* testCase = tcase_create("Counters");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, countersFollowTheOperations);
+	tcase_add_test(testCase, resetClearsTheCounters);
+	tcase_add_test(testCase, countersArePerThread);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("Stats");
+	suite_add_tcase(suite, createCountersTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * test_Trace.c
+ */
+
+#include <check.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Trace.h"
+#include "BeliefCombinations.h"
+#include "BeliefDecisions.h"
+#include "BeliefsFromRandomness.h"
+
+#include "unit_tests.h"
+
+
+BF_BeliefFunction m1, m2;
+
+
+static void setup() {
+	BFR_Random random = BFR_createRandom(42);
+
+	m1 = BFR_getRandomBelief(&random, ATOM_NB, 4, 1);
+	m2 = BFR_getRandomBelief(&random, ATOM_NB, 3, 1);
+	THEGAME_resetTrace();
+}
+
+static void teardown() {
+	BF_freeBeliefFunction(&m1);
+	BF_freeBeliefFunction(&m2);
+}
+
+static void* combineInThread(__attribute__((unused)) void* data){
+	BF_BeliefFunction combined = BF_SmetsCombination(m1, m2);
+
+	BF_freeBeliefFunction(&combined);
+	BF_clearPool();
+
+	return NULL;
+}
+
+
+/*
+ * Hooks
+ * =====
+ */
+
+START_TEST(entryPointsAreTraced) {
+	Sets_Set powerset = Sets_generatePowerSet(ATOM_NB);
+	BF_BeliefFunction combined = BF_DempsterCombination(m1, m2);
+	BF_FocalElement max = BF_getMax(BF_bel, combined, 1, powerset);
+	THEGAME_TraceEvent events[4];
+	int nbEvents = THEGAME_getTraceEvents(events, 4);
+
+	if(THEGAME_isTraceEnabled()){
+		ck_assert_int_eq(3, nbEvents);
+		/* The nested Smets combination is not counted twice: */
+		ck_assert(THEGAME_getLatencies(THEGAME_TRACE_COMBINATION)->count == 1);
+		ck_assert(THEGAME_getLatencies(THEGAME_TRACE_DECISION)->count == 1);
+		ck_assert(THEGAME_getLatencies(THEGAME_TRACE_EVIDENCE)->count == 0);
+		/* The Smets combination is nested in the Dempster one: */
+		ck_assert_str_eq("BF_SmetsCombination", events[0].name);
+		ck_assert_str_eq("BF_DempsterCombination", events[1].name);
+		ck_assert_str_eq("BF_getMax", events[2].name);
+		ck_assert(events[1].start <= events[0].start);
+		ck_assert(events[0].start + events[0].duration <= events[1].start + events[1].duration);
+		ck_assert(events[2].stage == THEGAME_TRACE_DECISION);
+	}
+	else {
+		ck_assert_int_eq(0, nbEvents);
+		ck_assert(THEGAME_getLatencies(THEGAME_TRACE_COMBINATION)->count == 0);
+	}
+
+	Sets_freeElement(&(max.element));
+	Sets_freeSet(&powerset);
+	BF_freeBeliefFunction(&combined);
+}
+END_TEST
+
+START_TEST(oldDecisionsAreTraced) {
+	Sets_Set powerset = Sets_generatePowerSet(ATOM_NB);
+	BF_FocalElement max = BF_getMaxBetP(m1, 1, powerset);
+	BF_FocalElement* list = BF_getListMaxBel(m1, 0, powerset);
+	int nbMax = 0, i = 0;
+
+	if(THEGAME_isTraceEnabled()){
+		/* BF_getListMaxBel() calling BF_getMaxBel() is one decision: */
+		ck_assert(THEGAME_getLatencies(THEGAME_TRACE_DECISION)->count == 2);
+	}
+	else {
+		ck_assert(THEGAME_getLatencies(THEGAME_TRACE_DECISION)->count == 0);
+	}
+
+	nbMax = BF_getNbMaxBel(m1, 0, powerset);
+	for(i = 0; i < nbMax; i++){
+		BF_freeBeliefPoint(&(list[i]));
+	}
+	free(list);
+	BF_freeBeliefPoint(&max);
+	Sets_freeSet(&powerset);
+}
+END_TEST
+
+START_TEST(resetEmptiesTheTrace) {
+	BF_BeliefFunction combined = BF_SmetsCombination(m1, m2);
+	THEGAME_TraceEvent event;
+
+	BF_freeBeliefFunction(&combined);
+	THEGAME_resetTrace();
+	ck_assert_int_eq(0, THEGAME_getTraceEvents(&event, 1));
+	ck_assert(THEGAME_getLatencies(THEGAME_TRACE_COMBINATION)->count == 0);
+}
+END_TEST
+
+START_TEST(traceIsPerThread) {
+	pthread_t thread;
+
+	ck_assert_int_eq(0, pthread_create(&thread, NULL, combineInThread, NULL));
+	ck_assert_int_eq(0, pthread_join(thread, NULL));
+	/* The combination of the other thread is not traced here: */
+	ck_assert(THEGAME_getLatencies(THEGAME_TRACE_COMBINATION)->count == 0);
+}
+END_TEST
+
+START_TEST(endedThreadsArePublished) {
+	static THEGAME_Histogram histogram;
+	BF_BeliefFunction combined;
+	pthread_t thread;
+
+	THEGAME_resetProcessLatencies();
+	ck_assert_int_eq(0, pthread_create(&thread, NULL, combineInThread, NULL));
+	ck_assert_int_eq(0, pthread_join(thread, NULL));
+	combined = BF_SmetsCombination(m1, m2);
+	THEGAME_getProcessLatencies(THEGAME_TRACE_COMBINATION, &histogram);
+	/* The combination of the ended thread and the one of this thread: */
+	ck_assert(histogram.count == (THEGAME_isTraceEnabled() ? 2u : 0u));
+
+	THEGAME_publishLatencies();
+	ck_assert(THEGAME_getLatencies(THEGAME_TRACE_COMBINATION)->count == 0);
+	THEGAME_getProcessLatencies(THEGAME_TRACE_COMBINATION, &histogram);
+	ck_assert(histogram.count == (THEGAME_isTraceEnabled() ? 2u : 0u));
+
+	THEGAME_resetProcessLatencies();
+	THEGAME_getProcessLatencies(THEGAME_TRACE_COMBINATION, &histogram);
+	ck_assert(histogram.count == 0);
+	BF_freeBeliefFunction(&combined);
+}
+END_TEST
+
+START_TEST(chromeTraceIsWritten) {
+	BF_BeliefFunction combined = BF_SmetsCombination(m1, m2);
+	FILE* file = tmpfile();
+	char buffer[1024] = "";
+	size_t length = 0;
+	int nbWritten = 0;
+
+	ck_assert(file != NULL);
+	nbWritten = THEGAME_writeChromeTrace(file);
+	rewind(file);
+	length = fread(buffer, 1, sizeof(buffer) - 1, file);
+	buffer[length] = '\0';
+	fclose(file);
+
+	ck_assert(strncmp("{\"traceEvents\":[", buffer, 16) == 0);
+	if(THEGAME_isTraceEnabled()){
+		ck_assert_int_eq(1, nbWritten);
+		ck_assert(strstr(buffer, "\"name\":\"BF_SmetsCombination\",\"cat\":\"combination\",\"ph\":\"X\"") != NULL);
+	}
+	else {
+		ck_assert_int_eq(0, nbWritten);
+	}
+	BF_freeBeliefFunction(&combined);
+}
+END_TEST
+
+
+/*
+ * Histograms
+ * ==========
+ */
+
+START_TEST(percentilesAreWithinThePrecision) {
+	static THEGAME_Histogram histogram, merged;
+	uint64_t latency = 0;
+
+	for(latency = 1; latency <= 1000; latency++){
+		THEGAME_recordLatency(&histogram, latency * 1000);
+	}
+	ck_assert(histogram.count == 1000);
+	ck_assert(histogram.min == 1000);
+	ck_assert(histogram.max == 1000000);
+	ck_assert(THEGAME_getPercentile(&histogram, 50) >= 500000);
+	ck_assert(THEGAME_getPercentile(&histogram, 50) <= 500000 + 500000 / THEGAME_HISTOGRAM_SUB_BUCKETS);
+	ck_assert(THEGAME_getPercentile(&histogram, 99) >= 990000);
+	ck_assert(THEGAME_getPercentile(&histogram, 99) <= 990000 + 990000 / THEGAME_HISTOGRAM_SUB_BUCKETS);
+	ck_assert(THEGAME_getPercentile(&histogram, 100) == 1000000);
+	/* Small latencies are exact: */
+	THEGAME_recordLatency(&merged, 7);
+	ck_assert(THEGAME_getPercentile(&merged, 50) == 7);
+
+	THEGAME_mergeHistograms(&merged, &histogram);
+	ck_assert(merged.count == 1001);
+	ck_assert(merged.min == 7);
+	ck_assert(merged.max == 1000000);
+	ck_assert(THEGAME_getPercentile(&merged, 0) == 7);
+}
+END_TEST
+
+START_TEST(emptyHistogramsGiveNullPercentiles) {
+	static THEGAME_Histogram histogram;
+
+	ck_assert(THEGAME_getPercentile(&histogram, 99) == 0);
+	ck_assert(THEGAME_getLatencies(THEGAME_TRACE_NB_STAGES)->count == 0);
+	ck_assert_str_eq("loading", THEGAME_getStageName(THEGAME_TRACE_LOADING));
+	ck_assert_str_eq("unknown", THEGAME_getStageName(THEGAME_TRACE_NB_STAGES));
+}
+END_TEST
+
+
+TCase* createHooksTestCase() {
+	TCase* testCase = tcase_create("Hooks");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, entryPointsAreTraced);
+	tcase_add_test(testCase, oldDecisionsAreTraced);
+	tcase_add_test(testCase, resetEmptiesTheTrace);
+	tcase_add_test(testCase, traceIsPerThread);
+	tcase_add_test(testCase, endedThreadsArePublished);
+	tcase_add_test(testCase, chromeTraceIsWritten);
+	return testCase;
+}
+
+TCase* createHistogramsTestCase() {
+	TCase* testCase = tcase_create("Histograms");
+	tcase_add_test(testCase, percentilesAreWithinThePrecision);
+	tcase_add_test(testCase, emptyHistogramsGiveNullPercentiles);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("Trace");
+	suite_add_tcase(suite, createHooksTestCase());
+	suite_add_tcase(suite, createHistogramsTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2011-2014, EDF. This software was developed with the collaboration of INRIA (Bastien Pietropaoli)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * test_Validation.c
+ */
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Validation.h"
+#include "BeliefCombinations.h"
+
+#include "unit_tests.h"
+
+
+BF_BeliefFunction vacuous, bad;
+int nbCalls = 0;
+THEGAME_ValidationError lastError;
+int lastNbFocals = 0;
+
+
+static void setup() {
+	vacuous = BF_getVacuousBeliefFunction(ATOM_NB);
+	/* A function whose sum is 0.5: */
+	bad = BF_getVacuousBeliefFunction(ATOM_NB);
+	bad.focals[0].beliefValue = 0.5;
+	nbCalls = 0;
+	THEGAME_resetValidationErrors();
+}
+
+static void teardown() {
+	BF_freeBeliefFunction(&vacuous);
+	BF_freeBeliefFunction(&bad);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_OFF);
+	THEGAME_setValidationCallback(NULL, NULL);
+}
+
+static void countCalls(const THEGAME_ValidationError* error, void* data){
+	nbCalls++;
+	lastError = *error;
+	lastNbFocals = error->beliefFunction != NULL ? error->beliefFunction->nbFocals : -1;
+	ck_assert(data == &nbCalls);
+}
+
+/**
+ * Combines the bad function with the vacuous one, which gives a function whose sum is 0.5.
+ */
+static void combineBadFunction(){
+	BF_BeliefFunction combined = BF_SmetsCombination(bad, vacuous);
+
+	BF_freeBeliefFunction(&combined);
+}
+
+
+/*
+ * Levels
+ * ======
+ */
+
+START_TEST(offSkipsTheChecks) {
+	ck_assert(THEGAME_getValidationLevel() == THEGAME_VALIDATION_OFF);
+	THEGAME_setValidationCallback(countCalls, &nbCalls);
+	combineBadFunction();
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_SUM) == 0);
+	ck_assert_int_eq(0, nbCalls);
+}
+END_TEST
+
+START_TEST(countOnlyCountsTheErrors) {
+	THEGAME_setValidationCallback(countCalls, &nbCalls);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_COUNT);
+	combineBadFunction();
+	#ifdef CHECK_SUM
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_SUM) == 1);
+	#endif
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_VALUES) == 0);
+	ck_assert_int_eq(0, nbCalls);
+
+	THEGAME_resetValidationErrors();
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_SUM) == 0);
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_NB_CHECKS) == 0);
+}
+END_TEST
+
+START_TEST(callbackReceivesTheErrors) {
+	THEGAME_setValidationCallback(countCalls, &nbCalls);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_CALLBACK);
+	combineBadFunction();
+	#ifdef CHECK_SUM
+	ck_assert_int_eq(1, nbCalls);
+	ck_assert(THEGAME_getNbValidationErrors(THEGAME_CHECK_SUM) == 1);
+	ck_assert(lastError.check == THEGAME_CHECK_SUM);
+	ck_assert_str_eq("BF_SmetsCombination", lastError.function);
+	ck_assert_int_eq(1, lastNbFocals);
+	#endif
+}
+END_TEST
+
+START_TEST(modelsAreChecked) {
+	const char* const values[] = {"A", "B", "C"};
+	const char* const invalid[] = {"A", "D"};
+	Sets_ReferenceList rl = Sets_createRefListFromArray(values, 3);
+	Sets_Element element;
+
+	THEGAME_setValidationCallback(countCalls, &nbCalls);
+	THEGAME_setValidationLevel(THEGAME_VALIDATION_CALLBACK);
+	element = Sets_createElementFromStrings(invalid, 2, rl);
+	#ifdef CHECK_MODELS
+	ck_assert_int_eq(1, nbCalls);
+	ck_assert(lastError.check == THEGAME_CHECK_MODELS);
+	ck_assert(strstr(lastError.message, "\"D\"") != NULL);
+	ck_assert(lastError.beliefFunction == NULL);
+	#endif
+	ck_assert_int_eq(1, element.card);
+
+	Sets_freeElement(&element);
+	Sets_freeReferenceList(&rl);
+}
+END_TEST
+
+
+TCase* createLevelsTestCase() {
+	TCase* testCase = tcase_create("Levels");
+	tcase_add_checked_fixture(testCase, setup, teardown);
+	tcase_add_test(testCase, offSkipsTheChecks);
+	tcase_add_test(testCase, countOnlyCountsTheErrors);
+	tcase_add_test(testCase, callbackReceivesTheErrors);
+	tcase_add_test(testCase, modelsAreChecked);
+	return testCase;
+}
+
+Suite *createSuite(void) {
+	Suite *suite = suite_create("Validation");
+	suite_add_tcase(suite, createLevelsTestCase());
+
+	return suite;
+}
+
+
+int main() {
+	int numberFailed = 0;
+	Suite *suite = createSuite();
+	SRunner *suiteRunner= srunner_create(suite);
+	srunner_run_all(suiteRunner, CK_NORMAL);
+	numberFailed = srunner_ntests_failed (suiteRunner);
+	srunner_free(suiteRunner);
+	return (numberFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -14,6 +14,24 @@ target_link_libraries(test-thegame THEGAME)
 ## unit testing
 if(NOT SKIPTEST AND NOT CMAKE_CROSSCOMPILING)
 
+## differential testing of the optimized functions (no dependency on Check)
+enable_testing()
+
+add_executable(
+	differential-thegame
+	src/test/c/differential.c
+)
+
+target_link_libraries(differential-thegame THEGAME)
+
+set_target_properties(
+    differential-thegame
+    PROPERTIES
+    COMPILE_FLAGS ${thegame_compile_flags}
+)
+
+add_test(NAME differential COMMAND differential-thegame)
+
 find_package(Check)
 
 if(CHECK_FOUND)
@@ -29,10 +47,18 @@ if(CHECK_FOUND)
     
     
     thegame_add_test(test_Sets)
+    thegame_add_test(test_Memory)
+    thegame_add_test(test_Stats)
+    thegame_add_test(test_Trace)
+    thegame_add_test(test_Validation)
     thegame_add_test(test_BeliefFromSensors)
         thegame_add_test(test_BeliefFromSensorsCreation)
     thegame_add_test(test_BeliefFunctions)
     thegame_add_test(test_BeliefCombination)
+    thegame_add_test(test_BeliefApproximations)
+    thegame_add_test(test_BeliefMetrics)
+    thegame_add_test(test_BeliefsFromBeliefs)
+    thegame_add_test(test_BeliefsFromRandomness)
     
     if(LIBXML2_FOUND)
         thegame_add_test(test_XmlBeliefFromSensors)